@@ -16,6 +16,8 @@
 #pragma once
 #include <sys/uio.h>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include <folly/small_vector.h>
 #include <folly/futures/Future.h>
@@ -64,9 +66,10 @@ public:
      * @param alloc_type The type of block allocator to use for the virtual device.
      * @param chunk_sel_type The type of chunk selector to use for the virtual device.
      * @param num_chunks The number of chunks to use for the virtual device.
+     * @param enable_discard Whether the freed blocks are discarded on the device once the checkpoint is committed.
      */
     void create_vdev(uint64_t size, HSDevType devType, uint32_t blk_size, blk_allocator_type_t alloc_type,
-                     chunk_selector_type_t chunk_sel_type, uint32_t num_chunks);
+                     chunk_selector_type_t chunk_sel_type, uint32_t num_chunks, bool enable_discard = false);
 
     /**
      * @brief Opens a virtual device with the specified virtual device information.
@@ -89,6 +92,18 @@ public:
     folly::Future< std::error_code > async_alloc_write(sisl::sg_list const& sgs, blk_alloc_hints const& hints,
                                                        MultiBlkId& out_blkids, bool part_of_batch = false);
 
+    /**
+     * @brief Allocates blocks for a batch of writes and writes them, submitting all the writes as one io batch.
+     *
+     * @param sgs_list The scatter-gather list of each write in the batch.
+     * @param hints Hints for allocating the blocks, common to all the writes.
+     * @param out_blkids The blkids allocated and written to, one per sg_list in the same order.
+     * @return A Future that will contain the first error of any of the writes or success if all of them succeeded.
+     */
+    folly::Future< std::error_code > async_alloc_write_batch(std::span< sisl::sg_list const > sgs_list,
+                                                             blk_alloc_hints const& hints,
+                                                             std::vector< MultiBlkId >& out_blkids);
+
     /**
      * @brief Asynchronously writes the given buffer to the specified block ID.
      *
@@ -154,6 +169,19 @@ public:
      */
     BlkAllocStatus alloc_blks(uint32_t size, blk_alloc_hints const& hints, MultiBlkId& out_blkids);
 
+    /**
+     * @brief Allocates blocks for a batch of sizes in one go. The chunk is selected once for the entire batch, instead
+     * of going through the chunk selector for every allocation. Allocation is all or nothing, partial allocation of
+     * any size is treated as failure.
+     *
+     * @param sizes Sizes to allocate, in bytes, each of which is expected to be multiple of blk size.
+     * @param hints Hints for how to allocate the blocks, common to all the sizes.
+     * @param out_blkids Output parameter that will be filled with the blkids, one per size in the same order.
+     * @return SUCCESS if all the sizes are allocated, otherwise the failure status with nothing allocated.
+     */
+    BlkAllocStatus alloc_blks_batch(std::span< uint32_t const > sizes, blk_alloc_hints const& hints,
+                                    std::vector< MultiBlkId >& out_blkids);
+
     /**
      * @brief Asynchronously frees the specified block IDs.
      * It is asynchronous because it might need to wait for pending read to complete if same block is being read and not
@@ -17,8 +17,12 @@
 
 #include <atomic>
 #include <array>
+#include <limits>
+#include <mutex>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
+#include <boost/fiber/fss.hpp>
 #include <folly/small_vector.h>
 #include <iomgr/fiber_lib.hpp>
 
@@ -81,19 +85,32 @@ protected:
 #ifdef _PRERELEASE
     BTREE_FLIPS m_flips;
 #endif
-    // This workaround of BtreeThreadVariables is needed instead of directly declaring statics
-    // to overcome the gcc bug, pointer here: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=66944
+    // Btree per operation state is kept in fiber specific storage, which is looked up in the fiber's own context and
+    // is freed when the fiber exits. It is allocated only on the first use in a fiber.
     static BtreeThreadVariables* bt_thread_vars() {
-        auto this_id(boost::this_fiber::get_id());
-        static thread_local std::map< boost::fibers::fiber::id, std::unique_ptr< BtreeThreadVariables > > fiber_map;
-        if (fiber_map.count(this_id)) { return fiber_map[this_id].get(); }
-        fiber_map[this_id] = std::make_unique< BtreeThreadVariables >();
-        return fiber_map[this_id].get();
+        static boost::fibers::fiber_specific_ptr< BtreeThreadVariables > fiber_vars;
+        auto* vars = fiber_vars.get();
+        if (vars == nullptr) {
+            vars = new BtreeThreadVariables();
+            fiber_vars.reset(vars);
+        }
+        return vars;
     }
 
 protected:
     BtreeConfig m_bt_cfg;
 
+    // Number of times an optimistic read is restarted, before it falls back to lock coupled read
+    static constexpr uint32_t max_optimistic_read_attempts{4};
+
+    // Parallel query splits the range into these many partitions per fiber, so that a fiber done with a sparse
+    // partition could pick up another one
+    static constexpr uint32_t parallel_query_partitions_per_fiber{4};
+
+    // Roots of the subtrees detached by range remove, which are yet to be freed
+    std::mutex m_dropped_nodes_mtx;
+    std::vector< bnodeid_t > m_dropped_nodes;
+
 public:
     /////////////////////////////////////// All External APIs /////////////////////////////
     Btree(const BtreeConfig& cfg);
@@ -110,6 +127,21 @@ public:
 
     btree_status_t query(BtreeQueryRequest< K >& query_req, std::vector< std::pair< K, V > >& out_values) const;
 
+    /// @brief Query the range concurrently across partitions, see BtreeParallelQueryRequest. Values are returned in
+    /// out_values in key order, unless the request streams them.
+    btree_status_t parallel_query(BtreeParallelQueryRequest< K >& qreq,
+                                  std::vector< std::pair< K, V > >& out_values) const;
+
+    /// @brief Build the btree bottom-up from the sorted key value pairs, packing the nodes upto ideal fill size.
+    /// Supported only on an empty btree. Iterator is expected to dereference to std::pair< K, V > with strictly
+    /// increasing keys.
+    template < typename InputIt >
+    btree_status_t bulk_load(InputIt begin, InputIt end, void* context = nullptr);
+
+    /// @brief Free upto max_nodes nodes of the subtrees detached by range remove in drop subtrees mode. Returns
+    /// has_more if there are more nodes yet to be freed and cp_mismatch if it is to be retried with a newer cp.
+    btree_status_t free_dropped_subtrees(uint32_t max_nodes, void* context);
+
     // bool verify_tree(bool update_debug_bm) const;
     virtual std::pair< btree_status_t, uint64_t > destroy_btree(void* context);
     nlohmann::json get_status(int log_level) const;
@@ -141,15 +173,36 @@ protected:
     virtual BtreeNodePtr alloc_node(bool is_leaf) = 0;
     virtual BtreeNode* init_node(uint8_t* node_buf, bnodeid_t id, bool init_buf, bool is_leaf) const;
     virtual btree_status_t read_node_impl(bnodeid_t id, BtreeNodePtr& node) const = 0;
+    virtual bool has_prefetch() const { return false; }
+    virtual void prefetch_nodes_impl(std::vector< bnodeid_t > const& ids) const {}
     virtual btree_status_t write_node_impl(const BtreeNodePtr& node, void* context) = 0;
     virtual btree_status_t refresh_node(const BtreeNodePtr& node, bool for_read_modify_write, void* context) const = 0;
     virtual void free_node_impl(const BtreeNodePtr& node, void* context) = 0;
+    // Free a leaf node of a dropped subtree given only its id. Store which can free the node without reading it could
+    // override it, btree_obj_count is not adjusted for such a node then.
+    virtual void free_node_by_id_impl(bnodeid_t id, void* context);
     virtual btree_status_t transact_nodes(const BtreeNodeList& new_nodes, const BtreeNodeList& freed_nodes,
                                           const BtreeNodePtr& left_child_node, const BtreeNodePtr& parent_node,
                                           void* context) = 0;
     virtual btree_status_t on_root_changed(BtreeNodePtr const& root, void* context) = 0;
     virtual std::string btree_store_type() const = 0;
 
+    // Optimistic descent reads nodes without holding any lock on them. A store which reuses the memory of freed nodes
+    // could override these to defer it till the unlocked readers who could have reached the node are done.
+    virtual uint64_t enter_unlocked_read() const { return 0; }
+    virtual void exit_unlocked_read(uint64_t) const {}
+
+    // Called after range remove detached some subtrees, the store could override it to free them in the background
+    virtual void on_subtrees_dropped(void* context) {
+        while (free_dropped_subtrees(std::numeric_limits< uint32_t >::max(), context) == btree_status_t::has_more) {}
+    }
+
+    // Called with m_dropped_nodes changed, before any node is modified or freed for the change. The store could
+    // persist the list along with the changes in this context, after the given node (if any) is persisted.
+    virtual btree_status_t on_dropped_nodes_changed(BtreeNodePtr const& node, void* context) {
+        return btree_status_t::success;
+    }
+
     /////////////////////////// Methods the application use case is expected to handle ///////////////////////////
 
 protected:
@@ -158,9 +211,13 @@ protected:
     /////////////////////////////// Internal Node Management Methods ////////////////////////////////////
     btree_status_t read_and_lock_node(bnodeid_t id, BtreeNodePtr& node_ptr, locktype_t int_lock_type,
                                       locktype_t leaf_lock_type, void* context) const;
+    bool is_optimistic_read_possible() const;
+    btree_status_t optimistic_read_and_lock_leaf(const BtreeKey& key, BtreeNodePtr& leaf, BtreeRequest& req) const;
+    btree_status_t do_optimistic_read_and_lock_leaf(const BtreeKey& key, BtreeNodePtr& leaf, BtreeRequest& req) const;
     void read_node_or_fail(bnodeid_t id, BtreeNodePtr& node) const;
     btree_status_t write_node(const BtreeNodePtr& node, void* context);
     void free_node(const BtreeNodePtr& node, locktype_t cur_lock, void* context);
+    void free_leaf_node(bnodeid_t id, void* context);
     BtreeNodePtr alloc_leaf_node();
     BtreeNodePtr alloc_interior_node();
 
@@ -230,6 +287,7 @@ protected:
 
     btree_status_t merge_nodes(const BtreeNodePtr& parent_node, const BtreeNodePtr& leftmost_node, uint32_t start_indx,
                                uint32_t end_indx, void* context);
+    btree_status_t drop_covered_subtrees(BtreeRangeRemoveRequest< K >& rrreq);
     bool remove_extents_in_leaf(const BtreeNodePtr& node, BtreeRangeRemoveRequest< K >& rrreq);
 
     ///////// Query Impl Methods
@@ -237,6 +295,14 @@ protected:
                                   std::vector< std::pair< K, V > >& out_values) const;
     btree_status_t do_traversal_query(const BtreeNodePtr& my_node, BtreeQueryRequest< K >& qreq,
                                       std::vector< std::pair< K, V > >& out_values) const;
+    bool readahead_enabled() const { return has_prefetch() && (m_bt_cfg.m_max_readahead_nodes != 0); }
+    void readahead_leaves(const BtreeNodePtr& parent, uint32_t start_idx, BtreeQueryRequest< K >& qreq) const;
+    void on_readahead_leaf(const BtreeNodePtr& prev_leaf, const BtreeNodePtr& leaf,
+                           BtreeQueryRequest< K >& qreq) const;
+    btree_status_t split_query_range(BtreeKeyRange< K > const& range, uint32_t num_partitions,
+                                     std::vector< BtreeKeyRange< K > >& partitions, void* context) const;
+    btree_status_t query_partition(BtreeParallelQueryRequest< K >& qreq, uint32_t partition,
+                                   BtreeKeyRange< K > const& range, std::vector< std::pair< K, V > >& out_values) const;
 #ifdef SERIALIZABLE_QUERY_IMPLEMENTATION
     btree_status_t do_serialzable_query(const BtreeNodePtr& my_node, BtreeSerializableQueryRequest& qreq,
                                         std::vector< std::pair< K, V > >& out_values);
@@ -245,6 +311,16 @@ protected:
                                       std::vector< std::pair< K, V > >& out_values);
 #endif
 
+    ///////// Bulk Load Impl Methods
+    struct bulk_load_level {
+        BtreeNodePtr node;  // Rightmost node of the level, which is still being filled
+        BtreeNodeList done; // Completed nodes of the level, kept around to free them if the load fails
+    };
+    btree_status_t bulk_load_new_root(std::vector< bulk_load_level >& levels, void* context);
+    btree_status_t bulk_load_roll_node(std::vector< bulk_load_level >& levels, uint32_t level, void* context);
+    btree_status_t bulk_load_finish(std::vector< bulk_load_level >& levels, void* context);
+    void bulk_load_abort(std::vector< bulk_load_level >& levels, void* context);
+
     ///////// Get Impl Methods
     template < typename ReqT >
     btree_status_t do_get(const BtreeNodePtr& my_node, ReqT& greq) const;
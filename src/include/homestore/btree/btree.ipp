@@ -24,6 +24,8 @@
 // #include <flip/flip.hpp>
 #include <sisl/logging/logging.h>
 #include <sisl/fds/buffer.hpp>
+#include <iomgr/iomgr.hpp>
+#include <homestore/work_sharing.hpp>
 
 #include <homestore/btree/btree.hpp>
 #include <homestore/btree/detail/btree_common.ipp>
@@ -32,6 +34,7 @@
 #include <homestore/btree/detail/btree_query_impl.ipp>
 #include <homestore/btree/detail/btree_get_impl.ipp>
 #include <homestore/btree/detail/btree_remove_impl.ipp>
+#include <homestore/btree/detail/btree_bulk_load_impl.ipp>
 #include <homestore/btree/detail/btree_node.hpp>
 
 namespace homestore {
@@ -61,6 +64,8 @@ std::pair< btree_status_t, uint64_t > Btree< K, V >::destroy_btree(void* context
     }
     ret = do_destroy(n_freed_nodes, context);
     if (ret == btree_status_t::success) {
+        // Subtrees detached by range remove are not reachable from root, free the ones not yet freed
+        while (free_dropped_subtrees(std::numeric_limits< uint32_t >::max(), context) == btree_status_t::has_more) {}
         BT_LOG(DEBUG, "btree(root: {}) {} nodes destroyed successfully", m_root_node_info.bnode_id(), n_freed_nodes);
     } else {
         m_destroyed = false;
@@ -73,8 +78,12 @@ std::pair< btree_status_t, uint64_t > Btree< K, V >::destroy_btree(void* context
 template < typename K, typename V >
 template < typename ReqT >
 btree_status_t Btree< K, V >::put(ReqT& put_req) {
-    static_assert(std::is_same_v< ReqT, BtreeSinglePutRequest > || std::is_same_v< ReqT, BtreeRangePutRequest< K > >,
+    static_assert(std::is_same_v< ReqT, BtreeSinglePutRequest > || std::is_same_v< ReqT, BtreeRangePutRequest< K > > ||
+                      std::is_same_v< ReqT, BtreeBatchPutRequest< K > >,
                   "put api is called with non put request type");
+    if constexpr (std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
+        if (put_req.is_done()) { return btree_status_t::success; }
+    }
     COUNTER_INCREMENT(m_metrics, btree_write_ops_count, 1);
     auto acq_lock = locktype_t::READ;
     bool is_leaf = false;
@@ -88,6 +97,7 @@ retry:
 #endif
     BT_LOG_ASSERT_EQ(bt_thread_vars()->rd_locked_nodes.size(), 0);
     BT_LOG_ASSERT_EQ(bt_thread_vars()->wr_locked_nodes.size(), 0);
+    if constexpr (std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) { put_req.m_leaf_end_key.reset(); }
 
     BtreeNodePtr root;
     ret = read_and_lock_node(m_root_node_info.bnode_id(), root, acq_lock, acq_lock, put_req.m_op_context);
@@ -118,7 +128,8 @@ retry:
     } else {
         ret = do_put(root, acq_lock, put_req);
         if ((ret == btree_status_t::retry) || (ret == btree_status_t::has_more)) {
-            // Need to start from top down again, since there was a split or we have more to insert in case of range put
+            // Need to start from top down again, since there was a split or we have more to insert in case of range or
+            // batch put
             acq_lock = locktype_t::READ;
             BT_LOG(TRACE, "retrying put operation");
             BT_LOG_ASSERT_EQ(bt_thread_vars()->rd_locked_nodes.size(), 0);
@@ -143,19 +154,43 @@ out:
 template < typename K, typename V >
 template < typename ReqT >
 btree_status_t Btree< K, V >::get(ReqT& greq) const {
-    static_assert(std::is_same_v< BtreeSingleGetRequest, ReqT > || std::is_same_v< BtreeGetAnyRequest< K >, ReqT >,
+    static_assert(std::is_same_v< BtreeSingleGetRequest, ReqT > || std::is_same_v< BtreeGetAnyRequest< K >, ReqT > ||
+                      std::is_same_v< BtreeBatchGetRequest< K >, ReqT >,
                   "get api is called with non get request type");
 
     btree_status_t ret = btree_status_t::success;
+    constexpr bool is_batch = std::is_same_v< BtreeBatchGetRequest< K >, ReqT >;
+    if constexpr (is_batch) {
+        if (greq.is_done()) { return ret; }
+    }
 
-    m_btree_lock.lock_shared();
-    BtreeNodePtr root;
-
-    ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::READ, locktype_t::READ, greq.m_op_context);
-    if (ret != btree_status_t::success) { goto out; }
+    if constexpr (!is_batch) {
+        if (is_optimistic_read_possible()) {
+            BtreeKey const* key;
+            if constexpr (std::is_same_v< BtreeSingleGetRequest, ReqT >) {
+                key = &greq.key();
+            } else {
+                key = &greq.m_range.start_key();
+            }
+
+            BtreeNodePtr leaf;
+            ret = optimistic_read_and_lock_leaf(*key, leaf, greq);
+            if (ret == btree_status_t::success) { return do_get(leaf, greq); }
+            if (ret != btree_status_t::retry) { return ret; }
+        }
+    }
 
-    ret = do_get(root, greq);
-out:
+    m_btree_lock.lock_shared();
+    do {
+        // Batch get descends again for the next key, once the keys of a leaf are exhausted
+        if constexpr (is_batch) { greq.m_leaf_end_key.reset(); }
+
+        BtreeNodePtr root;
+        ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::READ, locktype_t::READ,
+                                 greq.m_op_context);
+        if (ret != btree_status_t::success) { break; }
+        ret = do_get(root, greq);
+    } while (ret == btree_status_t::has_more);
     m_btree_lock.unlock_shared();
 
 #ifndef NDEBUG
@@ -172,6 +207,15 @@ btree_status_t Btree< K, V >::remove(ReqT& req) {
                       std::is_same_v< ReqT, BtreeRemoveAnyRequest< K > >,
                   "remove api is called with non remove request type");
 
+    if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+        if (req.m_drop_subtrees && !req.m_filter_cb) {
+            // Detach the subtrees fully within the range first, so that the regular remove below has to only walk the
+            // two boundary paths
+            auto const ret = drop_covered_subtrees(req);
+            if ((ret != btree_status_t::success) && (ret != btree_status_t::not_found)) { return ret; }
+        }
+    }
+
     locktype_t acq_lock = locktype_t::READ;
     m_btree_lock.lock_shared();
 
@@ -222,6 +266,9 @@ out:
 #ifndef NDEBUG
     check_lock_debug();
 #endif
+    if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+        if ((ret == btree_status_t::not_found) && (req.m_num_dropped_subtrees != 0)) { ret = btree_status_t::success; }
+    }
     return ret;
 }
 
@@ -232,10 +279,22 @@ btree_status_t Btree< K, V >::query(BtreeQueryRequest< K >& qreq, std::vector< s
     btree_status_t ret = btree_status_t::success;
     if (qreq.batch_size() == 0) { return ret; }
 
-    m_btree_lock.lock_shared();
     BtreeNodePtr root = nullptr;
-    ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::READ, locktype_t::READ, qreq.m_op_context);
-    if (ret != btree_status_t::success) { goto out; }
+    bool tree_locked{false};
+    if (is_optimistic_read_possible() &&
+        (qreq.query_type() == BtreeQueryType::SWEEP_NON_INTRUSIVE_PAGINATION_QUERY)) {
+        // Sweep query descends only to the first leaf and then walks the siblings, so start with that leaf directly
+        ret = optimistic_read_and_lock_leaf(qreq.first_key(), root, qreq);
+        if ((ret != btree_status_t::success) && (ret != btree_status_t::retry)) { goto out; }
+    }
+
+    if (root == nullptr) {
+        m_btree_lock.lock_shared();
+        tree_locked = true;
+        ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::READ, locktype_t::READ,
+                                 qreq.m_op_context);
+        if (ret != btree_status_t::success) { goto out; }
+    }
 
     switch (qreq.query_type()) {
     case BtreeQueryType::SWEEP_NON_INTRUSIVE_PAGINATION_QUERY:
@@ -264,7 +323,7 @@ btree_status_t Btree< K, V >::query(BtreeQueryRequest< K >& qreq, std::vector< s
     }
 
 out:
-    m_btree_lock.unlock_shared();
+    if (tree_locked) { m_btree_lock.unlock_shared(); }
 #ifndef NDEBUG
     check_lock_debug();
 #endif
@@ -275,6 +334,39 @@ out:
     return ret;
 }
 
+template < typename K, typename V >
+btree_status_t Btree< K, V >::parallel_query(BtreeParallelQueryRequest< K >& qreq,
+                                             std::vector< std::pair< K, V > >& out_values) const {
+    auto const parallelism = std::max(qreq.m_parallelism, 1u);
+    std::vector< BtreeKeyRange< K > > partitions;
+    auto ret = split_query_range(qreq.m_range, parallelism * parallel_query_partitions_per_fiber, partitions,
+                                 qreq.m_op_context);
+    if (ret != btree_status_t::success) { return ret; }
+    qreq.m_num_partitions = uint32_cast(partitions.size());
+
+    std::vector< std::vector< std::pair< K, V > > > results(partitions.size());
+    std::vector< btree_status_t > statuses(partitions.size(), btree_status_t::success);
+    auto const query_one = [this, &qreq, &partitions, &results, &statuses](size_t p) {
+        statuses[p] = query_partition(qreq, uint32_cast(p), partitions[p], results[p]);
+    };
+
+    // Caller itself scans the partitions along with the other fibers which could do sync io
+    run_shared_works(partitions.size(), parallelism, iomanager.sync_io_capable_fibers(), query_one);
+
+    for (size_t p{0}; p < partitions.size(); ++p) {
+        if (statuses[p] != btree_status_t::success) {
+            BT_LOG(ERROR, "Parallel query of partition {} range {} failed {}", p, partitions[p].to_string(),
+                   statuses[p]);
+            return statuses[p];
+        }
+        if (!qreq.m_stream_cb) {
+            out_values.insert(out_values.end(), std::make_move_iterator(results[p].begin()),
+                              std::make_move_iterator(results[p].end()));
+        }
+    }
+    return btree_status_t::success;
+}
+
 #if 0
 /**
  * @brief : verify btree is consistent and no corruption;
@@ -14,6 +14,10 @@
  *
  *********************************************************************************/
 #pragma once
+#include <deque>
+#include <optional>
+#include <vector>
+
 #include <sisl/fds/buffer.hpp>
 #include <homestore/btree/btree_kv.hpp>
 
@@ -115,6 +119,34 @@ public:
     put_filter_cb_t m_filter_cb;
 };
 
+// Put of multiple entries in one request. Entries are expected to be sorted by key without duplicates, which lets all
+// the entries which belong to the same leaf to be put with one traversal and under one lock of the leaf.
+template < typename K >
+struct BtreeBatchPutRequest : public BtreeRequest {
+public:
+    BtreeBatchPutRequest(std::vector< std::pair< const BtreeKey*, const BtreeValue* > >&& kvs, btree_put_type put_type,
+                         void* app_context = nullptr, put_filter_cb_t filter_cb = nullptr) :
+            BtreeRequest{app_context, nullptr},
+            m_kvs{std::move(kvs)},
+            m_put_type{put_type},
+            m_filter_cb{std::move(filter_cb)} {}
+
+    // Key and value of the next entry to put
+    const BtreeKey& key() const { return *m_kvs[m_cursor].first; }
+    const BtreeValue& value() const { return *m_kvs[m_cursor].second; }
+    bool is_done() const { return (m_cursor == m_kvs.size()); }
+
+    // Is the next entry within the leaf the current traversal lead to
+    bool is_within_leaf() const { return !m_leaf_end_key || (key().compare(*m_leaf_end_key) <= 0); }
+
+    std::vector< std::pair< const BtreeKey*, const BtreeValue* > > m_kvs;
+    const btree_put_type m_put_type;
+    put_filter_cb_t m_filter_cb;
+    uint32_t m_cursor{0};       // Index of the next entry to put
+    uint32_t m_num_failed{0};   // Number of entries not put, because of put type or filter
+    std::optional< K > m_leaf_end_key; // Last key the current leaf could hold, nullopt for the rightmost leaf
+};
+
 /////////////////////////// 2: Remove Operations /////////////////////////////////////
 struct BtreeSingleRemoveRequest : public BtreeRequest {
 public:
@@ -145,11 +177,19 @@ struct BtreeRangeRemoveRequest : public BtreeRangeRequest< K > {
 public:
     remove_filter_cb_t m_filter_cb;
 
+    // In drop subtrees mode, subtrees whose entire key space falls within the range are detached from the btree
+    // without reading them and their nodes are freed later. Only the leaves at either end of the range are modified
+    // in place. It removes the whole range irrespective of batch size and is ignored if there is a filter callback.
+    bool m_drop_subtrees{false};
+    uint64_t m_num_dropped_subtrees{0};
+
 public:
     BtreeRangeRemoveRequest(BtreeKeyRange< K >&& inp_range, void* app_context = nullptr,
                             uint32_t batch_size = std::numeric_limits< uint32_t >::max(),
-                            remove_filter_cb_t filter_cb = nullptr) :
-            BtreeRangeRequest< K >(std::move(inp_range), app_context, batch_size), m_filter_cb{std::move(filter_cb)} {}
+                            remove_filter_cb_t filter_cb = nullptr, bool drop_subtrees = false) :
+            BtreeRangeRequest< K >(std::move(inp_range), app_context, batch_size),
+            m_filter_cb{std::move(filter_cb)},
+            m_drop_subtrees{drop_subtrees} {}
 };
 
 /////////////////////////// 3: Get Operations /////////////////////////////////////
@@ -175,6 +215,27 @@ public:
     BtreeValue* m_outval;
 };
 
+// Get of multiple keys in one request, keys are expected to be sorted without duplicates. Value of each key found is
+// copied to its out value and its entry in m_found is set.
+template < typename K >
+struct BtreeBatchGetRequest : public BtreeRequest {
+public:
+    BtreeBatchGetRequest(std::vector< std::pair< const BtreeKey*, BtreeValue* > >&& keys, void* app_context = nullptr) :
+            BtreeRequest{app_context, nullptr}, m_keys{std::move(keys)}, m_found(m_keys.size(), false) {}
+
+    // Next key to get
+    const BtreeKey& key() const { return *m_keys[m_cursor].first; }
+    BtreeValue* outval() const { return m_keys[m_cursor].second; }
+    bool is_done() const { return (m_cursor == m_keys.size()); }
+    bool is_within_leaf() const { return !m_leaf_end_key || (key().compare(*m_leaf_end_key) <= 0); }
+
+    std::vector< std::pair< const BtreeKey*, BtreeValue* > > m_keys;
+    std::vector< bool > m_found;
+    uint32_t m_cursor{0};
+    uint32_t m_num_found{0};
+    std::optional< K > m_leaf_end_key;
+};
+
 /////////////////////////// 4 Range Query Operations /////////////////////////////////////
 ENUM(BtreeQueryType, uint8_t,
      // This is default query which walks to first element in range, and then sweeps/walks
@@ -216,11 +277,45 @@ public:
 
     get_filter_cb_t const& filter() const { return m_filter_cb; }
 
+    // Leaf read-ahead state of the sweep query, window is retained across the pages of the query
+    struct readahead_state {
+        std::vector< bnodeid_t > leaf_ids; // Leaves read ahead and not yet swept, in key order
+        uint32_t leaf_entries{0};          // Entries in the last leaf swept, to estimate the leaves a batch needs
+        uint32_t window{0};                // Number of leaves to read ahead
+    } m_readahead;
+
 protected:
     const BtreeQueryType m_query_type; // Type of the query
     get_filter_cb_t m_filter_cb;
 };
 
+using query_stream_cb_t = std::function< void(uint32_t, BtreeKey const&, BtreeValue const&) >;
+
+// Query which splits the range at interior node boundaries into partitions and sweeps them concurrently, upto
+// m_parallelism partitions at a time. Each partition is queried in batches of m_batch_size, which bounds the time a
+// leaf is held locked. If stream_cb is set, entries are passed to it along with their partition number as they are
+// found, in key order within a partition but concurrently across partitions. Otherwise they are returned in key order.
+template < typename K >
+struct BtreeParallelQueryRequest : public BtreeRequest {
+public:
+    BtreeParallelQueryRequest(BtreeKeyRange< K >&& range, uint32_t parallelism, uint32_t batch_size = 1000,
+                              get_filter_cb_t filter_cb = nullptr, query_stream_cb_t stream_cb = nullptr,
+                              void* app_context = nullptr) :
+            BtreeRequest{app_context, nullptr},
+            m_range{std::move(range)},
+            m_parallelism{parallelism},
+            m_batch_size{batch_size},
+            m_filter_cb{std::move(filter_cb)},
+            m_stream_cb{std::move(stream_cb)} {}
+
+    BtreeKeyRange< K > m_range;
+    uint32_t m_parallelism;
+    uint32_t m_batch_size;
+    get_filter_cb_t m_filter_cb;
+    query_stream_cb_t m_stream_cb;
+    uint32_t m_num_partitions{0}; // Number of partitions the range is split into
+};
+
 /* This class is a top level class to keep track of the locks that are held currently. It is
  * used for serializabke query to unlock all nodes in right order at the end of the lock */
 class BtreeLockTracker {
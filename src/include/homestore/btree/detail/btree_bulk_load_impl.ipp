@@ -0,0 +1,188 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <optional>
+#include <vector>
+
+#include <homestore/btree/btree.hpp>
+
+namespace homestore {
+
+/*
+ * Bulk load builds the tree bottom-up from the sorted input, instead of traversing from root for every key. Entries
+ * are appended to the rightmost leaf until it reaches the ideal fill size, at which point a new leaf is started and
+ * the completed one is appended as an entry to its parent at level 1, which in turn is rolled over the same way when
+ * it is filled up. This way only the rightmost node at every level is open at any point of time.
+ *
+ * Similar to check_split_root, whenever a new topmost node is created, it is linked as the root first, before any
+ * node is written under it. Rolling over a node is then written like a split, completed node being the left child
+ * and the new node its right sibling, so that the store can order all new nodes ahead of the root switch. Once the
+ * input is exhausted, the rightmost node at every level becomes the edge of the rightmost node at the level above.
+ * If the load fails midway, all the nodes allocated so far are freed and the old (empty) root is restored.
+ */
+template < typename K, typename V >
+template < typename InputIt >
+btree_status_t Btree< K, V >::bulk_load(InputIt begin, InputIt end, void* context) {
+    btree_status_t ret{btree_status_t::success};
+    BtreeNodePtr old_root;
+    std::vector< bulk_load_level > levels;
+    uint64_t nentries{0};
+    std::optional< K > prev_key;
+
+    m_btree_lock.lock();
+    ret = read_and_lock_node(m_root_node_info.bnode_id(), old_root, locktype_t::WRITE, locktype_t::WRITE, context);
+    if (ret != btree_status_t::success) { goto done; }
+
+    if (!old_root->is_leaf() || (old_root->total_entries() != 0)) {
+        BT_LOG(ERROR, "Bulk load is supported only on an empty btree, root={}", old_root->to_string());
+        unlock_node(old_root, locktype_t::WRITE);
+        ret = btree_status_t::not_supported;
+        goto done;
+    }
+    if (begin == end) {
+        unlock_node(old_root, locktype_t::WRITE);
+        goto done;
+    }
+
+    ret = bulk_load_new_root(levels, context);
+    if (ret != btree_status_t::success) {
+        on_root_changed(old_root, context); // Revert it back
+        unlock_node(old_root, locktype_t::WRITE);
+        goto done;
+    }
+
+    for (auto it = begin; it != end; ++it) {
+        K const& key = it->first;
+        V const& val = it->second;
+        BT_REL_ASSERT(!prev_key || (prev_key->compare(key) < 0), "Bulk load input is not sorted, key={} after key={}",
+                      key.to_string(), prev_key->to_string());
+
+        auto const& leaf = levels[0].node;
+        if ((leaf->total_entries() > 0) &&
+            (!leaf->has_room_for_put(btree_put_type::INSERT, key.serialized_size(), val.serialized_size()) ||
+             (leaf->occupied_size() >= m_bt_cfg.ideal_fill_size()))) {
+            ret = bulk_load_roll_node(levels, 0u, context);
+            if (ret != btree_status_t::success) { break; }
+        }
+
+        ret = levels[0].node->insert(levels[0].node->total_entries(), key, val);
+        if (ret != btree_status_t::success) {
+            BT_LOG(ERROR, "Bulk load unable to insert key={} into an empty leaf, ret={}", key.to_string(),
+                   enum_name(ret));
+            break;
+        }
+        prev_key = key;
+        ++nentries;
+    }
+
+    if (ret == btree_status_t::success) { ret = bulk_load_finish(levels, context); }
+
+    if (ret == btree_status_t::success) {
+        auto const& new_root = levels.back().node;
+        m_root_node_info = BtreeLinkInfo{new_root->node_id(), new_root->link_version()};
+        free_node(old_root, locktype_t::WRITE, context);
+        COUNTER_INCREMENT(m_metrics, btree_obj_count, nentries);
+        COUNTER_INCREMENT(m_metrics, btree_depth, new_root->level());
+        BT_LOG(INFO, "Bulk loaded {} entries, new root={} depth={} total_nodes={}", nentries, new_root->node_id(),
+               new_root->level() + 1, m_total_nodes.load());
+    } else {
+        // Tree still has the old (empty) root, free all the nodes built so far
+        BT_LOG(ERROR, "Bulk load failed after {} entries, ret={}, freeing the nodes built so far", nentries,
+               enum_name(ret));
+        bulk_load_abort(levels, context);
+        on_root_changed(old_root, context); // Revert it back
+        unlock_node(old_root, locktype_t::WRITE);
+    }
+
+done:
+    m_btree_lock.unlock();
+    return ret;
+}
+
+// Create a new topmost level, whose node is linked as the root right away, before anything is written under it.
+template < typename K, typename V >
+btree_status_t Btree< K, V >::bulk_load_new_root(std::vector< bulk_load_level >& levels, void* context) {
+    BtreeNodePtr root = levels.empty() ? alloc_leaf_node() : alloc_interior_node();
+    if (root == nullptr) { return btree_status_t::space_not_avail; }
+    root->set_level(uint32_cast(levels.size()));
+
+    auto ret = on_root_changed(root, context);
+    if (ret != btree_status_t::success) {
+        free_node(root, locktype_t::NONE, context);
+        return ret;
+    }
+    levels.emplace_back();
+    levels.back().node = std::move(root);
+    return btree_status_t::success;
+}
+
+// Start a new node at the given level, right of the current open node and append the current one as an entry to its
+// parent level, rolling over the parent first if it is full.
+template < typename K, typename V >
+btree_status_t Btree< K, V >::bulk_load_roll_node(std::vector< bulk_load_level >& levels, uint32_t level,
+                                                  void* context) {
+    auto ret = btree_status_t::success;
+    if (levels.size() == level + 1) {
+        ret = bulk_load_new_root(levels, context);
+    } else {
+        auto const& parent = levels[level + 1].node;
+        if (!parent->has_room_for_put(btree_put_type::INSERT, K::get_max_size(), BtreeLinkInfo::get_fixed_size()) ||
+            (parent->occupied_size() >= m_bt_cfg.ideal_fill_size())) {
+            ret = bulk_load_roll_node(levels, level + 1, context);
+        }
+    }
+    if (ret != btree_status_t::success) { return ret; }
+
+    BtreeNodePtr new_node = (level == 0) ? alloc_leaf_node() : alloc_interior_node();
+    if (new_node == nullptr) { return btree_status_t::space_not_avail; }
+    new_node->set_level(level);
+
+    auto& lvl = levels[level];
+    auto const& parent = levels[level + 1].node;
+    lvl.node->set_next_bnode(new_node->node_id());
+    parent->insert(parent->total_entries(), lvl.node->get_last_key< K >(), lvl.node->link_info());
+    lvl.done.push_back(std::move(lvl.node));
+    lvl.node = std::move(new_node);
+
+    // Completed node is the left child and the new node its right sibling, same as a split
+    return transact_nodes({lvl.node}, {}, lvl.done.back(), parent, context);
+}
+
+// Link the rightmost node of every level as the edge of its parent and write them, topmost node is the new root.
+template < typename K, typename V >
+btree_status_t Btree< K, V >::bulk_load_finish(std::vector< bulk_load_level >& levels, void* context) {
+    for (uint32_t level{0}; level < levels.size(); ++level) {
+        auto const& node = levels[level].node;
+        if (level + 1 < levels.size()) { levels[level + 1].node->set_edge_value(node->link_info()); }
+
+        auto const ret = write_node(node, context);
+        if (ret != btree_status_t::success) { return ret; }
+    }
+    return btree_status_t::success;
+}
+
+// Free all the nodes allocated by a failed bulk load, none of them are locked or reachable from the tree.
+template < typename K, typename V >
+void Btree< K, V >::bulk_load_abort(std::vector< bulk_load_level >& levels, void* context) {
+    for (auto& lvl : levels) {
+        for (auto const& node : lvl.done) {
+            free_node(node, locktype_t::NONE, context);
+        }
+        if (lvl.node) { free_node(lvl.node, locktype_t::NONE, context); }
+    }
+    levels.clear();
+}
+} // namespace homestore
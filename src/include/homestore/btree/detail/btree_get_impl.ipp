@@ -30,6 +30,21 @@ btree_status_t Btree< K, V >::do_get(const BtreeNodePtr& my_node, ReqT& greq) co
                 to_variant_node(my_node)->get_any(greq.m_range, greq.m_outkey, greq.m_outval, true, true);
         } else if constexpr (std::is_same_v< BtreeSingleGetRequest, ReqT >) {
             std::tie(found, idx) = my_node->find(greq.key(), greq.m_outval, true);
+        } else if constexpr (std::is_same_v< BtreeBatchGetRequest< K >, ReqT >) {
+            // Lookup all the keys which belong to this leaf under the same lock
+            do {
+                std::tie(found, idx) = my_node->find(greq.key(), greq.outval(), true);
+                if (found) {
+                    greq.m_found[greq.m_cursor] = true;
+                    ++greq.m_num_found;
+                    if (greq.route_tracing) { append_route_trace(greq, my_node, btree_event_t::READ, idx, idx); }
+                }
+                ++greq.m_cursor;
+            } while (!greq.is_done() && greq.is_within_leaf());
+            unlock_node(my_node, locktype_t::READ);
+
+            if (!greq.is_done()) { return btree_status_t::has_more; }
+            return (greq.m_num_found == greq.m_keys.size()) ? btree_status_t::success : btree_status_t::not_found;
         }
         if (!found) {
             ret = btree_status_t::not_found;
@@ -45,6 +60,9 @@ btree_status_t Btree< K, V >::do_get(const BtreeNodePtr& my_node, ReqT& greq) co
         std::tie(found, idx) = my_node->find(greq.m_range.start_key(), &child_info, true);
     } else if constexpr (std::is_same_v< BtreeSingleGetRequest, ReqT >) {
         std::tie(found, idx) = my_node->find(greq.key(), &child_info, true);
+    } else if constexpr (std::is_same_v< BtreeBatchGetRequest< K >, ReqT >) {
+        std::tie(found, idx) = my_node->find(greq.key(), &child_info, true);
+        if (idx < my_node->total_entries()) { greq.m_leaf_end_key = my_node->get_nth_key< K >(idx, true); }
     }
 
     if (greq.route_tracing) { append_route_trace(greq, my_node, btree_event_t::READ, idx, idx); }
@@ -243,6 +243,8 @@ struct BtreeConfig {
     uint32_t m_max_merge_nodes{3};
     bool m_rebalance_turned_on{false};
     bool m_merge_turned_on{true};
+    bool m_optimistic_read_turned_on{false}; // Readers descend interior nodes without locks, validating node versions
+    uint32_t m_max_readahead_nodes{32};      // Max leaves a sweep query reads ahead, if store can prefetch. 0 disables
 
     btree_node_type m_leaf_node_type{btree_node_type::VAR_OBJECT};
     btree_node_type m_int_node_type{btree_node_type::VAR_KEY};
@@ -297,6 +299,7 @@ public:
                          {"node_type", "interior"}, _publish_as::publish_as_gauge);
         REGISTER_COUNTER(btree_split_count, "Total number of btree node splits");
         REGISTER_COUNTER(btree_merge_count, "Total number of btree node merges");
+        REGISTER_COUNTER(btree_dropped_subtree_count, "Total number of subtrees detached by range remove");
         REGISTER_COUNTER(btree_depth, "Depth of btree", _publish_as::publish_as_gauge);
 
         REGISTER_COUNTER(btree_int_node_writes, "Total number of btree interior node writes", "btree_node_writes",
@@ -310,6 +313,9 @@ public:
         REGISTER_HISTOGRAM(btree_leaf_node_occupancy, "Leaf node occupancy", "btree_node_occupancy",
                            {"node_type", "leaf"}, HistogramBucketsType(LinearUpto128Buckets));
         REGISTER_COUNTER(btree_retry_count, "number of retries");
+        REGISTER_COUNTER(btree_optimistic_read_restarts, "number of optimistic reads restarted due to writers");
+        REGISTER_COUNTER(btree_optimistic_read_fallbacks, "number of optimistic reads fallen back to locked reads");
+        REGISTER_COUNTER(btree_readahead_nodes, "number of leaves read ahead by sweep queries");
         REGISTER_COUNTER(write_err_cnt, "number of errors in write");
         REGISTER_COUNTER(query_err_cnt, "number of errors in query");
         REGISTER_COUNTER(read_node_count_in_write_ops, "number of nodes read in write_op");
@@ -59,7 +59,8 @@ retry:
             ret = btree_status_t::put_failed;
             goto out;
         }
-    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
         auto const [found, idx] = my_node->find(req.key(), nullptr, true);
         ASSERT_IS_VALID_INTERIOR_CHILD_INDX(found, idx, my_node);
         end_idx = start_idx = idx;
@@ -125,6 +126,10 @@ retry:
                 BT_NODE_LOG(DEBUG, my_node, "Subrange:idx=[{}-{}],c={},working={}", start_idx, end_idx, curr_idx,
                             req.working_range().to_string());
             }
+        } else if constexpr (std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
+            // Key of the child entry bounds the keys the leaf underneath could hold. Keys at lower levels are always
+            // tighter, edge child is bounded by the key set at upper levels.
+            if (curr_idx < my_node->total_entries()) { req.m_leaf_end_key = my_node->get_nth_key< K >(curr_idx, true); }
         }
 
 #ifndef NDEBUG
@@ -187,12 +192,27 @@ btree_status_t Btree< K, V >::mutate_write_leaf_node(const BtreeNodePtr& my_node
             ret = btree_status_t::put_failed;
         }
         COUNTER_INCREMENT(m_metrics, btree_obj_count, 1);
+    } else if constexpr (std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
+        // Put all the entries which belong to this leaf, as long as they fit in. The first entry is guaranteed to fit
+        // in, since the leaf is split upfront otherwise.
+        auto* vnode = to_variant_node(my_node);
+        uint32_t nput{0};
+        do {
+            if (!vnode->put(req.key(), req.value(), req.m_put_type, nullptr, req.m_filter_cb)) { ++req.m_num_failed; }
+            ++req.m_cursor;
+            ++nput;
+        } while (!req.is_done() && req.is_within_leaf() && !is_split_needed(my_node, req));
+        COUNTER_INCREMENT(m_metrics, btree_obj_count, nput);
+        if (!req.is_done()) { ret = btree_status_t::has_more; }
     }
 
     if ((ret == btree_status_t::success) || (ret == btree_status_t::has_more)) {
         if (req.route_tracing) { append_route_trace(req, my_node, btree_event_t::MUTATE); }
         write_node(my_node, req.m_op_context);
     }
+    if constexpr (std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
+        if ((ret == btree_status_t::success) && (req.m_num_failed != 0)) { ret = btree_status_t::put_failed; }
+    }
     return ret;
 }
 
@@ -306,7 +326,8 @@ bool Btree< K, V >::is_split_needed(const BtreeNodePtr& node, ReqT& req) const {
         return !node->has_room_for_put(btree_put_type::UPSERT, K::get_max_size(), BtreeLinkInfo::get_fixed_size());
     } else if constexpr (std::is_same_v< ReqT, BtreeRangePutRequest< K > >) {
         return !node->has_room_for_put(req.m_put_type, req.first_key_size(), req.m_newval->serialized_size());
-    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeBatchPutRequest< K > >) {
         return !node->has_room_for_put(req.m_put_type, req.key().serialized_size(), req.value().serialized_size());
     } else {
         return false;
@@ -15,6 +15,7 @@
  *********************************************************************************/
 
 #pragma once
+#include <atomic>
 #include <iostream>
 #include <queue>
 #include <iomgr/fiber_lib.hpp>
@@ -92,6 +93,10 @@ public:
     transient_hdr_t m_trans_hdr;
     uint8_t* m_phys_node_buf;
 
+    // Version of the node, incremented on every write lock and unlock, so it is odd while the node is write locked.
+    // Optimistic readers read the node without lock and validate that this version is unchanged.
+    mutable std::atomic< uint64_t > m_lock_version{0};
+
 public:
     BtreeNode(uint8_t* node_buf, bnodeid_t id, bool init_buf, bool is_leaf, BtreeConfig const& cfg) :
             m_phys_node_buf{node_buf} {
@@ -241,7 +246,7 @@ public:
     virtual bool update_one(const BtreeKey& key, const BtreeValue& val, BtreeValue* outval) {
         const auto [found, idx] = find(key, outval, true);
         if (found) {
-            update(idx, val);
+            if (update(idx, val) != btree_status_t::success) { return false; }
             LOGMSG_ASSERT((magic() == BTREE_NODE_MAGIC), "{}", get_persistent_header_const()->to_string());
         }
         return found;
@@ -326,6 +331,8 @@ public:
             m_trans_hdr.lock.lock_shared();
         } else if (l == locktype_t::WRITE) {
             m_trans_hdr.lock.lock();
+            m_lock_version.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
         }
     }
 
@@ -333,10 +340,21 @@ public:
         if (l == locktype_t::READ) {
             m_trans_hdr.lock.unlock_shared();
         } else if (l == locktype_t::WRITE) {
+            m_lock_version.fetch_add(1, std::memory_order_release);
             m_trans_hdr.lock.unlock();
         }
     }
 
+    uint64_t lock_version() const { return m_lock_version.load(std::memory_order_acquire); }
+    static bool is_write_locked_version(uint64_t version) { return ((version & 1) != 0); }
+
+    // Validate that no writer has locked the node since the version was read, all the reads done on the node before
+    // this call are guaranteed to be consistent if this returns true.
+    bool validate_lock_version(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (m_lock_version.load(std::memory_order_relaxed) == version);
+    }
+
     void lock_upgrade() {
         m_trans_hdr.upgraders.increment(1);
         this->unlock(locktype_t::READ);
@@ -353,8 +371,8 @@ public:
     virtual void remove(uint32_t ind) { remove(ind, ind); }
     virtual void remove(uint32_t ind_s, uint32_t ind_e) = 0;
     virtual void remove_all(const BtreeConfig& cfg) = 0;
-    virtual void update(uint32_t ind, const BtreeValue& val) = 0;
-    virtual void update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) = 0;
+    virtual btree_status_t update(uint32_t ind, const BtreeValue& val) = 0;
+    virtual btree_status_t update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) = 0;
 
     virtual uint32_t move_out_to_right_by_entries(const BtreeConfig& cfg, BtreeNode& other_node, uint32_t nentries) = 0;
     virtual uint32_t move_out_to_right_by_size(const BtreeConfig& cfg, BtreeNode& other_node, uint32_t size) = 0;
@@ -387,7 +405,8 @@ public:
     virtual std::string to_string_keys(bool print_friendly = false) const = 0;
 
 protected:
-    node_find_result_t bsearch_node(const BtreeKey& key) const {
+    // Node types which can search without comparing key by key through virtual calls, override this method
+    virtual node_find_result_t bsearch_node(const BtreeKey& key) const {
         DEBUG_ASSERT_EQ(magic(), BTREE_NODE_MAGIC);
         auto [found, idx] = bsearch(-1, total_entries(), key);
         if (found) { DEBUG_ASSERT_LT(idx, total_entries()); }
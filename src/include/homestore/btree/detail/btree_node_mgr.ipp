@@ -19,6 +19,7 @@
 #include <homestore/btree/detail/simple_node.hpp>
 #include <homestore/btree/detail/varlen_node.hpp>
 #include <homestore/btree/detail/prefix_node.hpp>
+#include <homestore/btree/detail/compact_node.hpp>
 #include <sisl/fds/utils.hpp>
 // #include <iomgr/iomgr_flip.hpp>
 
@@ -97,6 +98,84 @@ btree_status_t Btree< K, V >::write_node(const BtreeNodePtr& node, void* context
     return (write_node_impl(node, context));
 }
 
+/*
+ * Descend from root to the leaf covering the key, without locking any of the interior nodes. Each node's lock version
+ * is recorded before reading it and validated after the child link is read out of it; writers bump the version on
+ * every write lock and unlock, so a changed version means a writer intervened and the descent has to be restarted.
+ * Only the leaf is read locked and its version is validated after locking, which catches any split or merge of the
+ * leaf after its link was read from the parent.
+ *
+ * Descent is restarted upto max_optimistic_read_attempts times, after which it returns retry for the caller to fall
+ * back to the lock coupled read. Returns success with the leaf read locked or any other failure status.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::optimistic_read_and_lock_leaf(const BtreeKey& key, BtreeNodePtr& leaf,
+                                                            BtreeRequest& req) const {
+    btree_status_t ret{btree_status_t::retry};
+    auto const epoch = enter_unlocked_read();
+    for (uint32_t attempt{0}; attempt < max_optimistic_read_attempts; ++attempt) {
+        ret = do_optimistic_read_and_lock_leaf(key, leaf, req);
+        if (ret != btree_status_t::retry) { break; }
+        COUNTER_INCREMENT(m_metrics, btree_optimistic_read_restarts, 1);
+    }
+    exit_unlocked_read(epoch);
+
+    if (ret == btree_status_t::retry) { COUNTER_INCREMENT(m_metrics, btree_optimistic_read_fallbacks, 1); }
+    return ret;
+}
+
+/*
+ * Interior nodes are searched without a lock, a torn read of a node with variable sized entries could follow a
+ * garbage offset out of the node. Only fixed size interior nodes, whose entry locations depend only on the index
+ * validated against the entry count, are safe to be read that way.
+ */
+template < typename K, typename V >
+bool Btree< K, V >::is_optimistic_read_possible() const {
+    return m_bt_cfg.m_optimistic_read_turned_on && (m_bt_cfg.m_int_node_type == btree_node_type::FIXED);
+}
+
+template < typename K, typename V >
+btree_status_t Btree< K, V >::do_optimistic_read_and_lock_leaf(const BtreeKey& key, BtreeNodePtr& leaf,
+                                                               BtreeRequest& req) const {
+    auto const root_id = m_root_node_info.bnode_id();
+    BtreeNodePtr node;
+    auto ret = read_node_impl(root_id, node);
+    if (node == nullptr) { return ret; }
+
+    // Root change always write locks the old root before the root info is updated
+    auto version = node->lock_version();
+    if (BtreeNode::is_write_locked_version(version) || (root_id != m_root_node_info.bnode_id())) {
+        return btree_status_t::retry;
+    }
+
+    while (!node->is_leaf()) {
+        BtreeLinkInfo child_info;
+        [[maybe_unused]] auto const [found, idx] = node->find(key, &child_info, false);
+        if (node->is_node_deleted() || !node->validate_lock_version(version)) { return btree_status_t::retry; }
+        if (req.route_tracing) { append_route_trace(req, node, btree_event_t::READ, idx, idx); }
+
+        BtreeNodePtr child;
+        ret = read_node_impl(child_info.bnode_id(), child);
+        if (child == nullptr) { return ret; }
+
+        auto const child_version = child->lock_version();
+        if (BtreeNode::is_write_locked_version(child_version) || !node->validate_lock_version(version)) {
+            return btree_status_t::retry;
+        }
+        node = std::move(child);
+        version = child_version;
+    }
+
+    ret = lock_node(node, locktype_t::READ, req.m_op_context);
+    if (ret != btree_status_t::success) { return ret; }
+    if (node->is_node_deleted() || !node->validate_lock_version(version)) {
+        unlock_node(node, locktype_t::READ);
+        return btree_status_t::retry;
+    }
+    leaf = std::move(node);
+    return btree_status_t::success;
+}
+
 /* Caller of this api doesn't expect read to fail in any circumstance */
 template < typename K, typename V >
 void Btree< K, V >::read_node_or_fail(bnodeid_t id, BtreeNodePtr& node) const {
@@ -284,6 +363,11 @@ BtreeNode* Btree< K, V >::init_node(uint8_t* node_buf, bnodeid_t id, bool init_b
                     : create_node< FixedPrefixNode< K, BtreeLinkInfo > >(node_buf, id, init_buf, false, this->m_bt_cfg);
         break;
 
+    case btree_node_type::COMPACT:
+        BT_REL_ASSERT(is_leaf, "Compact node type is supported only for leaf nodes");
+        n = create_node< CompactNode< K, V > >(node_buf, id, init_buf, true, this->m_bt_cfg);
+        break;
+
     default:
         BT_REL_ASSERT(false, "Unsupported node type {}", node_type);
         break;
@@ -308,6 +392,26 @@ void Btree< K, V >::free_node(const BtreeNodePtr& node, locktype_t cur_lock, voi
     // intrusive_ptr_release(node.get());
 }
 
+template < typename K, typename V >
+void Btree< K, V >::free_leaf_node(bnodeid_t id, void* context) {
+    BT_LOG(TRACE, "Freeing leaf node {}", id);
+
+    COUNTER_DECREMENT(m_metrics, btree_leaf_node_count, 1);
+    --m_total_nodes;
+    free_node_by_id_impl(id, context);
+}
+
+template < typename K, typename V >
+void Btree< K, V >::free_node_by_id_impl(bnodeid_t id, void* context) {
+    BtreeNodePtr node;
+    if (read_node_impl(id, node) != btree_status_t::success) {
+        BT_LOG(ERROR, "Unable to read leaf node {} to free it", id);
+        return;
+    }
+    COUNTER_DECREMENT(m_metrics, btree_obj_count, node->total_entries());
+    free_node_impl(node, context);
+}
+
 template < typename K, typename V >
 void Btree< K, V >::observe_lock_time(const BtreeNodePtr& node, locktype_t type, uint64_t time_spent) const {
     if (time_spent == 0) { return; }
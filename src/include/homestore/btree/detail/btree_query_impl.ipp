@@ -14,6 +14,7 @@
  *
  *********************************************************************************/
 #pragma once
+#include <algorithm>
 #include <homestore/btree/btree.hpp>
 
 namespace homestore {
@@ -56,6 +57,7 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
                 ret = read_and_lock_node(my_node->next_bnode(), next_node, locktype_t::READ, locktype_t::READ,
                                          qreq.m_op_context);
                 if (ret != btree_status_t::success) { break; }
+                on_readahead_leaf(my_node, next_node, qreq);
             } else {
                 ret = btree_status_t::has_more;
                 break;
@@ -70,6 +72,7 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
     [[maybe_unused]] const auto [isfound, idx] = my_node->find(qreq.first_key(), &start_child_info, false);
     ASSERT_IS_VALID_INTERIOR_CHILD_INDX(isfound, idx, my_node);
     if (qreq.route_tracing) { append_route_trace(qreq, my_node, btree_event_t::READ, idx, idx); }
+    if ((my_node->level() == 1) && readahead_enabled()) { readahead_leaves(my_node, idx + 1, qreq); }
 
     BtreeNodePtr child_node;
     ret = read_and_lock_node(start_child_info.bnode_id(), child_node, locktype_t::READ, locktype_t::READ,
@@ -79,6 +82,62 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
     return (do_sweep_query(child_node, qreq, out_values));
 }
 
+/*
+ * Sweep query walks the leaves through sibling links, which only lets it know the next leaf once it is on the current
+ * one. To overlap the leaf reads, while it descends through the parent of the leaves (and holds its lock), it
+ * asynchronously loads a window of the leaves which follow in the range into the cache. Leaves are only read ahead
+ * from the locked parent, as a leaf id is not safe to read through once the parent lock is released (it could be
+ * merged and freed). Window starts small and doubles every time the sweep lands on a leaf which was read ahead, upto
+ * m_max_readahead_nodes, but never beyond the leaves that the rest of the batch is likely to need.
+ */
+template < typename K, typename V >
+void Btree< K, V >::readahead_leaves(const BtreeNodePtr& parent, uint32_t start_idx,
+                                     BtreeQueryRequest< K >& qreq) const {
+    auto& ra = qreq.m_readahead;
+    ra.leaf_ids.clear();
+    if (ra.window == 0) { ra.window = std::min(2u, m_bt_cfg.m_max_readahead_nodes); }
+
+    [[maybe_unused]] auto [found, end_idx] = parent->find(qreq.input_range().end_key(), nullptr, false);
+    if ((end_idx == parent->total_entries()) && !parent->has_valid_edge()) {
+        if (end_idx == 0) { return; }
+        --end_idx;
+    }
+
+    // Batch needs about these many leaves, assuming they are as full as the last one swept
+    auto window = ra.window;
+    if (ra.leaf_entries != 0) { window = std::min(window, (qreq.batch_size() / ra.leaf_entries) + 1); }
+
+    for (auto idx = start_idx; (idx <= end_idx) && (ra.leaf_ids.size() < window); ++idx) {
+        BtreeLinkInfo child_info;
+        if (idx == parent->total_entries()) {
+            child_info = parent->get_edge_value();
+        } else {
+            parent->get_nth_value(idx, &child_info, false /* copy */);
+        }
+        ra.leaf_ids.push_back(child_info.bnode_id());
+    }
+    if (ra.leaf_ids.empty()) { return; }
+
+    COUNTER_INCREMENT(m_metrics, btree_readahead_nodes, ra.leaf_ids.size());
+    prefetch_nodes_impl(ra.leaf_ids);
+}
+
+template < typename K, typename V >
+void Btree< K, V >::on_readahead_leaf(const BtreeNodePtr& prev_leaf, const BtreeNodePtr& leaf,
+                                      BtreeQueryRequest< K >& qreq) const {
+    if (!readahead_enabled()) { return; }
+    auto& ra = qreq.m_readahead;
+    ra.leaf_entries = std::max(prev_leaf->total_entries(), 1u);
+
+    // Ids are only compared against and never read through, so it is fine if they are stale by now
+    auto const it = std::find(ra.leaf_ids.begin(), ra.leaf_ids.end(), leaf->node_id());
+    if (it == ra.leaf_ids.end()) { return; }
+
+    // Sweep is on a leaf which was read ahead, so it is a sequential scan, read further ahead on the next descent
+    ra.window = std::min(ra.window * 2, m_bt_cfg.m_max_readahead_nodes);
+    ra.leaf_ids.erase(ra.leaf_ids.begin(), std::next(it));
+}
+
 template < typename K, typename V >
 btree_status_t Btree< K, V >::do_traversal_query(const BtreeNodePtr& my_node, BtreeQueryRequest< K >& qreq,
                                                  std::vector< std::pair< K, V > >& out_values) const {
@@ -143,6 +202,111 @@ done:
     return ret;
 }
 
+/*
+ * Split the range into upto num_partitions partitions at the keys of interior nodes. It goes down level by level
+ * collecting the child boundaries within the range, until there are enough boundaries or it reaches the level above
+ * leaves, so only a few top levels are read. Only one node is locked at a time, its keys and child links are copied
+ * before it is unlocked. Partitions are picked evenly from the boundaries, which roughly balances the number of leaves
+ * in each. Btree could change after the split, partitions are only key ranges and each of them is queried from the
+ * root.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::split_query_range(BtreeKeyRange< K > const& range, uint32_t num_partitions,
+                                                std::vector< BtreeKeyRange< K > >& partitions, void* context) const {
+    btree_status_t ret{btree_status_t::success};
+    std::vector< K > boundaries;
+    std::vector< BtreeLinkInfo > level_links;
+    std::vector< BtreeLinkInfo > next_links;
+
+    m_btree_lock.lock_shared();
+    level_links.push_back(m_root_node_info);
+    m_btree_lock.unlock_shared();
+
+    // A child could be freed by a merge or a dropped subtree once its parent is unlocked. Store which reuses the memory
+    // of freed nodes defers it till this read is done, and such a child is skipped, as boundaries are only a hint.
+    auto const epoch = enter_unlocked_read();
+    while (!level_links.empty() && ((boundaries.size() + 1) < num_partitions)) {
+        for (auto const& link : level_links) {
+            BtreeNodePtr node;
+            ret = read_and_lock_node(link.bnode_id(), node, locktype_t::READ, locktype_t::READ, context);
+            if (ret != btree_status_t::success) { goto done; }
+
+            uint32_t start_idx;
+            uint32_t end_idx;
+            if (node->is_node_deleted() || (node->link_version() != link.link_version()) || node->is_leaf() ||
+                !node->match_range< K >(range, start_idx, end_idx)) {
+                unlock_node(node, locktype_t::READ);
+                continue;
+            }
+
+            for (auto idx = start_idx; idx <= end_idx; ++idx) {
+                if (idx < end_idx) {
+                    K key = node->get_nth_key< K >(idx, true /* copy */);
+                    if ((key.compare(range.start_key()) > 0) && (key.compare(range.end_key()) < 0)) {
+                        boundaries.push_back(std::move(key));
+                    }
+                }
+                if (node->level() > 1) {
+                    BtreeLinkInfo child_info;
+                    if (idx == node->total_entries()) {
+                        child_info = node->get_edge_value();
+                    } else {
+                        node->get_nth_value(idx, &child_info, false /* copy */);
+                    }
+                    next_links.push_back(child_info);
+                }
+            }
+            unlock_node(node, locktype_t::READ);
+        }
+        level_links = std::move(next_links);
+        next_links.clear();
+    }
+
+done:
+    exit_unlocked_read(epoch);
+    if (ret != btree_status_t::success) { return ret; }
+
+    std::sort(boundaries.begin(), boundaries.end(), [](K const& a, K const& b) { return a.compare(b) < 0; });
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                                 [](K const& a, K const& b) { return a.compare(b) == 0; }),
+                     boundaries.end());
+
+    auto const nparts = std::min(num_partitions, uint32_cast(boundaries.size() + 1));
+    K start_key = range.start_key();
+    bool start_incl = range.is_start_inclusive();
+    for (uint32_t p{1}; p < nparts; ++p) {
+        auto const& boundary = boundaries[((p * (boundaries.size() + 1)) / nparts) - 1];
+        partitions.emplace_back(start_key, start_incl, boundary, true /* end_incl */);
+        start_key = boundary;
+        start_incl = false;
+    }
+    partitions.emplace_back(start_key, start_incl, range.end_key(), range.is_end_inclusive());
+    return ret;
+}
+
+template < typename K, typename V >
+btree_status_t Btree< K, V >::query_partition(BtreeParallelQueryRequest< K >& qreq, uint32_t partition,
+                                              BtreeKeyRange< K > const& range,
+                                              std::vector< std::pair< K, V > >& out_values) const {
+    BtreeQueryRequest< K > preq{BtreeKeyRange< K >{range}, BtreeQueryType::SWEEP_NON_INTRUSIVE_PAGINATION_QUERY,
+                                qreq.m_batch_size, qreq.m_filter_cb, qreq.m_app_context};
+    preq.m_op_context = qreq.m_op_context;
+
+    btree_status_t ret;
+    do {
+        if (qreq.m_stream_cb) {
+            std::vector< std::pair< K, V > > batch;
+            ret = query(preq, batch);
+            for (auto const& [k, v] : batch) {
+                qreq.m_stream_cb(partition, k, v);
+            }
+        } else {
+            ret = query(preq, out_values);
+        }
+    } while (ret == btree_status_t::has_more);
+    return ret;
+}
+
 #ifdef SERIALIZABLE_QUERY_IMPLEMENTATION
 btree_status_t do_serialzable_query(const BtreeNodePtr& my_node, BtreeSerializableQueryRequest& qreq,
                                     std::vector< std::pair< K, V > >& out_values) {
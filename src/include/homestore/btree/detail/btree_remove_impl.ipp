@@ -208,8 +208,9 @@ btree_status_t Btree< K, V >::check_collapse_root(ReqT& req) {
 
     if (req.route_tracing) { append_route_trace(req, root, btree_event_t::MERGE); }
 
-    free_node(root, locktype_t::WRITE, req.m_op_context);
+    // Update root info before freeing (unlocking) the old root, so that optimistic readers see the change in root
     m_root_node_info = child->link_info();
+    free_node(root, locktype_t::WRITE, req.m_op_context);
     unlock_node(child, locktype_t::WRITE);
     COUNTER_DECREMENT(m_metrics, btree_depth, 1);
 
@@ -494,4 +495,239 @@ out:
     }
     return ret;
 }
+
+/*
+ * Detach the subtrees whose entire key space is within the range of the request, without reading any of them. Nodes
+ * which the range covers only partially form two paths from the root, one leading to the leaf containing the start of
+ * the range and other to the leaf containing the end of the range. Each node on these paths drops its children which
+ * fall in between the paths and the node left of the gap is linked to the node right of the gap on every level. Keys
+ * on the two boundary leaves are left for the regular range remove to cleanup.
+ *
+ * All nodes on the paths are locked before any of them is modified, so that failure to lock any node leaves the btree
+ * untouched. It is done under exclusive btree lock, which ensures that no one else is within the dropped subtrees
+ * once it is released and hence they could be freed at any time later. Each modified node is transacted along with its
+ * parent on the path and the roots of the dropped subtrees are handed to the store to persist along with them, so that
+ * they are freed even across restarts.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::drop_covered_subtrees(BtreeRangeRemoveRequest< K >& rrreq) {
+    struct path_node {
+        BtreeNodePtr node;
+        size_t parent_idx;  // Position of the parent of the node in the path, root is at 0
+        bool lower_covered; // Range covers the key space of the node upto its first key
+        bool upper_covered; // Range covers the key space of the node beyond its last key
+        bool modified{false};
+    };
+
+    struct drop_info {
+        size_t path_idx;
+        uint32_t start_idx;
+        uint32_t end_idx;
+    };
+
+    btree_status_t ret{btree_status_t::success};
+    std::vector< path_node > path; // Nodes on both the paths, top down
+    std::vector< drop_info > drops;
+    std::vector< std::pair< size_t, size_t > > relinks;
+    size_t num_dropped{0};
+    size_t level_start{0};
+
+    m_btree_lock.lock();
+    BtreeNodePtr root;
+    ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::WRITE, locktype_t::WRITE,
+                             rrreq.m_op_context);
+    if (ret != btree_status_t::success) { goto out; }
+    path.push_back(path_node{root, 0, false, false});
+
+    while ((level_start < path.size()) && !path[level_start].node->is_leaf()) {
+        auto const level_end = path.size();
+        for (auto i = level_start; i < level_end; ++i) {
+            auto const pn = path[i];
+            BT_NODE_DBG_ASSERT(!(pn.lower_covered && pn.upper_covered), pn.node,
+                               "Fully covered node should have been dropped by its parent");
+
+            uint32_t start_idx;
+            uint32_t end_idx;
+            if (!pn.node->match_range< K >(rrreq.working_range(), start_idx, end_idx)) { continue; }
+
+            // Children in between start and end are fully covered, while start and end children are fully covered
+            // only if the node itself is covered on that side
+            std::vector< path_node > children;
+            if (start_idx == end_idx) {
+                children.push_back(path_node{nullptr, i, pn.lower_covered, pn.upper_covered});
+            } else {
+                if (!pn.lower_covered) { children.push_back(path_node{nullptr, i, false, true}); }
+                if (!pn.upper_covered) { children.push_back(path_node{nullptr, i, true, false}); }
+
+                uint32_t const drop_start = pn.lower_covered ? start_idx : start_idx + 1;
+                uint32_t const drop_end = pn.upper_covered ? end_idx : end_idx - 1;
+                if (drop_start <= drop_end) { drops.push_back(drop_info{i, drop_start, drop_end}); }
+            }
+
+            for (auto& child : children) {
+                uint32_t const idx = child.lower_covered ? end_idx : start_idx;
+                BtreeLinkInfo child_info;
+                ret = get_child_and_lock_node(pn.node, idx, child_info, child.node, locktype_t::WRITE,
+                                              locktype_t::WRITE, rrreq.m_op_context);
+                if (ret != btree_status_t::success) { goto out; }
+                path.push_back(std::move(child));
+            }
+        }
+
+        // Nodes on the two paths are adjacent on this level, once the subtrees in between them are dropped
+        if (path.size() - level_end == 2) { relinks.emplace_back(level_end, level_end + 1); }
+        level_start = level_end;
+    }
+
+    if (drops.empty()) {
+        ret = btree_status_t::not_found;
+        goto out;
+    }
+
+    {
+        // Hand over the dropped subtrees to the store before modifying anything, so that nothing is to be undone if
+        // the store is unable to take them in this cp
+        std::unique_lock lg{m_dropped_nodes_mtx};
+        for (auto const& d : drops) {
+            auto const& node = path[d.path_idx].node;
+            BT_NODE_DBG_ASSERT(((d.start_idx != 0) || (d.end_idx != node->total_entries())), node,
+                               "Dropping all children of the node");
+            for (auto idx = d.start_idx; idx <= d.end_idx; ++idx) {
+                BtreeLinkInfo child_info;
+                if (idx == node->total_entries()) {
+                    child_info = node->get_edge_value();
+                } else {
+                    node->get_nth_value(idx, &child_info, false /* copy */);
+                }
+                m_dropped_nodes.push_back(child_info.bnode_id());
+                ++num_dropped;
+            }
+        }
+
+        ret = on_dropped_nodes_changed(root, rrreq.m_op_context);
+        if (ret != btree_status_t::success) {
+            m_dropped_nodes.resize(m_dropped_nodes.size() - num_dropped);
+            goto out;
+        }
+    }
+
+    for (auto const& [left_idx, right_idx] : relinks) {
+        auto& left = path[left_idx];
+        if (left.node->next_bnode() != path[right_idx].node->node_id()) {
+            left.node->set_next_bnode(path[right_idx].node->node_id());
+            left.modified = true;
+        }
+    }
+
+    for (auto const& d : drops) {
+        auto& pn = path[d.path_idx];
+        BT_NODE_LOG(DEBUG, pn.node, "Dropping subtrees of children [{}-{}] for range {}", d.start_idx, d.end_idx,
+                    rrreq.working_range().to_string());
+        pn.node->remove(d.start_idx, d.end_idx);
+        pn.modified = true;
+        if (rrreq.route_tracing) { append_route_trace(rrreq, pn.node, btree_event_t::REMOVE, d.start_idx, d.end_idx); }
+    }
+    rrreq.m_num_dropped_subtrees += num_dropped;
+    COUNTER_INCREMENT(m_metrics, btree_dropped_subtree_count, num_dropped);
+
+    // Bottom up, so that each node is persisted before its parent on the path and root before the dropped list
+    for (auto i = path.size() - 1; i > 0; --i) {
+        if (!path[i].modified) { continue; }
+        auto& parent = path[path[i].parent_idx];
+        transact_nodes({}, {}, path[i].node, parent.node, rrreq.m_op_context);
+        parent.modified = true;
+    }
+    write_node(root, rrreq.m_op_context);
+
+out:
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        unlock_node(it->node, locktype_t::WRITE);
+    }
+    m_btree_lock.unlock();
+
+    if (ret == btree_status_t::success) { on_subtrees_dropped(rrreq.m_op_context); }
+    return ret;
+}
+
+/*
+ * Dropped subtrees are unreachable from the root, so their nodes are freed in any order, one node at a time. Each node
+ * is read only to collect its children, which replace it in the dropped list. Leaf children of a level 1 node are freed
+ * by their id instead, without reading them. Updated list is handed to the store before the node is freed, so that the
+ * store persists it along with the frees. If a node is modified by a newer cp, or the store is unable to take the list
+ * in this cp, the node is not freed and cp_mismatch is returned for caller to retry with a newer cp.
+ *
+ * List is only accessed under m_dropped_nodes_mtx, which is not held while reading a node, so neither this nor the
+ * detach of more subtrees waits for the IO of the other.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::free_dropped_subtrees(uint32_t max_nodes, void* context) {
+    btree_status_t ret{btree_status_t::success};
+    std::vector< bnodeid_t > children;
+    uint32_t n_freed{0};
+
+    while (n_freed < max_nodes) {
+        bnodeid_t id;
+        {
+            std::unique_lock lg{m_dropped_nodes_mtx};
+            if (m_dropped_nodes.empty()) { break; }
+            id = m_dropped_nodes.back();
+            m_dropped_nodes.pop_back();
+        }
+
+        BtreeNodePtr node;
+        ret = read_and_lock_node(id, node, locktype_t::WRITE, locktype_t::WRITE, context);
+        if (ret != btree_status_t::success) {
+            if (ret == btree_status_t::cp_mismatch) {
+                std::unique_lock lg{m_dropped_nodes_mtx};
+                m_dropped_nodes.push_back(id);
+                break;
+            }
+            BT_LOG(ERROR, "Unable to read dropped node {}, its subtree is not freed, ret={}", id, ret);
+            ret = btree_status_t::success;
+            continue;
+        }
+
+        children.clear();
+        if (!node->is_leaf()) {
+            for (uint32_t idx{0}; idx < node->total_entries(); ++idx) {
+                BtreeLinkInfo child_info;
+                node->get_nth_value(idx, &child_info, false /* copy */);
+                children.push_back(child_info.bnode_id());
+            }
+            if (node->has_valid_edge()) { children.push_back(node->edge_id()); }
+        }
+        bool const leaf_children = (node->level() == 1);
+
+        {
+            std::unique_lock lg{m_dropped_nodes_mtx};
+            if (!leaf_children) { m_dropped_nodes.insert(m_dropped_nodes.end(), children.begin(), children.end()); }
+            ret = on_dropped_nodes_changed(nullptr, context);
+            if (ret != btree_status_t::success) {
+                // Put back the list as it was, node is retried with a newer cp
+                if (!leaf_children) { m_dropped_nodes.resize(m_dropped_nodes.size() - children.size()); }
+                m_dropped_nodes.push_back(id);
+            }
+        }
+        if (ret != btree_status_t::success) {
+            unlock_node(node, locktype_t::WRITE);
+            break;
+        }
+
+        // Readers could reach the leaves only through this node, which is write locked, so none of them is being read
+        if (leaf_children) {
+            for (auto const child_id : children) {
+                free_leaf_node(child_id, context);
+            }
+        }
+        if (node->is_leaf()) { COUNTER_DECREMENT(m_metrics, btree_obj_count, node->total_entries()); }
+        free_node(node, locktype_t::WRITE, context);
+        ++n_freed;
+    }
+
+    if (ret == btree_status_t::success) {
+        std::unique_lock lg{m_dropped_nodes_mtx};
+        if (!m_dropped_nodes.empty()) { ret = btree_status_t::has_more; }
+    }
+    return ret;
+}
 } // namespace homestore
@@ -0,0 +1,828 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <sisl/logging/logging.h>
+#include <homestore/btree/detail/variant_node.hpp>
+#include <homestore/btree/detail/node_key_search.hpp>
+#include <homestore/btree/btree_kv.hpp>
+#include "homestore/index/index_internal.hpp"
+
+SISL_LOGGING_DECL(btree)
+
+namespace homestore {
+#pragma pack(1)
+struct compact_node_header {
+    uint16_t m_data_end;  // Offset in node data area, past the last encoded entry
+    uint16_t m_nrestarts; // Number of restart points, which are stored at the tail end of the node
+
+    std::string to_string() const { return fmt::format("data_end={} nrestarts={}", m_data_end, m_nrestarts); }
+};
+
+struct compact_restart_point {
+    uint16_t m_offset;    // Offset of the first entry of the block in node data area
+    uint16_t m_first_idx; // Index of the first entry of the block
+};
+#pragma pack()
+
+template < typename K, bool = IntegralBtreeKey< K > >
+struct compact_key_int {
+    using type = uint64_t; // Unused for non integral keys
+};
+
+template < typename K >
+struct compact_key_int< K, true > {
+    using type = typename K::integral_key_t;
+};
+
+// Internal format of compact node:
+// [Persistent Header][compact node header][Entry][Entry].. ...  ... [Restart N-1]..[Restart 1][Restart 0]
+//
+// Entries are grouped in blocks of upto max_block_entries. First entry of a block (restart point) carries its full
+// key, rest of the entries in the block carry only the delta of the key against the previous key. For keys which are
+// native integers (IntegralBtreeKey) delta is the numerical difference, for all other keys it is the suffix after the
+// prefix shared with the previous key. Each entry is laid out as
+//      Integral keys: [varint key delta][varint value size][value]
+//      Other keys:    [varint shared size][varint suffix size][varint value size][key suffix][value]
+//
+// Search binary searches the restart points and then decodes the entries of that block linearly. Insert and update
+// re-encode only the entry and the one following it, a full block is split at the inserted entry. Other modifications
+// re-encode only the blocks they touch. Compact node is supported only as a leaf node.
+//
+template < typename K, typename V >
+class CompactNode : public VariantNode< K, V > {
+public:
+    using BtreeNode::get_nth_key_internal;
+    using BtreeNode::get_nth_key_size;
+    using BtreeNode::get_nth_obj_size;
+    using BtreeNode::get_nth_value;
+    using BtreeNode::get_nth_value_size;
+    using BtreeNode::to_string;
+    using VariantNode< K, V >::get_nth_value;
+    using node_find_result_t = std::pair< bool, uint32_t >;
+
+    static constexpr uint32_t max_block_entries{16};
+
+    CompactNode(uint8_t* node_buf, bnodeid_t id, bool init, bool is_leaf, const BtreeConfig& cfg) :
+            VariantNode< K, V >(node_buf, id, init, is_leaf, cfg) {
+        DEBUG_ASSERT(is_leaf, "Compact node is supported only as leaf node");
+        // Offsets within the node data area are stored in 16 bits
+        RELEASE_ASSERT_LE(cfg.node_size(), 64u * 1024, "Compact node supports node size upto 64K");
+        this->set_node_type(btree_node_type::COMPACT);
+        if (init) { reset_header(); }
+    }
+
+    virtual ~CompactNode() = default;
+
+    ///////////////////////////////////////// Modify APIs of the node /////////////////////////////////////////
+    btree_status_t insert(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+        LOGTRACEMOD(btree, "{}:{}", key.to_string(), val.to_string());
+        DEBUG_ASSERT_LE(ind, this->total_entries(), "Insert on compact node out-of-bound");
+        if (!splice_entry(ind, key.serialize(), val.serialize(), false /* replace */)) {
+            return btree_status_t::space_not_avail;
+        }
+#ifndef NDEBUG
+        validate_sanity();
+#endif
+        return btree_status_t::success;
+    }
+
+    btree_status_t update(uint32_t ind, const BtreeValue& val) override {
+        DEBUG_ASSERT_LT(ind, this->total_entries(), "Update on compact node out-of-bound");
+        auto const c = seek(ind);
+        sisl::blob const vblob = val.serialize();
+        if (vblob.size() == c.value_size) {
+            // Same size value, update in place
+            uint8_t* val_ptr = this->node_data_area() + c.value_offset;
+            if (val_ptr != vblob.cbytes()) { std::memcpy(val_ptr, vblob.cbytes(), vblob.size()); }
+            this->inc_gen();
+            return btree_status_t::success;
+        }
+
+        // Key is rebuilt in the cursor, which lives till the entry is re-encoded
+        return splice_entry(ind, cursor_key_blob(c), vblob, true /* replace */) ? btree_status_t::success
+                                                                                : btree_status_t::space_not_avail;
+    }
+
+    btree_status_t update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+        DEBUG_ASSERT_LT(ind, this->total_entries(), "Update on compact node out-of-bound");
+        sisl::blob const kblob = key.serialize();
+        if (key_bytes_equal(seek(ind), kblob)) { return update(ind, val); }
+        return splice_entry(ind, kblob, val.serialize(), true /* replace */) ? btree_status_t::success
+                                                                             : btree_status_t::space_not_avail;
+    }
+
+    // ind_s and ind_e are inclusive
+    void remove(uint32_t ind_s, uint32_t ind_e) override {
+        DEBUG_ASSERT_LE(ind_s, ind_e, "Invalid range to remove");
+        DEBUG_ASSERT_LT(ind_e, this->total_entries(), "Remove on compact node out-of-bound");
+
+        // Each block is re-encoded on its own, from the last one, so that the block boundaries are retained. Entry
+        // following a removed one is re-encoded against a key which shares atleast as much with it (or it carries the
+        // full key if it is the first of the block now), which is never more than what is removed. Hence it always
+        // fits, unlike re-encoding the blocks together, which could move the restart points.
+        auto const rs = block_of(ind_s);
+        for (auto block = block_of(ind_e) + 1; block-- > rs;) {
+            auto const first_idx = block_first_idx(block);
+            auto const end_idx = block_first_idx(block + 1);
+            auto const from = std::max(ind_s, first_idx);
+            auto const to = std::min(ind_e + 1, end_idx);
+
+            std::vector< kv_entry > entries;
+            if (from != first_idx) { decode_range(first_idx, from, entries); }
+            if (to != end_idx) { decode_range(to, end_idx, entries); }
+            [[maybe_unused]] bool const done = replace_blocks(block, block + 1, entries);
+            DEBUG_ASSERT(done, "Re-encoded block after remove is larger than the block, node={}", to_string());
+        }
+    }
+
+    void remove_all(const BtreeConfig&) override {
+        this->sub_entries(this->total_entries());
+        this->invalidate_edge();
+        this->inc_gen();
+        reset_header();
+    }
+
+    uint32_t move_out_to_right_by_entries(const BtreeConfig& cfg, BtreeNode& o, uint32_t nentries) override {
+        auto& other = static_cast< CompactNode& >(o);
+        const auto this_gen = this->node_gen();
+        const auto other_gen = other.node_gen();
+
+        auto const this_nentries = this->total_entries();
+        nentries = std::min(nentries, this_nentries);
+        if (nentries == 0) { return 0; /* Nothing to move */ }
+
+        std::vector< kv_entry > entries;
+        decode_range(this_nentries - nentries, this_nentries, entries);
+
+        // Blocks are re-encoded on the other side, if they don't fit, leave the entries at the front here.
+        while (!entries.empty() && !other.insert_entries(0, entries)) {
+            entries.erase(entries.begin());
+        }
+
+        auto const nmoved = uint32_cast(entries.size());
+        if (nmoved) { remove(this_nentries - nmoved, this_nentries - 1); }
+
+        // Remove and insert would have set the gen multiple increments, just reset it to increment only by 1
+        this->set_gen(this_gen + 1);
+        other.set_gen(other_gen + 1);
+        return nmoved;
+    }
+
+    uint32_t move_out_to_right_by_size(const BtreeConfig& cfg, BtreeNode& o, uint32_t size_to_move) override {
+        auto const n = this->total_entries();
+        if (n == 0) { return 0; }
+
+        std::vector< uint32_t > sizes;
+        sizes.reserve(n);
+        for_each_entry(0, n, [&sizes](entry_cursor const& c) { sizes.push_back(c.next_offset - c.offset); });
+
+        // Move the entries from the tail whose encoded size fits, but leave atleast one entry here
+        uint32_t nmove{0};
+        uint32_t moved_size{0};
+        for (auto ind = n - 1; ind > 0; --ind) {
+            if ((moved_size + sizes[ind]) > size_to_move) { break; }
+            moved_size += sizes[ind];
+            ++nmove;
+        }
+        return move_out_to_right_by_entries(cfg, o, nmove);
+    }
+
+    uint32_t num_entries_by_size(uint32_t start_idx, uint32_t size) const override {
+        // Entries are counted with their full key encoded, since they could become a restart point in the node they
+        // are copied into. This makes sure whatever is counted here, fits in that size when copied
+        uint32_t count{0};
+        uint32_t cum_size{0};
+        for_each_entry(start_idx, this->total_entries(), [&](entry_cursor const& c) {
+            cum_size += full_entry_size(c);
+            if ((cum_size + restarts_size_for(count + 1)) <= size) { ++count; }
+        });
+        return count;
+    }
+
+    uint32_t copy_by_size(const BtreeConfig& cfg, const BtreeNode& o, uint32_t start_idx, uint32_t copy_size) override {
+        auto& other = static_cast< const CompactNode& >(o);
+        return copy_by_entries(cfg, o, start_idx, other.num_entries_by_size(start_idx, copy_size));
+    }
+
+    uint32_t copy_by_entries(const BtreeConfig& cfg, const BtreeNode& o, uint32_t start_idx,
+                             uint32_t nentries) override {
+        auto& other = static_cast< const CompactNode& >(o);
+        auto const this_gen = this->node_gen();
+
+        nentries = std::min(nentries, other.total_entries() - start_idx);
+        std::vector< kv_entry > entries;
+        other.decode_range(start_idx, start_idx + nentries, entries);
+        while (!entries.empty() && !insert_entries(this->total_entries(), entries)) {
+            entries.pop_back();
+        }
+        this->set_gen(this_gen + 1);
+        return uint32_cast(entries.size());
+    }
+
+    ///////////////////////////////////////// Get/Size APIs of the node /////////////////////////////////////////
+    uint32_t multi_get(BtreeKeyRange< K > const& range, uint32_t max_count, uint32_t& start_idx, uint32_t& end_idx,
+                       std::vector< std::pair< K, V > >* out_values = nullptr,
+                       get_filter_cb_t const& filter_cb = nullptr) const override {
+        if (!this->match_range(range, start_idx, end_idx)) { return 0; }
+
+        uint32_t count = std::min(end_idx - start_idx + 1, max_count);
+        if (out_values || filter_cb) {
+            // Decode the entries in one pass, instead of decoding the block upto each entry
+            uint32_t const upto_idx = start_idx + count;
+            for_each_entry(start_idx, upto_idx, [&](entry_cursor const& c) {
+                K key = cursor_key(c);
+                V val;
+                get_cursor_value(c, &val, (out_values != nullptr) /* copy */);
+                if (!filter_cb || filter_cb(key, val)) {
+                    if (out_values) { out_values->emplace_back(std::move(key), std::move(val)); }
+                } else {
+                    --count;
+                }
+            });
+        }
+        return count;
+    }
+
+    uint32_t available_size() const override {
+        return this->node_data_size() - get_compact_header_const()->m_data_end - restarts_size_for_nblocks(nrestarts());
+    }
+
+    uint32_t occupied_size() const override {
+        return (this->node_data_size() - sizeof(compact_node_header) - available_size());
+    }
+
+    bool has_room_for_put(btree_put_type put_type, uint32_t key_size, uint32_t value_size) const override {
+        // Worst case of a put is the new entry with full key starting a new block with one more restart point. For
+        // integral keys, the next entry's delta against the new key is never larger than what it had. Other keys are
+        // not necessarily ordered by their bytes, so the next entry could loose all its shared prefix.
+        uint32_t const max_key_size = max_encoded_key_size(key_size);
+        uint32_t needed_size = max_key_size + value_size + 3 * max_varint_size + sizeof(compact_restart_point);
+        if constexpr (!IntegralBtreeKey< K >) { needed_size += max_key_size + max_varint_size; }
+        return (available_size() >= needed_size);
+    }
+
+    void get_nth_key_internal(uint32_t ind, BtreeKey& out_key, bool) const override {
+        DEBUG_ASSERT_LT(ind, this->total_entries(), "get_nth_key out-of-bound");
+        // Keys are rebuilt from its delta, so they are always copied out, irrespective of what is asked for
+        auto const c = seek(ind);
+        sisl::blob const b = cursor_key_blob(c);
+        out_key.deserialize(b, true);
+    }
+
+    uint32_t get_nth_key_size(uint32_t ind) const override {
+        if constexpr (IntegralBtreeKey< K >) {
+            return sizeof(key_int_t);
+        } else {
+            return uint32_cast(seek(ind).key.size());
+        }
+    }
+
+    void get_nth_value(uint32_t ind, BtreeValue* out_val, bool copy) const override {
+        DEBUG_ASSERT_LT(ind, this->total_entries(), "get_nth_value out-of-bound");
+        get_cursor_value(seek(ind), out_val, copy);
+    }
+
+    uint32_t get_nth_value_size(uint32_t ind) const override { return seek(ind).value_size; }
+
+    std::string to_string(bool print_friendly = false) const override {
+        auto str = fmt::format(
+            "{}id={} level={} nEntries={} {} free_space={} {}{} ",
+            (print_friendly ? "---------------------------------------------------------------------\n" : ""),
+            this->node_id(), this->level(), this->total_entries(), (this->is_leaf() ? "LEAF" : "INTERIOR"),
+            available_size(), get_compact_header_const()->to_string(),
+            (this->next_bnode() == empty_bnodeid) ? "" : fmt::format(" next_node={}", this->next_bnode()));
+        uint32_t i{0};
+        for_each_entry(0, this->total_entries(), [&](entry_cursor const& c) {
+            V val;
+            get_cursor_value(c, &val, false);
+            fmt::format_to(std::back_inserter(str), "{}Entry{} [Key={} Val={}]", (print_friendly ? "\n\t" : " "), ++i,
+                           cursor_key(c).to_string(), val.to_string());
+        });
+        return str;
+    }
+
+    std::string to_string_keys(bool print_friendly = false) const override {
+        auto str = fmt::format("{}{}.{} nEntries={} {} ",
+                               print_friendly ? "------------------------------------------------------------\n" : "",
+                               this->node_id(), this->link_version(), this->total_entries(),
+                               (this->is_leaf() ? "LEAF" : "INTERIOR"));
+        for_each_entry(0, this->total_entries(), [&](entry_cursor const& c) {
+            fmt::format_to(std::back_inserter(str), "{}{}", (print_friendly ? "\n\t" : " "), cursor_key(c).to_string());
+        });
+        return str;
+    }
+
+#ifndef NDEBUG
+    void validate_sanity() const {
+        std::optional< K > prev_key;
+        for_each_entry(0, this->total_entries(), [&](entry_cursor const& c) {
+            K key = cursor_key(c);
+            if (prev_key && (prev_key->compare(key) >= 0)) {
+                DEBUG_ASSERT(false, "Found non sorted entry at idx={} -> {}", c.idx, to_string());
+            }
+            prev_key = std::move(key);
+        });
+    }
+#endif
+
+protected:
+    node_find_result_t bsearch_node(const BtreeKey& key) const override {
+        DEBUG_ASSERT_EQ(this->magic(), BTREE_NODE_MAGIC);
+        auto const nblocks = nrestarts();
+        if (nblocks == 0) { return std::make_pair(false, 0u); }
+
+        search_key skey{key};
+
+        // Find the first block whose first key is greater than the search key, the key if present is in the block
+        // before that.
+        uint32_t lo{0};
+        uint32_t hi{nblocks};
+        entry_cursor c;
+        while (lo < hi) {
+            uint32_t const mid = lo + (hi - lo) / 2;
+            decode_restart(c, mid);
+            if (compare_cursor(c, skey) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0) { return std::make_pair(false, 0u); }
+
+        auto const block = lo - 1;
+        auto const end_idx = block_first_idx(block + 1);
+        decode_restart(c, block);
+        while (true) {
+            auto const x = compare_cursor(c, skey);
+            if (x >= 0) { return std::make_pair((x == 0), c.idx); }
+            if ((c.idx + 1) == end_idx) { return std::make_pair(false, end_idx); }
+            advance(c);
+        }
+    }
+
+private:
+    using key_int_t = typename compact_key_int< K >::type;
+    static constexpr uint32_t max_varint_size{3}; // All the sizes are within 64K node
+
+    // Owned copy of the full key and value of an entry, used while re-encoding the blocks
+    struct kv_entry {
+        std::vector< uint8_t > key;
+        std::vector< uint8_t > value;
+    };
+
+    // Position of an entry while decoding the entries sequentially
+    struct entry_cursor {
+        uint32_t idx{0};          // Index of the entry
+        uint32_t block{0};        // Restart point (block) the entry belongs to
+        uint32_t offset{0};       // Offset of the entry in node data area
+        uint32_t value_offset{0}; // Offset of the value in node data area
+        uint32_t value_size{0};
+        uint32_t next_offset{0};  // Offset of the next entry in node data area
+        key_int_t int_key{0};     // Full key for integral keys
+        std::vector< uint8_t > key; // Full key for other keys
+    };
+
+    struct search_key {
+        explicit search_key(BtreeKey const& k) : key{k} {
+            if constexpr (IntegralBtreeKey< K >) {
+                DEBUG_ASSERT_EQ(k.serialized_size(), sizeof(key_int_t), "Integral key size mismatch");
+                std::memcpy(&int_key, k.serialize().cbytes(), sizeof(key_int_t));
+            }
+        }
+
+        BtreeKey const& key;
+        key_int_t int_key{0};
+    };
+
+    ///////////// Encoding helpers //////////////////
+    static void put_varint(std::vector< uint8_t >& buf, uint64_t v) {
+        while (v >= 0x80) {
+            buf.push_back(s_cast< uint8_t >(v | 0x80));
+            v >>= 7;
+        }
+        buf.push_back(s_cast< uint8_t >(v));
+    }
+
+    static uint64_t get_varint(const uint8_t*& p) {
+        uint64_t v{0};
+        for (uint32_t shift{0};; shift += 7) {
+            uint8_t const b = *p++;
+            v |= static_cast< uint64_t >(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) { break; }
+        }
+        return v;
+    }
+
+    static uint32_t varint_size(uint64_t v) {
+        uint32_t sz{1};
+        while (v >= 0x80) {
+            v >>= 7;
+            ++sz;
+        }
+        return sz;
+    }
+
+    static uint32_t max_encoded_key_size(uint32_t key_size) {
+        if constexpr (IntegralBtreeKey< K >) {
+            return varint_size(std::numeric_limits< key_int_t >::max());
+        } else {
+            return key_size;
+        }
+    }
+
+    static key_int_t to_int_key(sisl::blob const& key) {
+        key_int_t k;
+        std::memcpy(&k, key.cbytes(), sizeof(key_int_t));
+        return k;
+    }
+
+    static sisl::blob to_blob(std::vector< uint8_t > const& v) {
+        return sisl::blob{const_cast< uint8_t* >(v.data()), uint32_cast(v.size())};
+    }
+
+    static void encode_entry(std::vector< uint8_t >& buf, sisl::blob const* prev_key, sisl::blob const& key,
+                             sisl::blob const& value) {
+        if constexpr (IntegralBtreeKey< K >) {
+            auto const k = to_int_key(key);
+            put_varint(buf, prev_key ? static_cast< uint64_t >(k - to_int_key(*prev_key)) : static_cast< uint64_t >(k));
+            put_varint(buf, value.size());
+        } else {
+            size_t shared{0};
+            if (prev_key) {
+                auto const max_shared = std::min(prev_key->size(), key.size());
+                while ((shared < max_shared) && (prev_key->cbytes()[shared] == key.cbytes()[shared])) {
+                    ++shared;
+                }
+            }
+            put_varint(buf, shared);
+            put_varint(buf, key.size() - shared);
+            put_varint(buf, value.size());
+            buf.insert(buf.end(), key.cbytes() + shared, key.cbytes() + key.size());
+        }
+        buf.insert(buf.end(), value.cbytes(), value.cbytes() + value.size());
+    }
+
+    static void encode_entry(std::vector< uint8_t >& buf, kv_entry const* prev, kv_entry const& e) {
+        sisl::blob const prev_key = prev ? to_blob(prev->key) : sisl::blob{};
+        encode_entry(buf, prev ? &prev_key : nullptr, to_blob(e.key), to_blob(e.value));
+    }
+
+    // Encode the entries as one or more blocks into the buffer, with restart points relative to the buffer and first
+    // entry. Entries are spread evenly across the blocks, so that a block which overflows splits into two halves.
+    static void encode_entries(std::vector< kv_entry > const& entries, std::vector< uint8_t >& buf,
+                               std::vector< compact_restart_point >& restarts) {
+        auto const n = uint32_cast(entries.size());
+        if (n == 0) { return; }
+
+        uint32_t const nblocks = (n - 1) / max_block_entries + 1;
+        uint32_t const block_entries = (n - 1) / nblocks + 1;
+        for (uint32_t i{0}; i < n; ++i) {
+            bool const is_restart = ((i % block_entries) == 0);
+            if (is_restart) {
+                restarts.push_back(compact_restart_point{s_cast< uint16_t >(buf.size()), s_cast< uint16_t >(i)});
+            }
+            encode_entry(buf, is_restart ? nullptr : &entries[i - 1], entries[i]);
+        }
+    }
+
+    static uint32_t restarts_size_for(uint32_t nentries) {
+        // Blocks are atleast half full, except for the last one
+        return restarts_size_for_nblocks(nentries / (max_block_entries / 2) + 1);
+    }
+
+    static uint32_t restarts_size_for_nblocks(uint32_t nblocks) { return nblocks * sizeof(compact_restart_point); }
+
+    ///////////// Decoding helpers //////////////////
+    void decode_entry(entry_cursor& c, uint32_t offset, bool is_restart) const {
+        const uint8_t* base = this->node_data_area_const();
+        const uint8_t* p = base + offset;
+        if constexpr (IntegralBtreeKey< K >) {
+            auto const delta = s_cast< key_int_t >(get_varint(p));
+            c.int_key = is_restart ? delta : s_cast< key_int_t >(c.int_key + delta);
+            c.value_size = uint32_cast(get_varint(p));
+        } else {
+            auto const shared = get_varint(p);
+            auto const suffix = get_varint(p);
+            c.value_size = uint32_cast(get_varint(p));
+            DEBUG_ASSERT(!is_restart || (shared == 0), "Restart point entry is expected to have full key");
+            c.key.resize(shared);
+            c.key.insert(c.key.end(), p, p + suffix);
+            p += suffix;
+        }
+        c.offset = offset;
+        c.value_offset = uint32_cast(p - base);
+        c.next_offset = c.value_offset + c.value_size;
+    }
+
+    void decode_restart(entry_cursor& c, uint32_t block) const {
+        auto const rp = nth_restart(block);
+        c.idx = rp.m_first_idx;
+        c.block = block;
+        decode_entry(c, rp.m_offset, true);
+    }
+
+    // Move the cursor to the next entry, caller needs to make sure there is a next entry
+    void advance(entry_cursor& c) const {
+        ++c.idx;
+        bool const is_restart = ((c.block + 1) < nrestarts()) && (nth_restart(c.block + 1).m_first_idx == c.idx);
+        if (is_restart) { ++c.block; }
+        decode_entry(c, c.next_offset, is_restart);
+    }
+
+    entry_cursor seek(uint32_t ind) const {
+        entry_cursor c;
+        decode_restart(c, block_of(ind));
+        while (c.idx < ind) {
+            advance(c);
+        }
+        return c;
+    }
+
+    template < typename CB >
+    void for_each_entry(uint32_t from_idx, uint32_t to_idx, CB&& cb) const {
+        if (from_idx >= to_idx) { return; }
+        auto c = seek(from_idx);
+        while (true) {
+            cb(c);
+            if ((c.idx + 1) == to_idx) { break; }
+            advance(c);
+        }
+    }
+
+    // Decode the entries [from_idx, to_idx) as owned copies
+    void decode_range(uint32_t from_idx, uint32_t to_idx, std::vector< kv_entry >& out) const {
+        out.reserve(out.size() + (to_idx - from_idx));
+        for_each_entry(from_idx, to_idx, [this, &out](entry_cursor const& c) { out.emplace_back(to_entry(c)); });
+    }
+
+    kv_entry to_entry(entry_cursor const& c) const {
+        sisl::blob const kb = cursor_key_blob(c);
+        const uint8_t* val_ptr = this->node_data_area_const() + c.value_offset;
+        return kv_entry{std::vector< uint8_t >(kb.cbytes(), kb.cbytes() + kb.size()),
+                        std::vector< uint8_t >(val_ptr, val_ptr + c.value_size)};
+    }
+
+    sisl::blob cursor_key_blob(entry_cursor const& c) const {
+        if constexpr (IntegralBtreeKey< K >) {
+            return sisl::blob{r_cast< uint8_t* >(const_cast< key_int_t* >(&c.int_key)), sizeof(key_int_t)};
+        } else {
+            return sisl::blob{const_cast< uint8_t* >(c.key.data()), uint32_cast(c.key.size())};
+        }
+    }
+
+    K cursor_key(entry_cursor const& c) const {
+        K key;
+        key.deserialize(cursor_key_blob(c), true);
+        return key;
+    }
+
+    void get_cursor_value(entry_cursor const& c, BtreeValue* out_val, bool copy) const {
+        sisl::blob const b{const_cast< uint8_t* >(this->node_data_area_const()) + c.value_offset, c.value_size};
+        out_val->deserialize(b, copy);
+    }
+
+    int compare_cursor(entry_cursor const& c, search_key const& skey) const {
+        if constexpr (IntegralBtreeKey< K >) {
+            return (c.int_key < skey.int_key) ? -1 : ((c.int_key > skey.int_key) ? 1 : 0);
+        } else {
+            K key;
+            key.deserialize(cursor_key_blob(c), false);
+            return key.compare(skey.key);
+        }
+    }
+
+    bool key_bytes_equal(entry_cursor const& c, sisl::blob const& kblob) const {
+        sisl::blob const cur = cursor_key_blob(c);
+        return (cur.size() == kblob.size()) && (std::memcmp(cur.cbytes(), kblob.cbytes(), kblob.size()) == 0);
+    }
+
+    uint32_t full_entry_size(entry_cursor const& c) const {
+        if constexpr (IntegralBtreeKey< K >) {
+            return varint_size(c.int_key) + varint_size(c.value_size) + c.value_size;
+        } else {
+            return varint_size(0) + varint_size(c.key.size()) + varint_size(c.value_size) + uint32_cast(c.key.size()) +
+                c.value_size;
+        }
+    }
+
+    ///////////// Block management //////////////////
+    // Index of the block the entry belongs to, entry index past the last entry belongs to the last block
+    uint32_t block_of(uint32_t ind) const {
+        uint32_t lo{0};
+        uint32_t hi{nrestarts()};
+        while (lo < hi) {
+            uint32_t const mid = lo + (hi - lo) / 2;
+            if (nth_restart(mid).m_first_idx <= ind) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return (lo == 0) ? 0 : lo - 1;
+    }
+
+    uint32_t block_first_idx(uint32_t block) const {
+        return (block < nrestarts()) ? nth_restart(block).m_first_idx : this->total_entries();
+    }
+
+    uint32_t block_offset(uint32_t block) const {
+        return (block < nrestarts()) ? nth_restart(block).m_offset : get_compact_header_const()->m_data_end;
+    }
+
+    // Insert the entries starting at index ind by re-encoding the block it falls in. Returns false if there is no room
+    // for them, in which case the node is left untouched.
+    bool insert_entries(uint32_t ind, std::vector< kv_entry > const& new_entries) {
+        DEBUG_ASSERT_LE(ind, this->total_entries(), "Insert on compact node out-of-bound");
+        if (nrestarts() == 0) { return replace_blocks(0, 0, new_entries); }
+
+        auto const block = block_of(ind);
+        auto const first_idx = block_first_idx(block);
+        std::vector< kv_entry > entries;
+        decode_range(first_idx, block_first_idx(block + 1), entries);
+        entries.insert(entries.begin() + (ind - first_idx), new_entries.begin(), new_entries.end());
+        return replace_blocks(block, block + 1, entries);
+    }
+
+    // Insert (or replace) the entry at index ind, re-encoding only that entry and the one following it in the block.
+    // If the block is full, it is split at ind with the new entry starting the new block. Returns false if there is no
+    // room for it, in which case the node is left untouched.
+    bool splice_entry(uint32_t ind, sisl::blob const& kblob, sisl::blob const& vblob, bool replace) {
+        auto const nr = nrestarts();
+        if (nr == 0) {
+            DEBUG_ASSERT(!replace, "Replace on an empty compact node");
+            return replace_blocks(0, 0, std::vector< kv_entry >{kv_entry{
+                                            std::vector< uint8_t >(kblob.cbytes(), kblob.cbytes() + kblob.size()),
+                                            std::vector< uint8_t >(vblob.cbytes(), vblob.cbytes() + vblob.size())}});
+        }
+
+        auto const block = block_of(ind);
+        auto const first_idx = block_first_idx(block);
+        auto const end_idx = block_first_idx(block + 1);
+        bool const new_block = !replace && ((end_idx - first_idx) >= max_block_entries);
+
+        // Encode the new entry, against the previous entry unless it starts a block
+        std::vector< uint8_t > buf;
+        entry_cursor c;
+        uint32_t start_off;
+        if (ind == first_idx) {
+            start_off = block_offset(block);
+            encode_entry(buf, nullptr, kblob, vblob);
+            decode_restart(c, block);
+        } else {
+            c = seek(ind - 1);
+            start_off = c.next_offset;
+            sisl::blob const prev_key = cursor_key_blob(c);
+            encode_entry(buf, new_block ? nullptr : &prev_key, kblob, vblob);
+            if (ind < end_idx) { advance(c); }
+        }
+        auto const new_entry_size = uint32_cast(buf.size());
+
+        // Cursor is now at the old entry at ind (if any), skip it on replace and re-encode the one following it in
+        // the block against the new key. It stays the restart point, if the new entry went into a block of its own.
+        uint32_t end_off{start_off};
+        uint32_t next_idx{ind};
+        if (replace) {
+            end_off = c.next_offset;
+            if (++next_idx < end_idx) { advance(c); }
+        }
+        if (next_idx < end_idx) {
+            bool const next_is_restart = new_block && (ind == first_idx);
+            sisl::blob const next_val{const_cast< uint8_t* >(this->node_data_area_const()) + c.value_offset,
+                                      c.value_size};
+            encode_entry(buf, next_is_restart ? nullptr : &kblob, cursor_key_blob(c), next_val);
+            end_off = c.next_offset;
+        }
+
+        int64_t const size_delta = int64_cast(buf.size()) - int64_cast(end_off - start_off);
+        int64_t const restart_size = new_block ? int64_cast(sizeof(compact_restart_point)) : 0;
+        if ((size_delta + restart_size) > int64_cast(available_size())) { return false; }
+
+        auto* hdr = get_compact_header();
+        uint8_t* base = this->node_data_area();
+        std::memmove(base + start_off + buf.size(), base + end_off, hdr->m_data_end - end_off);
+        std::memcpy(base + start_off, buf.data(), buf.size());
+        hdr->m_data_end = s_cast< uint16_t >(hdr->m_data_end + size_delta);
+
+        uint32_t const count_delta = replace ? 0 : 1;
+        for (uint32_t r{block + 1}; r < nr; ++r) {
+            auto* rp = nth_restart_mutable(r);
+            rp->m_offset = s_cast< uint16_t >(rp->m_offset + size_delta);
+            rp->m_first_idx = s_cast< uint16_t >(rp->m_first_idx + count_delta);
+        }
+        if (new_block) {
+            // New block goes right after the split block, or before it if the new entry is inserted at its start
+            auto const nb = (ind == first_idx) ? block : block + 1;
+            for (uint32_t r{nr}; r > nb; --r) {
+                *nth_restart_mutable(r) = nth_restart(r - 1);
+            }
+            *nth_restart_mutable(nb) = compact_restart_point{s_cast< uint16_t >(start_off), s_cast< uint16_t >(ind)};
+            if (nb == block) {
+                *nth_restart_mutable(block + 1) = compact_restart_point{
+                    s_cast< uint16_t >(start_off + new_entry_size), s_cast< uint16_t >(ind + 1)};
+            }
+            hdr->m_nrestarts = s_cast< uint16_t >(nr + 1);
+        }
+
+        this->set_total_entries(this->total_entries() + count_delta);
+        this->inc_gen();
+        return true;
+    }
+
+    // Replace the blocks [rs, re) with the entries encoded as new blocks. Returns false if there is no room for them,
+    // in which case the node is left untouched.
+    bool replace_blocks(uint32_t rs, uint32_t re, std::vector< kv_entry > const& entries) {
+        auto const nr = nrestarts();
+        auto const start_off = block_offset(rs);
+        auto const end_off = block_offset(re);
+        auto const first_idx = block_first_idx(rs);
+        auto const end_idx = block_first_idx(re);
+
+        std::vector< uint8_t > buf;
+        std::vector< compact_restart_point > new_restarts;
+        encode_entries(entries, buf, new_restarts);
+
+        int64_t const size_delta = int64_cast(buf.size()) - int64_cast(end_off - start_off);
+        int64_t const restart_delta = int64_cast(new_restarts.size()) - int64_cast(re - rs);
+        int64_t const count_delta = int64_cast(entries.size()) - int64_cast(end_idx - first_idx);
+        if ((size_delta + restart_delta * int64_cast(sizeof(compact_restart_point))) > int64_cast(available_size())) {
+            return false;
+        }
+
+        // Collect the restart points before moving the entries, since they could overlap the old restart area
+        std::vector< compact_restart_point > restarts;
+        restarts.reserve(nr + new_restarts.size());
+        for (uint32_t r{0}; r < rs; ++r) {
+            restarts.push_back(nth_restart(r));
+        }
+        for (auto const& rp : new_restarts) {
+            restarts.push_back(compact_restart_point{s_cast< uint16_t >(start_off + rp.m_offset),
+                                                     s_cast< uint16_t >(first_idx + rp.m_first_idx)});
+        }
+        for (uint32_t r{re}; r < nr; ++r) {
+            auto rp = nth_restart(r);
+            rp.m_offset = s_cast< uint16_t >(rp.m_offset + size_delta);
+            rp.m_first_idx = s_cast< uint16_t >(rp.m_first_idx + count_delta);
+            restarts.push_back(rp);
+        }
+
+        auto* hdr = get_compact_header();
+        uint8_t* base = this->node_data_area();
+        std::memmove(base + start_off + buf.size(), base + end_off, hdr->m_data_end - end_off);
+        if (!buf.empty()) { std::memcpy(base + start_off, buf.data(), buf.size()); }
+        hdr->m_data_end = s_cast< uint16_t >(hdr->m_data_end + size_delta);
+        hdr->m_nrestarts = s_cast< uint16_t >(restarts.size());
+        for (uint32_t r{0}; r < restarts.size(); ++r) {
+            *nth_restart_mutable(r) = restarts[r];
+        }
+
+        this->set_total_entries(uint32_cast(int64_cast(this->total_entries()) + count_delta));
+        this->inc_gen();
+        return true;
+    }
+
+    ///////////// Header and restart array //////////////////
+    void reset_header() {
+        auto* hdr = get_compact_header();
+        hdr->m_data_end = sizeof(compact_node_header);
+        hdr->m_nrestarts = 0;
+    }
+
+    uint32_t nrestarts() const { return get_compact_header_const()->m_nrestarts; }
+
+    compact_restart_point nth_restart(uint32_t r) const {
+        return *r_cast< const compact_restart_point* >(this->node_data_area_const() + this->node_data_size() -
+                                                        ((r + 1) * sizeof(compact_restart_point)));
+    }
+
+    compact_restart_point* nth_restart_mutable(uint32_t r) {
+        return r_cast< compact_restart_point* >(this->node_data_area() + this->node_data_size() -
+                                                ((r + 1) * sizeof(compact_restart_point)));
+    }
+
+    compact_node_header* get_compact_header() { return r_cast< compact_node_header* >(this->node_data_area()); }
+    const compact_node_header* get_compact_header_const() const {
+        return r_cast< const compact_node_header* >(this->node_data_area_const());
+    }
+};
+} // namespace homestore
@@ -0,0 +1,143 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
+#include <vector>
+#include <sys/mman.h>
+
+#include <sisl/fds/utils.hpp>
+#include <sisl/logging/logging.h>
+
+namespace homestore {
+
+/// @brief Pool of node buffers for in-memory btree.
+///
+/// Node buffers are carved out of large slabs (huge page sized and aligned by default), each buffer aligned to cache
+/// line. Freed buffers are reused for subsequent allocations, always from the lowest addressed slab which has a free
+/// buffer, so that as the tree shrinks the higher slabs drain out. Once more than max_spare_slabs slabs are completely
+/// free, they are returned to the system.
+class MemBtreeNodePool {
+public:
+    static constexpr uint32_t default_slab_size{2 * 1024 * 1024};
+    static constexpr uint32_t cache_line_size{64};
+
+    MemBtreeNodePool(uint32_t node_size, uint32_t slab_size = default_slab_size, uint32_t max_spare_slabs = 1) :
+            m_buf_stride{sisl::round_up(node_size, cache_line_size)}, m_max_spare_slabs{max_spare_slabs} {
+        m_bufs_per_slab = std::max(slab_size / m_buf_stride, 1u);
+        m_slab_alignment = (slab_size >= default_slab_size) ? default_slab_size : cache_line_size;
+        m_slab_size = sisl::round_up(m_bufs_per_slab * m_buf_stride, m_slab_alignment);
+    }
+
+    MemBtreeNodePool(const MemBtreeNodePool&) = delete;
+    MemBtreeNodePool& operator=(const MemBtreeNodePool&) = delete;
+
+    ~MemBtreeNodePool() {
+        for (auto& [base, s] : m_slabs) {
+            std::free(base);
+        }
+    }
+
+    uint8_t* alloc() {
+        std::unique_lock lg{m_mtx};
+        if (m_partial_slabs.empty()) { add_slab(); }
+
+        auto* base = *m_partial_slabs.begin();
+        auto& s = m_slabs.at(base);
+        if (s.free_slots.size() == m_bufs_per_slab) { --m_nempty_slabs; }
+
+        auto const slot = s.free_slots.back();
+        s.free_slots.pop_back();
+        if (s.free_slots.empty()) { m_partial_slabs.erase(base); }
+        return base + (uint64_t{slot} * m_buf_stride);
+    }
+
+    void free(uint8_t* buf) {
+        std::unique_lock lg{m_mtx};
+        auto it = m_slabs.upper_bound(buf);
+        RELEASE_ASSERT(it != m_slabs.begin(), "Freeing buffer {} which is not allocated from node pool",
+                       static_cast< void* >(buf));
+        --it;
+        auto* base = it->first;
+        auto& s = it->second;
+
+        auto const slot = uint32_cast((buf - base) / m_buf_stride);
+        DEBUG_ASSERT_LT(slot, m_bufs_per_slab, "Freeing buffer outside of the slab");
+        if (s.free_slots.empty()) { m_partial_slabs.insert(base); }
+        s.free_slots.push_back(slot);
+
+        if (s.free_slots.size() == m_bufs_per_slab) {
+            if (++m_nempty_slabs > m_max_spare_slabs) {
+                m_partial_slabs.erase(base);
+                m_slabs.erase(it);
+                std::free(base);
+                --m_nempty_slabs;
+            }
+        }
+    }
+
+    /// @brief Total memory held by the pool, including the free buffers in it
+    uint64_t allocated_size() const {
+        std::unique_lock lg{m_mtx};
+        return m_slabs.size() * m_slab_size;
+    }
+
+    uint64_t num_slabs() const {
+        std::unique_lock lg{m_mtx};
+        return m_slabs.size();
+    }
+
+private:
+    struct slab_info {
+        std::vector< uint32_t > free_slots;
+    };
+
+    void add_slab() {
+        auto* base = r_cast< uint8_t* >(std::aligned_alloc(m_slab_alignment, m_slab_size));
+        if (base == nullptr) { throw std::bad_alloc(); }
+#ifdef MADV_HUGEPAGE
+        if (m_slab_alignment == default_slab_size) { ::madvise(base, m_slab_size, MADV_HUGEPAGE); }
+#endif
+
+        slab_info s;
+        s.free_slots.reserve(m_bufs_per_slab);
+        // Slots are popped from the back, so keep the lower buffers at the back
+        for (uint32_t slot{m_bufs_per_slab}; slot > 0; --slot) {
+            s.free_slots.push_back(slot - 1);
+        }
+        m_slabs.emplace(base, std::move(s));
+        m_partial_slabs.insert(base);
+        ++m_nempty_slabs;
+    }
+
+private:
+    mutable std::mutex m_mtx;
+    uint32_t m_buf_stride;
+    uint32_t m_bufs_per_slab;
+    uint32_t m_slab_alignment;
+    uint32_t m_slab_size;
+    uint32_t m_max_spare_slabs;
+    uint32_t m_nempty_slabs{0};
+    std::map< uint8_t*, slab_info > m_slabs;   // All slabs ordered by its address
+    std::set< uint8_t* > m_partial_slabs;      // Slabs which have atleast one free buffer
+};
+} // namespace homestore
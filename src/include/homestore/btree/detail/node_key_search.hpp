@@ -0,0 +1,141 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace homestore {
+
+/// Keys which are serialized as a native unsigned integer and whose compare() is plain numeric comparison of that
+/// integer, can opt in for a specialized node search (without virtual compare per entry) by declaring
+///     using integral_key_t = <uint32_t or uint64_t>;
+template < typename K >
+concept IntegralBtreeKey = requires { typename K::integral_key_t; } &&
+    std::is_unsigned_v< typename K::integral_key_t > &&
+    ((sizeof(typename K::integral_key_t) == sizeof(uint32_t)) ||
+     (sizeof(typename K::integral_key_t) == sizeof(uint64_t)));
+
+namespace node_search {
+// Below this many entries, node is searched by comparing all the keys in the window (vectorized wherever possible)
+static constexpr uint32_t linear_search_window{16};
+
+template < typename T >
+inline T nth_key(const uint8_t* base, uint32_t stride, uint32_t ind) {
+    T k;
+    std::memcpy(&k, base + (uint64_t{stride} * ind), sizeof(T));
+    return k;
+}
+
+/// @brief Count the number of keys in [start, end) which are less than the key. Keys are laid out at every stride
+/// bytes from base and are expected to be sorted, so the count is the lower bound position within the window.
+template < typename T >
+inline uint32_t count_less_than(const uint8_t* base, uint32_t stride, uint32_t start, uint32_t end, T key) {
+    uint32_t count{0};
+    uint32_t i{start};
+
+    // There is no unsigned compare in SSE/AVX, so keys are compared as signed after flipping the sign bit.
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        auto const flip = _mm256_set1_epi64x(std::numeric_limits< int64_t >::min());
+        auto const vkey = _mm256_xor_si256(_mm256_set1_epi64x(static_cast< int64_t >(key)), flip);
+        auto const offsets = _mm_setr_epi32(0, int(stride), int(2 * stride), int(3 * stride));
+        for (; (i + 4) <= end; i += 4) {
+            auto const* p = reinterpret_cast< const long long* >(base + (uint64_t{stride} * i));
+            auto const keys = _mm256_xor_si256(_mm256_i32gather_epi64(p, offsets, 1), flip);
+            auto const lt = _mm256_cmpgt_epi64(vkey, keys);
+            count += std::popcount(uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(lt))));
+        }
+    } else {
+        auto const flip = _mm256_set1_epi32(std::numeric_limits< int32_t >::min());
+        auto const vkey = _mm256_xor_si256(_mm256_set1_epi32(static_cast< int32_t >(key)), flip);
+        auto const s = int(stride);
+        auto const offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+        for (; (i + 8) <= end; i += 8) {
+            auto const* p = reinterpret_cast< const int* >(base + (uint64_t{stride} * i));
+            auto const keys = _mm256_xor_si256(_mm256_i32gather_epi32(p, offsets, 1), flip);
+            auto const lt = _mm256_cmpgt_epi32(vkey, keys);
+            count += std::popcount(uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(lt))));
+        }
+    }
+#elif defined(__SSE4_2__)
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        auto const flip = _mm_set1_epi64x(std::numeric_limits< int64_t >::min());
+        auto const vkey = _mm_xor_si128(_mm_set1_epi64x(static_cast< int64_t >(key)), flip);
+        for (; (i + 2) <= end; i += 2) {
+            auto const keys = _mm_xor_si128(_mm_set_epi64x(static_cast< int64_t >(nth_key< T >(base, stride, i + 1)),
+                                                           static_cast< int64_t >(nth_key< T >(base, stride, i))),
+                                            flip);
+            auto const lt = _mm_cmpgt_epi64(vkey, keys);
+            count += std::popcount(uint32_t(_mm_movemask_pd(_mm_castsi128_pd(lt))));
+        }
+    } else {
+        auto const flip = _mm_set1_epi32(std::numeric_limits< int32_t >::min());
+        auto const vkey = _mm_xor_si128(_mm_set1_epi32(static_cast< int32_t >(key)), flip);
+        for (; (i + 4) <= end; i += 4) {
+            auto const keys = _mm_xor_si128(_mm_set_epi32(static_cast< int32_t >(nth_key< T >(base, stride, i + 3)),
+                                                          static_cast< int32_t >(nth_key< T >(base, stride, i + 2)),
+                                                          static_cast< int32_t >(nth_key< T >(base, stride, i + 1)),
+                                                          static_cast< int32_t >(nth_key< T >(base, stride, i))),
+                                            flip);
+            auto const lt = _mm_cmpgt_epi32(vkey, keys);
+            count += std::popcount(uint32_t(_mm_movemask_ps(_mm_castsi128_ps(lt))));
+        }
+    }
+#endif
+
+    // Scalar fallback and also the tail which is not a multiple of vector width
+    for (; i < end; ++i) {
+        count += (nth_key< T >(base, stride, i) < key) ? 1u : 0u;
+    }
+    return count;
+}
+
+/// @brief Search the key among nentries sorted integral keys laid out every stride bytes from base.
+///
+/// @return pair of <found, idx> where idx is the position of the key if found, otherwise the position where the key
+/// would be inserted. This is same as what BtreeNode::bsearch_node returns.
+template < typename T >
+inline std::pair< bool, uint32_t > integral_key_search(const uint8_t* base, uint32_t stride, uint32_t nentries,
+                                                       T key) {
+    uint32_t start{0};
+    uint32_t end{nentries};
+
+    // Narrow down the window with binary search, all keys before start are less than the key and all keys from end
+    // are greater or equal to the key.
+    while ((end - start) > linear_search_window) {
+        uint32_t const mid = start + (end - start) / 2;
+        if (nth_key< T >(base, stride, mid) < key) {
+            start = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+
+    uint32_t const idx = start + count_less_than< T >(base, stride, start, end, key);
+    bool const found = (idx < nentries) && (nth_key< T >(base, stride, idx) == key);
+    return std::make_pair(found, idx);
+}
+} // namespace node_search
+} // namespace homestore
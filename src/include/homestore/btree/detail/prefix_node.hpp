@@ -455,17 +455,17 @@ public:
         return btree_status_t::success;
     }
 
-    void update(uint32_t idx, BtreeValue const& val) override {
-        update(idx, BtreeNode::get_nth_key< K >(idx, false), val);
+    btree_status_t update(uint32_t idx, BtreeValue const& val) override {
+        return update(idx, BtreeNode::get_nth_key< K >(idx, false), val);
     }
 
-    void update(uint32_t idx, BtreeKey const& key, BtreeValue const& val) override {
+    btree_status_t update(uint32_t idx, BtreeKey const& key, BtreeValue const& val) override {
         // If we are updating the edge value, none of the other logic matter. Just update edge value and move on
         if (idx == this->total_entries()) {
             DEBUG_ASSERT_EQ(this->is_leaf(), false);
             this->set_edge_value(val);
             this->inc_gen();
-            return;
+            return btree_status_t::success;
         }
 
         if (!has_room(1u)) {
@@ -473,7 +473,7 @@ public:
                 compact();
             } else {
                 LOGMSG_ASSERT(false, "Even after compaction there is no room for update");
-                return;
+                return btree_status_t::space_not_avail;
             }
         }
         write_suffix(idx, add_prefix(key, val), key, val);
@@ -482,6 +482,7 @@ public:
 #ifndef NDEBUG
         validate_sanity();
 #endif
+        return btree_status_t::success;
     }
 
     void remove(uint32_t idx) override {
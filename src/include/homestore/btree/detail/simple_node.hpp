@@ -18,6 +18,7 @@
 #include <homestore/btree/btree_kv.hpp>
 #include <homestore/btree/detail/variant_node.hpp>
 #include <homestore/btree/detail/btree_internal.hpp>
+#include <homestore/btree/detail/node_key_search.hpp>
 #include "homestore/index/index_internal.hpp"
 
 using namespace std;
@@ -59,7 +60,7 @@ public:
         return btree_status_t::success;
     }
 
-    void update(uint32_t ind, const BtreeValue& val) override {
+    btree_status_t update(uint32_t ind, const BtreeValue& val) override {
         set_nth_value(ind, val);
 
         // TODO: Check if we need to upgrade the gen and impact of doing  so with performance. It is especially
@@ -68,9 +69,10 @@ public:
 #ifndef NDEBUG
         validate_sanity();
 #endif
+        return btree_status_t::success;
     }
 
-    void update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+    btree_status_t update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
         if (ind == this->total_entries()) {
             DEBUG_ASSERT_EQ(this->is_leaf(), false);
             this->set_edge_value(val);
@@ -78,6 +80,7 @@ public:
             set_nth_obj(ind, key, val);
         }
         this->inc_gen();
+        return btree_status_t::success;
     }
 
     // ind_s and ind_e are inclusive
@@ -316,6 +319,25 @@ public:
         return get_nth_key(ind, false).compare_range(range);
     }*/
 
+protected:
+    node_find_result_t bsearch_node(const BtreeKey& key) const override {
+        if constexpr (IntegralBtreeKey< K >) {
+            // Keys are fixed size integers at a fixed stride, so search them directly instead of deserializing and
+            // comparing each key through virtual calls.
+            using key_int_t = typename K::integral_key_t;
+            DEBUG_ASSERT_EQ(this->magic(), BTREE_NODE_MAGIC);
+            DEBUG_ASSERT_EQ(key.serialized_size(), sizeof(key_int_t), "Integral key size mismatch");
+
+            key_int_t search_key;
+            std::memcpy(&search_key, key.serialize().cbytes(), sizeof(key_int_t));
+            return node_search::integral_key_search< key_int_t >(this->node_data_area_const(), get_nth_obj_size(0),
+                                                                 this->total_entries(), search_key);
+        } else {
+            return BtreeNode::bsearch_node(key);
+        }
+    }
+
+public:
     /////////////// Other Internal Methods /////////////
     void set_nth_obj(uint32_t ind, const BtreeKey& k, const BtreeValue& v) {
         if (ind > this->total_entries()) {
@@ -223,9 +223,9 @@ public:
             ret = (insert(idx, key, val) == btree_status_t::success);
         } else if (put_type == btree_put_type::UPDATE) {
             if (!found) return false;
-            update(idx, key, val);
+            ret = (update(idx, key, val) == btree_status_t::success);
         } else if (put_type == btree_put_type::UPSERT) {
-            (found) ? update(idx, key, val) : (void)insert(idx, key, val);
+            ret = (((found) ? update(idx, key, val) : insert(idx, key, val)) == btree_status_t::success);
         } else {
             DEBUG_ASSERT(false, "Wrong put_type {}", put_type);
         }
@@ -271,16 +271,22 @@ public:
                 if (last_failed_key) { this->get_nth_key_internal(idx, *last_failed_key, true); }
                 return btree_status_t::has_more;
             }
+            auto status = btree_status_t::success;
             if (filter_cb) {
                 auto decision = filter_cb(get_nth_key< K >(idx, false), get_nth_value(idx, false), val);
                 if (decision == put_filter_decision::replace) {
-                    this->update(idx, val);
+                    status = this->update(idx, val);
                 } else if (decision == put_filter_decision::remove) {
                     this->remove(idx);
                     --idx;
                 }
             } else {
-                update(idx, val);
+                status = update(idx, val);
+            }
+            if (status != btree_status_t::success) {
+                // Node couldn't fit the update after all, let the caller split and continue from this key
+                if (last_failed_key) { this->get_nth_key_internal(idx, *last_failed_key, true); }
+                return btree_status_t::has_more;
             }
         }
         return btree_status_t::success;
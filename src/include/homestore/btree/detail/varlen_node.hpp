@@ -105,20 +105,20 @@ public:
 
     /* Update a value in a given index to the provided value. It will support change in size of the new value.
      * Assumption: Node lock is already taken, size check for the node to support new value is already done */
-    void update(uint32_t ind, const BtreeValue& val) override {
+    btree_status_t update(uint32_t ind, const BtreeValue& val) override {
         // If we are updating the edge value, none of the other logic matter. Just update edge value and move on
         if (ind == this->total_entries()) {
             DEBUG_ASSERT_EQ(this->is_leaf(), false);
             this->set_edge_value(val);
             this->inc_gen();
-        } else {
-            K key = BtreeNode::get_nth_key< K >(ind, true);
-            update(ind, key, val);
+            return btree_status_t::success;
         }
+        K key = BtreeNode::get_nth_key< K >(ind, true);
+        return update(ind, key, val);
     }
 
     // TODO - currently we do not support variable size key
-    void update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+    btree_status_t update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
         LOGTRACEMOD(btree, "Update called:{}", to_string());
         DEBUG_ASSERT_LE(ind, this->total_entries());
 
@@ -127,7 +127,7 @@ public:
             DEBUG_ASSERT_EQ(this->is_leaf(), false);
             this->set_edge_value(val);
             this->inc_gen();
-            return;
+            return btree_status_t::success;
         }
 
         // Determine if we are doing same size update or smaller size update, in that case, reuse the space.
@@ -154,9 +154,11 @@ public:
             this->inc_gen();
         } else {
             remove(ind, ind);
-            insert(ind, key, val);
+            auto const ret = insert(ind, key, val);
             LOGTRACEMOD(btree, "Size changed for either key or value. Had to delete and insert :{}", to_string());
+            return ret;
         }
+        return btree_status_t::success;
     }
 
     // ind_s and ind_e are inclusive
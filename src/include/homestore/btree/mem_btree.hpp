@@ -21,15 +21,32 @@
 #define StoreSpecificBtreeNode BtreeNode
 
 #include "btree.ipp"
+#include "detail/mem_node_pool.hpp"
 
 namespace homestore {
 template < typename K, typename V >
 class MemBtree : public Btree< K, V > {
 private:
-    std::vector< std::shared_ptr< uint8_t[] > > node_buf_ptr_vec;
+    // Freed nodes could still be referenced by the operations which were in-progress on them, their buffers are
+    // returned to the pool only after all such references are dropped. Optimistic readers could also be about to take
+    // a reference on a node they read the link of, so freed nodes are retired with the epoch they were freed in and
+    // optimistic readers register in the epoch they started in. Epoch is advanced only after all readers of the
+    // previous epoch are gone, hence a node retired in epoch e is unreachable to any reader once epoch is e + 2.
+    static constexpr uint32_t retired_nodes_reclaim_threshold{64};
+
+    struct retired_node {
+        BtreeNode* node;
+        uint64_t epoch;
+    };
+
+    MemBtreeNodePool m_node_pool;
+    std::mutex m_retired_mtx;
+    std::vector< retired_node > m_retired_nodes;
+    mutable std::atomic< uint64_t > m_epoch{0};
+    mutable std::array< std::atomic< uint64_t >, 2 > m_epoch_readers{};
 
 public:
-    MemBtree(const BtreeConfig& cfg) : Btree< K, V >(cfg) {
+    MemBtree(const BtreeConfig& cfg) : Btree< K, V >(cfg), m_node_pool{cfg.node_size()} {
         BT_LOG(INFO, "New {} being created: Node size {}", btree_store_type(), cfg.node_size());
         auto const status = this->create_root_node(nullptr);
         if (status != btree_status_t::success) { throw std::runtime_error(fmt::format("Unable to create root node")); }
@@ -38,16 +55,17 @@ public:
     virtual ~MemBtree() {
         const auto [ret, free_node_cnt] = this->destroy_btree(nullptr);
         BT_LOG_ASSERT_EQ(ret, btree_status_t::success, "btree destroy failed");
+        reclaim_retired_nodes(true /* force */);
     }
 
     std::string btree_store_type() const override { return "MEM_BTREE"; }
 
+    /// @brief Memory held by the btree for its node buffers, including the ones free in the pool to be reused
+    uint64_t node_memory_size() const { return m_node_pool.allocated_size(); }
+
 private:
     BtreeNodePtr alloc_node(bool is_leaf) override {
-        std::shared_ptr< uint8_t[] > ptr(new uint8_t[this->m_bt_cfg.node_size()]);
-        node_buf_ptr_vec.emplace_back(ptr);
-
-        auto new_node = this->init_node(ptr.get(), bnodeid_t{0}, true, is_leaf);
+        auto new_node = this->init_node(m_node_pool.alloc(), bnodeid_t{0}, true, is_leaf);
         new_node->set_node_id(bnodeid_t{r_cast< std::uintptr_t >(new_node)});
         new_node->m_refcount.increment();
         return BtreeNodePtr{new_node};
@@ -64,7 +82,56 @@ private:
         return btree_status_t::success;
     }
 
-    void free_node_impl(const BtreeNodePtr& node, void* context) override { intrusive_ptr_release(node.get()); }
+    void free_node_impl(const BtreeNodePtr& node, void* context) override {
+        bool reclaim{false};
+        {
+            std::unique_lock lg{m_retired_mtx};
+            m_retired_nodes.push_back(retired_node{node.get(), m_epoch.load()});
+            reclaim = (m_retired_nodes.size() >= retired_nodes_reclaim_threshold);
+        }
+        if (reclaim) { reclaim_retired_nodes(false /* force */); }
+    }
+
+    uint64_t enter_unlocked_read() const override {
+        while (true) {
+            auto const epoch = m_epoch.load();
+            m_epoch_readers[epoch & 1].fetch_add(1);
+            // Epoch moved on before we registered, the slot now belongs to an epoch which could be advanced past us
+            if (m_epoch.load() == epoch) { return epoch; }
+            m_epoch_readers[epoch & 1].fetch_sub(1);
+        }
+    }
+
+    void exit_unlocked_read(uint64_t epoch) const override { m_epoch_readers[epoch & 1].fetch_sub(1); }
+
+    // Release the retired nodes which no optimistic reader could reach anymore and no one else refers to (other than
+    // the reference taken at alloc_node) and return their buffers to the pool.
+    void reclaim_retired_nodes(bool force) {
+        std::vector< BtreeNode* > reclaimable;
+        {
+            std::unique_lock lg{m_retired_mtx};
+
+            // Only the reclaimer advances the epoch (under m_retired_mtx), once no reader of the previous epoch is
+            // left. Slot of the previous epoch is the one the next epoch will use.
+            auto epoch = m_epoch.load();
+            if (m_epoch_readers[(epoch + 1) & 1].load() == 0) { m_epoch.store(++epoch); }
+
+            auto it = std::partition(m_retired_nodes.begin(), m_retired_nodes.end(), [force, epoch](retired_node& r) {
+                if (force) { return false; }
+                return ((r.epoch + 2 > epoch) || !r.node->m_refcount.test_le(1));
+            });
+            for (auto rit = it; rit != m_retired_nodes.end(); ++rit) {
+                reclaimable.push_back(rit->node);
+            }
+            m_retired_nodes.erase(it, m_retired_nodes.end());
+        }
+
+        for (auto* n : reclaimable) {
+            auto* buf = n->m_phys_node_buf;
+            intrusive_ptr_release(n);
+            m_node_pool.free(buf);
+        }
+    }
 
     btree_status_t transact_nodes(const BtreeNodeList& new_nodes, const BtreeNodeList& freed_nodes,
                                   const BtreeNodePtr& left_child_node, const BtreeNodePtr& parent_node,
@@ -157,6 +157,8 @@ struct hs_format_params {
     vdev_size_type_t vdev_size_type{vdev_size_type_t::VDEV_SIZE_STATIC};
     blk_allocator_type_t alloc_type{blk_allocator_type_t::varsize};
     chunk_selector_type_t chunk_sel_type{chunk_selector_type_t::ROUND_ROBIN};
+    bool enable_discard{false}; // Discard the freed blks/chunks of this service's vdev on the device
+    bool mirrored{false};       // Mirror this service's vdev on all devices of dev_type. Supported for meta and log
 };
 
 struct hs_input_params {
@@ -15,7 +15,9 @@
  *********************************************************************************/
 #pragma once
 
+#include <cstring>
 #include <memory>
+#include <vector>
 #include <boost/intrusive_ptr.hpp>
 #include <sisl/utility/atomic_counter.hpp>
 #include <homestore/blk.h>
@@ -37,7 +39,7 @@ using bnodeid_t = uint64_t;
 typedef int64_t cp_id_t;
 
 static constexpr uint64_t indx_sb_magic{0xbedabb1e};
-static constexpr uint32_t indx_sb_version{0x2};
+static constexpr uint32_t indx_sb_version{0x3};
 
 #pragma pack(1)
 struct index_table_sb {
@@ -56,6 +58,32 @@ struct index_table_sb {
 
     uint32_t user_sb_size; // Size of the user superblk
     uint8_t user_sb_bytes[0];
+    // From version 0x3, user sb is followed by the nodes of subtrees detached by range remove yet to be freed, as their
+    // count (uint32_t) and ids. They are not aligned, so they are only copied in and out.
+
+    static uint32_t size(uint32_t user_sb_size, uint32_t num_dropped_nodes) {
+        return sizeof(index_table_sb) + user_sb_size + sizeof(uint32_t) + (num_dropped_nodes * sizeof(bnodeid_t));
+    }
+    uint32_t size() const { return size(user_sb_size, num_dropped_nodes()); }
+
+    uint32_t num_dropped_nodes() const {
+        uint32_t n;
+        std::memcpy(&n, &user_sb_bytes[user_sb_size], sizeof(n));
+        return n;
+    }
+
+    std::vector< bnodeid_t > dropped_nodes() const {
+        std::vector< bnodeid_t > ids(num_dropped_nodes());
+        std::memcpy(ids.data(), &user_sb_bytes[user_sb_size + sizeof(uint32_t)], ids.size() * sizeof(bnodeid_t));
+        return ids;
+    }
+
+    // Superblk is expected to be sized for the given nodes
+    void set_dropped_nodes(std::vector< bnodeid_t > const& ids) {
+        auto const n = uint32_cast(ids.size());
+        std::memcpy(&user_sb_bytes[user_sb_size], &n, sizeof(n));
+        std::memcpy(&user_sb_bytes[user_sb_size + sizeof(uint32_t)], ids.data(), n * sizeof(bnodeid_t));
+    }
 };
 #pragma pack()
 
@@ -73,6 +101,8 @@ public:
     virtual void destroy() = 0;
     virtual void repair_node(IndexBufferPtr const& buf) = 0;
     virtual void repair_root(IndexBufferPtr const& buf) = 0;
+    virtual void free_dropped_nodes() = 0;
+    virtual void resume_free_dropped_nodes() = 0;
 };
 
 enum class index_buf_state_t : uint8_t {
@@ -106,7 +136,7 @@ struct IndexBuffer : public sisl::ObjLifeCounter< IndexBuffer > {
     void set_crash_flag() { m_crash_flag_on = true; }
 #endif
 
-    uint32_t m_index_ordinal{0};  // Ordinal of the index table this buffer belongs to, used only during recovery
+    uint32_t m_index_ordinal{0};  // Ordinal of the index table this buffer belongs to
     uint8_t m_is_meta_buf{false}; // Is the index buffer writing to metablk?
     bool m_node_freed{false};
 
@@ -132,6 +162,7 @@ struct MetaIndexBuffer : public IndexBuffer {
     void copy_sb_to_buf();
 
     superblk< index_table_sb >& m_sb;
+    uint32_t m_size{0}; // Size of the superblk copied to this buffer
 };
 
 struct IndexBtreeNode : public BtreeNode {
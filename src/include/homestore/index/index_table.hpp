@@ -24,6 +24,7 @@
 #include <homestore/checkpoint/cp_mgr.hpp>
 #include <homestore/index/wb_cache_base.hpp>
 #include <homestore/btree/detail/btree_internal.hpp>
+#include <iomgr/iomgr.hpp>
 #include <iomgr/iomgr_flip.hpp>
 
 SISL_LOGGING_DECL(wbcache)
@@ -36,15 +37,19 @@ private:
     superblk< index_table_sb > m_sb;
     shared< MetaIndexBuffer > m_sb_buffer;
 
+    // Max number of dropped nodes freed within a cp
+    static constexpr uint32_t dropped_nodes_free_batch{1024};
+
 public:
     IndexTable(uuid_t uuid, uuid_t parent_uuid, uint32_t user_sb_size, const BtreeConfig& cfg) :
             Btree< K, V >{cfg}, m_sb{"index"} {
         // Create a superblk for the index table and create MetaIndexBuffer corresponding to that
-        m_sb.create(sizeof(index_table_sb));
+        m_sb.create(index_table_sb::size(user_sb_size, 0));
         m_sb->uuid = uuid;
         m_sb->ordinal = hs()->index_service().reserve_ordinal();
         m_sb->parent_uuid = parent_uuid;
         m_sb->user_sb_size = user_sb_size;
+        m_sb->set_dropped_nodes({});
         m_sb.write();
         m_sb_buffer = std::make_shared< MetaIndexBuffer >(m_sb);
 
@@ -55,8 +60,16 @@ public:
     }
 
     IndexTable(superblk< index_table_sb >&& sb, const BtreeConfig& cfg) : Btree< K, V >{cfg}, m_sb{std::move(sb)} {
+        BT_REL_ASSERT_LE(m_sb->version, indx_sb_version, "Index superblk of a newer version");
+        if (m_sb->version < indx_sb_version) {
+            // Version 0x2 has no dropped nodes after the user sb, upgraded one is written with the next change to it
+            m_sb.resize(index_table_sb::size(m_sb->user_sb_size, 0));
+            m_sb->set_dropped_nodes({});
+            m_sb->version = indx_sb_version;
+        }
         m_sb_buffer = std::make_shared< MetaIndexBuffer >(m_sb);
         this->set_root_node_info(BtreeLinkInfo{m_sb->root_node, m_sb->root_link_version});
+        this->m_dropped_nodes = m_sb->dropped_nodes();
     }
 
     void destroy() override {
@@ -67,6 +80,13 @@ public:
     uuid_t uuid() const override { return m_sb->uuid; }
     uint32_t ordinal() const override { return m_sb->ordinal; }
     uint64_t used_size() const override { return m_sb->index_size; }
+    uint32_t num_dropped_nodes() const { return m_sb->num_dropped_nodes(); }
+
+    // Limit the index node cache this table could use, see IndexWBCacheBase::set_cache_quota
+    void set_cache_quota(uint64_t quota, uint64_t reservation) {
+        wb_cache().set_cache_quota(ordinal(), quota, reservation);
+    }
+    index_cache_stats cache_stats() const { return wb_cache().cache_stats(ordinal()); }
     superblk< index_table_sb >& mutable_super_blk() { return m_sb; }
     const superblk< index_table_sb >& mutable_super_blk() const { return m_sb; }
     std::string btree_store_type() const override { return "INDEX_BTREE"; }
@@ -95,6 +115,19 @@ public:
         return ret;
     }
 
+    // Whole tree is built within a single CP, so that either all the nodes along with the new root are persisted or
+    // none of them.
+    template < typename InputIt >
+    btree_status_t bulk_load(InputIt begin, InputIt end) {
+        auto ret = btree_status_t::success;
+        do {
+            auto cpg = cp_mgr().cp_guard();
+            ret = Btree< K, V >::bulk_load(begin, end, (void*)cpg.context(cp_consumer_t::INDEX_SVC));
+            if (ret == btree_status_t::cp_mismatch) { LOGTRACEMOD(wbcache, "CP Mismatch, retrying bulk load"); }
+        } while (ret == btree_status_t::cp_mismatch);
+        return ret;
+    }
+
     void repair_node(IndexBufferPtr const& idx_buf) override {
         BtreeNode* n = this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(), true,
                                        BtreeNode::identify_leaf_node(idx_buf->raw_buffer()));
@@ -103,6 +136,20 @@ public:
         repair_links(BtreeNodePtr{n}, (void*)cpg.context(cp_consumer_t::INDEX_SVC));
     }
 
+    // Free the nodes of the subtrees detached by range remove in batches, each within its own cp
+    void free_dropped_nodes() override {
+        auto ret = btree_status_t::success;
+        do {
+            auto cpg = cp_mgr().cp_guard();
+            ret = this->free_dropped_subtrees(dropped_nodes_free_batch, (void*)cpg.context(cp_consumer_t::INDEX_SVC));
+            if (ret == btree_status_t::cp_mismatch) { LOGTRACEMOD(wbcache, "CP Mismatch, retrying free of nodes"); }
+        } while ((ret == btree_status_t::has_more) || (ret == btree_status_t::cp_mismatch));
+    }
+
+    void resume_free_dropped_nodes() override {
+        if (m_sb->num_dropped_nodes() != 0) { on_subtrees_dropped(nullptr); }
+    }
+
     void repair_root(IndexBufferPtr const& root_buf) override {
         BtreeNode* n = this->init_node(root_buf->raw_buffer(), root_buf->blkid().to_integer(), true,
                                        BtreeNode::identify_leaf_node(root_buf->raw_buffer()));
@@ -115,6 +162,7 @@ protected:
     ////////////////// Override Implementation of underlying store requirements //////////////////
     BtreeNodePtr alloc_node(bool is_leaf) override {
         return wb_cache().alloc_buf([this, is_leaf](const IndexBufferPtr& idx_buf) -> BtreeNodePtr {
+            idx_buf->m_index_ordinal = ordinal();
             BtreeNode* n = this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(), true, is_leaf);
             static_cast< IndexBtreeNode* >(n)->attach_buf(idx_buf);
             return BtreeNodePtr{n};
@@ -170,17 +218,28 @@ protected:
 
     btree_status_t read_node_impl(bnodeid_t id, BtreeNodePtr& node) const override {
         try {
-            wb_cache().read_buf(id, node, [this](const IndexBufferPtr& idx_buf) mutable -> BtreeNodePtr {
-                bool is_leaf = BtreeNode::identify_leaf_node(idx_buf->raw_buffer());
-                BtreeNode* n = this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(),
-                                               false /* init_buf */, is_leaf);
-                static_cast< IndexBtreeNode* >(n)->attach_buf(idx_buf);
-                return BtreeNodePtr{n};
-            });
+            wb_cache().read_buf(id, node, read_node_initializer());
             return btree_status_t::success;
         } catch (std::exception& e) { return btree_status_t::node_read_failed; }
     }
 
+    bool has_prefetch() const override { return true; }
+
+    void prefetch_nodes_impl(std::vector< bnodeid_t > const& ids) const override {
+        wb_cache().prefetch_bufs(ids, read_node_initializer());
+    }
+
+    node_initializer_t read_node_initializer() const {
+        return [this](const IndexBufferPtr& idx_buf) -> BtreeNodePtr {
+            idx_buf->m_index_ordinal = ordinal();
+            bool is_leaf = BtreeNode::identify_leaf_node(idx_buf->raw_buffer());
+            BtreeNode* n = this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(), false /* init_buf */,
+                                           is_leaf);
+            static_cast< IndexBtreeNode* >(n)->attach_buf(idx_buf);
+            return BtreeNodePtr{n};
+        };
+    }
+
     btree_status_t refresh_node(const BtreeNodePtr& node, bool for_read_modify_write, void* context) const override {
         if (context == nullptr || !for_read_modify_write) { return btree_status_t::success; }
         return wb_cache().get_writable_buf(node, r_cast< CPContext* >(context)) ? btree_status_t::success
@@ -192,6 +251,36 @@ protected:
         wb_cache().free_buf(n->m_idx_buf, r_cast< CPContext* >(context));
     }
 
+    void free_node_by_id_impl(bnodeid_t id, void* context) override {
+        wb_cache().free_buf(id, r_cast< CPContext* >(context));
+    }
+
+    void on_subtrees_dropped(void*) override {
+        // Table is looked up again, since it could be destroyed by the time the nodes are freed
+        iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [uuid = uuid()]() {
+            auto tbl = hs()->index_service().get_index_table(uuid);
+            if (tbl) { tbl->free_dropped_nodes(); }
+        });
+    }
+
+    // List is persisted in the superblk, which is written after the root, so after the rest of the nodes modified for
+    // the detach of the subtrees in this cp
+    btree_status_t on_dropped_nodes_changed(BtreeNodePtr const& root, void* context) override {
+        if (context == nullptr) { return btree_status_t::success; } // Btree is being destroyed along with superblk
+        auto cp_ctx = r_cast< CPContext* >(context);
+        if (m_sb_buffer->m_dirtied_cp_id > cp_ctx->id()) { return btree_status_t::cp_mismatch; }
+
+        m_sb.resize(index_table_sb::size(m_sb->user_sb_size, uint32_cast(this->m_dropped_nodes.size())));
+        m_sb->set_dropped_nodes(this->m_dropped_nodes);
+        wb_cache().refresh_meta_buf(m_sb_buffer, cp_ctx);
+
+        if (root) {
+            auto& root_buf = static_cast< IndexBtreeNode* >(root.get())->m_idx_buf;
+            wb_cache().transact_bufs(ordinal(), m_sb_buffer, root_buf, {}, {}, cp_ctx);
+        }
+        return btree_status_t::success;
+    }
+
     btree_status_t on_root_changed(BtreeNodePtr const& new_root, void* context) override {
         m_sb->root_node = new_root->node_id();
         m_sb->root_link_version = new_root->link_version();
@@ -30,6 +30,13 @@ using node_initializer_t = std::function< BtreeNodePtr(const IndexBufferPtr&) >;
 
 struct CPContext;
 
+struct index_cache_stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    uint64_t cached_size{0};
+};
+
 class IndexWBCacheBase {
 public:
     virtual ~IndexWBCacheBase() = default;
@@ -47,6 +54,12 @@ public:
 
     virtual void read_buf(bnodeid_t id, BtreeNodePtr& node, node_initializer_t&& node_initializer) = 0;
 
+    /// @brief Read the given nodes asynchronously as one batch and add them to the cache. Nodes which are already in
+    /// cache or being read are skipped. It does not wait for the reads to complete.
+    /// @param ids List of node ids to prefetch
+    /// @param node_initializer Callback to be called upon which buffer is turned into btree node
+    virtual void prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t const& node_initializer) = 0;
+
     virtual bool get_writable_buf(const BtreeNodePtr& node, CPContext* context) = 0;
 
     virtual bool refresh_meta_buf(shared< MetaIndexBuffer >& meta_buf, CPContext* cp_ctx) = 0;
@@ -60,6 +73,20 @@ public:
     /// @param context
     virtual void free_buf(const IndexBufferPtr& buf, CPContext* context) = 0;
 
+    /// @brief Free the buffer of the given node without reading it, removing it from wb cache if it is cached
+    /// @param id Node id of the buffer
+    /// @param context
+    virtual void free_buf(bnodeid_t id, CPContext* context) = 0;
+
+    /// @brief Limit the cache used by the nodes of the given index
+    /// @param index_ordinal Ordinal of the index table
+    /// @param quota Max size of the cache the index could use, beyond which it evicts only its own nodes. 0 for no limit
+    /// @param reservation Size of the cache upto which nodes of the index are not evicted for other indexes
+    virtual void set_cache_quota(uint32_t index_ordinal, uint64_t quota, uint64_t reservation) = 0;
+
+    /// @brief Get the cache usage and hit/miss counts of the given index
+    virtual index_cache_stats cache_stats(uint32_t index_ordinal) = 0;
+
     /// @brief Copy buffer
     /// @param cur_buf
     /// @return
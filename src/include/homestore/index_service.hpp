@@ -57,7 +57,7 @@ public:
     IndexService(std::unique_ptr< IndexServiceCallbacks > cbs);
 
     // Creates the vdev that is needed to initialize the device
-    void create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks);
+    void create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks, bool enable_discard = false);
 
     // Open the existing vdev which is represnted by the vdev_info_block
     shared< VirtualDev > open_vdev(const vdev_info& vb, bool load_existing);
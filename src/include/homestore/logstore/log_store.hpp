@@ -327,6 +327,15 @@ public:
      */
     void on_log_found(logstore_seq_num_t seq_num, const logdev_key& ld_key, const logdev_key& flush_ld_key,
                       log_buffer buf);
+
+    /**
+     * @brief Handles all the logs of this store found in one log group during recovery, in their seq_num order.
+     *
+     * Same as calling on_log_found for each of them, but the max seq_num is updated only once for the batch.
+     *
+     * @param recs The log records of this store found in the log group.
+     */
+    void on_logs_found(std::vector< log_found_record > const& recs);
     /**
      * @brief Handles the completion of a batch flush operation to update internal state.
      *
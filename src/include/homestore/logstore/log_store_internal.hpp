@@ -163,6 +163,13 @@ struct seq_ld_key_pair {
     logdev_key ld_key;
 };
 
+// A log record of a log store found during recovery
+struct log_found_record {
+    logstore_seq_num_t seq_num;
+    logdev_key ld_key;
+    log_buffer buf;
+};
+
 struct truncation_info {
     // Safe log dev location upto which it is truncatable
     logdev_key ld_key{std::numeric_limits< logid_t >::min(), 0};
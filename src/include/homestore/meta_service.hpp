@@ -26,6 +26,8 @@
 #include <vector>
 #include <optional>
 
+#include <folly/futures/Future.h>
+#include <iomgr/iomgr.hpp>
 #include <sisl/fds/buffer.hpp>
 #include <sisl/metrics/metrics.hpp>
 #include <nlohmann/json.hpp>
@@ -62,7 +64,16 @@ public:
         REGISTER_COUNTER(compress_backoff_memory_cnt, "compression back-off cnt because of exceending memory limit")
         REGISTER_COUNTER(compress_backoff_ratio_cnt, "compression back-off cnt because of exceeding ratio limit");
 
+        REGISTER_COUNTER(update_batch_cnt, "number of group committed sub sb update batches");
+        REGISTER_COUNTER(update_coalesced_cnt, "sub sb updates superseded by a later update of the same sb");
+        REGISTER_COUNTER(update_writer_handover_cnt, "times the writing of pending sub sb updates is handed over");
+        REGISTER_COUNTER(dir_prefetched_blks, "meta blks read through meta blk directory during scan");
+        REGISTER_COUNTER(dir_prefetch_miss_cnt, "meta blks read individually during scan, missing in directory");
+
         REGISTER_HISTOGRAM(compress_ratio_percent, "compression ration percentage");
+        REGISTER_HISTOGRAM(update_batch_size, "number of sub sbs written in one group commit",
+                           HistogramBucketsType(LinearUpto128Buckets));
+        REGISTER_HISTOGRAM(scan_latency, "time taken to scan and load meta blks at startup (in us)");
         register_me_to_farm();
     }
 
@@ -76,7 +87,24 @@ public:
 
 struct meta_vdev_context;
 
+// Blks read to load the meta blks at startup
+struct meta_scan_stats {
+    uint64_t dir_prefetched_blks{0}; // header and ovf data blks read through the meta blk directory
+    uint64_t dir_misses{0};          // blks read individually, as they were missing in the directory
+};
+
 class MetaBlkService {
+private:
+    // A sub sb update queued for group commit. Repeated updates of the same meta blk before it is written collapse
+    // into one, the latest data wins and all the waiters are notified once it is persisted.
+    struct meta_update_req {
+        const uint8_t* context_data{nullptr}; // either points to owned_data or to the caller's buffer
+        uint64_t sz{0};
+        std::vector< uint8_t > owned_data;
+        std::vector< std::function< void(bool) > > done_cbs;
+        std::function< void() > take_over_cb; // set if a synchronous updater waits on it, to hand the writing over
+    };
+
 private:
     static bool s_self_recover;
     std::shared_ptr< VirtualDev > m_sb_vdev; // super block vdev
@@ -93,6 +121,18 @@ private:
     std::unique_ptr< meta_vdev_context > m_meta_vdev_context;
     subtype_graph_t m_dep_topo_graph;
 
+    std::mutex m_pending_upd_mtx;                                       // protects the below 2 members
+    std::unordered_map< meta_blk*, meta_update_req > m_pending_updates; // sub sb updates yet to be written
+    bool m_upd_flush_in_progress{false}; // whether an updater is already writing pending updates
+    bool m_dir_dirty{true};              // meta blk directory on disk doesn't reflect all the meta blks
+    std::mutex m_upd_writer_mtx;                   // protects the start/stop of the below worker
+    iomgr::io_fiber_t m_upd_writer_fiber{nullptr}; // Worker which writes the updates queued by async updaters
+
+    mutable std::mutex m_prefetched_data_mtx; // protects the below member
+    // ovf data blks read through the meta blk directory at scan, consumed by recovery (blkid -> buf)
+    mutable std::unordered_map< uint64_t, uint8_t* > m_prefetched_ovf_data;
+    meta_scan_stats m_last_scan_stats;
+
 public:
     MetaBlkService(const char* name = "MetaBlkStore");
     MetaBlkService(const MetaBlkService&) = delete;
@@ -102,8 +142,8 @@ public:
 
     ~MetaBlkService() = default;
 
-    // Creates the vdev that is needed to initialize the device
-    void create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks);
+    // Creates the vdev that is needed to initialize the device. If mirrored, every device of devType holds a copy of it
+    void create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks, bool mirrored = false);
 
     // Open the existing vdev which is represented by the vdev_info
     shared< VirtualDev > open_vdev(const vdev_info& vinfo, bool load_existing);
@@ -166,6 +206,18 @@ public:
      */
     void update_sub_sb(const uint8_t* context_data, uint64_t sz, void* cookie);
 
+    /**
+     * @brief : update metablk in-place asynchronously. Concurrent updates, of any subtype, are group committed: the
+     * first updater writes all the updates queued until then under one meta lock acquisition, while the others return
+     * right away. Headers of adjacent meta blks are written in one io.
+     *
+     * @param context_data : subsytem sb; it is copied, so caller can release it once this call returns;
+     * @param sz : size of context_data
+     * @param cookie : handle to address the unique subsytem sb that is being updated;
+     * @return : future which is fulfilled once this update (or a later update of the same sb) is persisted;
+     */
+    folly::Future< bool > async_update_sub_sb(const uint8_t* context_data, uint64_t sz, void* cookie);
+
     // size_t read_sub_sb(const meta_sub_type type, sisl::byte_view& buf);
     void read_sub_sb(meta_sub_type type);
 
@@ -243,6 +295,13 @@ private:
      */
     void write_meta_blk_to_disk(meta_blk* mblk);
 
+    /**
+     * @brief : write headers of a set of meta blks, coalescing the headers of adjacent meta blks into single writes;
+     *
+     * @param mblks : meta blks whose headers are to be written, they are sorted by their location;
+     */
+    void write_meta_blk_hdrs_to_disk(std::vector< meta_blk* >& mblks);
+
     void write_ovf_blk_to_disk(meta_blk_ovf_hdr* ovf_hdr, const uint8_t* context_data, uint64_t sz, uint64_t offset,
                                const std::string& type);
 
@@ -265,6 +324,32 @@ private:
      */
     void write_ssb();
 
+    /**
+     * @brief : persist the meta blk directory (blkids of all the meta blks and ovf header blks) and point ssb to it;
+     * previous directory is freed only after ssb points to the new one;
+     */
+    void write_meta_blk_dir();
+
+    /**
+     * @brief : read all the blks listed in the meta blk directory, adjacent header blks are read in one io and the ios
+     * are spread across io fibers;
+     *
+     * @param ovf_data : filled with ovf data blkid to buffer map of the ovf data blks read;
+     * @return : blkid to blk buffer map of the header blks read; empty if there is no valid directory;
+     */
+    std::unordered_map< uint64_t, uint8_t* > prefetch_meta_blk_dir(std::unordered_map< uint64_t, uint8_t* >& ovf_data);
+
+    /**
+     * @brief : copy the ovf data blk prefetched at scan, if there is one, and release it;
+     *
+     * @return : true if it was prefetched and copied, false if caller has to read it from disk;
+     */
+    bool take_prefetched_ovf_data(BlkId const& bid, uint8_t* dest, size_t sz) const;
+
+    // prefetched copies of ovf data blks which are about to be overwritten are no longer valid
+    void drop_prefetched_ovf_data(BlkId const* bids, uint32_t nbids);
+    void free_prefetched_ovf_data();
+
     /**
      * @brief : Allocate meta BlkId
      *
@@ -274,6 +359,12 @@ private:
 
     void free_meta_blk(meta_blk* mblk);
 
+    /**
+     * @brief : remove the sub sb, with the waiters of its pending update (if any) returned in superseded_cbs;
+     */
+    std::error_condition remove_sub_sb_internal(void* cookie,
+                                                std::vector< std::function< void(bool) > >& superseded_cbs);
+
     /**
      * @brief : free the overflow blk chain
      *  1. free on-disk overflow blk header
@@ -310,7 +401,46 @@ private:
      * @param context_data
      * @param sz
      */
-    void write_meta_blk_internal(meta_blk* mblk, const uint8_t* context_data, uint64_t sz);
+    void write_meta_blk_internal(meta_blk* mblk, const uint8_t* context_data, uint64_t sz, bool write_hdr = true);
+
+    /**
+     * @brief : queue an update for group commit and write the pending updates if no one else is doing it;
+     *
+     * @param copy_data : if false, caller has to keep context_data valid until done_cb is called;
+     * @param done_cb : called once the update is persisted or superseded;
+     * @param take_over_cb : if set, called instead of done_cb when the writer hands the writing of the pending updates
+     * (including this one) over to the caller, which has to call flush_pending_updates. If not set, the caller is an
+     * async updater and never writes itself, the writing is posted to the update writer worker instead;
+     */
+    void queue_sub_sb_update(const uint8_t* context_data, uint64_t sz, void* cookie, bool copy_data,
+                             std::function< void(bool) > done_cb, std::function< void() > take_over_cb = nullptr);
+
+    /**
+     * @brief : write the queued sub sb updates, batch by batch, until there is nothing more pending or the writing is
+     * handed over to a synchronous updater of the pending updates;
+     */
+    void flush_pending_updates();
+
+    /**
+     * @brief : hand the writing of the pending updates over to one of their synchronous updaters, if there is any;
+     *
+     * @return : true if handed over, caller is no longer the writer;
+     */
+    bool hand_over_pending_updates();
+
+    /**
+     * @brief : get the worker fiber which writes the updates of async updaters, starting it on first use;
+     */
+    iomgr::io_fiber_t upd_writer_fiber();
+
+    void stop_upd_writer();
+
+    /**
+     * @brief : prepare the in-place update of a meta blk (overflow blks are written), except its header write;
+     *
+     * @return : ovf blkid that needs to be freed once the new meta blk header is persisted;
+     */
+    BlkId prepare_sub_sb_update(meta_blk* mblk, const uint8_t* context_data, uint64_t sz);
 
     /**
      * @brief : sync read;
@@ -339,6 +469,7 @@ private:
 
 public:
     bool get_skip_hdr_check() const;
+    meta_scan_stats last_scan_stats() const { return m_last_scan_stats; }
 
 private:
     /**
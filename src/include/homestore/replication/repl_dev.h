@@ -1,6 +1,7 @@
 #pragma once
 
 #include <variant>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
@@ -64,6 +65,22 @@ struct repl_snapshot {
     uint64_t last_log_term_{0};
 };
 
+/// @brief A portion of the snapshot, which is read from the listener on the leader, streamed to a lagging follower and
+/// handed over to the listener on that follower. The state is opaque to the repl_dev, whereas the data of the blks
+/// listed here are read on the leader and written to the locally allocated blks on the follower by the repl_dev.
+struct repl_snapshot_obj {
+    struct blk_entry {
+        sisl::io_blob_safe header; // User header of the blk, used to get the blk alloc hints on the follower
+        MultiBlkId blkid;          // Leader: blkid to read the data from, Follower: local blkid data is written to
+    };
+
+    uint64_t cursor{0};            // Listener defined position in the snapshot this obj starts from (0 = beginning)
+    uint64_t next_cursor{0};       // Position where the next obj starts from, expected to be greater than cursor
+    bool is_last{false};           // Is this the last obj of the snapshot
+    sisl::io_blob_safe state;      // Opaque listener state (say index entries) carried in this obj
+    std::vector< blk_entry > blks; // Data blks carried in this obj
+};
+
 struct repl_journal_entry;
 struct repl_req_ctx : public boost::intrusive_ref_counter< repl_req_ctx, boost::thread_safe_counter >,
                       sisl::ObjLifeCounter< repl_req_ctx > {
@@ -288,6 +305,39 @@ public:
     /// @brief Called when the snapshot is being created by nuraft;
     virtual AsyncReplResult<> create_snapshot(repl_snapshot& s) = 0;
 
+    /// @brief Called on the leader to read the next obj of the snapshot, which is to be sent to a lagging follower.
+    ///
+    /// Listener is expected to fill the state and the data blks (along with their user header) starting from
+    /// obj.cursor, keeping the total size of state and data within max_size wherever possible. It also sets the
+    /// next_cursor and is_last. The repl_dev reads the data of the blks and streams them along with the state.
+    /// Objs are read one at a time in cursor order, but the same obj could be read again if the transfer is retried.
+    ///
+    /// @param s Snapshot which is being transferred
+    /// @param obj [in/out] cursor is set by the caller, listener fills rest of the obj
+    /// @param max_size Approximate max size of the state and data carried by this obj
+    /// @return OK if the obj is read, any error will have the transfer retried later. Default implementation doesn't
+    /// support snapshot transfer.
+    virtual ReplServiceError read_snapshot_obj(repl_snapshot const& s, repl_snapshot_obj& obj, uint32_t max_size) {
+        return ReplServiceError::NOT_IMPLEMENTED;
+    }
+
+    /// @brief Called on the follower for every snapshot obj received from the leader, in cursor order.
+    ///
+    /// By the time this is called, data of every blk in the obj is written and committed to blks allocated locally
+    /// (using get_blk_alloc_hints on the blk header) and obj.blks[i].blkid is replaced with this local blkid. The
+    /// listener owns these blks from here on and is expected to free them, if it doesn't need them.
+    ///
+    /// @param s Snapshot which is being received
+    /// @param obj Snapshot obj with the state and the local blkids
+    /// @return OK if the obj is saved, any error will have the leader to resend this obj
+    virtual ReplServiceError write_snapshot_obj(repl_snapshot const& s, repl_snapshot_obj const& obj) {
+        return ReplServiceError::NOT_IMPLEMENTED;
+    }
+
+    /// @brief Called on the follower once all objs of the snapshot are received. Once this returns OK, the repl_dev
+    /// moves its commit lsn to the last log idx of the snapshot and resumes replication from there.
+    virtual ReplServiceError apply_snapshot(repl_snapshot const& s) { return ReplServiceError::NOT_IMPLEMENTED; }
+
 private:
     std::weak_ptr< ReplDev > m_repl_dev;
 };
@@ -115,6 +115,16 @@ public:
         }
     }
 
+    // Persist the superblk without waiting for it; updates are group committed with other sub sb updates. Only the
+    // very first write (which adds the sb) is done synchronously.
+    folly::Future< bool > async_write() {
+        if (m_meta_blk) {
+            return meta_service().async_update_sub_sb(m_raw_buf->cbytes(), m_raw_buf->size(), m_meta_blk);
+        }
+        meta_service().add_sub_sb(m_meta_sub_name, m_raw_buf->cbytes(), m_raw_buf->size(), m_meta_blk);
+        return folly::makeFuture< bool >(true);
+    }
+
     bool is_empty() const { return (m_sb == nullptr); }
     T* get() { return m_sb; }
     T* operator->() { return m_sb; }
@@ -0,0 +1,70 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <iomgr/iomgr.hpp>
+#include <iomgr/fiber_lib.hpp>
+
+namespace homestore {
+
+/// @brief Run work(i) for every i in [0, num_works) on the calling fiber, shared with upto (parallelism - 1) of the
+/// given fibers other than the caller's own, and return once all the works are done.
+///
+/// Helper fibers could get to run only after the caller is done with all the works, since they could be busy with
+/// something else (even waiting on this caller). Hence nobody waits for the helpers to be scheduled, the caller only
+/// waits for the works picked up by some helper to complete. A helper which runs late finds no work left and doesn't
+/// call work, so work could refer to the caller's stack.
+inline void run_shared_works(size_t num_works, uint32_t parallelism, std::vector< iomgr::io_fiber_t > const& fibers,
+                             std::function< void(size_t) > work) {
+    if (num_works == 0) { return; }
+
+    struct shared_works {
+        size_t num_works;
+        std::function< void(size_t) > work;
+        std::atomic< size_t > next_work{0};
+        std::atomic< size_t > pending_works{0};
+        iomgr::FiberManagerLib::Promise< void > done;
+    };
+    auto state = std::make_shared< shared_works >();
+    state->num_works = num_works;
+    state->work = std::move(work);
+    state->pending_works.store(num_works);
+    auto done_future = state->done.get_future();
+
+    auto const run_works = [](shared_works& st) {
+        for (auto w = st.next_work.fetch_add(1); w < st.num_works; w = st.next_work.fetch_add(1)) {
+            st.work(w);
+            if (st.pending_works.fetch_sub(1) == 1) { st.done.set_value(); }
+        }
+    };
+
+    auto const max_helpers = std::min< size_t >(std::max(parallelism, 1u), num_works) - 1;
+    size_t helpers{0};
+    for (auto const& fiber : fibers) {
+        if (helpers >= max_helpers) { break; }
+        if (iomanager.am_i_io_reactor() && (fiber == iomanager.iofiber_self())) { continue; }
+        iomanager.run_on_forget(fiber, [run_works, state]() { run_works(*state); });
+        ++helpers;
+    }
+    run_works(*state);
+    done_future.wait();
+}
+} // namespace homestore
@@ -76,6 +76,7 @@ public:
 
     BlkAllocStatus alloc_contiguous(BlkId& bid) override;
     BlkAllocStatus alloc(blk_count_t nblks, blk_alloc_hints const& hints, BlkId& out_blkid) override;
+    using BlkAllocator::free;
     void free(BlkId const& b) override;
     BlkAllocStatus reserve_on_disk(BlkId const& in_bid) override;
     BlkAllocStatus reserve_on_cache(BlkId const& b) override;
@@ -12,6 +12,10 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <homestore/homestore.hpp>
 #include <homestore/meta_service.hpp>
 #include <homestore/checkpoint/cp_mgr.hpp>
@@ -21,14 +25,22 @@
 
 namespace homestore {
 BitmapBlkAllocator::BitmapBlkAllocator(BlkAllocConfig const& cfg, bool is_fresh, chunk_num_t id) :
-        BlkAllocator(cfg, id), m_blks_per_portion{cfg.m_blks_per_portion} {
+        BlkAllocator(cfg, id), m_blks_per_portion{cfg.m_blks_per_portion}, m_delta_meta_name{get_name() + "_delta"} {
     if (is_persistent()) {
+        // Incremental bitmap records are recovered first, so that they can be applied on top of full bitmap as soon
+        // as full bitmap is found.
+        meta_service().register_handler(
+            m_delta_meta_name,
+            [this](meta_blk* mblk, sisl::byte_view buf, size_t size) {
+                on_delta_meta_blk_found(voidptr_cast(mblk), std::move(buf), size);
+            },
+            nullptr);
         meta_service().register_handler(
             get_name(),
             [this](meta_blk* mblk, sisl::byte_view buf, size_t size) {
                 on_meta_blk_found(voidptr_cast(mblk), std::move(buf), size);
             },
-            nullptr);
+            nullptr, true /* do_crc */, meta_subtype_vec_t{m_delta_meta_name});
     }
 
     if (is_fresh) {
@@ -47,26 +59,250 @@ BitmapBlkAllocator::BitmapBlkAllocator(BlkAllocConfig const& cfg, bool is_fresh,
 void BitmapBlkAllocator::on_meta_blk_found(void* mblk_cookie, sisl::byte_view const& buf, size_t size) {
     m_meta_blk_cookie = mblk_cookie;
 
-    m_disk_bm = std::unique_ptr< sisl::Bitset >{new sisl::Bitset{
-        hs_utils::extract_byte_array(buf, meta_service().is_aligned_buf_needed(size), meta_service().align_size())}};
+    sisl::byte_view bm_buf{buf};
+    auto const hdr = r_cast< bitmap_full_hdr const* >(buf.bytes());
+    if ((size >= sizeof(bitmap_full_hdr)) && (hdr->magic == bitmap_full_hdr::BITMAP_FULL_MAGIC)) {
+        m_full_gen = hdr->gen;
+        bm_buf.move_forward(sizeof(bitmap_full_hdr));
+        size -= sizeof(bitmap_full_hdr);
+    } else {
+        // Bitmap persisted prior to incremental bitmap support, treat it as generation 0
+        m_full_gen = 0;
+    }
+
+    m_disk_bm = std::unique_ptr< sisl::Bitset >{new sisl::Bitset{hs_utils::extract_byte_array(
+        bm_buf, meta_service().is_aligned_buf_needed(size), meta_service().align_size())}};
+    apply_delta_bitmaps();
 
     m_alloced_blk_count.store(m_disk_bm->get_set_count(), std::memory_order_relaxed);
     load();
 }
 
+void BitmapBlkAllocator::on_delta_meta_blk_found(void* mblk_cookie, sisl::byte_view const& buf, size_t size) {
+    // Irrespective of whether the delta is applicable or not, it needs to be removed on next full bitmap flush
+    m_delta_meta_cookies.push_back(mblk_cookie);
+
+    auto const hdr = r_cast< bitmap_delta_hdr const* >(buf.bytes());
+    if ((size < sizeof(bitmap_delta_hdr)) || (hdr->magic != bitmap_delta_hdr::BITMAP_DELTA_MAGIC)) {
+        BLKALLOC_LOG(ERROR, "Incremental bitmap record of size={} is corrupted, ignoring it", size);
+        return;
+    }
+    m_recovered_deltas.emplace_back(hs_utils::extract_byte_array(buf, false /* aligned */, 0));
+}
+
+void BitmapBlkAllocator::apply_delta_bitmaps() {
+    // Only the deltas generated on top of the persisted full bitmap are applicable. Deltas with older generation
+    // are the ones whose full bitmap was written, but crashed before those deltas were removed.
+    std::vector< bitmap_delta_hdr const* > deltas;
+    for (auto const& d : m_recovered_deltas) {
+        auto const hdr = r_cast< bitmap_delta_hdr const* >(d->cbytes());
+        if (hdr->base_gen == m_full_gen) { deltas.push_back(hdr); }
+    }
+    std::sort(deltas.begin(), deltas.end(),
+              [](bitmap_delta_hdr const* a, bitmap_delta_hdr const* b) { return a->seq_num < b->seq_num; });
+
+    for (auto const hdr : deltas) {
+        uint8_t const* page = r_cast< uint8_t const* >(hdr) + sizeof(bitmap_delta_hdr);
+        size_t const page_size = sizeof(blk_num_t) + (hdr->blks_per_portion / 64) * sizeof(uint64_t);
+        for (uint32_t i{0}; i < hdr->num_portions; ++i) {
+            deserialize_portion(page, hdr->blks_per_portion);
+            page += page_size;
+        }
+        m_delta_bytes += sizeof(bitmap_delta_hdr) + page_size * hdr->num_portions;
+        m_next_delta_seq = hdr->seq_num + 1;
+    }
+
+    BLKALLOC_LOG(INFO, "Loaded full bitmap gen={}, applied {} incremental bitmaps out of {} found", m_full_gen,
+                 deltas.size(), m_recovered_deltas.size());
+    m_recovered_deltas.clear();
+}
+
 void BitmapBlkAllocator::cp_flush(CP*) {
     if (!is_persistent()) { return; }
 
     if (m_is_disk_bm_dirty.load()) {
-        sisl::byte_array bitmap_buf = acquire_underlying_buffer();
-        if (m_meta_blk_cookie) {
-            meta_service().update_sub_sb(bitmap_buf->cbytes(), bitmap_buf->size(), m_meta_blk_cookie);
+        // Freeze the disk bitmap so that the allocations which are in-flight gets accumulated in a list and gets
+        // applied to the bitmap after the flush.
+        freeze_disk_bitmap();
+        auto const dirty_portions = collect_dirty_portions();
+        if (need_full_flush(dirty_portions.size())) {
+            flush_full_bitmap();
+        } else if (!dirty_portions.empty()) {
+            flush_delta_bitmap(dirty_portions);
         } else {
-            meta_service().add_sub_sb(get_name(), bitmap_buf->cbytes(), bitmap_buf->size(), m_meta_blk_cookie);
+            m_last_cp_flush_bytes.store(0, std::memory_order_relaxed);
         }
         m_is_disk_bm_dirty.store(false); // No longer dirty now, needs to be set before releasing the buffer
         release_underlying_buffer();
+    } else {
+        m_last_cp_flush_bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::vector< blk_num_t > BitmapBlkAllocator::collect_dirty_portions() {
+    std::vector< blk_num_t > dirty_portions;
+    {
+        std::scoped_lock lg(m_dirty_mtx);
+        dirty_portions.swap(m_dirty_portions);
+    }
+    // A portion could be listed more than once, if it is dirtied again while previous full bitmap flush is in progress
+    std::sort(dirty_portions.begin(), dirty_portions.end());
+    dirty_portions.erase(std::unique(dirty_portions.begin(), dirty_portions.end()), dirty_portions.end());
+    return dirty_portions;
+}
+
+bool BitmapBlkAllocator::need_full_flush(size_t num_dirty_portions) const {
+    // Full bitmap was never written or it is loaded from old format, which doesn't have incremental support
+    if ((m_meta_blk_cookie == nullptr) || (m_full_gen == 0)) { return true; }
+
+    auto const max_deltas = HS_DYNAMIC_CONFIG(blkallocator.max_incremental_bitmaps);
+    if (m_delta_meta_cookies.size() >= max_deltas) { return true; }
+
+    auto const full_size = (uint64_cast(m_num_blks) + 7) / 8;
+    auto const delta_size = sizeof(bitmap_delta_hdr) + delta_page_size() * num_dirty_portions;
+    return ((m_delta_bytes + delta_size) * 100.0 >=
+            HS_DYNAMIC_CONFIG(blkallocator.incremental_bitmap_compact_pct) * full_size);
+}
+
+void BitmapBlkAllocator::flush_full_bitmap() {
+    // Dirty flags of all portions are reset before serializing, so that any free which happens after the portion is
+    // cleaned is guaranteed to be marked dirty again for next cp.
+    for (blk_num_t p{0}; p < get_num_portions(); ++p) {
+        auto& portion = m_blk_portions[p];
+        auto lock{portion.portion_auto_lock()};
+        portion.set_disk_dirty(false);
+    }
+
+    sisl::byte_array bitmap_buf = m_disk_bm->serialize(m_align_size);
+    auto const total_size = sizeof(bitmap_full_hdr) + bitmap_buf->size();
+    auto buf = sisl::make_byte_array(s_cast< uint32_t >(total_size), m_align_size, sisl::buftag::metablk);
+
+    auto hdr = new (buf->bytes()) bitmap_full_hdr();
+    hdr->gen = m_full_gen + 1;
+    std::memcpy(buf->bytes() + sizeof(bitmap_full_hdr), bitmap_buf->cbytes(), bitmap_buf->size());
+
+    if (m_meta_blk_cookie) {
+        meta_service().update_sub_sb(buf->cbytes(), total_size, m_meta_blk_cookie);
+    } else {
+        meta_service().add_sub_sb(get_name(), buf->cbytes(), total_size, m_meta_blk_cookie);
+    }
+    ++m_full_gen;
+
+    // Full bitmap is persisted, all incremental records prior to this are no longer needed. If we crash before
+    // removing all of them, recovery ignores them because of their older generation.
+    for (auto cookie : m_delta_meta_cookies) {
+        meta_service().remove_sub_sb(cookie);
+    }
+    m_delta_meta_cookies.clear();
+    m_delta_bytes = 0;
+    m_next_delta_seq = 0;
+
+    m_last_cp_flush_bytes.store(total_size, std::memory_order_relaxed);
+    m_num_full_writes.fetch_add(1, std::memory_order_relaxed);
+    BLKALLOC_LOG(DEBUG, "Flushed full bitmap gen={} size={}", m_full_gen, total_size);
+}
+
+void BitmapBlkAllocator::flush_delta_bitmap(std::vector< blk_num_t > const& dirty_portions) {
+    auto const total_size = sizeof(bitmap_delta_hdr) + delta_page_size() * dirty_portions.size();
+    auto buf = sisl::make_byte_array(s_cast< uint32_t >(total_size), m_align_size, sisl::buftag::metablk);
+
+    auto hdr = new (buf->bytes()) bitmap_delta_hdr();
+    hdr->base_gen = m_full_gen;
+    hdr->seq_num = m_next_delta_seq++;
+    hdr->blks_per_portion = m_blks_per_portion;
+    hdr->num_portions = s_cast< uint32_t >(dirty_portions.size());
+
+    uint8_t* page = buf->bytes() + sizeof(bitmap_delta_hdr);
+    for (auto const portion_num : dirty_portions) {
+        serialize_portion(portion_num, page);
+        page += delta_page_size();
+    }
+
+    void* cookie{nullptr};
+    meta_service().add_sub_sb(m_delta_meta_name, buf->cbytes(), total_size, cookie);
+    m_delta_meta_cookies.push_back(cookie);
+    m_delta_bytes += total_size;
+
+    m_last_cp_flush_bytes.store(total_size, std::memory_order_relaxed);
+    m_num_delta_writes.fetch_add(1, std::memory_order_relaxed);
+    BLKALLOC_LOG(DEBUG, "Flushed incremental bitmap gen={} seq={} dirty_portions={} size={}", m_full_gen,
+                 hdr->seq_num, dirty_portions.size(), total_size);
+}
+
+void BitmapBlkAllocator::serialize_portion(blk_num_t portion_num, uint8_t* page) {
+    // Words follow the portion num in the page, hence are not 8 byte aligned; build them aside and copy them in.
+    std::vector< uint64_t > words(m_blks_per_portion / 64, 0);
+
+    auto const start_blk = portion_num * m_blks_per_portion;
+    auto const end_blk = std::min(start_blk + m_blks_per_portion, m_num_blks);
+
+    auto& portion = m_blk_portions[portion_num];
+    auto lock{portion.portion_auto_lock()};
+    portion.set_disk_dirty(false);
+
+    uint64_t b = m_disk_bm->get_next_set_bit(start_blk);
+    while ((b != sisl::Bitset::npos) && (b < end_blk)) {
+        uint64_t e = m_disk_bm->get_next_reset_bit(b);
+        if ((e == sisl::Bitset::npos) || (e > end_blk)) { e = end_blk; }
+        for (; b < e; ++b) {
+            auto const off = b - start_blk;
+            words[off / 64] |= (1ull << (off % 64));
+        }
+        if (e == end_blk) { break; }
+        b = m_disk_bm->get_next_set_bit(e);
+    }
+
+    std::memcpy(page, &portion_num, sizeof(blk_num_t));
+    std::memcpy(page + sizeof(blk_num_t), words.data(), words.size() * sizeof(uint64_t));
+}
+
+void BitmapBlkAllocator::deserialize_portion(uint8_t const* page, uint32_t blks_per_portion) {
+    blk_num_t portion_num;
+    std::memcpy(&portion_num, page, sizeof(blk_num_t));
+    std::vector< uint64_t > words(blks_per_portion / 64);
+    std::memcpy(words.data(), page + sizeof(blk_num_t), words.size() * sizeof(uint64_t));
+
+    auto const start_blk = uint64_cast(portion_num) * blks_per_portion;
+    if (start_blk >= m_num_blks) {
+        BLKALLOC_LOG(ERROR, "Incremental bitmap page portion={} is beyond total blks={}, ignoring", portion_num,
+                     m_num_blks);
+        return;
+    }
+    auto const nblks = std::min(uint64_cast(blks_per_portion), m_num_blks - start_blk);
+    m_disk_bm->reset_bits(start_blk, nblks);
+
+    uint64_t run_start{0};
+    uint64_t run_len{0};
+    for (uint64_t off{0}; off < nblks; ++off) {
+        if (words[off / 64] & (1ull << (off % 64))) {
+            if (run_len++ == 0) { run_start = off; }
+        } else if (run_len) {
+            m_disk_bm->set_bits(start_blk + run_start, run_len);
+            run_len = 0;
+        }
+    }
+    if (run_len) { m_disk_bm->set_bits(start_blk + run_start, run_len); }
+}
+
+void BitmapBlkAllocator::mark_disk_dirty(BlkAllocPortion& portion, blk_num_t start_blk, blk_count_t nblks) {
+    auto const do_mark = [this](BlkAllocPortion& p) {
+        if (!p.is_disk_dirty()) {
+            p.set_disk_dirty(true);
+            std::scoped_lock lg(m_dirty_mtx);
+            m_dirty_portions.push_back(p.get_portion_num());
+        }
+    };
+
+    do_mark(portion);
+
+    // Blks could span across portions, mark all of them dirty, taking their lock (in ascending order)
+    auto const end_portion_num = blknum_to_portion_num(start_blk + nblks - 1);
+    for (auto p = portion.get_portion_num() + 1; p <= end_portion_num; ++p) {
+        auto& next_portion = m_blk_portions[p];
+        auto lock{next_portion.portion_auto_lock()};
+        do_mark(next_portion);
     }
+    m_is_disk_bm_dirty.store(true);
 }
 
 bool BitmapBlkAllocator::is_blk_alloced_on_disk(const BlkId& b, bool use_lock) const {
@@ -105,6 +341,7 @@ BlkAllocStatus BitmapBlkAllocator::reserve_on_disk(BlkId const& bid) {
                                         "Expected disk blks to reset");
                 }
                 m_disk_bm->set_bits(b.blk_num(), b.blk_count());
+                mark_disk_dirty(portion, b.blk_num(), b.blk_count());
                 BLKALLOC_LOG(DEBUG, "blks allocated {} chunk number {}", b.to_string(), m_chunk_id);
             }
         };
@@ -119,7 +356,6 @@ BlkAllocStatus BitmapBlkAllocator::reserve_on_disk(BlkId const& bid) {
         } else {
             set_on_disk_bm(bid);
         }
-        m_is_disk_bm_dirty.store(true);
     }
     rcu_read_unlock();
 
@@ -135,6 +371,7 @@ void BitmapBlkAllocator::free_on_disk(BlkId const& bid) {
         {
             auto lock{portion.portion_auto_lock()};
             m_disk_bm->reset_bits(b.blk_num(), b.blk_count());
+            mark_disk_dirty(portion, b.blk_num(), b.blk_count());
         }
     };
 
@@ -149,7 +386,41 @@ void BitmapBlkAllocator::free_on_disk(BlkId const& bid) {
     }
 }
 
-sisl::byte_array BitmapBlkAllocator::acquire_underlying_buffer() {
+void BitmapBlkAllocator::free_on_disk(std::vector< BlkId > const& bids) {
+    DEBUG_ASSERT_EQ(is_persistent(), true, "free_on_disk called for non-persistent blk allocator");
+
+    foreach_blk_in_portion(bids, [this](BlkAllocPortion& portion, BlkId const& b) {
+        m_disk_bm->reset_bits(b.blk_num(), b.blk_count());
+        mark_disk_dirty(portion, b.blk_num(), b.blk_count());
+    });
+}
+
+void BitmapBlkAllocator::foreach_blk_in_portion(std::vector< BlkId > const& bids,
+                                                std::function< void(BlkAllocPortion&, BlkId const&) > const& cb) {
+    std::vector< BlkId > blks;
+    blks.reserve(bids.size());
+    for (auto const& bid : bids) {
+        if (bid.is_multi()) {
+            auto it = r_cast< MultiBlkId const& >(bid).iterate();
+            while (auto const b = it.next()) {
+                blks.push_back(*b);
+            }
+        } else {
+            blks.push_back(bid);
+        }
+    }
+    std::sort(blks.begin(), blks.end(), [](BlkId const& a, BlkId const& b) { return a.blk_num() < b.blk_num(); });
+
+    for (size_t i{0}; i < blks.size();) {
+        BlkAllocPortion& portion = blknum_to_portion(blks[i].blk_num());
+        auto lock{portion.portion_auto_lock()};
+        for (; (i < blks.size()) && (blknum_to_portion_num(blks[i].blk_num()) == portion.get_portion_num()); ++i) {
+            cb(portion, blks[i]);
+        }
+    }
+}
+
+void BitmapBlkAllocator::freeze_disk_bitmap() {
     // prepare and temporary alloc list, where blkalloc is accumulated till underlying buffer is released.
     // RCU will wait for all I/Os that are still in critical section (allocating on disk bm) to complete and exit;
     auto alloc_list_ptr = new sisl::ThreadVector< MultiBlkId >();
@@ -157,7 +428,6 @@ sisl::byte_array BitmapBlkAllocator::acquire_underlying_buffer() {
     synchronize_rcu();
 
     BLKALLOC_REL_ASSERT(old_alloc_list_ptr == nullptr, "Multiple acquires concurrently?");
-    return (m_disk_bm->serialize(m_align_size));
 }
 
 void BitmapBlkAllocator::release_underlying_buffer() {
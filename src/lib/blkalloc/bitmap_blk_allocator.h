@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -43,6 +44,7 @@ private:
     mutable std::mutex m_blk_lock;
     blk_num_t m_portion_num;
     blk_temp_t m_temperature;
+    bool m_disk_dirty{false}; // Is the on-disk bitmap of this portion modified since last cp, protected by m_blk_lock
 
 public:
     BlkAllocPortion(blk_temp_t temp = default_temperature()) : m_temperature(temp) {}
@@ -58,9 +60,40 @@ public:
 
     void set_portion_num(blk_num_t portion_num) { m_portion_num = portion_num; }
     void set_temperature(const blk_temp_t temp) { m_temperature = temp; }
+
+    // Caller is expected to hold the portion lock
+    bool is_disk_dirty() const { return m_disk_dirty; }
+    void set_disk_dirty(bool dirty) { m_disk_dirty = dirty; }
     static constexpr blk_temp_t default_temperature() { return 1; }
 };
 
+#pragma pack(1)
+// Header prefixed to the full bitmap persisted in meta blk. Bitmaps persisted before incremental flush was introduced
+// do not have this header, which is detected by the absence of magic.
+struct bitmap_full_hdr {
+    static constexpr uint64_t BITMAP_FULL_MAGIC{0xB1770F0011B17A9F};
+    static constexpr uint32_t BITMAP_FULL_VERSION{1};
+
+    uint64_t magic{BITMAP_FULL_MAGIC};
+    uint32_t version{BITMAP_FULL_VERSION};
+    uint64_t gen{0}; // Generation of the full bitmap, incremented on every compaction
+};
+
+// Incremental bitmap record, which contains only the portions (bitmap pages) that are modified in a cp. Each record
+// is followed by num_portions of bitmap pages, where each page is portion_num followed by words of that portion.
+struct bitmap_delta_hdr {
+    static constexpr uint64_t BITMAP_DELTA_MAGIC{0xB17DE17A0011B17D};
+    static constexpr uint32_t BITMAP_DELTA_VERSION{1};
+
+    uint64_t magic{BITMAP_DELTA_MAGIC};
+    uint32_t version{BITMAP_DELTA_VERSION};
+    uint64_t base_gen{0};         // Generation of full bitmap, this delta has to be applied on
+    uint64_t seq_num{0};          // Order in which deltas of same base generation are to be applied
+    uint32_t blks_per_portion{0}; // Blks covered by each bitmap page
+    uint32_t num_portions{0};     // Number of bitmap pages followed by this header
+};
+#pragma pack()
+
 class CP;
 class BitmapBlkAllocator : public BlkAllocator {
 public:
@@ -96,24 +129,48 @@ public:
     nlohmann::json get_status(int log_level) const override;
 
     void incr_alloced_blk_count(blk_count_t nblks) { m_alloced_blk_count.fetch_add(nblks, std::memory_order_relaxed); }
-    void decr_alloced_blk_count(blk_count_t nblks) { m_alloced_blk_count.fetch_sub(nblks, std::memory_order_relaxed); }
+    void decr_alloced_blk_count(uint64_t nblks) { m_alloced_blk_count.fetch_sub(nblks, std::memory_order_relaxed); }
     int64_t get_alloced_blk_count() const { return m_alloced_blk_count.load(std::memory_order_acquire); }
 
+    // Bytes of bitmap written to meta service by the last cp flush and number of full/incremental bitmap writes
+    uint64_t last_cp_flush_bytes() const { return m_last_cp_flush_bytes.load(std::memory_order_relaxed); }
+    uint64_t num_full_bitmap_writes() const { return m_num_full_writes.load(std::memory_order_relaxed); }
+    uint64_t num_delta_bitmap_writes() const { return m_num_delta_writes.load(std::memory_order_relaxed); }
+
 protected:
     void free_on_disk(BlkId const& b);
+    void free_on_disk(std::vector< BlkId > const& bids);
+
+    // Calls cb for each single blkid (pieces of a multi blkid) of the given blkids in ascending blk_num order, holding
+    // the lock of the portion of its start blk. Lock of a portion is taken only once for all of its blkids.
+    void foreach_blk_in_portion(std::vector< BlkId > const& bids,
+                                std::function< void(BlkAllocPortion&, BlkId const&) > const& cb);
 
 private:
     void do_init();
     sisl::ThreadVector< MultiBlkId >* get_alloc_blk_list();
     void on_meta_blk_found(void* mblk_cookie, sisl::byte_view const& buf, size_t size);
+    void on_delta_meta_blk_found(void* mblk_cookie, sisl::byte_view const& buf, size_t size);
+    void apply_delta_bitmaps();
 
-    // Acquire the underlying bitmap buffer and while the caller has acquired, all the new allocations
-    // will be captured in a separate list and then pushes into buffer once released.
+    // Freeze the underlying bitmap and while the caller has frozen, all the new allocations will be captured in a
+    // separate list and then pushed into bitmap once released.
     // NOTE: THIS IS NON-THREAD SAFE METHOD. Caller is expected to ensure synchronization between multiple
     // acquires/releases
-    sisl::byte_array acquire_underlying_buffer();
+    void freeze_disk_bitmap();
     void release_underlying_buffer();
 
+    // Dirty portion tracking, mark_disk_dirty is expected to be called with the lock of portion of start_blk held.
+    void mark_disk_dirty(BlkAllocPortion& portion, blk_num_t start_blk, blk_count_t nblks);
+    std::vector< blk_num_t > collect_dirty_portions();
+    bool need_full_flush(size_t num_dirty_portions) const;
+
+    void flush_full_bitmap();
+    void flush_delta_bitmap(std::vector< blk_num_t > const& dirty_portions);
+    size_t delta_page_size() const { return sizeof(blk_num_t) + (m_blks_per_portion / 64) * sizeof(uint64_t); }
+    void serialize_portion(blk_num_t portion_num, uint8_t* page);
+    void deserialize_portion(uint8_t const* page, uint32_t blks_per_portion);
+
 protected:
     blk_num_t m_blks_per_portion;
 
@@ -124,5 +181,18 @@ private:
     std::atomic< bool > m_is_disk_bm_dirty{true}; // initially disk_bm treated as dirty
     void* m_meta_blk_cookie{nullptr};
     std::atomic< int64_t > m_alloced_blk_count{0};
+
+    // Incremental bitmap persistence
+    std::string m_delta_meta_name;                      // meta subtype for incremental bitmap records
+    std::mutex m_dirty_mtx;                             // Protects the dirty portion list below
+    std::vector< blk_num_t > m_dirty_portions;          // Portions modified on disk bitmap since last cp flush
+    uint64_t m_full_gen{0};                             // Generation of the last persisted full bitmap
+    uint64_t m_next_delta_seq{0};                       // Seq num of next incremental record on this generation
+    uint64_t m_delta_bytes{0};                          // Bytes of incremental records since last full bitmap
+    std::vector< void* > m_delta_meta_cookies;          // Incremental records persisted since last full bitmap
+    std::vector< sisl::byte_array > m_recovered_deltas; // Incremental records found during recovery, yet to apply
+    std::atomic< uint64_t > m_last_cp_flush_bytes{0};
+    std::atomic< uint64_t > m_num_full_writes{0};
+    std::atomic< uint64_t > m_num_delta_writes{0};
 };
 } // namespace homestore
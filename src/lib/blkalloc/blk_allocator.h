@@ -154,6 +154,12 @@ public:
     virtual BlkAllocStatus reserve_on_cache(BlkId const& bid) = 0;
 
     virtual void free(BlkId const& id) = 0;
+    // Free all the given blkids of this chunk, allocator could override it to take its locks once for all of them
+    virtual void free(std::vector< BlkId > const& bids) {
+        for (auto const& b : bids) {
+            free(b);
+        }
+    }
 
     virtual blk_num_t available_blks() const = 0;
     virtual blk_num_t get_defrag_nblks() const = 0;
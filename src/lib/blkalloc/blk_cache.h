@@ -287,6 +287,19 @@ public:
      */
     [[nodiscard]] virtual BlkAllocStatus try_alloc_blks(const blk_cache_alloc_req& req, blk_cache_alloc_resp& resp) = 0;
 
+    /**
+     * @brief Pop upto max_entries from a single slab in one go, without splitting higher or merging lower slabs. This is
+     * used to bulk refill the caches which sit in front of this cache for a specific slab size.
+     *
+     * @param slab_idx Slab from which entries are to be popped
+     * @param preferred_level Preferred temperature level, other levels of the slab are used if it is empty
+     * @param max_entries Maximum number of entries to pop
+     * @param resp Popped entries are appended to resp.out_blks and need_refill is set if slab is running low
+     * @return Number of entries popped
+     */
+    [[nodiscard]] virtual blk_num_t try_alloc_slab_entries(const slab_idx_t slab_idx, const blk_temp_t preferred_level,
+                                                           const blk_num_t max_entries, blk_cache_alloc_resp& resp) = 0;
+
     [[maybe_unused]] virtual blk_count_t try_free_blks(const blk_cache_entry& entry,
                                                        std::vector< blk_cache_entry >& excess_blks) = 0;
     [[maybe_unused]] virtual blk_count_t try_free_blks(const std::vector< blk_cache_entry >& blks,
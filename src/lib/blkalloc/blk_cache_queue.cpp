@@ -89,6 +89,28 @@ BlkAllocStatus FreeBlkCacheQueue::try_alloc_blks(const blk_cache_alloc_req& req,
     return status;
 }
 
+blk_num_t FreeBlkCacheQueue::try_alloc_slab_entries(const slab_idx_t slab_idx, const blk_temp_t preferred_level,
+                                                     const blk_num_t max_entries, blk_cache_alloc_resp& resp) {
+    COUNTER_INCREMENT(slab_metrics(slab_idx), num_slab_alloc, 1);
+
+    blk_num_t nentries{0};
+    while (nentries < max_entries) {
+        blk_cache_entry e;
+        const auto popped_level{pop_slab(slab_idx, preferred_level, false /* only_this_level */, e)};
+        if (!popped_level) {
+            // Slab is drained, time to refill this slab
+            resp.need_refill = true;
+            break;
+        }
+        if (popped_level.value() != preferred_level) { resp.need_refill = true; }
+        resp.out_blks.push_back(e);
+        ++nentries;
+    }
+
+    if (nentries == 0) { COUNTER_INCREMENT(slab_metrics(slab_idx), num_slab_alloc_failure, 1); }
+    return nentries;
+}
+
 blk_count_t FreeBlkCacheQueue::try_free_blks(const blk_cache_entry& entry,
                                              std::vector< blk_cache_entry >& excess_blks) {
     auto ret{BlkAllocStatus::SUCCESS};
@@ -91,6 +91,8 @@ public:
     FreeBlkCacheQueue& operator=(FreeBlkCacheQueue&&) noexcept = delete;
 
     BlkAllocStatus try_alloc_blks(const blk_cache_alloc_req& req, blk_cache_alloc_resp& resp) override;
+    blk_num_t try_alloc_slab_entries(const slab_idx_t slab_idx, const blk_temp_t preferred_level,
+                                     const blk_num_t max_entries, blk_cache_alloc_resp& resp) override;
     blk_count_t try_free_blks(const blk_cache_entry& entry, std::vector< blk_cache_entry >& excess_blks) override;
     blk_count_t try_free_blks(const std::vector< blk_cache_entry >& blks,
                               std::vector< blk_cache_entry >& excess_blks) override;
@@ -103,6 +103,16 @@ void FixedBlkAllocator::free(BlkId const& b) {
     if (is_persistent()) { free_on_disk(b); }
 }
 
+void FixedBlkAllocator::free(std::vector< BlkId > const& bids) {
+    for (auto const& b : bids) {
+        HS_DBG_ASSERT_EQ(b.blk_count(), 1,
+                         "Multiple blk free for FixedBlkAllocator? allocated by different allocator?");
+        const auto pushed = m_free_blk_q.write(b.blk_num());
+        HS_DBG_ASSERT_EQ(pushed, true, "Expected to be able to push the blk on fixed capacity Q");
+    }
+    if (is_persistent()) { free_on_disk(bids); }
+}
+
 blk_num_t FixedBlkAllocator::available_blks() const { return m_free_blk_q.sizeGuess(); }
 
 blk_num_t FixedBlkAllocator::get_defrag_nblks() const {
@@ -82,6 +82,17 @@ VarsizeBlkAllocator::VarsizeBlkAllocator(VarsizeBlkAllocConfig const& cfg, bool
     if (m_cfg.m_use_slabs) {
         m_fb_cache = std::make_unique< FreeBlkCacheQueue >(cfg.get_slab_config(), &m_metrics);
         LOGINFO("m_fb_cache total free blks: {}", m_fb_cache->total_free_blks());
+
+        auto const mag_max_blks = HS_DYNAMIC_CONFIG(blkallocator.magazine_max_slab_blks);
+        if (mag_max_blks > 0) {
+            m_mag_slab_cnt = std::min(s_cast< slab_idx_t >(FreeBlkCache::find_slab(mag_max_blks) + 1),
+                                      m_cfg.get_slab_cnt());
+            m_mag_slot_cnt = std::max(std::thread::hardware_concurrency(), 1u);
+            m_mag_slots = std::make_unique< magazine_slot[] >(m_mag_slot_cnt);
+            for (uint32_t i{0}; i < m_mag_slot_cnt; ++i) {
+                m_mag_slots[i].slab_mags.resize(m_mag_slab_cnt);
+            }
+        }
     }
 
     if (is_fresh || !is_persistent()) { do_start(); }
@@ -413,7 +424,15 @@ BlkAllocStatus VarsizeBlkAllocator::alloc(blk_count_t nblks, blk_alloc_hints con
     BlkAllocStatus status;
     blk_count_t num_allocated{0};
     blk_count_t nblks_remain;
+    bool magazines_drained{false};
+
+    if (use_slabs && out_mbid.has_room() && alloc_from_magazine(nblks, hints, out_mbid)) {
+        num_allocated = nblks;
+        status = BlkAllocStatus::SUCCESS;
+        goto out;
+    }
 
+retry:
     if (use_slabs && (nblks <= m_cfg.highest_slab_blks_count())) {
         num_allocated = alloc_blks_slab(nblks, hints, out_mbid);
         if (num_allocated >= nblks) {
@@ -432,6 +451,13 @@ BlkAllocStatus VarsizeBlkAllocator::alloc(blk_count_t nblks, blk_alloc_hints con
         status = BlkAllocStatus::PARTIAL;
     } else {
         free_blks_direct(out_mbid);
+        if (use_slabs && !magazines_drained && (drain_all_magazines() > 0)) {
+            // Free blks could be parked in magazines of other threads, put them back to slab cache and try again
+            magazines_drained = true;
+            num_allocated = 0;
+            out_mbid = MultiBlkId{};
+            goto retry;
+        }
         status = hints.is_contiguous ? BlkAllocStatus::FAILED : BlkAllocStatus::SPACE_FULL;
     }
 
@@ -654,15 +680,46 @@ BlkAllocStatus VarsizeBlkAllocator::reserve_on_cache(BlkId const& bid) {
 }
 
 void VarsizeBlkAllocator::free(BlkId const& bid) {
-    blk_count_t n_freed = (m_cfg.m_use_slabs && (bid.blk_count() <= m_cfg.highest_slab_blks_count()))
-        ? free_blks_slab(r_cast< MultiBlkId const& >(bid))
-        : free_blks_direct(r_cast< MultiBlkId const& >(bid));
+    blk_count_t n_freed;
+    if (m_cfg.m_use_slabs && !bid.is_multi() && free_to_magazine(bid)) {
+        n_freed = bid.blk_count();
+    } else {
+        n_freed = (m_cfg.m_use_slabs && (bid.blk_count() <= m_cfg.highest_slab_blks_count()))
+            ? free_blks_slab(r_cast< MultiBlkId const& >(bid))
+            : free_blks_direct(r_cast< MultiBlkId const& >(bid));
+    }
 
     if (is_persistent()) { free_on_disk(bid); }
     decr_alloced_blk_count(n_freed);
     BLKALLOC_LOG(TRACE, "Freed blk_num={}", bid.to_string());
 }
 
+void VarsizeBlkAllocator::free(std::vector< BlkId > const& bids) {
+    // Blks which are not taken by the free blk cache are freed on the cache bitmap, like on the disk bitmap, under a
+    // single lock of each portion
+    std::vector< BlkId > direct_bids;
+    uint64_t n_freed{0};
+    for (auto const& bid : bids) {
+        if (m_cfg.m_use_slabs && !bid.is_multi() && free_to_magazine(bid)) {
+            n_freed += bid.blk_count();
+        } else if (m_cfg.m_use_slabs && (bid.blk_count() <= m_cfg.highest_slab_blks_count())) {
+            n_freed += free_blks_slab(r_cast< MultiBlkId const& >(bid));
+        } else {
+            direct_bids.push_back(bid);
+        }
+    }
+
+    foreach_blk_in_portion(direct_bids, [this, &n_freed](BlkAllocPortion&, BlkId const& b) {
+        BLKALLOC_REL_ASSERT(m_cache_bm->is_bits_set(b.blk_num(), b.blk_count()), "Expected bits to be set");
+        m_cache_bm->reset_bits(b.blk_num(), b.blk_count());
+        n_freed += b.blk_count();
+    });
+
+    if (is_persistent()) { free_on_disk(bids); }
+    decr_alloced_blk_count(n_freed);
+    BLKALLOC_LOG(TRACE, "Freed {} blkids, {} blks", bids.size(), n_freed);
+}
+
 blk_count_t VarsizeBlkAllocator::free_blks_slab(MultiBlkId const& bid) {
     static thread_local std::vector< blk_cache_entry > excess_blks;
     excess_blks.clear();
@@ -720,6 +777,107 @@ blk_count_t VarsizeBlkAllocator::free_blks_direct(MultiBlkId const& bid) {
     return n_freed;
 }
 
+VarsizeBlkAllocator::magazine_slot& VarsizeBlkAllocator::my_magazine_slot() {
+    static std::atomic< uint32_t > s_next_thread_idx{0};
+    static thread_local uint32_t const t_thread_idx{s_next_thread_idx.fetch_add(1, std::memory_order_relaxed)};
+    return m_mag_slots[t_thread_idx % m_mag_slot_cnt];
+}
+
+// Returns the slab if nblks is served by magazines (only exact slab sizes are), otherwise m_mag_slab_cnt
+slab_idx_t VarsizeBlkAllocator::magazine_slab(blk_count_t nblks) const {
+    if (!m_mag_slots || (nblks == 0)) { return m_mag_slab_cnt; }
+    auto const slab_idx = FreeBlkCache::find_slab(nblks);
+    return ((slab_idx < m_mag_slab_cnt) && ((blk_count_t{1} << slab_idx) == nblks)) ? slab_idx : m_mag_slab_cnt;
+}
+
+bool VarsizeBlkAllocator::alloc_from_magazine(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId& out_blkid) {
+    auto const slab_idx = magazine_slab(nblks);
+    if (slab_idx >= m_mag_slab_cnt) { return false; }
+
+    auto& slot = my_magazine_slot();
+    std::unique_lock< std::mutex > lk{slot.mtx, std::try_to_lock};
+    if (!lk.owns_lock()) { return false; } // Some other thread shares this slot, use the slab cache directly
+
+    auto& mag = slot.slab_mags[slab_idx];
+    if (mag.empty()) {
+        // Refill only half of the magazine, so that subsequent frees also have room to get absorbed here
+        auto const mag_size = HS_DYNAMIC_CONFIG(blkallocator.magazine_size);
+        if (mag_size == 0) { return false; }
+
+        static thread_local blk_cache_alloc_resp s_mag_resp;
+        s_mag_resp.reset();
+        s_mag_resp.need_refill = false;
+        [[maybe_unused]] auto const nentries = m_fb_cache->try_alloc_slab_entries(
+            slab_idx, hints.desired_temp, std::max(mag_size / 2, 1u), s_mag_resp);
+        if (s_mag_resp.need_refill) { request_more_blks(nullptr, false /* fill_entire_cache */); }
+        if (s_mag_resp.out_blks.empty()) { return false; }
+
+        // Reverse the order, so that entries are handed out in the same order as they are popped from slab cache
+        mag.insert(mag.end(), s_mag_resp.out_blks.rbegin(), s_mag_resp.out_blks.rend());
+        COUNTER_INCREMENT(m_metrics, num_magazine_refills, 1);
+    }
+
+    auto const e = mag.back();
+    mag.pop_back();
+    out_blkid.add(e.get_blk_num(), e.blk_count(), m_chunk_id);
+    COUNTER_INCREMENT(m_metrics, num_alloc, 1);
+    COUNTER_INCREMENT(m_metrics, num_magazine_alloc, 1);
+    BLKALLOC_LOG(TRACE, "Alloced from magazine entry={}", e.to_string());
+    return true;
+}
+
+bool VarsizeBlkAllocator::free_to_magazine(BlkId const& b) {
+    auto const slab_idx = magazine_slab(b.blk_count());
+    if (slab_idx >= m_mag_slab_cnt) { return false; }
+
+    auto const mag_size = HS_DYNAMIC_CONFIG(blkallocator.magazine_size);
+    if (mag_size == 0) { return false; }
+
+    auto& slot = my_magazine_slot();
+    std::unique_lock< std::mutex > lk{slot.mtx, std::try_to_lock};
+    if (!lk.owns_lock()) { return false; }
+
+    auto& mag = slot.slab_mags[slab_idx];
+    if (mag.size() >= mag_size) { drain_magazine(mag, mag.size() - (mag_size / 2)); }
+    mag.push_back(blkid_to_blk_cache_entry(b, 2));
+    COUNTER_INCREMENT(m_metrics, num_magazine_free, 1);
+    return true;
+}
+
+// Moves the oldest nentries of the magazine back to slab cache. Caller is expected to hold the slot lock.
+void VarsizeBlkAllocator::drain_magazine(std::vector< blk_cache_entry >& mag, size_t nentries) {
+    static thread_local std::vector< blk_cache_entry > s_excess_blks;
+    s_excess_blks.clear();
+
+    nentries = std::min(nentries, mag.size());
+    for (size_t i{0}; i < nentries; ++i) {
+        m_fb_cache->try_free_blks(mag[i], s_excess_blks);
+    }
+    mag.erase(mag.begin(), mag.begin() + nentries);
+
+    // Whatever slab cache could not accomodate goes back to the bitmap
+    for (auto const& e : s_excess_blks) {
+        BLKALLOC_LOG(TRACE, "Freeing in bitmap of entry={} - excess of magazine drain size={}", e.to_string(),
+                     s_excess_blks.size());
+        free_blks_direct(MultiBlkId{blk_cache_entry_to_blkid(e)});
+    }
+    COUNTER_INCREMENT(m_metrics, num_magazine_drains, 1);
+}
+
+size_t VarsizeBlkAllocator::drain_all_magazines() {
+    size_t ndrained{0};
+    for (uint32_t i{0}; i < m_mag_slot_cnt; ++i) {
+        std::unique_lock< std::mutex > lk{m_mag_slots[i].mtx};
+        for (auto& mag : m_mag_slots[i].slab_mags) {
+            if (mag.empty()) { continue; }
+            ndrained += mag.size();
+            drain_magazine(mag, mag.size());
+        }
+    }
+    if (ndrained) { BLKALLOC_LOG(DEBUG, "Drained {} entries from all magazines to slab cache", ndrained); }
+    return ndrained;
+}
+
 bool VarsizeBlkAllocator::is_blk_alloced(BlkId const& bid, bool use_lock) const {
     auto check_bits_set = [this](BlkId const& b, bool use_lock) {
         if (use_lock) {
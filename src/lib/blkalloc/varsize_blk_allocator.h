@@ -178,6 +178,10 @@ public:
         REGISTER_COUNTER(num_alloc_partial, "Number of blk alloc partial allocations");
         REGISTER_COUNTER(num_retries, "Number of times it retried because of empty cache");
         REGISTER_COUNTER(num_blks_alloc_direct, "Number of blks alloc attempt directly because of empty cache");
+        REGISTER_COUNTER(num_magazine_alloc, "Number of blk allocs served from per thread magazines");
+        REGISTER_COUNTER(num_magazine_free, "Number of blk frees absorbed by per thread magazines");
+        REGISTER_COUNTER(num_magazine_refills, "Number of bulk refills of magazines from shared slab cache");
+        REGISTER_COUNTER(num_magazine_drains, "Number of bulk drains of magazines to shared slab cache");
 
         REGISTER_HISTOGRAM(frag_pct_distribution, "Distribution of fragmentation percentage",
                            HistogramBucketsType(LinearUpto64Buckets));
@@ -216,6 +220,7 @@ public:
     BlkAllocStatus alloc(blk_count_t nblks, blk_alloc_hints const& hints, std::vector< BlkId >& out_blkids);
     BlkAllocStatus reserve_on_cache(BlkId const& b) override;
     void free(BlkId const& blk_id) override;
+    void free(std::vector< BlkId > const& bids) override;
 
     blk_num_t available_blks() const override;
     blk_num_t get_defrag_nblks() const override;
@@ -252,6 +257,17 @@ private:
     BlkAllocSegment* m_sweep_segment{nullptr};                    // Segment to sweep - if woken up
     std::shared_ptr< blk_cache_fill_session > m_cur_fill_session; // Cache fill requirements while sweeping
 
+    // Per thread magazines of free blk cache entries in front of the shared slab caches. Every thread maps to one of
+    // the slots, whose lock is almost never contended, and single piece allocs/frees of the smaller slab sizes are served
+    // from it. Entries in magazine are still marked in m_cache_bm, same as entries in slab cache.
+    struct alignas(64) magazine_slot {
+        std::mutex mtx;
+        std::vector< std::vector< blk_cache_entry > > slab_mags; // One magazine per slab upto m_mag_slab_cnt
+    };
+    std::unique_ptr< magazine_slot[] > m_mag_slots;
+    uint32_t m_mag_slot_cnt{0};
+    slab_idx_t m_mag_slab_cnt{0};
+
     std::uniform_int_distribution< blk_num_t > m_rand_portion_num_generator;
     BlkAllocMetrics m_metrics;
 
@@ -271,6 +287,14 @@ private:
     blk_count_t free_blks_slab(MultiBlkId const& b);
     blk_count_t free_blks_direct(MultiBlkId const& b);
 
+    // Magazine related functions
+    magazine_slot& my_magazine_slot();
+    slab_idx_t magazine_slab(blk_count_t nblks) const;
+    bool alloc_from_magazine(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId& out_blkid);
+    bool free_to_magazine(BlkId const& b);
+    void drain_magazine(std::vector< blk_cache_entry >& mag, size_t nentries);
+    size_t drain_all_magazines();
+
 #ifdef _PRERELEASE
     void alloc_sanity_check(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId const& out_blkids) const;
 #endif
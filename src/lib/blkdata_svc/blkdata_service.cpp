@@ -38,7 +38,7 @@ BlkDataService::~BlkDataService() = default;
 
 // first-time boot path
 void BlkDataService::create_vdev(uint64_t size, HSDevType devType, uint32_t blk_size, blk_allocator_type_t alloc_type,
-                                 chunk_selector_type_t chunk_sel_type, uint32_t num_chunks) {
+                                 chunk_selector_type_t chunk_sel_type, uint32_t num_chunks, bool enable_discard) {
     hs_vdev_context vdev_ctx;
     vdev_ctx.type = hs_vdev_type_t::DATA_VDEV;
 
@@ -52,7 +52,8 @@ void BlkDataService::create_vdev(uint64_t size, HSDevType devType, uint32_t blk_
                                                         .alloc_type = alloc_type,
                                                         .chunk_sel_type = chunk_sel_type,
                                                         .multi_pdev_opts = vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
-                                                        .context_data = vdev_ctx.to_blob()});
+                                                        .context_data = vdev_ctx.to_blob(),
+                                                        .enable_discard = enable_discard});
 }
 
 // both first_time_boot and recovery path will come here
@@ -146,6 +147,29 @@ folly::Future< std::error_code > BlkDataService::async_alloc_write(const sisl::s
     return async_write(sgs, out_blkids, part_of_batch);
 }
 
+folly::Future< std::error_code > BlkDataService::async_alloc_write_batch(std::span< sisl::sg_list const > sgs_list,
+                                                                         const blk_alloc_hints& hints,
+                                                                         std::vector< MultiBlkId >& out_blkids) {
+    std::vector< uint32_t > sizes;
+    sizes.reserve(sgs_list.size());
+    for (auto const& sgs : sgs_list) {
+        sizes.push_back(uint32_cast(sgs.size));
+    }
+
+    const auto status = alloc_blks_batch(sizes, hints, out_blkids);
+    if (status != BlkAllocStatus::SUCCESS) {
+        return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
+    }
+
+    std::vector< folly::Future< std::error_code > > futs;
+    futs.reserve(sgs_list.size());
+    for (size_t i{0}; i < sgs_list.size(); ++i) {
+        futs.emplace_back(async_write(sgs_list[i], out_blkids[i], true /* part_of_batch */));
+    }
+    m_vdev->submit_batch();
+    return collect_all_futures(futs);
+}
+
 folly::Future< std::error_code > BlkDataService::async_write(const char* buf, uint32_t size, MultiBlkId const& blkid,
                                                              bool part_of_batch) {
     if (blkid.num_pieces() == 1) {
@@ -195,6 +219,18 @@ BlkAllocStatus BlkDataService::alloc_blks(uint32_t size, const blk_alloc_hints&
     return m_vdev->alloc_blks(nblks, hints, out_blkids);
 }
 
+BlkAllocStatus BlkDataService::alloc_blks_batch(std::span< uint32_t const > sizes, const blk_alloc_hints& hints,
+                                                std::vector< MultiBlkId >& out_blkids) {
+    std::vector< blk_count_t > nblks_list;
+    nblks_list.reserve(sizes.size());
+    for (auto const size : sizes) {
+        HS_DBG_ASSERT_EQ(size % m_blk_size, 0, "Non aligned size requested");
+        nblks_list.push_back(static_cast< blk_count_t >(size / m_blk_size));
+    }
+
+    return m_vdev->alloc_blks_batch(nblks_list, hints, out_blkids);
+}
+
 BlkAllocStatus BlkDataService::commit_blk(MultiBlkId const& blkid) {
     if (blkid.num_pieces() == 1) {
         // Shortcut to most common case
@@ -36,7 +36,9 @@ folly::Future< bool > DataSvcCPCallbacks::cp_flush(CP* cp) {
     return folly::makeFuture< bool >(true);
 }
 
-void DataSvcCPCallbacks::cp_cleanup(CP* cp) {}
+void DataSvcCPCallbacks::cp_cleanup(CP* cp) {
+    m_vdev->cp_cleanup(s_cast< VDevCPContext* >(cp->context(cp_consumer_t::BLK_DATA_SVC)));
+}
 
 int DataSvcCPCallbacks::cp_progress_percent() { return m_vdev->cp_progress_percent(); }
 
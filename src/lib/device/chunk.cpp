@@ -24,15 +24,41 @@ Chunk::Chunk(PhysicalDev* pdev, const chunk_info& cinfo, uint32_t chunk_slot) :
 
 std::string Chunk::to_string() const {
     return fmt::format("chunk_id={}, vdev_id={}, start_offset={}, size={}, slot_num_in_pdev={} "
-                       "pdev_ordinal={} vdev_ordinal={} stream_id={}",
+                       "pdev_ordinal={} vdev_ordinal={} stream_id={} primary_chunk_id={} num_mirrors={} mirror_gen={} "
+                       "stale={}",
                        chunk_id(), vdev_id(), start_offset(), in_bytes(size()), slot_number(), pdev_ordinal(),
-                       vdev_ordinal(), stream_id());
+                       vdev_ordinal(), stream_id(), primary_chunk_id(), m_mirror_chunks.size(), mirror_gen(),
+                       is_stale());
 }
 
 void Chunk::set_user_private(const sisl::blob& data) {
+    {
+        std::unique_lock lg{m_mgmt_mutex};
+        m_chunk_info.set_user_private(data);
+        m_chunk_info.compute_checksum();
+        write_chunk_info();
+    }
+
+    // Mirrors carry the same private data, so that any of them can take over if this chunk's pdev goes missing
+    for (auto& mirror : m_mirror_chunks) {
+        mirror->set_user_private(data);
+    }
+}
+
+void Chunk::set_mirror_gen(uint32_t gen) {
+    set_mirror_gen_in_memory(gen);
+    persist_chunk_info();
+}
+
+void Chunk::set_mirror_gen_in_memory(uint32_t gen) {
     std::unique_lock lg{m_mgmt_mutex};
-    m_chunk_info.set_user_private(data);
+    m_chunk_info.mirror_gen = gen;
     m_chunk_info.compute_checksum();
+}
+
+void Chunk::persist_chunk_info() {
+    // Writes the latest chunk info, so a generation picked later is never overwritten by an older one
+    std::unique_lock lg{m_mgmt_mutex};
     write_chunk_info();
 }
 
@@ -27,6 +27,8 @@ private:
     const uint32_t m_stream_id;
     uint32_t m_vdev_ordinal{0};
     shared< BlkAllocator > m_blk_allocator;
+    std::vector< shared< Chunk > > m_mirror_chunks; // Chunks on other pdevs, which hold the same data as this chunk
+    std::atomic< bool > m_stale{false};             // Has this replica missed writes and should not be read from
 
 public:
     friend class DeviceManager;
@@ -58,6 +60,16 @@ public:
     uint32_t stream_id() const { return m_stream_id; }
     uint32_t slot_number() const { return m_chunk_slot; }
     uint32_t vdev_ordinal() const { return m_vdev_ordinal; }
+    bool is_mirror() const { return m_chunk_info.is_mirror_chunk(); }
+    bool is_stale() const { return m_stale.load(std::memory_order_relaxed); }
+    uint32_t mirror_gen() const { return m_chunk_info.mirror_gen; }
+
+    /// @brief Chunk id, which blkids served by this chunk carry. It is the chunk id of the primary chunk for a mirror,
+    /// which could have been promoted as primary if the pdev of the primary chunk is missing.
+    uint16_t primary_chunk_id() const {
+        return is_mirror() ? static_cast< uint16_t >(m_chunk_info.primary_chunk_id) : chunk_id();
+    }
+    const std::vector< shared< Chunk > >& mirror_chunks() const { return m_mirror_chunks; }
 
     std::string to_string() const;
     nlohmann::json get_status([[maybe_unused]] int log_level) const;
@@ -68,6 +80,17 @@ public:
     void set_user_private(const sisl::blob& data);
     void set_block_allocator(cshared< BlkAllocator >& blkalloc) { m_blk_allocator = blkalloc; }
     void set_vdev_ordinal(uint32_t vdev_ordinal) { m_vdev_ordinal = vdev_ordinal; }
+    void add_mirror_chunk(cshared< Chunk >& mirror) { m_mirror_chunks.push_back(mirror); }
+    void mark_stale() { m_stale.store(true, std::memory_order_relaxed); }
+
+    /// @brief Persist the generation of this replica. Replicas which got a write which another replica missed move to
+    /// a newer generation, so that the replica which missed it is known to be stale across restarts.
+    void set_mirror_gen(uint32_t gen);
+
+    /// @brief Move this replica to the given generation in memory only, persist_chunk_info writes it to disk. Lets the
+    /// caller pick the generations of all the replicas under its lock and do the blocking writes after releasing it.
+    void set_mirror_gen_in_memory(uint32_t gen);
+    void persist_chunk_info();
 
 private:
     void write_chunk_info();
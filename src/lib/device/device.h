@@ -39,7 +39,7 @@ struct vdev_info {
 
     uint64_t vdev_size{0};                     // 0: Size of the vdev
     uint32_t vdev_id{0};                       // 8: Id for this vdev. It is unique per homestore instance
-    uint32_t num_mirrors{0};                   // 12: Total number of mirrors
+    uint32_t num_mirrors{0};                   // 12: Number of mirrors of each primary chunk
     uint32_t blk_size{0};                      // 16: IO block size for this vdev
     uint32_t num_primary_chunks{0};            // 20: number of primary chunks
     uint32_t chunk_size{0};                    // 24: chunk size used in vdev.
@@ -53,7 +53,8 @@ struct vdev_info {
     uint8_t alloc_type;                        // 98: Allocator type of this vdev
     uint8_t chunk_sel_type;                    // 99: Chunk Selector type of this vdev_id
     uint8_t use_slab_allocator{0};             // 100: Use slab allocator for this vdev
-    uint8_t padding[154]{};                    // 101: Padding to make it 256 bytes
+    uint8_t enable_discard{0};                 // 101: Discard the freed blks/chunks of this vdev on the device
+    uint8_t padding[153]{};                    // 102: Padding to make it 256 bytes
     uint8_t user_private[user_private_size]{}; // 128: User sepcific information
 
     uint32_t get_vdev_id() const { return vdev_id; }
@@ -110,6 +111,7 @@ struct vdev_parameters {
     vdev_multi_pdev_opts_t multi_pdev_opts; // How data to be placed on multiple vdevs
     sisl::blob context_data;                // Context data about this vdev
     bool use_slab_allocator{false};         // Use slab allocator for this vdev
+    bool enable_discard{false};             // Discard the freed blks/chunks of this vdev on the device
 };
 
 class VirtualDev;
@@ -139,6 +141,9 @@ private:
     sisl::Bitset m_vdev_id_bm{hs_super_blk::MAX_VDEVS_IN_SYSTEM}; // Bitmap to keep track of vdev ids available
     vdev_create_cb_t m_vdev_create_cb;
     // std::unique_ptr< ChunkManager > m_chunk_mgr;
+    std::mutex m_discard_mtx;                   // protects the start/stop of the below worker
+    iomgr::io_fiber_t m_discard_fiber{nullptr}; // Worker on which the blocking discards of all vdevs are run
+    bool m_discard_worker_enabled{false};       // Worker could be started, devices are formatted/loaded and not closed
 
 public:
     DeviceManager(const std::vector< dev_info >& devs, vdev_create_cb_t vdev_create_cb);
@@ -185,8 +190,22 @@ public:
     void remove_chunk(shared< Chunk > chunk);
     void remove_chunk_locked(shared< Chunk > chunk);
 
+    /// @brief Queue the discard work on the discard worker, so that the blocking discard calls on the device don't
+    /// hold up the io, cp or log truncate threads. Works are run one after other in the order they are queued.
+    void run_discard(std::function< void() > work);
+
+    /// @brief Wait for all the discard works queued so far to complete
+    void wait_for_discards();
+
 private:
+    void enable_discard_worker();
+    void start_discard_worker();
+    void stop_discard_worker();
     void load_vdevs();
+
+    /// @brief Bring the mirrors of the chunk, which have missed writes while their pdev was failing or absent, in sync
+    /// with the replica of the latest generation.
+    void sync_mirrors(Chunk* chunk, uint32_t num_replicas);
     int device_open_flags(const std::string& devname) const;
 
     std::vector< vdev_info > read_vdev_infos(const std::vector< PhysicalDev* >& pdevs);
@@ -138,6 +138,7 @@ void DeviceManager::format_devices() {
 
         hs_utils::iobuf_free(buf, sisl::buftag::superblk);
     }
+    enable_discard_worker();
 }
 
 void DeviceManager::load_devices() {
@@ -173,15 +174,71 @@ void DeviceManager::load_devices() {
         m_all_pdevs[pinfo->pdev_id] = std::move(pdev);
     }
 
+    enable_discard_worker();
     load_vdevs();
 }
 
 void DeviceManager::close_devices() {
+    stop_discard_worker();
     for (auto& pdev : m_all_pdevs) {
         if (pdev) { pdev->close_device(); }
     }
 }
 
+void DeviceManager::enable_discard_worker() {
+    // Worker is started on the first discard, as most of the setups never have any discard to run
+    std::lock_guard< std::mutex > lg{m_discard_mtx};
+    m_discard_worker_enabled = true;
+}
+
+void DeviceManager::start_discard_worker() {
+    folly::Promise< folly::Unit > p;
+    auto f = p.getFuture();
+    iomanager.create_reactor("vdev_discard", iomgr::INTERRUPT_LOOP, 1u, [this, &p](bool is_started) mutable {
+        if (is_started) {
+            m_discard_fiber = iomanager.iofiber_self();
+            p.setValue();
+        }
+    });
+    std::move(f).get();
+}
+
+void DeviceManager::stop_discard_worker() {
+    iomgr::io_fiber_t fiber{nullptr};
+    {
+        std::lock_guard< std::mutex > lg{m_discard_mtx};
+        m_discard_worker_enabled = false;
+        std::swap(fiber, m_discard_fiber);
+    }
+    if (fiber == nullptr) { return; }
+
+    // Discards queued ahead of this are completed before the worker is stopped
+    iomanager.run_on_wait(fiber, [] { iomanager.stop_io_loop(); });
+}
+
+void DeviceManager::run_discard(std::function< void() > work) {
+    iomgr::io_fiber_t fiber{nullptr};
+    {
+        std::lock_guard< std::mutex > lg{m_discard_mtx};
+        if (m_discard_worker_enabled && (m_discard_fiber == nullptr)) { start_discard_worker(); }
+        fiber = m_discard_fiber;
+    }
+    if (fiber == nullptr) {
+        work();
+        return;
+    }
+    iomanager.run_on_forget(fiber, std::move(work));
+}
+
+void DeviceManager::wait_for_discards() {
+    iomgr::io_fiber_t fiber{nullptr};
+    {
+        std::lock_guard< std::mutex > lg{m_discard_mtx};
+        fiber = m_discard_fiber;
+    }
+    if (fiber) { iomanager.run_on_wait(fiber, [] {}); }
+}
+
 shared< VirtualDev > DeviceManager::create_vdev(vdev_parameters&& vparam) {
     std::unique_lock lg{m_vdev_mutex};
 
@@ -199,7 +256,8 @@ shared< VirtualDev > DeviceManager::create_vdev(vdev_parameters&& vparam) {
                                              [](int r, const PhysicalDev* a) { return r + a->num_streams(); });
         vparam.num_chunks = sisl::round_up(vparam.num_chunks, total_streams);
     } else if (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED) {
-        vparam.num_chunks = sisl::round_up(vparam.num_chunks, pdevs[0]->num_streams()) * pdevs.size();
+        // num_chunks are the primary chunks, each pdev other than the first one holds a mirror of every primary chunk
+        vparam.num_chunks = sisl::round_up(vparam.num_chunks, pdevs[0]->num_streams());
     } else if (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::SINGLE_FIRST_PDEV) {
         pdevs.erase(pdevs.begin() + 1, pdevs.end()); // Just pick first device
     } else {
@@ -314,38 +372,69 @@ shared< VirtualDev > DeviceManager::create_vdev(vdev_parameters&& vparam) {
     LOGINFO("total size of type {} in this homestore is  {}", vparam.dev_type, total_type_size)
 
     uint32_t total_created_chunks{0};
-
-    for (auto& pdev : pdevs) {
-        if (total_created_chunks >= vparam.num_chunks) break;
+    auto const alloc_chunk_ids = [this](uint32_t count) {
         std::vector< uint32_t > chunk_ids;
-
-        // the total number of chunks will be created in this pdev
-        auto total_chunk_num_in_pdev =
-            static_cast< uint32_t >(vparam.num_chunks * (pdev->data_size() / static_cast< float >(total_type_size)));
-
-        RELEASE_ASSERT(vparam.num_chunks >= total_chunk_num_in_pdev,
-                       "chunks in pdev {} is {},  larger than total chunks {} , which is expected to be created ",
-                       pdev->get_devname(), total_chunk_num_in_pdev, vparam.num_chunks);
-
-        LOGINFO("{} chunks is created on pdev {} for vdev {}, pdev data size is {}", total_chunk_num_in_pdev,
-                pdev->get_devname(), vparam.vdev_name, pdev->data_size());
-
-        // Create chunk ids for all chunks in each of these pdevs
-        for (uint32_t c{0}; c < total_chunk_num_in_pdev; ++c) {
+        for (uint32_t c{0}; c < count; ++c) {
             auto chunk_id = m_chunk_id_bm.get_next_reset_bit(0u);
             if (chunk_id == sisl::Bitset::npos) { throw std::out_of_range("System has no room for additional chunks"); }
             m_chunk_id_bm.set_bit(chunk_id);
             chunk_ids.push_back(chunk_id);
         }
+        return chunk_ids;
+    };
+
+    if (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED) {
+        // Chunks on the first pdev are the primaries and nth chunk on every other pdev mirrors the nth primary chunk.
+        // Only the primaries are added to the vdev, mirrors are reached through their primary.
+        std::vector< uint32_t > primary_chunk_ids;
+        std::vector< shared< Chunk > > primary_chunks;
+        for (auto& pdev : pdevs) {
+            auto chunk_ids = alloc_chunk_ids(vparam.num_chunks);
+            auto chunks = pdev->create_chunks(chunk_ids, vdev_id, vparam.chunk_size, primary_chunk_ids);
+            for (size_t c{0}; c < chunks.size(); ++c) {
+                m_chunks[chunks[c]->chunk_id()] = chunks[c];
+                if (!primary_chunks.empty()) { primary_chunks[c]->add_mirror_chunk(chunks[c]); }
+            }
+
+            if (primary_chunks.empty()) {
+                primary_chunk_ids = std::move(chunk_ids);
+                primary_chunks = std::move(chunks);
+            }
+            LOGINFO("{} chunks is created on pdev {} for mirrored vdev {}", vparam.num_chunks, pdev->get_devname(),
+                    vparam.vdev_name);
+            total_created_chunks += vparam.num_chunks;
+        }
 
-        // Create all chunks at one shot and add each one to the vdev
-        auto chunks = pdev->create_chunks(chunk_ids, vdev_id, vparam.chunk_size);
-        for (auto& chunk : chunks) {
+        for (auto& chunk : primary_chunks) {
             vdev->add_chunk(chunk, true /* fresh_chunk */);
-            m_chunks[chunk->chunk_id()] = chunk;
         }
+    } else {
+        for (auto& pdev : pdevs) {
+            if (total_created_chunks >= vparam.num_chunks) break;
+
+            // the total number of chunks will be created in this pdev
+            auto total_chunk_num_in_pdev = static_cast< uint32_t >(
+                vparam.num_chunks * (pdev->data_size() / static_cast< float >(total_type_size)));
+
+            RELEASE_ASSERT(vparam.num_chunks >= total_chunk_num_in_pdev,
+                           "chunks in pdev {} is {},  larger than total chunks {} , which is expected to be created ",
+                           pdev->get_devname(), total_chunk_num_in_pdev, vparam.num_chunks);
+
+            LOGINFO("{} chunks is created on pdev {} for vdev {}, pdev data size is {}", total_chunk_num_in_pdev,
+                    pdev->get_devname(), vparam.vdev_name, pdev->data_size());
 
-        total_created_chunks += total_chunk_num_in_pdev;
+            // Create chunk ids for all chunks in each of these pdevs
+            auto chunk_ids = alloc_chunk_ids(total_chunk_num_in_pdev);
+
+            // Create all chunks at one shot and add each one to the vdev
+            auto chunks = pdev->create_chunks(chunk_ids, vdev_id, vparam.chunk_size);
+            for (auto& chunk : chunks) {
+                vdev->add_chunk(chunk, true /* fresh_chunk */);
+                m_chunks[chunk->chunk_id()] = chunk;
+            }
+
+            total_created_chunks += total_chunk_num_in_pdev;
+        }
     }
 
     LOGINFO("{} chunks is created for vdev {}, expected {}", total_created_chunks, vparam.vdev_name, vparam.num_chunks);
@@ -378,10 +467,11 @@ void DeviceManager::load_vdevs() {
 
     // There are some vdevs load their chunks in each of pdev
     if (m_vdevs.size()) {
+        std::vector< shared< Chunk > > loaded_chunks;
         for (auto& pdev : m_all_pdevs) {
             // we might have some missing pdevs in the sparse_vector m_all_pdevs, so skip them
             if (!pdev) continue;
-            pdev->load_chunks([this](cshared< Chunk >& chunk) -> bool {
+            pdev->load_chunks([this, &loaded_chunks](cshared< Chunk >& chunk) -> bool {
                 // Found a chunk for which vdev information is missing
                 if (m_vdevs[chunk->vdev_id()] == nullptr) {
                     LOGWARN("Found a chunk id={}, which is expected to be part of vdev_id={}, but that vdev "
@@ -393,10 +483,33 @@ void DeviceManager::load_vdevs() {
                 m_chunk_id_bm.set_bit(chunk->chunk_id());
                 m_chunks[chunk->chunk_id()] = chunk;
                 HS_LOG(TRACE, device, "loaded chunks {} ", chunk->to_string())
-                m_vdevs[chunk->vdev_id()]->add_chunk(chunk, false /* fresh_chunk */);
+                loaded_chunks.push_back(chunk);
                 return true;
             });
         }
+
+        // Attach mirror chunks to their primary. If the pdev of a primary is missing, its first mirror takes over the
+        // primary chunk id, so that blkids and journal chunk chains carrying that id continue to be served.
+        for (auto& chunk : loaded_chunks) {
+            if (!chunk->is_mirror()) { continue; }
+            auto it = m_chunks.find(chunk->primary_chunk_id());
+            if (it == m_chunks.end()) {
+                LOGWARN("Primary chunk id={} of mirror chunk id={} vdev_id={} is missing, promoting the mirror as "
+                        "primary",
+                        chunk->primary_chunk_id(), chunk->chunk_id(), chunk->vdev_id());
+                m_chunk_id_bm.set_bit(chunk->primary_chunk_id());
+                m_chunks[chunk->primary_chunk_id()] = chunk;
+            } else {
+                it->second->add_mirror_chunk(chunk);
+            }
+        }
+
+        for (auto& chunk : loaded_chunks) {
+            if (m_chunks[chunk->primary_chunk_id()] != chunk) { continue; }
+            auto& vdev = m_vdevs[chunk->vdev_id()];
+            if (vdev->num_mirrors() != 0) { sync_mirrors(chunk.get(), vdev->num_mirrors() + 1); }
+            vdev->add_chunk(chunk, false /* fresh_chunk */);
+        }
     }
 
     // Run initialization of all vdevs.
@@ -405,6 +518,58 @@ void DeviceManager::load_vdevs() {
     }
 }
 
+void DeviceManager::sync_mirrors(Chunk* chunk, uint32_t num_replicas) {
+    std::vector< Chunk* > replicas{chunk};
+    for (auto& mirror : chunk->mirror_chunks()) {
+        replicas.push_back(mirror.get());
+    }
+
+    Chunk* src{chunk};
+    for (auto* replica : replicas) {
+        if (replica->mirror_gen() > src->mirror_gen()) { src = replica; }
+    }
+    uint32_t const gen = src->mirror_gen();
+
+    // Replicas of older generation have missed writes which the source replica got, copy the chunk over before they
+    // are read from. If the copy fails, the replica is excluded from reads until the next restart retries it.
+    static constexpr uint64_t copy_size{1024 * 1024};
+    auto* src_pdev = src->physical_dev_mutable();
+    auto buf = hs_utils::iobuf_alloc(copy_size, sisl::buftag::common, src_pdev->align_size());
+    for (auto* replica : replicas) {
+        if (replica->mirror_gen() == gen) { continue; }
+        LOGINFO("Resyncing mirror chunk id={} pdev={} gen={} from chunk id={} pdev={} gen={}", replica->chunk_id(),
+                replica->physical_dev()->get_devname(), replica->mirror_gen(), src->chunk_id(),
+                src_pdev->get_devname(), gen);
+
+        auto* pdev = replica->physical_dev_mutable();
+        std::error_code err;
+        for (uint64_t off{0}; !err && (off < src->size()); off += copy_size) {
+            auto const sz = uint32_t(std::min(copy_size, src->size() - off));
+            err = src_pdev->sync_read(r_cast< char* >(buf), sz, src->start_offset() + off);
+            if (!err) { err = pdev->sync_write(r_cast< const char* >(buf), sz, replica->start_offset() + off); }
+        }
+
+        if (err) {
+            LOGERROR("Resync of mirror chunk id={} pdev={} failed error={}, excluding it from reads",
+                     replica->chunk_id(), pdev->get_devname(), err.message());
+            replica->mark_stale();
+        } else {
+            replica->set_mirror_gen(gen);
+        }
+    }
+    hs_utils::iobuf_free(buf, sisl::buftag::common);
+
+    // Writes from here on miss the absent replicas. Move the present ones to a newer generation, so that the absent
+    // ones are resynced when their pdev comes back.
+    if (replicas.size() < num_replicas) {
+        LOGWARN("Chunk id={} vdev_id={} has {} of {} replicas, moving them to mirror gen={}", chunk->chunk_id(),
+                chunk->vdev_id(), replicas.size(), num_replicas, gen + 1);
+        for (auto* replica : replicas) {
+            if (!replica->is_stale()) { replica->set_mirror_gen(gen + 1); }
+        }
+    }
+}
+
 shared< Chunk > DeviceManager::create_chunk(HSDevType dev_type, uint32_t vdev_id, uint64_t chunk_size,
                                             const sisl::blob& data) {
     std::unique_lock lg{m_vdev_mutex};
@@ -426,10 +591,25 @@ shared< Chunk > DeviceManager::create_chunk(HSDevType dev_type, uint32_t vdev_id
     }
 
     if (!chunk) { throw std::out_of_range("Unable to create chunk on physical devices"); }
+    m_chunks[chunk->chunk_id()] = chunk;
 
     auto vdev = m_vdevs[vdev_id];
+    std::vector< PhysicalDev* > sb_pdevs{pdev};
+    if (vdev->info().multi_pdev_choice == s_cast< uint8_t >(vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED)) {
+        // Mirror the chunk on every other pdev of the device type, with the same private data
+        for (const auto& dev : pdevs) {
+            if (dev == pdev) { continue; }
+            auto mirror_id = m_chunk_id_bm.get_next_reset_bit(0u);
+            if (mirror_id == sisl::Bitset::npos) { throw std::out_of_range("System has no room for mirror chunk"); }
+            m_chunk_id_bm.set_bit(mirror_id);
+
+            auto mirror = dev->create_chunk(mirror_id, vdev_id, chunk_size, 0 /* ordinal */, data, chunk_id);
+            chunk->add_mirror_chunk(mirror);
+            m_chunks[mirror->chunk_id()] = mirror;
+            sb_pdevs.push_back(dev);
+        }
+    }
     vdev->add_chunk(chunk, true /* fresh_chunk */);
-    m_chunks[chunk->chunk_id()] = chunk;
 
     auto buf = hs_utils::iobuf_alloc(vdev_info::size, sisl::buftag::superblk, pdev->align_size());
     auto vdev_info = vdev->info();
@@ -441,7 +621,9 @@ shared< Chunk > DeviceManager::create_chunk(HSDevType dev_type, uint32_t vdev_id
     vdev->update_info(vdev_info);
     std::memcpy(buf, &vdev_info, sizeof(vdev_info));
     uint64_t offset = hs_super_blk::vdev_sb_offset() + (vdev_id * vdev_info::size);
-    pdev->write_super_block(buf, vdev_info::size, offset);
+    for (auto& sb_pdev : sb_pdevs) {
+        sb_pdev->write_super_block(buf, vdev_info::size, offset);
+    }
     hs_utils::iobuf_free(buf, sisl::buftag::superblk);
 
     HS_LOG(DEBUG, device, "Created chunk_id={} dev_type={} vdev_id={} size={}", chunk_id, (uint8_t)dev_type, vdev_id,
@@ -471,6 +653,17 @@ void DeviceManager::remove_chunk_locked(shared< Chunk > chunk) {
 
     m_chunks.erase(chunk_id);
 
+    // Mirrors go along with the primary. A mirror which took over a missing primary also releases the primary id.
+    for (auto& mirror : chunk->mirror_chunks()) {
+        m_chunk_id_bm.reset_bit(mirror->chunk_id());
+        mirror->physical_dev_mutable()->remove_chunk(mirror);
+        m_chunks.erase(mirror->chunk_id());
+    }
+    if (chunk->is_mirror()) {
+        m_chunk_id_bm.reset_bit(chunk->primary_chunk_id());
+        m_chunks.erase(chunk->primary_chunk_id());
+    }
+
     // Update the vdev info.
     auto buf = hs_utils::iobuf_alloc(vdev_info::size, sisl::buftag::superblk, pdev->align_size());
     auto vdev_info = vdev->info();
@@ -482,6 +675,9 @@ void DeviceManager::remove_chunk_locked(shared< Chunk > chunk) {
     std::memcpy(buf, &vdev_info, sizeof(vdev_info));
     uint64_t offset = hs_super_blk::vdev_sb_offset() + (vdev_id * vdev_info::size);
     pdev->write_super_block(buf, vdev_info::size, offset);
+    for (auto& mirror : chunk->mirror_chunks()) {
+        mirror->physical_dev_mutable()->write_super_block(buf, vdev_info::size, offset);
+    }
     hs_utils::iobuf_free(buf, sisl::buftag::superblk);
 
     HS_LOG(DEBUG, device, "Removed chunk_id={} vdev_id={}", chunk_id, vdev_id);
@@ -526,7 +722,8 @@ static void populate_vdev_info(const vdev_parameters& vparam, uint32_t vdev_id,
                                const std::vector< PhysicalDev* >& pdevs, vdev_info* out_info) {
     out_info->vdev_size = vparam.vdev_size;
     out_info->vdev_id = vdev_id;
-    out_info->num_mirrors = (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED) ? pdevs.size() : 0;
+    out_info->num_mirrors =
+        (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED) ? uint32_cast(pdevs.size() - 1) : 0;
     out_info->blk_size = vparam.blk_size;
     out_info->num_primary_chunks =
         (vparam.multi_pdev_opts == vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED) ? pdevs.size() : 1u;
@@ -540,6 +737,7 @@ static void populate_vdev_info(const vdev_parameters& vparam, uint32_t vdev_id,
     out_info->chunk_sel_type = s_cast< uint8_t >(vparam.chunk_sel_type);
     out_info->size_type = vparam.size_type;
     out_info->use_slab_allocator = vparam.use_slab_allocator ? 1 : 0;
+    out_info->enable_discard = vparam.enable_discard ? 1 : 0;
     out_info->compute_checksum();
 }
 
@@ -604,8 +802,9 @@ std::vector< shared< Chunk > > DeviceManager::get_chunks() const {
     std::unique_lock lg{m_vdev_mutex};
     std::vector< shared< Chunk > > res;
     res.reserve(m_chunks.size());
-    for (auto& [_, chunk] : m_chunks) {
-        if (chunk) res.push_back(chunk);
+    for (auto& [chunk_id, chunk] : m_chunks) {
+        // Skip the entries of the missing primary chunks, which are served by their mirror
+        if (chunk && (chunk->chunk_id() == chunk_id)) res.push_back(chunk);
     }
     return res;
 }
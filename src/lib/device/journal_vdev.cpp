@@ -83,7 +83,8 @@ void JournalVirtualDev::init() {
     // Traverse the chunks and find the heads of the logdev_id's.
     for (auto& [_, chunk] : m_all_chunks) {
         auto* data = r_cast< JournalChunkPrivate* >(const_cast< uint8_t* >(chunk->user_private()));
-        auto chunk_id = chunk->chunk_id();
+        // Chunk chains are linked through primary chunk ids, which a mirror keeps serving if the primary is missing
+        auto chunk_id = chunk->primary_chunk_id();
         auto logdev_id = data->logdev_id;
         // Create index for chunks.
         chunk_map[chunk_id] = chunk;
@@ -123,7 +124,7 @@ void JournalVirtualDev::init() {
     // Remove chunk will affect the m_all_chunks so keep a separate list.
     std::vector< shared< Chunk > > orphan_chunks;
     for (auto& [_, chunk] : m_all_chunks) {
-        if (!visited_chunks.count(chunk->chunk_id())) { orphan_chunks.push_back(chunk); }
+        if (!visited_chunks.count(chunk->primary_chunk_id())) { orphan_chunks.push_back(chunk); }
     }
 
     // Remove the orphan chunks.
@@ -166,6 +167,14 @@ void JournalVirtualDev::release_chunk_to_pool(shared< Chunk > chunk) {
     LOGINFOMOD(journalvdev, "Released chunk to pool {}", chunk->to_string());
 }
 
+void JournalVirtualDev::discard_and_release_chunk(shared< Chunk > chunk) {
+    // The chunk is no longer part of any logdev, so discard its truncated log before it is reused from the pool.
+    m_dmgr.run_discard([this, chunk]() mutable {
+        if (is_discard_enabled()) { discard(chunk.get(), 0, chunk->size()); }
+        release_chunk_to_pool(chunk);
+    });
+}
+
 void JournalVirtualDev::update_chunk_private(shared< Chunk >& chunk, JournalChunkPrivate* private_data) {
     sisl::blob private_blob{r_cast< uint8_t* >(private_data), sizeof(JournalChunkPrivate)};
     chunk->set_user_private(private_blob);
@@ -225,7 +234,7 @@ void JournalVirtualDev::Descriptor::append_chunk() {
         auto* last_chunk_private = r_cast< JournalChunkPrivate* >(const_cast< uint8_t* >(last_chunk->user_private()));
 
         // Set the next chunk with the newly created chunk id.
-        last_chunk_private->next_chunk = new_chunk->chunk_id();
+        last_chunk_private->next_chunk = new_chunk->primary_chunk_id();
 
         // Append the new chunk
         m_journal_chunks.push_back(new_chunk);
@@ -655,7 +664,11 @@ off_t JournalVirtualDev::Descriptor::truncate(off_t truncate_offset) {
                        "Released chunk_id={} log_dev={} cover={} truncate_offset={} tail={} end_of_chunk={} desc {}",
                        chunk->chunk_id(), m_logdev_id, to_hex(cover_offset), to_hex(truncate_offset), to_hex(tail_off),
                        m_vdev.get_end_of_chunk(chunk), to_string());
-            m_vdev.release_chunk_to_pool(chunk);
+            if (m_vdev.is_discard_enabled()) {
+                m_truncated_chunks.push_back(std::move(chunk));
+            } else {
+                m_vdev.release_chunk_to_pool(chunk);
+            }
         } else {
             ++it;
         }
@@ -686,6 +699,13 @@ off_t JournalVirtualDev::Descriptor::truncate(off_t truncate_offset) {
     return data_start_offset();
 }
 
+void JournalVirtualDev::Descriptor::release_truncated_chunks() {
+    for (auto& chunk : m_truncated_chunks) {
+        m_vdev.discard_and_release_chunk(std::move(chunk));
+    }
+    m_truncated_chunks.clear();
+}
+
 #if 0
 uint64_t JournalVirtualDev::Descriptor::get_offset_in_dev(uint32_t dev_id, uint32_t chunk_id, uint64_t offset_in_chunk) const {
     return get_chunk_start_offset(dev_id, chunk_id) + offset_in_chunk;
@@ -69,6 +69,8 @@ public:
         uint64_t m_total_size{0};                        // Total size of all chunks.
         off_t m_end_offset{0};        // Offset right to window. Never reduced. Increased in multiple of chunk size.
         bool m_end_offset_set{false}; // Adjust the m_end_offset only once during init.
+        // Truncated chunks waiting for the new start offset to be persisted, before they are discarded and released
+        std::vector< shared< Chunk > > m_truncated_chunks;
         friend class JournalVirtualDev;
 
     public:
@@ -279,6 +281,13 @@ public:
          */
         off_t truncate(off_t truncate_offset);
 
+        /**
+         * @brief : With discard enabled, chunks truncated away are held back by truncate, since the log in them is
+         * still needed till the caller persists the new start offset. Once persisted, this discards those chunks in the
+         * background and then releases them to the chunk pool.
+         */
+        void release_truncated_chunks();
+
         /**
          * @brief : get the total size in journal
          *
@@ -418,6 +427,7 @@ public:
 
     void remove_journal_chunks(std::vector< shared< Chunk > >& chunks);
     void release_chunk_to_pool(shared< Chunk > chunk);
+    void discard_and_release_chunk(shared< Chunk > chunk);
     void update_chunk_private(shared< Chunk >& chunk, JournalChunkPrivate* chunk_private);
     uint64_t get_end_of_chunk(shared< Chunk >& chunk) const;
 
@@ -18,6 +18,13 @@
 #include <stdexcept>
 #include <system_error>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#endif
+
 #include <folly/Exception.h>
 #include <iomgr/iomgr.hpp>
 #include <iomgr/iomgr_flip.hpp>
@@ -112,6 +119,17 @@ PhysicalDev::PhysicalDev(const dev_info& dinfo, int oflags, const pdev_info_head
         m_streams.emplace_back(i);
     }
     m_super_blk_in_footer = m_pdev_info.mirror_super_block;
+
+#ifdef __linux__
+    // Discard is issued directly on the device fd, hence is limited to the kernel drives.
+    if (!iomanager.is_spdk_mode()) {
+        struct stat st;
+        if (::fstat(m_iodev->fd(), &st) == 0) {
+            m_is_file = S_ISREG(st.st_mode);
+            m_discard_supported.store(m_is_file || S_ISBLK(st.st_mode), std::memory_order_relaxed);
+        }
+    }
+#endif
 }
 
 PhysicalDev::~PhysicalDev() { close_device(); }
@@ -218,6 +236,39 @@ std::error_code PhysicalDev::sync_write_zero(uint64_t size, uint64_t offset) {
 
 void PhysicalDev::submit_batch() { m_drive_iface->submit_batch(); }
 
+std::error_code PhysicalDev::sync_discard(uint64_t size, uint64_t offset) {
+    if (!is_discard_supported()) { return std::make_error_code(std::errc::operation_not_supported); }
+
+    COUNTER_INCREMENT(m_metrics, drive_discard_count, 1);
+    auto const start_time = Clock::now();
+    int ret{-1};
+#ifdef __linux__
+    if (m_is_file) {
+        ret = ::fallocate(m_iodev->fd(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, s_cast< off_t >(offset),
+                          s_cast< off_t >(size));
+    } else {
+        uint64_t range[2]{offset, size};
+        ret = ::ioctl(m_iodev->fd(), BLKDISCARD, &range);
+    }
+#else
+    errno = EOPNOTSUPP;
+#endif
+    if (ret != 0) {
+        auto const err = errno;
+        COUNTER_INCREMENT(m_metrics, drive_discard_errors, 1);
+        if ((err == EOPNOTSUPP) || (err == ENOTTY)) {
+            LOGWARN("Device {} does not support discard, disabling discard on it", m_devname);
+            m_discard_supported.store(false, std::memory_order_relaxed);
+        } else {
+            HS_LOG(ERROR, device, "Discard failed on dev={} offset={} size={} errno={}", m_devname, offset, size, err);
+        }
+        return std::error_code{err, std::system_category()};
+    }
+    COUNTER_INCREMENT(m_metrics, drive_discard_bytes, size);
+    HISTOGRAM_OBSERVE(m_metrics, drive_discard_latency, get_elapsed_time_us(start_time));
+    return std::error_code{};
+}
+
 //////////////////////////// Chunk Creation/Load related methods /////////////////////////////////////////
 void PhysicalDev::format_chunks() {
     m_chunk_info_slots = std::make_unique< sisl::Bitset >(hs_super_blk::chunk_info_bitmap_size(m_dev_info));
@@ -226,7 +277,8 @@ void PhysicalDev::format_chunks() {
 }
 
 std::vector< shared< Chunk > > PhysicalDev::create_chunks(const std::vector< uint32_t >& chunk_ids, uint32_t vdev_id,
-                                                          uint64_t size) {
+                                                          uint64_t size,
+                                                          const std::vector< uint32_t >& primary_chunk_ids) {
     std::vector< shared< Chunk > > ret_chunks;
     std::unique_lock lg{m_chunk_op_mtx};
     auto chunks_remaining = chunk_ids.size();
@@ -242,7 +294,8 @@ std::vector< shared< Chunk > > PhysicalDev::create_chunks(const std::vector< uin
             auto ptr = buf;
             for (auto cslot = b.start_bit; cslot < b.start_bit + b.nbits; ++cslot, ++cit, ptr += chunk_info::size) {
                 chunk_info* cinfo = new (ptr) chunk_info();
-                populate_chunk_info(cinfo, vdev_id, size, chunk_ids[cit], cit, {});
+                populate_chunk_info(cinfo, vdev_id, size, chunk_ids[cit], cit, {},
+                                    primary_chunk_ids.empty() ? INVALID_CHUNK_ID : primary_chunk_ids[cit]);
 
                 auto chunk = std::make_shared< Chunk >(this, *cinfo, cslot);
                 ret_chunks.push_back(chunk);
@@ -273,7 +326,7 @@ std::vector< shared< Chunk > > PhysicalDev::create_chunks(const std::vector< uin
 }
 
 shared< Chunk > PhysicalDev::create_chunk(uint32_t chunk_id, uint32_t vdev_id, uint64_t size, uint32_t ordinal,
-                                          const sisl::blob& user_private) {
+                                          const sisl::blob& user_private, uint32_t primary_chunk_id) {
     std::unique_lock lg{m_chunk_op_mtx};
 
     // We need to alloc a slot to store the chunk_info in the super blk
@@ -287,7 +340,7 @@ shared< Chunk > PhysicalDev::create_chunk(uint32_t chunk_id, uint32_t vdev_id, u
     shared< Chunk > chunk;
 
     try {
-        populate_chunk_info(cinfo, vdev_id, size, chunk_id, ordinal, user_private);
+        populate_chunk_info(cinfo, vdev_id, size, chunk_id, ordinal, user_private, primary_chunk_id);
 
         // Locate and write the chunk info in the super blk area
         write_super_block(buf, chunk_info::size, chunk_info_offset_nth(cslot));
@@ -408,7 +461,7 @@ uint64_t PhysicalDev::chunk_info_offset_nth(uint32_t slot) const {
 }
 
 void PhysicalDev::populate_chunk_info(chunk_info* cinfo, uint32_t vdev_id, uint64_t size, uint32_t chunk_id,
-                                      uint32_t ordinal, const sisl::blob& private_data) {
+                                      uint32_t ordinal, const sisl::blob& private_data, uint32_t primary_chunk_id) {
     // Find the free area for chunk data within between data_start_offset() and data_end_offset()
     auto ival = find_next_chunk_area(size);
     m_chunk_data_area.insert(ival);
@@ -420,6 +473,7 @@ void PhysicalDev::populate_chunk_info(chunk_info* cinfo, uint32_t vdev_id, uint6
     cinfo->chunk_ordinal = ordinal;
     cinfo->set_allocated();
     cinfo->set_user_private(private_data);
+    if (primary_chunk_id != INVALID_CHUNK_ID) { cinfo->set_mirror_of(primary_chunk_id); }
     cinfo->compute_checksum();
     auto [_, inserted] = m_chunk_start.insert(cinfo->chunk_start_offset);
     RELEASE_ASSERT(inserted, "Duplicate start offset {} for chunk {}", cinfo->chunk_start_offset, cinfo->chunk_id);
@@ -13,6 +13,7 @@
  *
  *********************************************************************************/
 #pragma once
+#include <atomic>
 #include <vector>
 #include <string>
 #include "hs_super_blk.h"
@@ -47,9 +48,13 @@ public:
         REGISTER_COUNTER(drive_write_errors, "Total drive write errors");
         REGISTER_COUNTER(drive_spurios_events, "Total number of spurious events per drive");
         REGISTER_COUNTER(drive_skipped_chunk_bm_writes, "Total number of skipped writes for chunk bitmap");
+        REGISTER_COUNTER(drive_discard_count, "Drive discard count");
+        REGISTER_COUNTER(drive_discard_bytes, "Total bytes discarded on the drive");
+        REGISTER_COUNTER(drive_discard_errors, "Total drive discard errors");
 
         REGISTER_HISTOGRAM(drive_write_latency, "BlkStore drive write latency in us");
         REGISTER_HISTOGRAM(drive_read_latency, "BlkStore drive read latency in us");
+        REGISTER_HISTOGRAM(drive_discard_latency, "BlkStore drive discard latency in us");
 
         REGISTER_HISTOGRAM(write_io_sizes, "Write IO Sizes", "io_sizes", {"io_direction", "write"},
                            HistogramBucketsType(ExponentialOfTwoBuckets));
@@ -85,7 +90,10 @@ struct chunk_info {
     uint32_t chunk_ordinal{0};     // 32: Chunk ordinal within the vdev on this pdev
     uint8_t chunk_allocated{0x00}; // 36: Is chunk allocated or free
     uint16_t checksum{0};          // 37: checksum of this chunk info
-    uint8_t padding[25]{};         // 39: pad to make it 128 bytes total
+    uint8_t is_mirror{0x00};       // 39: Is this chunk a mirror of a primary chunk on another pdev
+    uint32_t primary_chunk_id{0};  // 40: Chunk id of the primary chunk, if this chunk is a mirror
+    uint32_t mirror_gen{0};        // 44: Replicas with generation lower than the highest among them have missed writes
+    uint8_t padding[16]{};         // 48: pad to make it 128 bytes total
     uint8_t chunk_selector_private[selector_private_size]{}; // 64: Chunk selector private area
     uint8_t user_private[user_private_size]{};               // 128: Opaque user of the chunk information
 
@@ -94,6 +102,11 @@ struct chunk_info {
     bool is_allocated() const { return (chunk_allocated != 0x00); }
     void set_allocated() { chunk_allocated = 0x01; }
     void set_free() { chunk_allocated = 0x00; }
+    bool is_mirror_chunk() const { return (is_mirror != 0x00); }
+    void set_mirror_of(uint32_t primary_id) {
+        is_mirror = 0x01;
+        primary_chunk_id = primary_id;
+    }
 
     void set_selector_private(const sisl::blob& data) {
         std::memcpy(&chunk_selector_private, data.cbytes(), std::min(data.size(), uint32_cast(selector_private_size)));
@@ -137,6 +150,9 @@ private:
     std::unique_ptr< sisl::Bitset > m_chunk_info_slots; // Slots to write the chunk info
     uint32_t m_chunk_sb_size{0};                        // Total size of the chunk sb at present
     std::unordered_set< uint64_t > m_chunk_start;       // Store and verify start offset of all chunks for debugging.
+    bool m_is_file{false};                              // Is the device a regular file instead of a block device
+    std::atomic< bool > m_discard_supported{false};     // Can the freed ranges be discarded on this device
+    std::atomic< int64_t > m_outstanding_ios{0};        // Mirrored vdev ios issued and not yet completed
 
 public:
     PhysicalDev(const dev_info& dinfo, int oflags, const pdev_info_header& pinfo);
@@ -163,9 +179,10 @@ public:
     /// list, thus first chunk id is assigned with ordinal 0, then next with 1 etc..
     /// @param vdev_id: Vdev this chunk should be part of.
     /// @param size: Size of each chunk
+    /// @param primary_chunk_ids: If not empty, nth chunk is created as a mirror of nth chunk id in this list
     /// @return Vector of chunks that are created
     std::vector< shared< Chunk > > create_chunks(const std::vector< uint32_t >& chunk_ids, uint32_t vdev_id,
-                                                 uint64_t size);
+                                                 uint64_t size, const std::vector< uint32_t >& primary_chunk_ids = {});
 
     /// @brief Create a chunks on this device. In case of unavailable space it throws the std::out_of_range exception
     ///
@@ -175,9 +192,10 @@ public:
     /// @param ordinal: Ordinal for a pdev within the vdev. This is useful to match similar vdevs from different pdevs
     /// for mirroring
     /// @param private_data: data to be stored in chunk private space.
+    /// @param primary_chunk_id: If valid, chunk is created as a mirror of this chunk id
     /// @return Shared instance of chunk class created
     shared< Chunk > create_chunk(uint32_t chunk_id, uint32_t vdev_id, uint64_t size, uint32_t ordinal,
-                                 const sisl::blob& private_data = {});
+                                 const sisl::blob& private_data = {}, uint32_t primary_chunk_id = INVALID_CHUNK_ID);
 
     void load_chunks(std::function< bool(cshared< Chunk >&) >&& chunk_found_cb);
     void remove_chunks(std::vector< shared< Chunk > >& chunks);
@@ -216,6 +234,23 @@ public:
     std::error_code sync_write_zero(uint64_t size, uint64_t offset);
     void submit_batch();
 
+    /// @brief Discard (TRIM/unmap) the given range, so that the drive can reclaim it. Regular files, which are used
+    /// as devices in tests, get the range punched out as a hole instead. Once the device reports discard is not
+    /// supported, subsequent calls return error without going to the device.
+    ///
+    /// @param size: Size of the range to discard
+    /// @param offset: Offset of the range within the device
+    /// @return Error code if discard failed or is not supported
+    std::error_code sync_discard(uint64_t size, uint64_t offset);
+    bool is_discard_supported() const { return m_discard_supported.load(std::memory_order_relaxed); }
+
+    /// @brief Number of reads and writes issued to the mirrored vdev chunks on this device which are not completed
+    /// yet. Used to pick the least loaded replica while reading from a mirrored vdev. Ios of other vdevs are not
+    /// tracked, hence they are counted by the mirrored vdev itself around each io.
+    int64_t outstanding_ios() const { return m_outstanding_ios.load(std::memory_order_relaxed); }
+    void io_issued() { m_outstanding_ios.fetch_add(1, std::memory_order_relaxed); }
+    void io_completed() { m_outstanding_ios.fetch_sub(1, std::memory_order_relaxed); }
+
     ///////////// Parameters Getters ///////////////////////
     uint32_t optimal_page_size() const { return m_pdev_info.dev_attr.phys_page_size; }
     uint32_t align_size() const { return m_pdev_info.dev_attr.align_size; }
@@ -233,7 +268,7 @@ public:
 private:
     void do_remove_chunk(cshared< Chunk >& chunk);
     void populate_chunk_info(chunk_info* cinfo, uint32_t vdev_id, uint64_t size, uint32_t chunk_id, uint32_t ordinal,
-                             const sisl::blob& private_data);
+                             const sisl::blob& private_data, uint32_t primary_chunk_id);
     void free_chunk_info(chunk_info* cinfo);
     ChunkInterval find_next_chunk_area(uint64_t size) const;
 };
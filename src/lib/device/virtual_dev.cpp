@@ -13,6 +13,7 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
@@ -32,8 +33,10 @@
 #include <sisl/metrics/metrics.hpp>
 #include <sisl/logging/logging.h>
 #include <sisl/utility/atomic_counter.hpp>
+#include <iomgr/iomgr.hpp>
 #include <iomgr/iomgr_flip.hpp>
 #include <homestore/homestore_decl.hpp>
+#include <homestore/work_sharing.hpp>
 
 #include "device/chunk.h"
 #include "device/physical_dev.hpp"
@@ -94,7 +97,8 @@ VirtualDev::VirtualDev(DeviceManager& dmgr, vdev_info const& vinfo, vdev_event_c
         m_allocator_type{vinfo.alloc_type},
         m_chunk_selector_type{vinfo.chunk_sel_type},
         m_auto_recovery{is_auto_recovery},
-        m_use_slab_in_blk_allocator{vinfo.use_slab_allocator ? true : false} {
+        m_use_slab_in_blk_allocator{vinfo.use_slab_allocator ? true : false},
+        m_discard_enabled{vinfo.enable_discard ? true : false} {
     switch (m_chunk_selector_type) {
     case chunk_selector_type_t::ROUND_ROBIN: {
         m_chunk_selector = std::make_shared< RoundRobinChunkSelector >(false /* dynamically add chunk */);
@@ -119,18 +123,21 @@ void VirtualDev::add_chunk(cshared< Chunk >& chunk, bool is_fresh_chunk) {
     std::unique_lock lg{m_mgmt_mutex};
     auto ba = create_blk_allocator(m_allocator_type, block_size(), chunk->physical_dev()->optimal_page_size(),
                                    chunk->physical_dev()->align_size(), chunk->size(), m_auto_recovery,
-                                   chunk->chunk_id(), is_fresh_chunk, m_use_slab_in_blk_allocator);
+                                   chunk->primary_chunk_id(), is_fresh_chunk, m_use_slab_in_blk_allocator);
     chunk->set_block_allocator(std::move(ba));
     // TODO: when vdev_ordinal is  used, revisit here to make sure it is set correctly;
     chunk->set_vdev_ordinal(m_total_chunk_num++);
     m_pdevs.insert(chunk->physical_dev_mutable());
-    m_all_chunks[chunk->chunk_id()] = chunk;
+    for (auto& mirror : chunk->mirror_chunks()) {
+        m_pdevs.insert(mirror->physical_dev_mutable());
+    }
+    m_all_chunks[chunk->primary_chunk_id()] = chunk;
     m_chunk_selector->add_chunk(chunk);
 }
 
 void VirtualDev::remove_chunk(cshared< Chunk >& chunk) {
     std::unique_lock lg{m_mgmt_mutex};
-    m_all_chunks.erase(chunk->chunk_id());
+    m_all_chunks.erase(chunk->primary_chunk_id());
     m_total_chunk_num--;
     m_chunk_selector->remove_chunk(chunk);
 }
@@ -144,6 +151,10 @@ folly::Future< std::error_code > VirtualDev::async_format() {
         LOGINFO("writing zero for chunk: {}, size: {}, offset: {}", chunk->chunk_id(), in_bytes(chunk->size()),
                 chunk->start_offset());
         s_futs.emplace_back(pdev->async_write_zero(chunk->size(), chunk->start_offset()));
+        for (auto& mirror : chunk->mirror_chunks()) {
+            auto* mirror_pdev = mirror->physical_dev_mutable();
+            s_futs.emplace_back(mirror_pdev->async_write_zero(mirror->size(), mirror->start_offset()));
+        }
     }
     return folly::collectAllUnsafe(s_futs).thenTry([](auto&& t) {
         for (const auto& err_c : t.value()) {
@@ -271,6 +282,65 @@ BlkAllocStatus VirtualDev::alloc_blks(blk_count_t nblks, blk_alloc_hints const&
     return status;
 }
 
+BlkAllocStatus VirtualDev::alloc_blks_batch(std::span< blk_count_t const > nblks_list, blk_alloc_hints const& hints,
+                                            std::vector< MultiBlkId >& out_blkids) {
+    out_blkids.clear();
+    out_blkids.resize(nblks_list.size());
+    if (nblks_list.empty()) { return BlkAllocStatus::SUCCESS; }
+
+    auto h = hints;
+    h.partial_alloc_ok = false;
+
+    BlkAllocStatus status{BlkAllocStatus::SUCCESS};
+    size_t nallocated{0};
+    try {
+        // Select the chunk once for the entire batch, sized for the total blks of the batch
+        Chunk* chunk;
+        if (h.chunk_id_hint) {
+            chunk = m_dmgr.get_chunk_mutable(*(h.chunk_id_hint));
+            if (!chunk) { return BlkAllocStatus::INVALID_DEV; }
+        } else {
+            uint64_t total_nblks{0};
+            for (auto const nblks : nblks_list) {
+                total_nblks += nblks;
+            }
+            chunk = m_chunk_selector
+                        ->select_chunk(s_cast< blk_count_t >(std::min(total_nblks, uint64_cast(max_blks_per_blkid()))), h)
+                        .get();
+        }
+
+        for (; nallocated < nblks_list.size(); ++nallocated) {
+            auto const nblks = nblks_list[nallocated];
+            auto& out_blkid = out_blkids[nallocated];
+            status = chunk ? alloc_blks_from_chunk(nblks, h, out_blkid, chunk) : BlkAllocStatus::SPACE_FULL;
+            if (status == BlkAllocStatus::SUCCESS) { continue; }
+
+            // Selected chunk doesn't have room for rest of the batch, go through the regular path, which looks for
+            // other chunks and use the chunk it picked for rest of the batch.
+            if (h.chunk_id_hint || !h.can_look_for_other_chunk) { break; }
+            out_blkid = MultiBlkId{};
+            status = alloc_blks(nblks, h, out_blkid);
+            if (status != BlkAllocStatus::SUCCESS) { break; }
+            chunk = m_dmgr.get_chunk_mutable(out_blkid.chunk_num());
+        }
+    } catch (const std::exception& e) {
+        LOGERROR("exception happened {}", e.what());
+        assert(false);
+        status = BlkAllocStatus::FAILED;
+    }
+
+    if (status != BlkAllocStatus::SUCCESS) {
+        LOGERROR("Failed to alloc blks for batch of {} requests, allocated only for {} requests, status={}",
+                 nblks_list.size(), nallocated, enum_name(status));
+        for (size_t i{0}; i < nallocated; ++i) {
+            free_blk(out_blkids[i]);
+        }
+        out_blkids.clear();
+        COUNTER_INCREMENT(m_metrics, vdev_num_alloc_failure, 1);
+    }
+    return status;
+}
+
 BlkAllocStatus VirtualDev::alloc_blks_from_chunk(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId& out_blkid,
                                                  Chunk* chunk) {
 #ifdef _PRERELEASE
@@ -322,6 +392,252 @@ uint64_t VirtualDev::get_len(const iovec* iov, int iovcnt) {
     return len;
 }
 
+////////////////////////// mirrored io section //////////////////////////////////
+#ifdef _PRERELEASE
+static bool simulate_replica_io_error(Chunk const* replica, std::string const& op_type) {
+    return iomgr_flip::instance()->test_flip("simulate_mirror_io_error", replica->physical_dev()->get_devname(),
+                                             op_type);
+}
+#endif
+
+// A chunk of a mirrored vdev has the same data at the same offset on each of its mirror chunks. Writes are issued to
+// all the replicas and reads are served by the least loaded replica, falling back to the others on error. Only the ios
+// on replicas are counted as outstanding on their pdev, for the load based read selection. For chunks without
+// mirrors, these reduce to issuing the io on the chunk itself.
+template < typename IOFn >
+folly::Future< std::error_code > VirtualDev::write_replicas(Chunk* chunk, uint64_t offset_in_chunk, bool part_of_batch,
+                                                            IOFn&& io_fn) {
+    if (chunk->mirror_chunks().empty()) {
+        return io_fn(chunk->physical_dev_mutable(), chunk->start_offset() + offset_in_chunk, part_of_batch);
+    }
+
+    // Queue the write on all replicas as one batch, unless caller is going to submit the batch itself
+    std::vector< Chunk* > replicas = all_replicas(chunk);
+    std::vector< folly::Future< std::error_code > > futs;
+    futs.reserve(replicas.size());
+    for (auto* replica : replicas) {
+#ifdef _PRERELEASE
+        if (simulate_replica_io_error(replica, "WRITE")) {
+            futs.emplace_back(folly::makeFuture(std::make_error_code(std::errc::io_error)));
+            continue;
+        }
+#endif
+        auto* pdev = replica->physical_dev_mutable();
+        pdev->io_issued();
+        futs.emplace_back(
+            io_fn(pdev, replica->start_offset() + offset_in_chunk, true).ensure([pdev]() { pdev->io_completed(); }));
+    }
+    if (!part_of_batch) { chunk->physical_dev_mutable()->submit_batch(); }
+
+    return folly::collectAllUnsafe(futs).thenValue(
+        [this, replicas = std::move(replicas)](std::vector< folly::Try< std::error_code > >&& results) {
+            std::vector< std::error_code > errs;
+            errs.reserve(results.size());
+            for (auto& t : results) {
+                errs.push_back(t.hasValue() ? t.value() : std::make_error_code(std::errc::io_error));
+            }
+            std::vector< Chunk* > gen_changed;
+            auto err = replicas_written(replicas, errs, gen_changed);
+            return persist_mirror_gens(std::move(gen_changed), err);
+        });
+}
+
+template < typename IOFn >
+std::error_code VirtualDev::sync_write_replicas(Chunk* chunk, uint64_t offset_in_chunk, IOFn&& io_fn) {
+    if (chunk->mirror_chunks().empty()) {
+        return io_fn(chunk->physical_dev_mutable(), chunk->start_offset() + offset_in_chunk);
+    }
+
+    std::vector< Chunk* > replicas = all_replicas(chunk);
+    std::vector< std::error_code > errs;
+    errs.reserve(replicas.size());
+    for (auto* replica : replicas) {
+#ifdef _PRERELEASE
+        if (simulate_replica_io_error(replica, "WRITE")) {
+            errs.push_back(std::make_error_code(std::errc::io_error));
+            continue;
+        }
+#endif
+        auto* pdev = replica->physical_dev_mutable();
+        pdev->io_issued();
+        errs.push_back(io_fn(pdev, replica->start_offset() + offset_in_chunk));
+        pdev->io_completed();
+    }
+    std::vector< Chunk* > gen_changed;
+    auto const err = replicas_written(replicas, errs, gen_changed);
+    for (auto* replica : gen_changed) {
+        replica->persist_chunk_info();
+    }
+    return err;
+}
+
+template < typename IOFn >
+folly::Future< std::error_code > VirtualDev::read_from_replica(std::vector< Chunk* > replicas, size_t idx,
+                                                               uint64_t offset_in_chunk, bool part_of_batch,
+                                                               IOFn io_fn) {
+    auto* pdev = replicas[idx]->physical_dev_mutable();
+    folly::Future< std::error_code > fut = folly::makeFuture(std::make_error_code(std::errc::io_error));
+#ifdef _PRERELEASE
+    if (!simulate_replica_io_error(replicas[idx], "READ"))
+#endif
+    {
+        pdev->io_issued();
+        fut = io_fn(pdev, replicas[idx]->start_offset() + offset_in_chunk, part_of_batch).ensure([pdev]() {
+            pdev->io_completed();
+        });
+    }
+    if (idx + 1 == replicas.size()) { return fut; }
+
+    return std::move(fut).thenValue([this, replicas = std::move(replicas), idx, offset_in_chunk,
+                                     io_fn = std::move(io_fn)](std::error_code err) mutable {
+        if (!err) { return folly::makeFuture< std::error_code >(std::move(err)); }
+        COUNTER_INCREMENT(m_metrics, vdev_mirror_read_failovers, 1);
+        HS_LOG(WARN, device, "Read failed on chunk_id={} pdev={} error={}, retrying on the next mirror",
+               replicas[idx]->chunk_id(), replicas[idx]->physical_dev()->get_devname(), err.message());
+        return read_from_replica(std::move(replicas), idx + 1, offset_in_chunk, false /* part_of_batch */,
+                                 std::move(io_fn));
+    });
+}
+
+template < typename IOFn >
+folly::Future< std::error_code > VirtualDev::read_replicas(Chunk* chunk, uint64_t offset_in_chunk, bool part_of_batch,
+                                                           IOFn&& io_fn) {
+    if (chunk->mirror_chunks().empty()) {
+        return io_fn(chunk->physical_dev_mutable(), chunk->start_offset() + offset_in_chunk, part_of_batch);
+    }
+    return read_from_replica(replicas_by_load(chunk), 0, offset_in_chunk, part_of_batch, std::forward< IOFn >(io_fn));
+}
+
+template < typename IOFn >
+std::error_code VirtualDev::sync_read_replicas(Chunk* chunk, uint64_t offset_in_chunk, IOFn&& io_fn) {
+    if (chunk->mirror_chunks().empty()) {
+        return io_fn(chunk->physical_dev_mutable(), chunk->start_offset() + offset_in_chunk);
+    }
+
+    std::error_code err;
+    for (auto* replica : replicas_by_load(chunk)) {
+        if (err) {
+            COUNTER_INCREMENT(m_metrics, vdev_mirror_read_failovers, 1);
+            HS_LOG(WARN, device, "Read failed on a mirror of chunk_id={} error={}, retrying on chunk_id={}",
+                   chunk->chunk_id(), err.message(), replica->chunk_id());
+        }
+#ifdef _PRERELEASE
+        if (simulate_replica_io_error(replica, "READ")) {
+            err = std::make_error_code(std::errc::io_error);
+            continue;
+        }
+#endif
+        auto* pdev = replica->physical_dev_mutable();
+        pdev->io_issued();
+        err = io_fn(pdev, replica->start_offset() + offset_in_chunk);
+        pdev->io_completed();
+        if (!err) { break; }
+    }
+    return err;
+}
+
+std::vector< Chunk* > VirtualDev::all_replicas(Chunk* chunk) {
+    std::vector< Chunk* > replicas;
+    replicas.reserve(chunk->mirror_chunks().size() + 1);
+    replicas.push_back(chunk);
+    for (auto& mirror : chunk->mirror_chunks()) {
+        replicas.push_back(mirror.get());
+    }
+    return replicas;
+}
+
+std::vector< Chunk* > VirtualDev::replicas_by_load(Chunk* chunk) {
+    // Rotate the start, so that replicas with the same load take turns instead of primary always winning the tie
+    static thread_local uint32_t s_rotate{0};
+    auto replicas = all_replicas(chunk);
+    std::rotate(replicas.begin(), replicas.begin() + (s_rotate++ % replicas.size()), replicas.end());
+
+    // Snapshot the load, as outstanding ios keep changing while sorting. Replicas which missed a write are skipped,
+    // unless every replica has missed one.
+    std::vector< std::pair< int64_t, Chunk* > > loads;
+    loads.reserve(replicas.size());
+    for (auto* replica : replicas) {
+        if (!replica->is_stale()) { loads.emplace_back(replica->physical_dev()->outstanding_ios(), replica); }
+    }
+    if (loads.empty()) { return replicas; }
+
+    std::stable_sort(loads.begin(), loads.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+    replicas.clear();
+    for (auto const& [_, replica] : loads) {
+        replicas.push_back(replica);
+    }
+    if (replicas[0] != chunk) { COUNTER_INCREMENT(m_metrics, vdev_mirror_reads, 1); }
+    return replicas;
+}
+
+std::error_code VirtualDev::replicas_written(std::vector< Chunk* > const& replicas,
+                                             std::vector< std::error_code > const& errs,
+                                             std::vector< Chunk* >& gen_changed) {
+    std::error_code first_err;
+    size_t num_failed{0};
+    for (auto const& err : errs) {
+        if (!err) { continue; }
+        if (!first_err) { first_err = err; }
+        ++num_failed;
+    }
+    if (num_failed == 0 || num_failed == replicas.size()) { return first_err; }
+
+    // Data is durable on the rest of the replicas, so the write succeeds. Replicas which missed it are not read from
+    // any more, as they have stale data now. Before acknowledging the write, the replicas which got it are moved to a
+    // newer generation on disk, so that upon restart the ones which missed it are resynced before they are read from.
+    // Generations are picked here under the lock, caller persists them.
+    std::unique_lock lg{m_mgmt_mutex};
+    uint32_t gen{0};
+    for (auto* replica : replicas) {
+        gen = std::max(gen, replica->mirror_gen());
+    }
+    ++gen;
+
+    for (size_t i{0}; i < replicas.size(); ++i) {
+        if (!errs[i]) {
+            // A replica which has missed an earlier write stays at its older generation
+            if (!replicas[i]->is_stale()) {
+                replicas[i]->set_mirror_gen_in_memory(gen);
+                gen_changed.push_back(replicas[i]);
+            }
+            continue;
+        }
+        COUNTER_INCREMENT(m_metrics, vdev_mirror_write_errors, 1);
+        HS_LOG(ERROR, device, "Write failed on mirror chunk_id={} pdev={} error={}, excluding it from reads",
+               replicas[i]->chunk_id(), replicas[i]->physical_dev()->get_devname(), errs[i].message());
+        replicas[i]->mark_stale();
+    }
+    return std::error_code{};
+}
+
+folly::Future< std::error_code > VirtualDev::persist_mirror_gens(std::vector< Chunk* > gen_changed,
+                                                                  std::error_code err) {
+    if (gen_changed.empty()) { return folly::makeFuture< std::error_code >(std::move(err)); }
+
+    auto const persist = [gen_changed]() {
+        for (auto* replica : gen_changed) {
+            replica->persist_chunk_info();
+        }
+    };
+
+    // Write completion runs on the reactor, which can't block on the chunk info writes. Write is acknowledged only
+    // after they are persisted on a fiber which can do sync io.
+    auto const fibers = iomanager.am_i_io_reactor() ? iomanager.sync_io_capable_fibers()
+                                                    : std::vector< iomgr::io_fiber_t >{};
+    if (fibers.empty()) {
+        persist();
+        return folly::makeFuture< std::error_code >(std::move(err));
+    }
+
+    auto promise = std::make_shared< folly::Promise< std::error_code > >();
+    auto fut = promise->getFuture();
+    iomanager.run_on_forget(fibers[0], [persist, promise, err]() {
+        persist();
+        promise->setValue(err);
+    });
+    return fut;
+}
+
 // for all writes functions, we don't expect to get invalid dev_offset, since we will never allocate blkid from missing
 // chunk(missing pdev);
 ////////////////////////// async write section //////////////////////////////////
@@ -346,7 +662,10 @@ folly::Future< std::error_code > VirtualDev::async_write(const char* buf, uint32
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
-    return pdev->async_write(buf, size, dev_offset, part_of_batch);
+    return write_replicas(chunk, dev_offset - chunk->start_offset(), part_of_batch,
+                          [buf, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                              return pd->async_write(buf, size, offset, batch);
+                          });
 }
 
 folly::Future< std::error_code > VirtualDev::async_write(const char* buf, uint32_t size, cshared< Chunk >& chunk,
@@ -366,7 +685,10 @@ folly::Future< std::error_code > VirtualDev::async_write(const char* buf, uint32
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
-    return pdev->async_write(buf, size, dev_offset, false /* part_of_batch */);
+    return write_replicas(chunk.get(), offset_in_chunk, false /* part_of_batch */,
+                          [buf, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                              return pd->async_write(buf, size, offset, batch);
+                          });
 }
 
 folly::Future< std::error_code > VirtualDev::async_writev(const iovec* iov, const int iovcnt, BlkId const& bid,
@@ -389,7 +711,10 @@ folly::Future< std::error_code > VirtualDev::async_writev(const iovec* iov, cons
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
-    return pdev->async_writev(iov, iovcnt, size, dev_offset, part_of_batch);
+    return write_replicas(chunk, dev_offset - chunk->start_offset(), part_of_batch,
+                          [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                              return pd->async_writev(iov, iovcnt, size, offset, batch);
+                          });
 }
 
 folly::Future< std::error_code > VirtualDev::async_writev(const iovec* iov, const int iovcnt, cshared< Chunk >& chunk,
@@ -410,7 +735,10 @@ folly::Future< std::error_code > VirtualDev::async_writev(const iovec* iov, cons
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
-    return pdev->async_writev(iov, iovcnt, size, dev_offset, false /* part_of_batch */);
+    return write_replicas(chunk.get(), offset_in_chunk, false /* part_of_batch */,
+                          [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                              return pd->async_writev(iov, iovcnt, size, offset, batch);
+                          });
 }
 
 ////////////////////////// sync write section //////////////////////////////////
@@ -426,7 +754,10 @@ std::error_code VirtualDev::sync_write(const char* buf, uint32_t size, BlkId con
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return std::make_error_code(std::errc::resource_unavailable_try_again);
     }
-    return chunk->physical_dev_mutable()->sync_write(buf, size, dev_offset);
+    return sync_write_replicas(chunk, dev_offset - chunk->start_offset(),
+                               [buf, size](PhysicalDev* pd, uint64_t offset) {
+                                   return pd->sync_write(buf, size, offset);
+                               });
 }
 
 std::error_code VirtualDev::sync_write(const char* buf, uint32_t size, cshared< Chunk >& chunk,
@@ -438,7 +769,9 @@ std::error_code VirtualDev::sync_write(const char* buf, uint32_t size, cshared<
     if (sisl_unlikely(!is_chunk_available(chunk))) {
         return std::make_error_code(std::errc::resource_unavailable_try_again);
     }
-    return chunk->physical_dev_mutable()->sync_write(buf, size, chunk->start_offset() + offset_in_chunk);
+    return sync_write_replicas(chunk.get(), offset_in_chunk, [buf, size](PhysicalDev* pd, uint64_t offset) {
+        return pd->sync_write(buf, size, offset);
+    });
 }
 
 std::error_code VirtualDev::sync_writev(const iovec* iov, int iovcnt, BlkId const& bid) {
@@ -461,7 +794,10 @@ std::error_code VirtualDev::sync_writev(const iovec* iov, int iovcnt, BlkId cons
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
 
-    return pdev->sync_writev(iov, iovcnt, size, dev_offset);
+    return sync_write_replicas(chunk, dev_offset - chunk->start_offset(),
+                               [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset) {
+                                   return pd->sync_writev(iov, iovcnt, size, offset);
+                               });
 }
 
 std::error_code VirtualDev::sync_writev(const iovec* iov, int iovcnt, cshared< Chunk >& chunk,
@@ -483,7 +819,9 @@ std::error_code VirtualDev::sync_writev(const iovec* iov, int iovcnt, cshared< C
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
 
-    return pdev->sync_writev(iov, iovcnt, size, dev_offset);
+    return sync_write_replicas(chunk.get(), offset_in_chunk, [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset) {
+        return pd->sync_writev(iov, iovcnt, size, offset);
+    });
 }
 
 // for read, chunk might be missing in case of pdev is gone(for example , breakfix), so we need to check if chunk is
@@ -498,7 +836,10 @@ folly::Future< std::error_code > VirtualDev::async_read(char* buf, uint64_t size
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
     }
-    return pchunk->physical_dev_mutable()->async_read(buf, size, dev_offset, part_of_batch);
+    return read_replicas(pchunk, dev_offset - pchunk->start_offset(), part_of_batch,
+                         [buf, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                             return pd->async_read(buf, size, offset, batch);
+                         });
 }
 
 folly::Future< std::error_code > VirtualDev::async_readv(iovec* iovs, int iovcnt, uint64_t size, BlkId const& bid,
@@ -510,7 +851,10 @@ folly::Future< std::error_code > VirtualDev::async_readv(iovec* iovs, int iovcnt
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
     }
-    return pchunk->physical_dev_mutable()->async_readv(iovs, iovcnt, size, dev_offset, part_of_batch);
+    return read_replicas(pchunk, dev_offset - pchunk->start_offset(), part_of_batch,
+                         [iovs, iovcnt, size](PhysicalDev* pd, uint64_t offset, bool batch) {
+                             return pd->async_readv(iovs, iovcnt, size, offset, batch);
+                         });
 }
 
 ////////////////////////////////////////// sync read section ////////////////////////////////////////////
@@ -522,14 +866,18 @@ std::error_code VirtualDev::sync_read(char* buf, uint32_t size, BlkId const& bid
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return std::make_error_code(std::errc::resource_unavailable_try_again);
     }
-    return chunk->physical_dev_mutable()->sync_read(buf, size, dev_offset);
+    return sync_read_replicas(chunk, dev_offset - chunk->start_offset(), [buf, size](PhysicalDev* pd, uint64_t offset) {
+        return pd->sync_read(buf, size, offset);
+    });
 }
 
 std::error_code VirtualDev::sync_read(char* buf, uint32_t size, cshared< Chunk >& chunk, uint64_t offset_in_chunk) {
     if (sisl_unlikely(!is_chunk_available(chunk))) {
         return std::make_error_code(std::errc::resource_unavailable_try_again);
     }
-    return chunk->physical_dev_mutable()->sync_read(buf, size, chunk->start_offset() + offset_in_chunk);
+    return sync_read_replicas(chunk.get(), offset_in_chunk, [buf, size](PhysicalDev* pd, uint64_t offset) {
+        return pd->sync_read(buf, size, offset);
+    });
 }
 
 std::error_code VirtualDev::sync_readv(iovec* iov, int iovcnt, BlkId const& bid) {
@@ -548,7 +896,10 @@ std::error_code VirtualDev::sync_readv(iovec* iov, int iovcnt, BlkId const& bid)
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
 
-    return pdev->sync_readv(iov, iovcnt, size, dev_offset);
+    return sync_read_replicas(chunk, dev_offset - chunk->start_offset(),
+                              [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset) {
+                                  return pd->sync_readv(iov, iovcnt, size, offset);
+                              });
 }
 
 std::error_code VirtualDev::sync_readv(iovec* iov, int iovcnt, cshared< Chunk >& chunk, uint64_t offset_in_chunk) {
@@ -564,7 +915,9 @@ std::error_code VirtualDev::sync_readv(iovec* iov, int iovcnt, cshared< Chunk >&
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
 
-    return pdev->sync_readv(iov, iovcnt, size, dev_offset);
+    return sync_read_replicas(chunk.get(), offset_in_chunk, [iov, iovcnt, size](PhysicalDev* pd, uint64_t offset) {
+        return pd->sync_readv(iov, iovcnt, size, offset);
+    });
 }
 
 folly::Future< std::error_code > VirtualDev::queue_fsync_pdevs() {
@@ -654,6 +1007,38 @@ shared< Chunk > VirtualDev::get_next_chunk(cshared< Chunk >& chunk) {
 void VirtualDev::update_vdev_private(const sisl::blob& private_data) {
     std::unique_lock lg{m_mgmt_mutex};
     m_vdev_info.set_user_private(private_data);
+    write_vdev_info();
+}
+
+void VirtualDev::enable_discard(bool enable) {
+    std::unique_lock lg{m_mgmt_mutex};
+    m_vdev_info.enable_discard = enable ? 1 : 0;
+    write_vdev_info();
+    m_discard_enabled.store(enable, std::memory_order_relaxed);
+    HS_LOG(INFO, device, "Discard is {} on vdev={}", enable ? "enabled" : "disabled", m_name);
+}
+
+uint64_t VirtualDev::discard(Chunk* chunk, uint64_t offset_in_chunk, uint64_t size) {
+    // Mirrors hold the same blks, so they are discarded along with the chunk
+    for (auto& mirror : chunk->mirror_chunks()) {
+        discard(mirror.get(), offset_in_chunk, size);
+    }
+
+    auto pdev = chunk->physical_dev_mutable();
+    if (!pdev->is_discard_supported()) { return 0; }
+
+    auto const max_io_size = uint64_cast(std::max(HS_DYNAMIC_CONFIG(generic.discard_max_io_size_mb), 1u)) * 1024 * 1024;
+    uint64_t discarded{0};
+    while (discarded < size) {
+        auto const io_size = std::min(size - discarded, max_io_size);
+        if (pdev->sync_discard(io_size, chunk->start_offset() + offset_in_chunk + discarded)) { break; }
+        discarded += io_size;
+    }
+    COUNTER_INCREMENT(m_metrics, vdev_discard_bytes, discarded);
+    return discarded;
+}
+
+void VirtualDev::write_vdev_info() {
     m_vdev_info.compute_checksum();
 
     auto buf = hs_utils::iobuf_alloc(vdev_info::size, sisl::buftag::superblk, align_size());
@@ -677,20 +1062,123 @@ std::unique_ptr< CPContext > VirtualDev::create_cp_context(CP* cp) { return std:
 
 void VirtualDev::cp_flush(VDevCPContext* v_cp_ctx) {
     CP* cp = v_cp_ctx->cp();
+    auto const flush_start_time = Clock::now();
+
+    // Group the work per chunk, so that each chunk's allocator is flushed and then freed by only one fiber. Chunks are
+    // independent of each other, so the per chunk order (cp_flush before frees) is all that needs to be preserved.
+    struct chunk_cp_work {
+        Chunk* chunk{nullptr};
+        bool flush_allocator{false};
+        std::vector< BlkId > free_blkids;
+    };
+    std::map< chunk_num_t, chunk_cp_work > chunk_works;
 
     // pass down cp so that underlying components can get their customized CP context if needed;
-    m_chunk_selector->foreach_chunks(
-        [this, cp](cshared< Chunk >& chunk) { chunk->blk_allocator_mutable()->cp_flush(cp); });
+    m_chunk_selector->foreach_chunks([&chunk_works](cshared< Chunk >& chunk) {
+        auto& work = chunk_works[chunk->primary_chunk_id()];
+        work.chunk = chunk.get();
+        work.flush_allocator = true;
+    });
 
     // All of the blkids which were captured in the current vdev cp context will now be freed and hence available for
-    // allocation on the new CP dirty collection session which is ongoing
+    // allocation on the new CP dirty collection session which is ongoing. With discard enabled, they are held back
+    // until the cp is committed, as the data of these blks is still needed if we crash before that.
+    bool const defer_free = is_discard_enabled();
     for (auto const& b : v_cp_ctx->m_free_blkid_list) {
-        auto chunk = m_dmgr.get_chunk_mutable(b.chunk_num());
+        if (defer_free) {
+            v_cp_ctx->m_discard_blkids[b.chunk_num()].push_back(b);
+            continue;
+        }
+        auto& work = chunk_works[b.chunk_num()];
+        if (work.chunk == nullptr) {
+            work.chunk = m_dmgr.get_chunk_mutable(b.chunk_num());
+            // try to free a blk in a missing chunk, crash if it happens;
+            if (!work.chunk) HS_DBG_ASSERT(false, "chunk is missing for blkid {}", b.to_string());
+        }
+        work.free_blkids.push_back(b);
+    }
+
+    std::vector< chunk_cp_work > works;
+    for (auto& kv : chunk_works) {
+        if (kv.second.chunk) { works.push_back(std::move(kv.second)); }
+    }
+
+    auto const flush_chunk = [this, cp, &works](size_t w) {
+        auto& work = works[w];
+        BlkAllocator* allocator = work.chunk->blk_allocator_mutable();
+        if (work.flush_allocator) {
+            auto const start_time = Clock::now();
+            allocator->cp_flush(cp);
+            HISTOGRAM_OBSERVE(m_metrics, vdev_cp_alloc_flush_latency, get_elapsed_time_us(start_time));
+        }
+        if (!work.free_blkids.empty()) {
+            // Freed in one go, so that allocator takes its locks once for all the blks of the chunk
+            auto const start_time = Clock::now();
+            allocator->free(work.free_blkids);
+            HISTOGRAM_OBSERVE(m_metrics, vdev_cp_free_blks_latency, get_elapsed_time_us(start_time));
+        }
+    };
+
+    // Caller itself processes the chunks along with the other cp io fibers
+    auto const parallelism = HS_DYNAMIC_CONFIG(generic.cp_flush_parallelism);
+    run_shared_works(works.size(), parallelism, hs()->cp_mgr().cp_io_fibers(), flush_chunk);
+    HISTOGRAM_OBSERVE(m_metrics, vdev_cp_flush_latency, get_elapsed_time_us(flush_start_time));
+}
+
+void VirtualDev::cp_cleanup(VDevCPContext* v_cp_ctx) {
+    if (v_cp_ctx->m_discard_blkids.empty()) { return; }
+
+    // Discards are blocking calls on the device, hence are run on the discard worker instead of the cp thread. The
+    // blks remain allocated till the worker gets to them.
+    m_dmgr.run_discard([this, freed_blkids = std::move(v_cp_ctx->m_discard_blkids)]() mutable {
+        discard_and_free_blks(freed_blkids);
+    });
+    v_cp_ctx->m_discard_blkids.clear();
+}
+
+void VirtualDev::discard_and_free_blks(std::map< chunk_num_t, std::vector< BlkId > >& freed_blkids) {
+    auto const start_time = Clock::now();
+
+    // Discard could have been disabled after cp_flush, but the held back blkids still needs to be freed
+    bool const do_discard = is_discard_enabled();
+    uint64_t budget = uint64_cast(HS_DYNAMIC_CONFIG(generic.discard_max_size_per_cp_mb)) * 1024 * 1024;
+    for (auto& [chunk_num, blkids] : freed_blkids) {
+        auto chunk = m_dmgr.get_chunk_mutable(chunk_num);
         // try to free a blk in a missing chunk, crash if it happens;
-        if (!chunk) HS_DBG_ASSERT(false, "chunk is missing for blkid {}", b.to_string());
-        BlkAllocator* allocator = chunk->blk_allocator_mutable();
-        allocator->free(b);
+        if (!chunk) {
+            HS_DBG_ASSERT(false, "chunk is missing for chunk_num {}", chunk_num);
+            continue;
+        }
+
+        if (do_discard && chunk->physical_dev()->is_discard_supported()) {
+            auto const discard_extent = [this, chunk, &budget](blk_num_t start_blk, blk_num_t end_blk) {
+                auto const size = uint64_cast(end_blk - start_blk) * block_size();
+                if (size > budget) {
+                    COUNTER_INCREMENT(m_metrics, vdev_discard_skipped_bytes, size);
+                    return;
+                }
+                budget -= discard(chunk, uint64_cast(start_blk) * block_size(), size);
+                COUNTER_INCREMENT(m_metrics, vdev_discard_extent_count, 1);
+            };
+
+            // Coalesce the adjacent blkids freed in this cp, so that each contiguous extent is one discard
+            std::sort(blkids.begin(), blkids.end(),
+                      [](BlkId const& a, BlkId const& b) { return a.blk_num() < b.blk_num(); });
+            blk_num_t ext_start = blkids[0].blk_num();
+            blk_num_t ext_end = ext_start + blkids[0].blk_count();
+            for (size_t i{1}; i < blkids.size(); ++i) {
+                if (blkids[i].blk_num() > ext_end) {
+                    discard_extent(ext_start, ext_end);
+                    ext_start = blkids[i].blk_num();
+                }
+                ext_end = std::max(ext_end, blk_num_t(blkids[i].blk_num() + blkids[i].blk_count()));
+            }
+            discard_extent(ext_start, ext_end);
+        }
+
+        chunk->blk_allocator_mutable()->free(blkids);
     }
+    HISTOGRAM_OBSERVE(m_metrics, vdev_cp_discard_latency, get_elapsed_time_us(start_time));
 }
 
 // sync-ops during cp_flush, so return 100;
@@ -20,6 +20,7 @@
 #include <memory>
 #include <map>
 #include <mutex>
+#include <span>
 #include <string>
 #include <system_error>
 #include <type_traits>
@@ -54,6 +55,19 @@ public:
         REGISTER_COUNTER(default_chunk_allocation_cnt, "default chunk allocation count");
         REGISTER_COUNTER(random_chunk_allocation_cnt,
                          "random chunk allocation count"); // ideally it should be zero for hdd
+        REGISTER_COUNTER(vdev_discard_extent_count, "vdev total coalesced extents discarded after cp");
+        REGISTER_COUNTER(vdev_discard_bytes, "vdev total bytes discarded");
+        REGISTER_COUNTER(vdev_discard_skipped_bytes, "vdev freed bytes not discarded due to per cp limit");
+        REGISTER_COUNTER(vdev_mirror_reads, "vdev reads served by a mirror instead of the primary chunk");
+        REGISTER_COUNTER(vdev_mirror_read_failovers, "vdev reads retried on another mirror after an error");
+        REGISTER_COUNTER(vdev_mirror_write_errors, "vdev writes which failed on some of the mirrors");
+        REGISTER_HISTOGRAM(vdev_cp_flush_latency, "vdev cp flush latency (in us)", "vdev_cp_latency", {"phase", "all"});
+        REGISTER_HISTOGRAM(vdev_cp_alloc_flush_latency, "vdev per chunk blk allocator cp flush latency (in us)",
+                           "vdev_cp_latency", {"phase", "alloc_flush"});
+        REGISTER_HISTOGRAM(vdev_cp_free_blks_latency, "vdev per chunk deferred blk free latency (in us)",
+                           "vdev_cp_latency", {"phase", "free_blks"});
+        REGISTER_HISTOGRAM(vdev_cp_discard_latency, "vdev discard and free of blks after cp is committed (in us)",
+                           "vdev_cp_latency", {"phase", "discard"});
         register_me_to_farm();
     }
 
@@ -100,6 +114,7 @@ protected:
     chunk_selector_type_t m_chunk_selector_type;
     bool m_auto_recovery;
     bool m_use_slab_in_blk_allocator;
+    std::atomic< bool > m_discard_enabled;
 
 public:
     VirtualDev(DeviceManager& dmgr, const vdev_info& vinfo, vdev_event_cb_t event_cb, bool is_auto_recovery,
@@ -149,6 +164,16 @@ public:
     virtual BlkAllocStatus alloc_blks(blk_count_t nblks, blk_alloc_hints const& hints,
                                       std::vector< BlkId >& out_blkids);
 
+    /// @brief This method allocates blocks for a batch of requests. The chunk is selected once for the entire batch
+    /// and only if it runs out of space, rest of the batch goes through the chunk selector again. Allocation is all or
+    /// nothing and partial allocation of any request is not allowed.
+    /// @param nblks_list : Number of blocks to allocate for each request in the batch
+    /// @param hints : Hints about block allocation, common to all the requests
+    /// @param out_blkids : Allocated MultiBlkId per request, in the same order as nblks_list
+    /// @return BlkAllocStatus : SUCCESS if all of them are allocated, otherwise status of the failed allocation
+    virtual BlkAllocStatus alloc_blks_batch(std::span< blk_count_t const > nblks_list, blk_alloc_hints const& hints,
+                                            std::vector< MultiBlkId >& out_blkids);
+
     /// @brief Checks if a given block id is allocated in the in-memory version of the blk allocator
     /// @param blkid : BlkId to check for allocation
     /// @return true or false
@@ -270,6 +295,14 @@ public:
     /// @param cp
     void cp_flush(VDevCPContext* v_cp_ctx);
 
+    /// @brief Called once the cp is committed. If discard is enabled, the blks freed in this cp were held back from
+    /// the allocator by cp_flush. They are coalesced into extents per chunk, discarded on the device and then freed,
+    /// so that they can't be reallocated while the discard is in progress. All of this is done in the background on
+    /// the device manager's discard worker.
+    ///
+    /// @param v_cp_ctx: vdev cp context of the committed cp
+    void cp_cleanup(VDevCPContext* v_cp_ctx);
+
     /// @brief : percentage CP has been progressed, this api is normally used for cp watchdog;
     int cp_progress_percent();
 
@@ -283,7 +316,7 @@ public:
     virtual uint32_t block_size() const { return m_vdev_info.blk_size; }
     virtual vdev_info info() const { return m_vdev_info; }
     virtual void update_info(const vdev_info& info) { m_vdev_info = info; }
-    virtual uint32_t num_mirrors() const { return 0; }
+    virtual uint32_t num_mirrors() const { return m_vdev_info.num_mirrors; }
     virtual std::string to_string() const;
     virtual nlohmann::json get_status(int log_level) const;
     virtual uint64_t get_total_chunk_num() const { return m_total_chunk_num; }
@@ -301,9 +334,41 @@ public:
     ///////////////////////// Meta operations on vdev ////////////////////////
     void update_vdev_private(const sisl::blob& data);
 
+    /// @brief Enable or disable discard of the freed blks and chunks of this vdev. The choice is persisted.
+    void enable_discard(bool enable);
+    bool is_discard_enabled() const { return m_discard_enabled.load(std::memory_order_relaxed); }
+
+protected:
+    /// @brief Discard the given range of a chunk on its device, in ios of at most discard_max_io_size_mb.
+    /// @return Number of bytes actually discarded
+    uint64_t discard(Chunk* chunk, uint64_t offset_in_chunk, uint64_t size);
+
 private:
+    void write_vdev_info();
+    void discard_and_free_blks(std::map< chunk_num_t, std::vector< BlkId > >& freed_blkids);
     uint64_t to_dev_offset(BlkId const& b, Chunk** chunk) const;
     bool is_chunk_available(cshared< Chunk >& chunk) const;
+
+    // Mirror aware io. Writes go to the chunk and all of its mirrors, reads go to the least loaded replica and are
+    // retried on the other replicas on error. IOFn issues the io on the given pdev at the given device offset.
+    template < typename IOFn >
+    folly::Future< std::error_code > write_replicas(Chunk* chunk, uint64_t offset_in_chunk, bool part_of_batch,
+                                                    IOFn&& io_fn);
+    template < typename IOFn >
+    std::error_code sync_write_replicas(Chunk* chunk, uint64_t offset_in_chunk, IOFn&& io_fn);
+    template < typename IOFn >
+    folly::Future< std::error_code > read_replicas(Chunk* chunk, uint64_t offset_in_chunk, bool part_of_batch,
+                                                   IOFn&& io_fn);
+    template < typename IOFn >
+    folly::Future< std::error_code > read_from_replica(std::vector< Chunk* > replicas, size_t idx,
+                                                       uint64_t offset_in_chunk, bool part_of_batch, IOFn io_fn);
+    template < typename IOFn >
+    std::error_code sync_read_replicas(Chunk* chunk, uint64_t offset_in_chunk, IOFn&& io_fn);
+    static std::vector< Chunk* > all_replicas(Chunk* chunk);
+    std::vector< Chunk* > replicas_by_load(Chunk* chunk);
+    std::error_code replicas_written(std::vector< Chunk* > const& replicas, std::vector< std::error_code > const& errs,
+                                     std::vector< Chunk* >& gen_changed);
+    folly::Future< std::error_code > persist_mirror_gens(std::vector< Chunk* > gen_changed, std::error_code err);
     BlkAllocStatus alloc_blks_from_chunk(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId& out_blkid,
                                          Chunk* chunk);
 };
@@ -312,6 +377,7 @@ private:
 class VDevCPContext : public CPContext {
 public:
     sisl::ConcurrentInsertVector< BlkId > m_free_blkid_list;
+    std::map< chunk_num_t, std::vector< BlkId > > m_discard_blkids; // Freed blkids to be discarded after cp commit
 
 public:
     VDevCPContext(CP* cp);
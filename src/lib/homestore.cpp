@@ -205,24 +205,23 @@ void HomeStore::format_and_start(std::map< uint32_t, hs_format_params >&& format
     for (const auto& [svc_type, fparams] : format_opts) {
         if (fparams.size_pct == 0) { continue; }
 
-        if ((svc_type & HS_SERVICE::META) && has_meta_service()) {
-            m_meta_service->create_vdev(pct_to_size(fparams.size_pct, fparams.dev_type), fparams.dev_type,
-                                        fparams.num_chunks);
+        // A mirrored vdev takes its size on each of the devices, so the pct is shared by all the copies
+        auto size = pct_to_size(fparams.size_pct, fparams.dev_type);
+        if (fparams.mirrored) { size /= m_dev_mgr->get_pdevs_by_dev_type(fparams.dev_type).size(); }
 
+        if ((svc_type & HS_SERVICE::META) && has_meta_service()) {
+            m_meta_service->create_vdev(size, fparams.dev_type, fparams.num_chunks, fparams.mirrored);
         } else if ((svc_type & HS_SERVICE::LOG) && has_log_service()) {
-            futs.emplace_back(m_log_service->create_vdev(pct_to_size(fparams.size_pct, fparams.dev_type),
-                                                         fparams.dev_type, fparams.chunk_size));
+            futs.emplace_back(m_log_service->create_vdev(size, fparams.dev_type, fparams.chunk_size,
+                                                         fparams.enable_discard, fparams.mirrored));
         } else if ((svc_type & HS_SERVICE::INDEX) && has_index_service()) {
-            m_index_service->create_vdev(pct_to_size(fparams.size_pct, fparams.dev_type), fparams.dev_type,
-                                         fparams.num_chunks);
+            m_index_service->create_vdev(size, fparams.dev_type, fparams.num_chunks, fparams.enable_discard);
         } else if ((svc_type & HS_SERVICE::DATA) && has_data_service()) {
-            m_data_service->create_vdev(pct_to_size(fparams.size_pct, fparams.dev_type), fparams.dev_type,
-                                        fparams.block_size, fparams.alloc_type, fparams.chunk_sel_type,
-                                        fparams.num_chunks);
+            m_data_service->create_vdev(size, fparams.dev_type, fparams.block_size, fparams.alloc_type,
+                                        fparams.chunk_sel_type, fparams.num_chunks, fparams.enable_discard);
         } else if ((svc_type & HS_SERVICE::REPLICATION) && has_repl_data_service()) {
-            m_data_service->create_vdev(pct_to_size(fparams.size_pct, fparams.dev_type), fparams.dev_type,
-                                        fparams.block_size, fparams.alloc_type, fparams.chunk_sel_type,
-                                        fparams.num_chunks);
+            m_data_service->create_vdev(size, fparams.dev_type, fparams.block_size, fparams.alloc_type,
+                                        fparams.chunk_sel_type, fparams.num_chunks, fparams.enable_discard);
         }
     }
 
@@ -18,7 +18,10 @@ folly::Future< bool > IndexCPCallbacks::cp_flush(CP* cp) {
     return m_wb_cache->async_cp_flush(ctx);
 }
 
-void IndexCPCallbacks::cp_cleanup(CP* cp) {}
+void IndexCPCallbacks::cp_cleanup(CP* cp) {
+    auto ctx = s_cast< IndexCPContext* >(cp->context(cp_consumer_t::INDEX_SVC));
+    m_wb_cache->cp_cleanup(ctx);
+}
 
 int IndexCPCallbacks::cp_progress_percent() { return 100; }
 
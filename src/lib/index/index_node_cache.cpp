@@ -0,0 +1,259 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <algorithm>
+
+#include <homestore/btree/detail/btree_node.hpp>
+#include <homestore/index/index_internal.hpp>
+#include "common/homestore_config.hpp"
+#include "index/index_node_cache.hpp"
+
+namespace homestore {
+
+static BlkId node_blkid(BtreeNodePtr const& node) {
+    return static_cast< IndexBtreeNode* >(node.get())->m_idx_buf->m_blkid;
+}
+
+static uint32_t node_ordinal(BtreeNodePtr const& node) {
+    return static_cast< IndexBtreeNode* >(node.get())->m_idx_buf->m_index_ordinal;
+}
+
+IndexNodeCache::IndexNodeCache(uint64_t capacity, uint32_t node_size, uint32_t num_partitions) :
+        m_node_size{node_size} {
+    num_partitions = std::max(num_partitions, 1u);
+    m_partition_capacity = std::max(capacity / num_partitions, uint64_t{node_size});
+    m_partitions.reserve(num_partitions);
+    for (uint32_t i{0}; i < num_partitions; ++i) {
+        m_partitions.emplace_back(std::make_unique< partition >());
+    }
+}
+
+IndexNodeCache::~IndexNodeCache() {
+    for (auto& p : m_partitions) {
+        std::unique_lock lg{p->mtx};
+        p->entries.clear();
+        p->probation.clear();
+        p->protected_.clear();
+    }
+}
+
+bool IndexNodeCache::insert(BtreeNodePtr const& node, bool prefetched) {
+    auto const blkid = node_blkid(node);
+    auto const pind = partition_index(blkid);
+    ordinal_info* oinfo;
+    {
+        auto& p = *m_partitions[pind];
+        std::unique_lock lg{p.mtx};
+        if (p.entries.find(blkid) != p.entries.end()) { return false; }
+
+        oinfo = add_entry(p, node, blkid, prefetched);
+        evict(p);
+    }
+    evict_over_quota(oinfo, pind);
+    return true;
+}
+
+void IndexNodeCache::upsert(BtreeNodePtr const& node) {
+    auto const blkid = node_blkid(node);
+    auto const pind = partition_index(blkid);
+    ordinal_info* oinfo;
+    {
+        auto& p = *m_partitions[pind];
+        std::unique_lock lg{p.mtx};
+        if (auto it = p.entries.find(blkid); it != p.entries.end()) {
+            it->second->node = node;
+            touch_entry(p, it->second);
+            return;
+        }
+
+        oinfo = add_entry(p, node, blkid, false /* prefetched */);
+        evict(p);
+    }
+    evict_over_quota(oinfo, pind);
+}
+
+bool IndexNodeCache::get(BlkId const& blkid, BtreeNodePtr& node) {
+    auto& p = *m_partitions[partition_index(blkid)];
+    std::unique_lock lg{p.mtx};
+    auto it = p.entries.find(blkid);
+    if (it == p.entries.end()) { return false; }
+
+    auto eit = it->second;
+    node = eit->node;
+    eit->oinfo->hits.fetch_add(1, std::memory_order_relaxed);
+    COUNTER_INCREMENT(eit->oinfo->metrics, cache_hits, 1);
+    touch_entry(p, eit);
+    return true;
+}
+
+bool IndexNodeCache::remove(BlkId const& blkid, BtreeNodePtr& node) {
+    auto& p = *m_partitions[partition_index(blkid)];
+    std::unique_lock lg{p.mtx};
+    auto it = p.entries.find(blkid);
+    if (it == p.entries.end()) { return false; }
+
+    node = it->second->node;
+    erase_entry(p, it->second);
+    return true;
+}
+
+void IndexNodeCache::record_miss(uint32_t ordinal) {
+    auto* oinfo = get_ordinal_info(ordinal);
+    oinfo->misses.fetch_add(1, std::memory_order_relaxed);
+    COUNTER_INCREMENT(oinfo->metrics, cache_misses, 1);
+}
+
+void IndexNodeCache::set_quota(uint32_t ordinal, uint64_t quota, uint64_t reservation) {
+    auto* oinfo = get_ordinal_info(ordinal);
+    oinfo->quota.store(quota, std::memory_order_relaxed);
+    oinfo->reservation.store(reservation, std::memory_order_relaxed);
+}
+
+index_cache_stats IndexNodeCache::stats(uint32_t ordinal) {
+    auto* oinfo = get_ordinal_info(ordinal);
+    return index_cache_stats{.hits = oinfo->hits.load(std::memory_order_relaxed),
+                             .misses = oinfo->misses.load(std::memory_order_relaxed),
+                             .evictions = oinfo->evictions.load(std::memory_order_relaxed),
+                             .cached_size = oinfo->size.load(std::memory_order_relaxed)};
+}
+
+size_t IndexNodeCache::partition_index(BlkId const& blkid) const {
+    return std::hash< BlkId >{}(blkid) % m_partitions.size();
+}
+
+IndexNodeCache::ordinal_info* IndexNodeCache::get_ordinal_info(uint32_t ordinal) {
+    {
+        std::shared_lock lg{m_ordinal_mtx};
+        if (auto it = m_ordinals.find(ordinal); it != m_ordinals.end()) { return it->second.get(); }
+    }
+
+    std::unique_lock lg{m_ordinal_mtx};
+    auto [it, inserted] = m_ordinals.try_emplace(ordinal, nullptr);
+    if (inserted) { it->second = std::make_unique< ordinal_info >(ordinal); }
+    return it->second.get();
+}
+
+IndexNodeCache::ordinal_info* IndexNodeCache::add_entry(partition& p, BtreeNodePtr const& node, BlkId const& blkid,
+                                                        bool prefetched) {
+    auto* oinfo = get_ordinal_info(node_ordinal(node));
+
+    // Interior nodes are accessed by every operation on the index, so they skip the probation
+    bool const is_protected = !node->is_leaf();
+    auto& list = is_protected ? p.protected_ : p.probation;
+    list.push_front(cache_entry{node, blkid, oinfo, is_protected, prefetched && !is_protected});
+    p.entries.emplace(blkid, list.begin());
+
+    p.size += m_node_size;
+    if (is_protected) {
+        p.protected_size += m_node_size;
+        balance_protected(p);
+    }
+    oinfo->size.fetch_add(m_node_size, std::memory_order_relaxed);
+    COUNTER_INCREMENT(oinfo->metrics, cache_size, m_node_size);
+    return oinfo;
+}
+
+void IndexNodeCache::erase_entry(partition& p, lru_list_t::iterator it) {
+    auto* oinfo = it->oinfo;
+    p.entries.erase(it->blkid);
+    p.size -= m_node_size;
+    if (it->is_protected) {
+        p.protected_size -= m_node_size;
+        p.protected_.erase(it);
+    } else {
+        p.probation.erase(it);
+    }
+    oinfo->size.fetch_sub(m_node_size, std::memory_order_relaxed);
+    COUNTER_DECREMENT(oinfo->metrics, cache_size, m_node_size);
+}
+
+void IndexNodeCache::touch_entry(partition& p, lru_list_t::iterator it) {
+    if (it->is_protected) {
+        p.protected_.splice(p.protected_.begin(), p.protected_, it);
+    } else if (it->prefetched) {
+        // First access of the node read ahead, which a scan does for every node it read ahead
+        it->prefetched = false;
+        p.probation.splice(p.probation.begin(), p.probation, it);
+    } else {
+        // Second access of the node, promote it to protected segment
+        it->is_protected = true;
+        p.protected_.splice(p.protected_.begin(), p.probation, it);
+        p.protected_size += m_node_size;
+        balance_protected(p);
+    }
+}
+
+// Demote the least recently used protected entries to probation segment, once the protected segment outgrows its share
+void IndexNodeCache::balance_protected(partition& p) {
+    auto const max_protected_size = (m_partition_capacity * HS_DYNAMIC_CONFIG(cache.protected_percent)) / 100;
+    while ((p.protected_size > max_protected_size) && !p.protected_.empty()) {
+        auto it = std::prev(p.protected_.end());
+        it->is_protected = false;
+        p.probation.splice(p.probation.begin(), p.protected_, it);
+        p.protected_size -= m_node_size;
+    }
+}
+
+// Make room in the partition, without pushing any index below its reservation. Expected to be called with the partition
+// lock held.
+void IndexNodeCache::evict(partition& p) {
+    auto const above_reservation = [](cache_entry const& e) {
+        return (e.oinfo->size.load(std::memory_order_relaxed) > e.oinfo->reservation.load(std::memory_order_relaxed));
+    };
+    while ((p.size > m_partition_capacity) &&
+           (evict_one(p, p.probation, above_reservation) || evict_one(p, p.protected_, above_reservation))) {}
+}
+
+// Nodes of an index are spread across all the partitions, so an index above its quota evicts its own nodes from all of
+// them, starting from the partition it has added the node to. Probation segments of all the partitions are tried
+// before any protected segment. Expected to be called without any partition lock held.
+void IndexNodeCache::evict_over_quota(ordinal_info* oinfo, size_t start_partition) {
+    auto const quota = oinfo->quota.load(std::memory_order_relaxed);
+    if (quota == 0) { return; }
+
+    auto const over_quota = [oinfo, quota]() { return (oinfo->size.load(std::memory_order_relaxed) > quota); };
+    auto const is_own = [oinfo](cache_entry const& e) { return (e.oinfo == oinfo); };
+    for (bool const from_protected : {false, true}) {
+        for (size_t i{0}; (i < m_partitions.size()) && over_quota(); ++i) {
+            auto& p = *m_partitions[(start_partition + i) % m_partitions.size()];
+            std::unique_lock lg{p.mtx};
+            auto& list = from_protected ? p.protected_ : p.probation;
+            while (over_quota() && evict_one(p, list, is_own)) {
+                COUNTER_INCREMENT(oinfo->metrics, cache_quota_evictions, 1);
+            }
+        }
+    }
+}
+
+template < typename Pred >
+bool IndexNodeCache::evict_one(partition& p, lru_list_t& list, Pred&& pred) {
+    auto const is_evictable = [&pred](cache_entry const& e) {
+        return pred(e) && e.node->m_refcount.test_le(1) &&
+            static_cast< IndexBtreeNode* >(e.node.get())->m_idx_buf->is_clean();
+    };
+
+    uint32_t nscanned{0};
+    for (auto it = list.rbegin(); (it != list.rend()) && (nscanned < max_evict_scan); ++it, ++nscanned) {
+        if (!is_evictable(*it)) { continue; }
+
+        auto victim = std::prev(it.base());
+        victim->oinfo->evictions.fetch_add(1, std::memory_order_relaxed);
+        COUNTER_INCREMENT(victim->oinfo->metrics, cache_evictions, 1);
+        erase_entry(p, victim);
+        return true;
+    }
+    return false;
+}
+} // namespace homestore
@@ -0,0 +1,137 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sisl/metrics/metrics.hpp>
+#include <homestore/blk.h>
+#include <homestore/index/wb_cache_base.hpp>
+
+namespace homestore {
+
+class IndexCacheMetrics : public sisl::MetricsGroup {
+public:
+    explicit IndexCacheMetrics(const std::string& inst_name) : sisl::MetricsGroup("IndexCache", inst_name) {
+        REGISTER_COUNTER(cache_hits, "Number of index node lookups found in cache");
+        REGISTER_COUNTER(cache_misses, "Number of index nodes read from device");
+        REGISTER_COUNTER(cache_evictions, "Number of index nodes evicted to make room for other nodes");
+        REGISTER_COUNTER(cache_quota_evictions, "Number of index nodes evicted as the index exceeded its quota");
+        REGISTER_COUNTER(cache_size, "Size of index nodes in cache", sisl::_publish_as::publish_as_gauge);
+        register_me_to_farm();
+    }
+
+    IndexCacheMetrics(const IndexCacheMetrics&) = delete;
+    IndexCacheMetrics(IndexCacheMetrics&&) noexcept = delete;
+    IndexCacheMetrics& operator=(const IndexCacheMetrics&) = delete;
+    IndexCacheMetrics& operator=(IndexCacheMetrics&&) noexcept = delete;
+    ~IndexCacheMetrics() { deregister_me_from_farm(); }
+};
+
+/*
+ * Cache of index btree nodes, shared by all index tables.
+ *
+ * Replacement is segmented LRU, split into probation and protected segments. Leaf nodes enter the probation segment and
+ * are promoted to protected segment only if they are looked up again, while interior nodes directly enter the protected
+ * segment. Nodes read ahead are not looked up yet, so their first lookup keeps them in probation. Victims are picked
+ * from probation segment first, so a large scan or rebuild, which touches each leaf once, cycles through the probation
+ * segment without displacing the hot interior and leaf nodes of other indexes.
+ *
+ * Every index table could additionally have a quota, beyond which it evicts only its own nodes, and a reservation,
+ * below which its nodes are not evicted for other indexes. An index over its quota evicts its nodes from all the
+ * partitions, probation segments first. A node is evicted only if the cache is its only holder and its buffer is clean.
+ */
+class IndexNodeCache {
+public:
+    IndexNodeCache(uint64_t capacity, uint32_t node_size, uint32_t num_partitions);
+    ~IndexNodeCache();
+
+    /// @brief Add the node to the cache, returns false if the node of same blkid is already in cache. Node which is
+    /// prefetched is not counted as looked up.
+    bool insert(BtreeNodePtr const& node, bool prefetched = false);
+
+    /// @brief Add the node to the cache or replace the existing node of same blkid
+    void upsert(BtreeNodePtr const& node);
+
+    bool get(BlkId const& blkid, BtreeNodePtr& node);
+    bool remove(BlkId const& blkid, BtreeNodePtr& node);
+
+    /// @brief Record that a node of the index is not found in cache and is read from device
+    void record_miss(uint32_t ordinal);
+
+    void set_quota(uint32_t ordinal, uint64_t quota, uint64_t reservation);
+    index_cache_stats stats(uint32_t ordinal);
+
+private:
+    struct ordinal_info {
+        std::atomic< uint64_t > quota{0}; // 0 means no quota
+        std::atomic< uint64_t > reservation{0};
+        std::atomic< uint64_t > size{0};
+        std::atomic< uint64_t > hits{0};
+        std::atomic< uint64_t > misses{0};
+        std::atomic< uint64_t > evictions{0};
+        IndexCacheMetrics metrics;
+
+        ordinal_info(uint32_t ordinal) : metrics{"index_" + std::to_string(ordinal)} {}
+    };
+
+    struct cache_entry {
+        BtreeNodePtr node;
+        BlkId blkid;
+        ordinal_info* oinfo;
+        bool is_protected;
+        bool prefetched;
+    };
+    using lru_list_t = std::list< cache_entry >;
+
+    struct partition {
+        std::mutex mtx;
+        std::unordered_map< BlkId, lru_list_t::iterator > entries;
+        lru_list_t probation; // Front is the most recently used
+        lru_list_t protected_;
+        uint64_t size{0};
+        uint64_t protected_size{0};
+    };
+
+    size_t partition_index(BlkId const& blkid) const;
+    ordinal_info* get_ordinal_info(uint32_t ordinal);
+
+    ordinal_info* add_entry(partition& p, BtreeNodePtr const& node, BlkId const& blkid, bool prefetched);
+    void erase_entry(partition& p, lru_list_t::iterator it);
+    void touch_entry(partition& p, lru_list_t::iterator it);
+    void balance_protected(partition& p);
+    void evict(partition& p);
+    void evict_over_quota(ordinal_info* oinfo, size_t start_partition);
+
+    template < typename Pred >
+    bool evict_one(partition& p, lru_list_t& list, Pred&& pred);
+
+private:
+    static constexpr uint32_t max_evict_scan{64}; // Max entries looked at to find an evictable one
+
+    uint32_t m_node_size;
+    uint64_t m_partition_capacity;
+    std::vector< std::unique_ptr< partition > > m_partitions;
+
+    std::shared_mutex m_ordinal_mtx;
+    std::unordered_map< uint32_t, std::unique_ptr< ordinal_info > > m_ordinals;
+};
+} // namespace homestore
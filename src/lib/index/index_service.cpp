@@ -24,6 +24,7 @@
 #include "device/virtual_dev.hpp"
 #include "device/physical_dev.hpp"
 #include "device/chunk.h"
+#include "common/resource_mgr.hpp"
 
 namespace homestore {
 IndexService& index_service() { return hs()->index_service(); }
@@ -43,7 +44,7 @@ IndexService::IndexService(std::unique_ptr< IndexServiceCallbacks > cbs) : m_svc
         nullptr);
 }
 
-void IndexService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks) {
+void IndexService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks, bool enable_discard) {
     auto const atomic_page_size = hs()->device_mgr()->atomic_page_size(devType);
     hs_vdev_context vdev_ctx;
     vdev_ctx.type = hs_vdev_type_t::INDEX_VDEV;
@@ -56,7 +57,8 @@ void IndexService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_ch
                                                     .alloc_type = blk_allocator_type_t::fixed,
                                                     .chunk_sel_type = chunk_selector_type_t::ROUND_ROBIN,
                                                     .multi_pdev_opts = vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
-                                                    .context_data = vdev_ctx.to_blob()});
+                                                    .context_data = vdev_ctx.to_blob(),
+                                                    .enable_discard = enable_discard});
 }
 
 shared< VirtualDev > IndexService::open_vdev(const vdev_info& vinfo, bool load_existing) {
@@ -77,8 +79,14 @@ void IndexService::itable_meta_blk_found(const sisl::byte_view& buf, void* meta_
 
 void IndexService::start() {
     // Start Writeback cache
-    m_wb_cache = std::make_unique< IndexWBCache >(m_vdev, std::move(m_wbcache_sb), hs()->evictor(),
+    m_wb_cache = std::make_unique< IndexWBCache >(m_vdev, std::move(m_wbcache_sb), resource_mgr().get_cache_size(),
                                                   hs()->device_mgr()->atomic_page_size(HSDevType::Fast));
+
+    // Resume freeing the subtrees which range remove detached before the restart
+    std::unique_lock lg(m_index_map_mtx);
+    for (auto const& [_, tbl] : m_index_map) {
+        tbl->resume_free_dropped_nodes();
+    }
 }
 
 void IndexService::stop() { m_wb_cache.reset(); }
@@ -158,7 +166,6 @@ MetaIndexBuffer::MetaIndexBuffer(superblk< index_table_sb >& sb) : IndexBuffer{n
 MetaIndexBuffer::MetaIndexBuffer(shared< MetaIndexBuffer > const& other) :
         IndexBuffer{nullptr, BlkId{}}, m_sb{other->m_sb} {
     m_is_meta_buf = true;
-    m_bytes = hs_utils::iobuf_alloc(m_sb.size(), sisl::buftag::metablk, meta_service().align_size());
     copy_sb_to_buf();
 }
 
@@ -169,5 +176,13 @@ MetaIndexBuffer::~MetaIndexBuffer() {
     }
 }
 
-void MetaIndexBuffer::copy_sb_to_buf() { std::memcpy(m_bytes, m_sb.raw_buf()->cbytes(), m_sb.size()); }
+void MetaIndexBuffer::copy_sb_to_buf() {
+    // Superblk grows and shrinks with the list of dropped nodes yet to be freed
+    if (m_size != m_sb.size()) {
+        if (m_bytes) { hs_utils::iobuf_free(m_bytes, sisl::buftag::metablk); }
+        m_size = m_sb.size();
+        m_bytes = hs_utils::iobuf_alloc(m_size, sisl::buftag::metablk, meta_service().align_size());
+    }
+    std::memcpy(m_bytes, m_sb.raw_buf()->cbytes(), m_size);
+}
 } // namespace homestore
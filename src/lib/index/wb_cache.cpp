@@ -13,6 +13,9 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
+#include <climits>
+
 #include <sisl/fds/thread_vector.hpp>
 #include <homestore/btree/detail/btree_node.hpp>
 #include <homestore/index_service.hpp>
@@ -25,6 +28,7 @@
 #include "index_cp.hpp"
 #include "device/virtual_dev.hpp"
 #include "common/resource_mgr.hpp"
+#include "common/homestore_config.hpp"
 
 #ifdef _PRERELEASE
 #include "common/crash_simulator.hpp"
@@ -37,16 +41,9 @@ namespace homestore {
 IndexWBCacheBase& wb_cache() { return index_service().wb_cache(); }
 
 IndexWBCache::IndexWBCache(const std::shared_ptr< VirtualDev >& vdev, std::pair< meta_blk*, sisl::byte_view > sb,
-                           const std::shared_ptr< sisl::Evictor >& evictor, uint32_t node_size) :
+                           uint64_t cache_size, uint32_t node_size) :
         m_vdev{vdev},
-        m_cache{evictor, 100000, node_size,
-                [](const BtreeNodePtr& node) -> BlkId {
-                    return static_cast< IndexBtreeNode* >(node.get())->m_idx_buf->m_blkid;
-                },
-                [](const sisl::CacheRecord& rec) -> bool {
-                    const auto& hnode = (sisl::SingleEntryHashNode< BtreeNodePtr >&)rec;
-                    return (hnode.m_value->m_refcount.test_le(1));
-                }},
+        m_cache{cache_size, node_size, HS_DYNAMIC_CONFIG(cache.num_evictor_partitions)},
         m_node_size{node_size},
         m_meta_blk{sb.first} {
     start_flush_threads();
@@ -127,19 +124,95 @@ retry:
     // Check if the blkid is already in cache, if not load and put it into the cache
     if (m_cache.get(blkid, node)) { return; }
 
-    // Read the buffer from virtual device
-    auto idx_buf = std::make_shared< IndexBuffer >(blkid, m_node_size, m_vdev->align_size());
-    m_vdev->sync_read(r_cast< char* >(idx_buf->raw_buffer()), m_node_size, blkid);
+    // Join the read of this node if it is already in-flight, otherwise start a new read. Either way, only this fiber
+    // waits for the read to complete, other fibers on this reactor continue to run.
+    auto [rctx, is_new] = start_node_read(blkid, node_initializer);
+    if (rctx == nullptr) {
+        // Read has completed between our cache lookup and now, re-read from cache
+        goto retry;
+    }
+    if (!iomanager.am_i_sync_io_capable()) {
+        // This thread can't wait for an async read to complete. Read the node synchronously, if somebody else's read
+        // is in-flight, read it on our own instead of waiting for it, whichever completes first populates the cache.
+        if (!is_new) {
+            auto const joined_rctx = std::move(rctx);
+            rctx = std::make_shared< node_read_ctx >();
+            rctx->blkid = blkid;
+            rctx->buf = std::make_shared< IndexBuffer >(blkid, m_node_size, m_vdev->align_size());
+            rctx->node_initializer = joined_rctx->node_initializer;
+        }
+        auto const err = m_vdev->sync_read(r_cast< char* >(rctx->buf->raw_buffer()), m_node_size, blkid);
+        on_node_read_done(rctx, err, is_new /* inflight */);
+    } else {
+        if (is_new) { submit_node_read(rctx, false /* part_of_batch */); }
+        rctx->done.wait();
+    }
 
-    // Create the btree node out of buffer
-    node = node_initializer(idx_buf);
+    if (rctx->err) {
+        throw std::system_error(rctx->err, fmt::format("Unable to read index node blkid={}", blkid.to_string()));
+    }
+    node = rctx->node;
+}
 
-    // Push the node into cache
-    bool done = m_cache.insert(node);
-    if (!done) {
-        // There is a race between 2 concurrent reads from vdev and other party won the race. Re-read from cache
-        goto retry;
+void IndexWBCache::prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t const& node_initializer) {
+    uint32_t nsubmitted{0};
+    for (auto const id : ids) {
+        auto [rctx, is_new] = start_node_read(BlkId{id}, node_initializer);
+        if (!is_new) { continue; } // Already in cache or somebody else is reading it
+
+        rctx->prefetch = true;
+        submit_node_read(std::move(rctx), true /* part_of_batch */);
+        ++nsubmitted;
+    }
+    if (nsubmitted) { m_vdev->submit_batch(); }
+}
+
+std::pair< shared< IndexWBCache::node_read_ctx >, bool >
+IndexWBCache::start_node_read(BlkId const& blkid, node_initializer_t const& node_initializer) {
+    std::unique_lock lg{m_read_mtx};
+    if (auto it = m_inflight_reads.find(blkid); it != m_inflight_reads.end()) { return {it->second, false}; }
+
+    // The read could have been completed (and removed from inflight list) after the caller looked up the cache
+    BtreeNodePtr node;
+    if (m_cache.get(blkid, node)) { return {nullptr, false}; }
+
+    auto rctx = std::make_shared< node_read_ctx >();
+    rctx->blkid = blkid;
+    rctx->buf = std::make_shared< IndexBuffer >(blkid, m_node_size, m_vdev->align_size());
+    rctx->node_initializer = node_initializer;
+    m_inflight_reads.emplace(blkid, rctx);
+    return {std::move(rctx), true};
+}
+
+void IndexWBCache::submit_node_read(shared< node_read_ctx > rctx, bool part_of_batch) {
+    auto* buf = r_cast< char* >(rctx->buf->raw_buffer());
+    m_vdev->async_read(buf, m_node_size, rctx->blkid, part_of_batch).thenValue([rctx](std::error_code err) {
+        auto& pthis = s_cast< IndexWBCache& >(wb_cache()); // Avoiding more than 16 bytes capture
+        pthis.on_node_read_done(rctx, err, true /* inflight */);
+    });
+}
+
+void IndexWBCache::on_node_read_done(shared< node_read_ctx > const& rctx, std::error_code err, bool inflight) {
+    if (!err) {
+        // Create the btree node out of buffer and push the node into cache
+        auto node = rctx->node_initializer(rctx->buf);
+        m_cache.record_miss(rctx->buf->m_index_ordinal);
+        if (!m_cache.insert(node, rctx->prefetch)) {
+            // Node was added to the cache by other party (say evicted and re-read after this read started), use that
+            BtreeNodePtr cached_node;
+            if (m_cache.get(rctx->blkid, cached_node)) { node = std::move(cached_node); }
+        }
+        rctx->node = std::move(node);
+    } else {
+        LOGERRORMOD(wbcache, "Read of index node blkid={} failed, error={}", rctx->blkid.to_string(), err.message());
+    }
+    rctx->err = err;
+
+    if (inflight) {
+        std::unique_lock lg{m_read_mtx};
+        m_inflight_reads.erase(rctx->blkid);
     }
+    rctx->promise.set_value();
 }
 
 bool IndexWBCache::get_writable_buf(const BtreeNodePtr& node, CPContext* context) {
@@ -160,6 +233,7 @@ bool IndexWBCache::get_writable_buf(const BtreeNodePtr& node, CPContext* context
         // If its not clean, we do deep copy.
         auto new_buf = std::make_shared< IndexBuffer >(idx_buf->m_blkid, m_node_size, m_vdev->align_size());
         new_buf->m_created_cp_id = idx_buf->m_created_cp_id;
+        new_buf->m_index_ordinal = idx_buf->m_index_ordinal;
         std::memcpy(new_buf->raw_buffer(), idx_buf->raw_buffer(), m_node_size);
 
         node->update_phys_buf(new_buf->raw_buffer());
@@ -188,6 +262,12 @@ bool IndexWBCache::refresh_meta_buf(shared< MetaIndexBuffer >& meta_buf, CPConte
     return true;
 }
 
+void IndexWBCache::set_cache_quota(uint32_t index_ordinal, uint64_t quota, uint64_t reservation) {
+    m_cache.set_quota(index_ordinal, quota, reservation);
+}
+
+index_cache_stats IndexWBCache::cache_stats(uint32_t index_ordinal) { return m_cache.stats(index_ordinal); }
+
 #ifdef _PRERELEASE
 static void set_crash_flips(IndexBufferPtr const& parent_buf, IndexBufferPtr const& child_buf,
                             IndexBufferPtrList const& new_node_bufs, IndexBufferPtrList const& freed_node_bufs) {
@@ -353,6 +433,15 @@ void IndexWBCache::free_buf(const IndexBufferPtr& buf, CPContext* cp_ctx) {
     m_vdev->free_blk(buf->m_blkid, s_cast< VDevCPContext* >(cp_ctx));
 }
 
+void IndexWBCache::free_buf(bnodeid_t id, CPContext* cp_ctx) {
+    auto const blkid = BlkId{id};
+    BtreeNodePtr node;
+    m_cache.remove(blkid, node); // Node is not read, it is in cache only if somebody else read it
+
+    resource_mgr().inc_free_blk(m_node_size);
+    m_vdev->free_blk(blkid, s_cast< VDevCPContext* >(cp_ctx));
+}
+
 //////////////////// Recovery Related section /////////////////////////////////
 void IndexWBCache::recover(sisl::byte_view sb) {
     // If sb is empty, its possible a first time boot.
@@ -441,6 +530,8 @@ bool IndexWBCache::was_node_committed(IndexBufferPtr const& buf) {
 }
 
 //////////////////// CP Related API section /////////////////////////////////
+void IndexWBCache::cp_cleanup(IndexCPContext* cp_ctx) { m_vdev->cp_cleanup(cp_ctx); }
+
 folly::Future< bool > IndexWBCache::async_cp_flush(IndexCPContext* cp_ctx) {
     LOGTRACEMOD(wbcache, "cp_ctx {}", cp_ctx->to_string());
     if (!cp_ctx->any_dirty_buffers()) {
@@ -465,56 +556,132 @@ folly::Future< bool > IndexWBCache::async_cp_flush(IndexCPContext* cp_ctx) {
             IndexBufferPtrList buf_list;
             get_next_bufs(cp_ctx, resource_mgr().get_dirty_buf_qd(), buf_list);
 
-            for (auto& buf : buf_list) {
-                do_flush_one_buf(cp_ctx, buf, true);
-            }
-            m_vdev->submit_batch();
+            do_flush_bufs(cp_ctx, buf_list, false /* part_of_batch */);
         });
     }
     return std::move(cp_ctx->get_future());
 }
 
-void IndexWBCache::do_flush_one_buf(IndexCPContext* cp_ctx, IndexBufferPtr const& buf, bool part_of_batch) {
-    LOGTRACEMOD(wbcache, "cp {} buf {}", cp_ctx->id(), buf->to_string());
-    buf->set_state(index_buf_state_t::FLUSHING);
+void IndexWBCache::do_flush_bufs(IndexCPContext* cp_ctx, IndexBufferPtrList const& bufs, bool part_of_batch) {
+    IndexBufferPtrList write_bufs;
+    IndexBufferPtrList done_bufs;
+    for (auto const& buf : bufs) {
+        LOGTRACEMOD(wbcache, "cp {} buf {}", cp_ctx->id(), buf->to_string());
+        buf->set_state(index_buf_state_t::FLUSHING);
 
 #ifdef _PRERELEASE
-    if (buf->m_crash_flag_on) {
-        LOGINFOMOD(wbcache, "Simulating crash while writing buffer {}", buf->to_string());
-        hs()->crash_simulator().crash();
-    }
+        if (buf->m_crash_flag_on) {
+            // Queue the buffers ahead of this one before crashing, in the same batch as they were queued without
+            // coalescing. They are not submitted to the device before the crash either way.
+            write_coalesced_bufs(cp_ctx, write_bufs, true /* part_of_batch */);
+            write_bufs.clear();
+            LOGINFOMOD(wbcache, "Simulating crash while writing buffer {}", buf->to_string());
+            hs()->crash_simulator().crash();
+        }
 #endif
 
-    if (buf->is_meta_buf()) {
-        LOGTRACEMOD(wbcache, "flushing cp {} meta buf {} possibly because of root split", cp_ctx->id(),
-                    buf->to_string());
-        auto const& sb = r_cast< MetaIndexBuffer* >(buf.get())->m_sb;
-        meta_service().update_sub_sb(buf->m_bytes, sb.size(), sb.meta_blk());
-        process_write_completion(cp_ctx, buf);
-    } else if (buf->m_node_freed) {
-        LOGTRACEMOD(wbcache, "Not flushing buf {} as it was freed, its here for merely dependency", cp_ctx->id(),
-                    buf->to_string());
-        process_write_completion(cp_ctx, buf);
-    } else {
-        LOGTRACEMOD(wbcache, "flushing cp {} buf {} info: {}", cp_ctx->id(), buf->to_string(),
-                    BtreeNode::to_string_buf(buf->raw_buffer()));
-        m_vdev->async_write(r_cast< const char* >(buf->raw_buffer()), m_node_size, buf->m_blkid, part_of_batch)
-            .thenValue([buf, cp_ctx](auto) {
-                auto& pthis = s_cast< IndexWBCache& >(wb_cache()); // Avoiding more than 16 bytes capture
-                pthis.process_write_completion(cp_ctx, buf);
-            });
+        if (buf->is_meta_buf()) {
+            LOGTRACEMOD(wbcache, "flushing cp {} meta buf {} possibly because of root split", cp_ctx->id(),
+                        buf->to_string());
+            auto const* meta_buf = r_cast< MetaIndexBuffer* >(buf.get());
+            meta_service().update_sub_sb(buf->m_bytes, meta_buf->m_size, meta_buf->m_sb.meta_blk());
+            done_bufs.push_back(buf);
+        } else if (buf->m_node_freed) {
+            LOGTRACEMOD(wbcache, "Not flushing buf {} as it was freed, its here for merely dependency", cp_ctx->id(),
+                        buf->to_string());
+            done_bufs.push_back(buf);
+        } else {
+            LOGTRACEMOD(wbcache, "flushing cp {} buf {} info: {}", cp_ctx->id(), buf->to_string(),
+                        BtreeNode::to_string_buf(buf->raw_buffer()));
+            write_bufs.push_back(buf);
+        }
+    }
 
-        if (!part_of_batch) { m_vdev->submit_batch(); }
+    write_coalesced_bufs(cp_ctx, write_bufs, true /* part_of_batch */);
+    if (!part_of_batch) { m_vdev->submit_batch(); }
+
+    if (!done_bufs.empty()) { process_write_completion(cp_ctx, done_bufs); }
+}
+
+/*
+ * All the buffers passed here have their down buffers flushed already, so they can be written in any order. Sort them
+ * by their location on the device and write the buffers of adjacent blks as a single vectored write, upto the
+ * configured max io size.
+ */
+void IndexWBCache::write_coalesced_bufs(IndexCPContext* cp_ctx, IndexBufferPtrList& bufs, bool part_of_batch) {
+    if (bufs.empty()) { return; }
+
+    std::sort(bufs.begin(), bufs.end(), [](IndexBufferPtr const& a, IndexBufferPtr const& b) {
+        return (a->m_blkid.chunk_num() != b->m_blkid.chunk_num()) ? (a->m_blkid.chunk_num() < b->m_blkid.chunk_num())
+                                                                  : (a->m_blkid.blk_num() < b->m_blkid.blk_num());
+    });
+
+    auto const max_io_size = std::max(HS_DYNAMIC_CONFIG(generic.cache_flush_max_io_size_kb) * 1024, m_node_size);
+    auto const max_bufs_per_io = std::min(max_io_size / m_node_size, uint32_cast(IOV_MAX));
+
+    size_t start{0};
+    while (start < bufs.size()) {
+        auto const& first_bid = bufs[start]->m_blkid;
+        size_t end{start + 1};
+        blk_count_t nblks{first_bid.blk_count()};
+        while ((end < bufs.size()) && ((end - start) < max_bufs_per_io)) {
+            auto const& bid = bufs[end]->m_blkid;
+            if ((bid.chunk_num() != first_bid.chunk_num()) || (bid.blk_num() != first_bid.blk_num() + nblks)) {
+                break;
+            }
+            nblks += bid.blk_count();
+            ++end;
+        }
+
+        if (end - start == 1) {
+            auto const& buf = bufs[start];
+            m_vdev->async_write(r_cast< const char* >(buf->raw_buffer()), m_node_size, buf->m_blkid, part_of_batch)
+                .thenValue([buf, cp_ctx](auto) {
+                    auto& pthis = s_cast< IndexWBCache& >(wb_cache()); // Avoiding more than 16 bytes capture
+                    pthis.process_write_completion(cp_ctx, IndexBufferPtrList{buf});
+                });
+        } else {
+            // iovecs has to stay alive until the batch is submitted, so they are held along with the buffers till
+            // the write completes
+            auto io = std::make_shared< coalesced_write >();
+            io->cp_ctx = cp_ctx;
+            io->bufs.assign(bufs.begin() + start, bufs.begin() + end);
+            io->iovs.reserve(io->bufs.size());
+            for (auto const& buf : io->bufs) {
+                io->iovs.push_back(iovec{buf->raw_buffer(), m_node_size});
+            }
+
+            LOGTRACEMOD(wbcache, "cp {} coalesced {} bufs into single write at blk={} chunk={} nblks={}", cp_ctx->id(),
+                        io->bufs.size(), first_bid.blk_num(), first_bid.chunk_num(), nblks);
+            m_vdev
+                ->async_writev(io->iovs.data(), int_cast(io->iovs.size()),
+                               BlkId{first_bid.blk_num(), nblks, first_bid.chunk_num()}, part_of_batch)
+                .thenValue([io](auto) {
+                    auto& pthis = s_cast< IndexWBCache& >(wb_cache());
+                    pthis.process_write_completion(io->cp_ctx, io->bufs);
+                });
+        }
+        start = end;
     }
 }
 
-void IndexWBCache::process_write_completion(IndexCPContext* cp_ctx, IndexBufferPtr const& buf) {
-    LOGTRACEMOD(wbcache, "cp {} buf {}", cp_ctx->id(), buf->to_string());
-    resource_mgr().dec_dirty_buf_size(m_node_size);
-    auto [next_buf, has_more] = on_buf_flush_done(cp_ctx, buf);
-    if (next_buf) {
-        do_flush_one_buf(cp_ctx, next_buf, false);
-    } else if (!has_more) {
+void IndexWBCache::process_write_completion(IndexCPContext* cp_ctx, IndexBufferPtrList const& bufs) {
+    IndexBufferPtrList next_bufs;
+    bool all_flushed{false};
+    for (auto const& buf : bufs) {
+        LOGTRACEMOD(wbcache, "cp {} buf {}", cp_ctx->id(), buf->to_string());
+        resource_mgr().dec_dirty_buf_size(m_node_size);
+        auto [next_buf, has_more] = on_buf_flush_done(cp_ctx, buf);
+        if (next_buf) {
+            next_bufs.emplace_back(std::move(next_buf));
+        } else if (!has_more) {
+            all_flushed = true;
+        }
+    }
+
+    if (!next_bufs.empty()) {
+        do_flush_bufs(cp_ctx, next_bufs, false);
+    } else if (all_flushed) {
         // We are done flushing the buffers, We flush the vdev to persist the vdev bitmaps and free blks
         // Pick a CP Manager blocking IO fiber to execute the cp flush of vdev
         iomanager.run_on_forget(cp_mgr().pick_blocking_io_fiber(), [this, cp_ctx]() {
@@ -15,18 +15,21 @@
  *********************************************************************************/
 #pragma once
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <sys/uio.h>
 
 #include <iomgr/iomgr.hpp>
+#include <iomgr/fiber_lib.hpp>
 #include <homestore/index/wb_cache_base.hpp>
 #include <homestore/index/index_internal.hpp>
-#include <sisl/cache/simple_cache.hpp>
 #include "index/index_cp.hpp"
+#include "index/index_node_cache.hpp"
 
 namespace sisl {
 template < typename T >
 class ThreadVector;
-
-class Evictor;
 } // namespace sisl
 
 namespace homestore {
@@ -35,37 +38,69 @@ class VirtualDev;
 class IndexWBCache : public IndexWBCacheBase {
 private:
     std::shared_ptr< VirtualDev > m_vdev;
-    sisl::SimpleCache< BlkId, BtreeNodePtr > m_cache;
+    IndexNodeCache m_cache;
     uint32_t m_node_size;
     std::vector< iomgr::io_fiber_t > m_cp_flush_fibers;
     std::mutex m_flush_mtx;
     void* m_meta_blk;
 
+    // Read of a node from vdev, which is in-flight. Other readers of the same node wait on it, instead of issuing
+    // their own read.
+    struct node_read_ctx {
+        BlkId blkid;
+        IndexBufferPtr buf;
+        node_initializer_t node_initializer;
+        bool prefetch{false};
+        BtreeNodePtr node;
+        std::error_code err;
+        iomgr::FiberManagerLib::Promise< void > promise;
+        decltype(std::declval< iomgr::FiberManagerLib::Future< void > >().share()) done{promise.get_future().share()};
+    };
+    std::mutex m_read_mtx;
+    std::unordered_map< BlkId, shared< node_read_ctx > > m_inflight_reads;
+
+    // Write of multiple buffers of adjacent blks, issued as a single vectored write during cp flush
+    struct coalesced_write {
+        IndexCPContext* cp_ctx;
+        IndexBufferPtrList bufs;
+        std::vector< iovec > iovs;
+    };
+
 public:
     IndexWBCache(const std::shared_ptr< VirtualDev >& vdev, std::pair< meta_blk*, sisl::byte_view > sb,
-                 const std::shared_ptr< sisl::Evictor >& evictor, uint32_t node_size);
+                 uint64_t cache_size, uint32_t node_size);
 
     BtreeNodePtr alloc_buf(node_initializer_t&& node_initializer) override;
     void write_buf(const BtreeNodePtr& node, const IndexBufferPtr& buf, CPContext* cp_ctx) override;
     void read_buf(bnodeid_t id, BtreeNodePtr& node, node_initializer_t&& node_initializer) override;
+    void prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t const& node_initializer) override;
 
     bool get_writable_buf(const BtreeNodePtr& node, CPContext* context) override;
     void transact_bufs(uint32_t index_ordinal, IndexBufferPtr const& parent_buf, IndexBufferPtr const& child_buf,
                        IndexBufferPtrList const& new_node_bufs, IndexBufferPtrList const& freed_node_bufs,
                        CPContext* cp_ctx) override;
     void free_buf(const IndexBufferPtr& buf, CPContext* cp_ctx) override;
+    void free_buf(bnodeid_t id, CPContext* cp_ctx) override;
     bool refresh_meta_buf(shared< MetaIndexBuffer >& meta_buf, CPContext* cp_ctx) override;
+    void set_cache_quota(uint32_t index_ordinal, uint64_t quota, uint64_t reservation) override;
+    index_cache_stats cache_stats(uint32_t index_ordinal) override;
 
     //////////////////// CP Related API section /////////////////////////////////
     folly::Future< bool > async_cp_flush(IndexCPContext* context);
+    void cp_cleanup(IndexCPContext* context);
     IndexBufferPtr copy_buffer(const IndexBufferPtr& cur_buf, const CPContext* cp_ctx) const;
     void recover(sisl::byte_view sb);
 
 private:
     void start_flush_threads();
+    std::pair< shared< node_read_ctx >, bool > start_node_read(BlkId const& blkid,
+                                                               node_initializer_t const& node_initializer);
+    void submit_node_read(shared< node_read_ctx > rctx, bool part_of_batch);
+    void on_node_read_done(shared< node_read_ctx > const& rctx, std::error_code err, bool inflight);
     void recover_new_nodes(sisl::byte_view sb);
-    void process_write_completion(IndexCPContext* cp_ctx, IndexBufferPtr const& pbuf);
-    void do_flush_one_buf(IndexCPContext* cp_ctx, IndexBufferPtr const& buf, bool part_of_batch);
+    void process_write_completion(IndexCPContext* cp_ctx, IndexBufferPtrList const& bufs);
+    void do_flush_bufs(IndexCPContext* cp_ctx, IndexBufferPtrList const& bufs, bool part_of_batch);
+    void write_coalesced_bufs(IndexCPContext* cp_ctx, IndexBufferPtrList& bufs, bool part_of_batch);
     void link_buf(IndexBufferPtr const& up, IndexBufferPtr const& down, bool is_sibling_link, CPContext* cp_ctx);
 
     std::pair< IndexBufferPtr, bool > on_buf_flush_done(IndexCPContext* cp_ctx, IndexBufferPtr const& buf);
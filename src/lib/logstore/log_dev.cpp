@@ -85,6 +85,8 @@ void LogDev::start(bool format) {
         m_log_records->reinit(m_log_idx);
         m_last_flush_idx = m_log_idx - 1;
     }
+    m_last_prepared_idx = m_last_flush_idx;
+    m_last_prepared_crc = m_last_crc;
 
     start_timer();
     handle_unopened_log_stores(format);
@@ -134,11 +136,19 @@ void LogDev::stop() {
     m_log_records = nullptr;
     m_logdev_meta.reset();
     m_log_idx.store(0);
+    clear_read_cache();
     m_pending_flush_size.store(0);
     m_is_flushing.store(false);
     m_last_flush_idx = -1;
     m_last_truncate_idx = -1;
     m_last_crc = INVALID_CRC32_VALUE;
+    m_last_prepared_idx = -1;
+    m_last_prepared_crc = INVALID_CRC32_VALUE;
+    m_inflight_flushes = 0;
+    m_preparing_flush = false;
+    m_flush_inflight_q.clear();
+    m_flush_completion_in_progress = false;
+    m_log_group_idx = 0;
     if (m_block_flush_q != nullptr) {
         sisl::VectorPool< flush_blocked_callback >::free(m_block_flush_q, false /* no_cache */);
     }
@@ -178,6 +188,7 @@ void LogDev::do_load(const off_t device_cursor) {
     log_stream_reader lstream{device_cursor, m_vdev, m_vdev_jd, m_flush_size_multiple};
     logid_t loaded_from{-1};
     off_t group_dev_offset = 0;
+    std::unordered_map< logstore_id_t, std::vector< log_found_record > > store_recs; // records of a group per store
 
     THIS_LOGDEV_LOG(TRACE, "LogDev::do_load start log_dev={} ", m_logdev_id);
 
@@ -200,7 +211,7 @@ void LogDev::do_load(const off_t device_cursor) {
         HS_REL_ASSERT_EQ(header->start_idx(), m_log_idx.load(), "log indx is not the expected one");
         if (loaded_from == -1) { loaded_from = header->start_idx(); }
 
-        // Loop through each record within the log group and do a callback
+        // Loop through each record within the log group and collect them per store, to hand them over in one call
         decltype(header->nrecords()) i{0};
         HS_REL_ASSERT_GT(header->nrecords(), 0, "nrecords greater then zero");
         const auto flush_ld_key =
@@ -222,17 +233,26 @@ void LogDev::do_load(const off_t device_cursor) {
             } else {
                 THIS_LOGDEV_LOG(TRACE, "seq num {}, log indx {}, group dev offset {} size {}", rec->store_seq_num,
                                 (header->start_idx() + i), group_dev_offset, rec->size);
-                on_logfound(rec->store_id, rec->store_seq_num, {header->start_idx() + i, group_dev_offset},
-                            flush_ld_key, b, (header->nrecords() - (i + 1)));
+                store_recs[rec->store_id].push_back(log_found_record{
+                    rec->store_seq_num, logdev_key{header->start_idx() + i, group_dev_offset}, std::move(b)});
             }
 
             ++i;
         }
 
+        for (auto& [store_id, recs] : store_recs) {
+            if (recs.empty()) { continue; }
+            on_logs_found(store_id, recs, flush_ld_key);
+            recs.clear();
+        }
+
         m_log_idx = header->start_idx() + i;
         m_last_crc = header->cur_grp_crc;
     } while (true);
 
+    // Stop reading ahead before the journal descriptor is handed back for appends.
+    lstream.stop_read_ahead();
+
     // Update the tail offset with where we finally end up loading, so that new append entries can be written from
     // here.
     m_vdev_jd->update_tail_offset(group_dev_offset);
@@ -247,6 +267,19 @@ void LogDev::assert_next_pages(log_stream_reader& lstream) {
         const auto buf = lstream.group_in_next_page();
         if (buf.size() != 0) {
             auto* header = r_cast< const log_group_header* >(buf.bytes());
+            auto const* footer = r_cast< const log_group_footer* >(buf.bytes() + header->footer_offset);
+            if ((footer->inflight_prev_groups() > 0) &&
+                (header->start_idx() >= m_log_idx.load(std::memory_order_acquire))) {
+                // This group was written while earlier groups were still in-flight, so it could have reached the disk
+                // before an earlier one, which was not written when we crashed. Its records were never acknowledged,
+                // so we can safely ignore it. The decision is based on what was recorded on disk, since the pipeline
+                // depth config could have changed since the group was written.
+                THIS_LOGDEV_LOG(WARN,
+                                "Found a header with future log_idx after reaching end of log, ignoring it as it was "
+                                "probably an unacknowledged pipelined flush, Header: {}",
+                                *header);
+                continue;
+            }
             HS_REL_ASSERT_GT(m_log_idx.load(std::memory_order_acquire), header->start_idx(),
                              "Found a header with future log_idx after reaching end of log. Hence rbuf which was read "
                              "must have been corrupted, logdev id {} Header: {}",
@@ -267,20 +300,45 @@ int64_t LogDev::append_async(const logstore_id_t store_id, const logstore_seq_nu
         return idx;
     }
 
+    // With pipelined flushes, a new log group can be flushed while the earlier ones are still in-flight
     if (flush_wait ||
         ((prev_size < threshold_size && ((prev_size + data.size()) >= threshold_size) &&
-          !m_is_flushing.load(std::memory_order_relaxed)))) {
+          ((flush_pipeline_depth() > 1) || !m_is_flushing.load(std::memory_order_relaxed))))) {
         flush_if_needed(flush_wait ? 1 : -1);
     }
     return idx;
 }
 
 log_buffer LogDev::read(const logdev_key& key, serialized_log_record& return_record_header) {
+    auto const buf = read_log_group(key);
+    if (buf == nullptr) { return {}; }
+
+    auto* header = r_cast< const log_group_header* >(buf->cbytes());
+    auto record_header = header->nth_record(key.idx - header->start_log_idx);
+    uint32_t const data_offset = (record_header->offset + (record_header->get_inlined() ? 0 : header->oob_data_offset));
+    HS_REL_ASSERT_LE(data_offset + record_header->size, buf->size(), "Log record is beyond the log group {} {}",
+                     m_logdev_id, *header);
+
+    return_record_header =
+        serialized_log_record(record_header->size, record_header->offset, record_header->get_inlined(),
+                              record_header->store_seq_num, record_header->store_id);
+
+    // Record is handed out as a view into the log group buffer, no copy of the data
+    return sisl::byte_view{buf, data_offset, record_header->size};
+}
+
+sisl::byte_array LogDev::read_log_group(const logdev_key& key) {
+    if (auto cached = log_group_read_cache().get(m_logdev_id, key.dev_offset, key.idx); cached != nullptr) {
+        COUNTER_INCREMENT(logstore_service().metrics(), logdev_read_cache_hit, 1);
+        return cached;
+    }
+    COUNTER_INCREMENT(logstore_service().metrics(), logdev_read_cache_miss, 1);
+
     auto buf = sisl::make_byte_array(initial_read_size, m_flush_size_multiple, sisl::buftag::logread);
     auto ec = m_vdev_jd->sync_pread(buf->bytes(), initial_read_size, key.dev_offset);
     if (ec) {
-        LOGERROR("Failed to read from ournal vdev log_dev={} {} {}", m_logdev_id, ec.value(), ec.message());
-        return {};
+        LOGERROR("Failed to read from journal vdev log_dev={} {} {}", m_logdev_id, ec.value(), ec.message());
+        return nullptr;
     }
 
     auto* header = r_cast< const log_group_header* >(buf->cbytes());
@@ -296,33 +354,82 @@ log_buffer LogDev::read(const logdev_key& key, serialized_log_record& return_rec
     HS_LOG_ASSERT_GE(header->total_size(), header->_inline_data_offset(), "Inconsistent size data in log group {} {}",
                      m_logdev_id, *header);
 
-    // We can only do crc match in read if we have read all the blocks. We don't want to aggressively read more data
-    // than we need to just to compare CRC for read operation. It can be done during recovery.
-    if (header->total_size() <= initial_read_size) {
-        crc32_t const crc = crc32_ieee(init_crc32, (buf->cbytes() + sizeof(log_group_header)),
-                                       header->total_size() - sizeof(log_group_header));
-        HS_REL_ASSERT_EQ(header->this_group_crc(), crc, "CRC mismatch on read data");
+    // Read the entire group, so that rest of its records are also served from the cache
+    if (header->total_size() > initial_read_size) {
+        auto const rounded_size = sisl::round_up(header->total_size(), m_vdev->align_size());
+        auto new_buf = sisl::make_byte_array(rounded_size, m_vdev->align_size(), sisl::buftag::logread);
+        ec = m_vdev_jd->sync_pread(new_buf->bytes(), rounded_size, key.dev_offset);
+        if (ec) {
+            LOGERROR("Failed to read from journal vdev log_dev={} {} {}", m_logdev_id, ec.value(), ec.message());
+            return nullptr;
+        }
+        buf = std::move(new_buf);
+        header = r_cast< const log_group_header* >(buf->cbytes());
     }
-    auto record_header = header->nth_record(key.idx - header->start_log_idx);
-    uint32_t const data_offset = (record_header->offset + (record_header->get_inlined() ? 0 : header->oob_data_offset));
 
-    sisl::byte_view ret_view;
-    if ((data_offset + record_header->size) < initial_read_size) {
-        ret_view = sisl::byte_view{buf, data_offset, record_header->size};
-    } else {
-        auto const rounded_data_offset = sisl::round_down(data_offset, m_vdev->align_size());
-        auto const rounded_size =
-            sisl::round_up(record_header->size + data_offset - rounded_data_offset, m_vdev->align_size());
-        auto new_buf = sisl::make_byte_array(rounded_size, m_vdev->align_size(), sisl::buftag::logread);
-        m_vdev_jd->sync_pread(new_buf->bytes(), rounded_size, key.dev_offset + rounded_data_offset);
-        ret_view = sisl::byte_view{new_buf, s_cast< uint32_t >(data_offset - rounded_data_offset), record_header->size};
+    // Since we have read the entire group, crc can be verified for every group we read. Media going bad is reported
+    // to the reader as failed read, instead of crashing.
+    crc32_t const crc = crc32_ieee(init_crc32, (buf->cbytes() + sizeof(log_group_header)),
+                                   header->total_size() - sizeof(log_group_header));
+    if (header->this_group_crc() != crc) {
+        LOGERROR("CRC mismatch on read of log group log_dev={} dev_offset={} expected crc={} actual crc={} {}",
+                 m_logdev_id, key.dev_offset, header->this_group_crc(), crc, *header);
+        return nullptr;
     }
 
-    return_record_header =
-        serialized_log_record(record_header->size, record_header->offset, record_header->get_inlined(),
-                              record_header->store_seq_num, record_header->store_id);
+    log_group_read_cache().put(m_logdev_id, key.dev_offset, buf);
+    return buf;
+}
 
-    return ret_view;
+void LogDev::clear_read_cache() { log_group_read_cache().remove_logdev(m_logdev_id); }
+
+LogGroupReadCache& log_group_read_cache() {
+    static LogGroupReadCache s_cache;
+    return s_cache;
+}
+
+sisl::byte_array LogGroupReadCache::get(logdev_id_t logdev_id, off_t dev_offset, logid_t idx) {
+    std::unique_lock lg{m_mtx};
+    auto it = m_map.find(cache_key_t{logdev_id, dev_offset});
+    if (it == m_map.end()) { return nullptr; }
+
+    auto const* header = r_cast< const log_group_header* >(it->second->second->cbytes());
+    if ((header->start_idx() > idx) || ((header->start_idx() + header->nrecords()) <= idx)) { return nullptr; }
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+}
+
+void LogGroupReadCache::put(logdev_id_t logdev_id, off_t dev_offset, const sisl::byte_array& buf) {
+    uint64_t const max_size = static_cast< uint64_t >(HS_DYNAMIC_CONFIG(logstore.read_cache_size_mb)) * 1024 * 1024;
+    cache_key_t const key{logdev_id, dev_offset};
+
+    std::unique_lock lg{m_mtx};
+    // Stale group at the same offset from before the journal space is reused
+    if (auto it = m_map.find(key); it != m_map.end()) { remove(it); }
+    if (buf->size() > max_size) { return; }
+
+    m_lru.emplace_front(key, buf);
+    m_map.emplace(key, m_lru.begin());
+    m_size += buf->size();
+
+    while (m_size > max_size) {
+        remove(m_map.find(m_lru.back().first));
+    }
+}
+
+void LogGroupReadCache::remove_logdev(logdev_id_t logdev_id) {
+    std::unique_lock lg{m_mtx};
+    auto it = m_map.lower_bound(cache_key_t{logdev_id, std::numeric_limits< off_t >::min()});
+    while ((it != m_map.end()) && (it->first.first == logdev_id)) {
+        remove(it++);
+    }
+}
+
+// Expected to be called with m_mtx held
+void LogGroupReadCache::remove(std::map< cache_key_t, lru_list_t::iterator >::iterator it) {
+    m_size -= it->second->second->size();
+    m_lru.erase(it->second);
+    m_map.erase(it);
 }
 
 logstore_id_t LogDev::reserve_store_id() {
@@ -359,7 +466,7 @@ LogGroup* LogDev::prepare_flush(const int32_t estimated_records) {
 
     assert(estimated_records > 0);
     auto* lg = make_log_group(static_cast< uint32_t >(estimated_records));
-    m_log_records->foreach_contiguous_active(m_last_flush_idx + 1,
+    m_log_records->foreach_contiguous_active(m_last_prepared_idx + 1,
                                              [&](int64_t idx, int64_t, log_record& record) -> bool {
                                                  if (lg->add_record(record, idx)) {
                                                      flushing_upto_idx = idx;
@@ -369,10 +476,19 @@ LogGroup* LogDev::prepare_flush(const int32_t estimated_records) {
                                                  }
                                              });
 
-    lg->finish(m_logdev_id, get_prev_crc());
+    // Chain the crc to the previous prepared log group, which could still be in-flight
+    uint32_t n_inflight;
+    {
+        std::unique_lock lk{m_block_flush_q_mutex};
+        n_inflight = m_inflight_flushes;
+    }
+    lg->finish(m_logdev_id, m_last_prepared_crc, static_cast< uint8_t >(n_inflight));
     if (sisl_unlikely(flushing_upto_idx == -1)) { return nullptr; }
-    lg->m_flush_log_idx_from = m_last_flush_idx + 1;
+    advance_log_group();
+    lg->m_flush_log_idx_from = m_last_prepared_idx + 1;
     lg->m_flush_log_idx_upto = flushing_upto_idx;
+    m_last_prepared_idx = flushing_upto_idx;
+    m_last_prepared_crc = lg->header()->cur_grp_crc;
     HS_DBG_ASSERT_GE(lg->m_flush_log_idx_upto, lg->m_flush_log_idx_from, "log indx upto is smaller then log indx from");
 
     HS_DBG_ASSERT_GT(lg->header()->oob_data_offset, 0);
@@ -408,10 +524,7 @@ bool LogDev::flush_if_needed(int64_t threshold_size) {
             return false;
         }
 
-        bool expected_flushing{false};
-        if (!m_is_flushing.compare_exchange_strong(expected_flushing, true, std::memory_order_acq_rel)) {
-            return false;
-        }
+        if (!acquire_flush_slot()) { return false; }
         THIS_LOGDEV_LOG(TRACE,
                         "Flushing now because either pending_size={} is greater than data_threshold={} or "
                         "elapsed time since last flush={} us is greater than max_time_between_flush={} us",
@@ -421,16 +534,18 @@ bool LogDev::flush_if_needed(int64_t threshold_size) {
         m_last_flush_time = Clock::now();
         // We were able to win the flushing competition and now we gather all the flush data and reserve a slot.
         auto new_idx = m_log_idx.load(std::memory_order_relaxed) - 1;
-        if (m_last_flush_idx >= new_idx) {
+        if (m_last_prepared_idx >= new_idx) {
             THIS_LOGDEV_LOG(TRACE, "Log idx {} is just flushed", new_idx);
-            unlock_flush(false);
+            release_flush_slot(false /* submitted */);
             return false;
         }
 
-        auto* lg = prepare_flush(new_idx - m_last_flush_idx + 4); // Estimate 4 more extra in case of parallel writes
+        // Estimate 4 more extra in case of parallel writes
+        auto* lg = prepare_flush(new_idx - m_last_prepared_idx + 4);
         if (sisl_unlikely(!lg)) {
-            THIS_LOGDEV_LOG(TRACE, "Log idx {} last_flush_idx {} prepare flush failed", new_idx, m_last_flush_idx);
-            unlock_flush(false);
+            THIS_LOGDEV_LOG(TRACE, "Log idx {} last_prepared_idx {} prepare flush failed", new_idx,
+                            m_last_prepared_idx);
+            release_flush_slot(false /* submitted */);
             return false;
         }
         auto sz = m_pending_flush_size.fetch_sub(lg->actual_data_size(), std::memory_order_relaxed);
@@ -442,6 +557,11 @@ bool LogDev::flush_if_needed(int64_t threshold_size) {
         THIS_LOGDEV_LOG(TRACE, "Flushing log group data size={} at offset=0x{} log_group={}", lg->actual_data_size(),
                         to_hex(offset), *lg);
         // THIS_LOGDEV_LOG(DEBUG, "Log Group: {}", *lg);
+        {
+            std::unique_lock lk{m_comp_mutex};
+            m_flush_inflight_q.push_back(lg);
+        }
+        release_flush_slot(true /* submitted */);
         do_flush(lg);
         return true;
     } else {
@@ -449,6 +569,43 @@ bool LogDev::flush_if_needed(int64_t threshold_size) {
     }
 }
 
+uint32_t LogDev::flush_pipeline_depth() {
+    return std::clamp(HS_DYNAMIC_CONFIG(logstore.flush_pipeline_depth), 1u, max_flush_pipeline_depth);
+}
+
+bool LogDev::acquire_flush_slot() {
+    bool expected_flushing{false};
+    if (m_is_flushing.compare_exchange_strong(expected_flushing, true, std::memory_order_acq_rel)) {
+        std::unique_lock lk{m_block_flush_q_mutex};
+        m_preparing_flush = true;
+        return true;
+    }
+
+    // Flush lock is already held. If it is held only by in-flight flushes (and nobody is waiting to take the flush
+    // lock), we can pipeline one more log group as long as the pipeline is not full.
+    std::unique_lock lk{m_block_flush_q_mutex};
+    if (m_preparing_flush || (m_inflight_flushes == 0) || (m_block_flush_q != nullptr) ||
+        (m_inflight_flushes >= flush_pipeline_depth())) {
+        return false;
+    }
+    m_preparing_flush = true;
+    return true;
+}
+
+void LogDev::release_flush_slot(bool submitted) {
+    bool unlock{false};
+    {
+        std::unique_lock lk{m_block_flush_q_mutex};
+        m_preparing_flush = false;
+        if (submitted) {
+            ++m_inflight_flushes;
+        } else {
+            unlock = (m_inflight_flushes == 0);
+        }
+    }
+    if (unlock) { unlock_flush(false); }
+}
+
 void LogDev::do_flush(LogGroup* lg) {
 #ifdef _PRERELEASE
     if (iomgr_flip::instance()->delay_flip< int >(
@@ -478,6 +635,32 @@ void LogDev::do_flush_write(LogGroup* lg) {
 
 void LogDev::on_flush_completion(LogGroup* lg) {
     lg->m_flush_finish_time = Clock::now();
+    {
+        std::unique_lock lk{m_comp_mutex};
+        lg->m_flush_done = true;
+
+        // Completions are delivered in log_idx order. If some other thread is already delivering the completions, it
+        // will pick this group as well, once all earlier groups are completed.
+        if (m_flush_completion_in_progress) { return; }
+        m_flush_completion_in_progress = true;
+    }
+
+    while (true) {
+        LogGroup* done_lg{nullptr};
+        {
+            std::unique_lock lk{m_comp_mutex};
+            if (m_flush_inflight_q.empty() || !m_flush_inflight_q.front()->m_flush_done) {
+                m_flush_completion_in_progress = false;
+                break;
+            }
+            done_lg = m_flush_inflight_q.front();
+            m_flush_inflight_q.pop_front();
+        }
+        process_flush_completion(done_lg);
+    }
+}
+
+void LogDev::process_flush_completion(LogGroup* lg) {
     lg->m_post_flush_msg_rcvd_time = Clock::now();
     THIS_LOGDEV_LOG(TRACE, "Flush completed for logid[{} - {}]", lg->m_flush_log_idx_from, lg->m_flush_log_idx_upto);
 
@@ -499,8 +682,22 @@ void LogDev::on_flush_completion(LogGroup* lg) {
                       get_elapsed_time_us(lg->m_flush_finish_time, lg->m_post_flush_msg_rcvd_time));
     HISTOGRAM_OBSERVE(logstore_service().m_metrics, logdev_post_flush_processing_latency,
                       get_elapsed_time_us(lg->m_post_flush_msg_rcvd_time, lg->m_post_flush_process_done_time));
-    free_log_group(lg);
-    unlock_flush();
+
+    // Release the flush lock only when the last in-flight group is completed and nobody is preparing a new one,
+    // otherwise try to keep the pipeline full.
+    bool unlock{false};
+    {
+        std::unique_lock lk{m_block_flush_q_mutex};
+        HS_DBG_ASSERT_GT(m_inflight_flushes, 0u, "Flush completion without any in-flight flushes");
+        --m_inflight_flushes;
+        unlock = ((m_inflight_flushes == 0) && !m_preparing_flush);
+    }
+
+    if (unlock) {
+        unlock_flush();
+    } else {
+        flush_if_needed();
+    }
 }
 
 bool LogDev::run_under_flush_lock(const flush_blocked_callback& cb) {
@@ -582,6 +779,7 @@ uint64_t LogDev::truncate(const logdev_key& key) {
                         m_logdev_id, key.idx, key.dev_offset, num_records_to_truncate);
         m_log_records->truncate(key.idx);
         off_t new_offset = m_vdev_jd->truncate(key.dev_offset);
+        clear_read_cache();
         THIS_LOGDEV_LOG(DEBUG, "LogDev::truncate done {} offset old {} new {}", key.idx, key.dev_offset, new_offset);
         m_last_truncate_idx = key.idx;
 
@@ -611,6 +809,9 @@ uint64_t LogDev::truncate(const logdev_key& key) {
             m_logdev_meta.remove_rollback_record_upto(key.idx, false /* persist_now */);
             THIS_LOGDEV_LOG(DEBUG, "LogDev::truncate remove rollback {}", key.idx);
             m_logdev_meta.persist();
+
+            // New start offset is persisted, the chunks truncated away are no longer needed upon restart
+            m_vdev_jd->release_truncated_chunks();
 #ifdef _PRERELEASE
             if (garbage_collect && iomgr_flip::instance()->test_flip("logdev_abort_after_garbage")) {
                 THIS_LOGDEV_LOG(INFO, "logdev aborting after unreserving garbage ids");
@@ -756,8 +957,7 @@ void LogDev::on_io_completion(logstore_id_t id, logdev_key ld_key, logdev_key fl
     }
 }
 
-void LogDev::on_logfound(logstore_id_t id, logstore_seq_num_t seq_num, logdev_key ld_key, logdev_key flush_ld_key,
-                         log_buffer buf, uint32_t nremaining_in_batch) {
+void LogDev::on_logs_found(logstore_id_t id, std::vector< log_found_record > const& recs, logdev_key flush_ld_key) {
     HomeLogStore* log_store{nullptr};
 
     {
@@ -768,14 +968,16 @@ void LogDev::on_logfound(logstore_id_t id, logstore_seq_num_t seq_num, logdev_ke
             if (inserted) {
                 // HS_REL_ASSERT(0, "log id  {}-{} not found", m_logdev_id, id);
             }
-            ++unopened_it->second;
+            unopened_it->second += recs.size();
             return;
         }
         log_store = it->second.log_store.get();
     }
     if (!log_store) { return; }
-    log_store->on_log_found(seq_num, ld_key, flush_ld_key, buf);
-    on_batch_completion(log_store, nremaining_in_batch, flush_ld_key);
+
+    // All the records of this store in the group are handed over together, so the group ends here for this store
+    log_store->on_logs_found(recs);
+    log_store->on_batch_completion(flush_ld_key);
 }
 
 void LogDev::on_batch_completion(HomeLogStore* log_store, uint32_t nremaining_in_batch, logdev_key flush_ld_key) {
@@ -901,6 +1103,11 @@ nlohmann::json LogDev::get_status(int verbosity) const {
     if (verbosity == 2) {
         js["logdev_stopped?"] = m_stopped;
         js["is_log_flushing_now?"] = m_is_flushing.load(std::memory_order_relaxed);
+        js["flush_pipeline_depth"] = flush_pipeline_depth();
+        {
+            std::unique_lock lk{m_comp_mutex};
+            js["num_inflight_log_groups"] = m_flush_inflight_q.size();
+        }
         js["logdev_sb_start_offset"] = m_logdev_meta.get_start_dev_offset();
         js["logdev_sb_num_stores_reserved"] = m_logdev_meta.num_stores_reserved();
     }
@@ -16,14 +16,19 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <ostream>
 #include <set>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/intrusive_ptr.hpp>
@@ -46,8 +51,10 @@ static constexpr uint32_t LOG_GROUP_HDR_MAGIC{0xF00D1E};
 static constexpr uint32_t LOG_GROUP_FOOTER_MAGIC{0xB00D1E};
 static constexpr uint32_t dma_address_boundary{512}; // Mininum size the dma/writes to be aligned with
 static constexpr uint32_t initial_read_size{4096};
-// logdev doesn't support concurrent writes. There can only be 2 active log groups.
-static constexpr uint32_t max_log_group{2};
+// Maximum number of log groups that can be in-flight (written but not completed) at the same time. Completions of
+// the in-flight groups are always delivered in log_idx order. One additional group is kept to prepare the next flush.
+static constexpr uint32_t max_flush_pipeline_depth{16};
+static constexpr uint32_t max_log_group{max_flush_pipeline_depth + 1};
 
 // clang-format off
 /*
@@ -178,13 +185,16 @@ struct log_group_header {
 
 #pragma pack(1)
 struct log_group_footer {
-    static constexpr uint8_t footer_version{0};
+    static constexpr uint8_t footer_version{1};
 
-    log_group_footer() : magic{LOG_GROUP_FOOTER_MAGIC}, version{footer_version} {}
+    log_group_footer() : magic{LOG_GROUP_FOOTER_MAGIC}, version{footer_version}, n_inflight_prev{0} {}
     uint32_t magic : 24;
     uint32_t version : 8;
     logid_t start_log_idx;
-    uint8_t padding[12];
+    uint8_t n_inflight_prev; // Earlier groups of this logdev still in-flight when this group was written (version 1+)
+    uint8_t padding[11];
+
+    uint8_t inflight_prev_groups() const { return (version >= 1) ? n_inflight_prev : 0; }
 };
 #pragma pack()
 } // namespace homestore
@@ -255,7 +265,7 @@ public:
     bool add_record(log_record& record, const int64_t log_idx);
     bool can_accomodate(const log_record& record) const { return (m_nrecords <= m_max_records); }
 
-    const iovec_array& finish(logdev_id_t logdev_id, const crc32_t prev_crc);
+    const iovec_array& finish(logdev_id_t logdev_id, const crc32_t prev_crc, uint8_t n_inflight_prev);
     crc32_t compute_crc();
 
     log_group_header* header() { return reinterpret_cast< log_group_header* >(m_cur_log_buf); }
@@ -293,6 +303,7 @@ public:
     off_t m_log_dev_offset;
 
     uint64_t m_flush_multiple_size{0};
+    bool m_flush_done{false};                         // Is write of this group completed (protected by comp mutex)
     Clock::time_point m_flush_finish_time;            // Time at which flush is completed
     Clock::time_point m_post_flush_msg_rcvd_time;     // Time at which flush done message delivered
     Clock::time_point m_post_flush_process_done_time; // Time at which entire log group cb is called
@@ -563,13 +574,29 @@ public:
     log_stream_reader& operator=(const log_stream_reader&) = delete;
     log_stream_reader(log_stream_reader&&) noexcept = delete;
     log_stream_reader& operator=(log_stream_reader&&) noexcept = delete;
-    ~log_stream_reader() = default;
+    ~log_stream_reader();
 
     sisl::byte_view next_group(off_t* out_dev_offset);
     sisl::byte_view group_in_next_page();
 
+    /**
+     * @brief Stop the read ahead of the journal (if running). Journal descriptor seek position should not be used by
+     * the caller, until read ahead is stopped.
+     */
+    void stop_read_ahead();
+
 private:
+    // Bytes read from the journal, size of -1 indicates end of stream
+    struct read_chunk {
+        sisl::byte_array buf;
+        int64_t size{0};
+    };
+
     sisl::byte_view read_next_bytes(uint64_t nbytes, bool& end_of_stream);
+    read_chunk next_read_chunk(uint64_t nbytes);
+    read_chunk sync_read_chunk(uint64_t nbytes);
+    bool claim_read_ahead();
+    void issue_read_ahead(uint64_t bulk_read_size);
 
 private:
     JournalVirtualDev* m_vdev;
@@ -579,6 +606,17 @@ private:
     off_t m_cur_read_bytes{0};
     crc32_t m_prev_crc{0};
     uint64_t m_read_size_multiple;
+
+    // Read ahead of the journal, so that next bulk reads are issued while the current groups are validated and
+    // replayed. Reads are issued one at a time on the logstore sync io fiber, the one in flight is the only one
+    // moving the descriptor seek position.
+    uint32_t m_read_ahead_depth{0};
+    bool m_read_ahead_inflight{false};
+    std::mutex m_read_ahead_mtx;
+    std::condition_variable m_read_ahead_cv;
+    std::deque< read_chunk > m_read_ahead_chunks;
+    bool m_read_ahead_stop{false};
+    bool m_read_ahead_done{false};
 };
 
 struct logstore_info {
@@ -599,6 +637,32 @@ struct truncate_req {
 static std::string const logdev_sb_meta_name{"Logdev_sb"};
 static std::string const logdev_rollback_sb_meta_name{"Logdev_rollback_sb"};
 
+/**
+ * @brief LRU cache of log groups read from the journal, shared by all the logdevs so that they are all bounded by the
+ * single logstore.read_cache_size_mb budget. Groups are keyed by the logdev and their device offset. Readers get
+ * views into these buffers, so evicting a group only drops the cache reference.
+ */
+class LogGroupReadCache {
+public:
+    /// @brief Get the cached group at the offset, if it covers the log idx (a stale group of reused journal space won't)
+    sisl::byte_array get(logdev_id_t logdev_id, off_t dev_offset, logid_t idx);
+    void put(logdev_id_t logdev_id, off_t dev_offset, const sisl::byte_array& buf);
+    void remove_logdev(logdev_id_t logdev_id);
+
+private:
+    using cache_key_t = std::pair< logdev_id_t, off_t >;
+    using lru_list_t = std::list< std::pair< cache_key_t, sisl::byte_array > >;
+
+    void remove(std::map< cache_key_t, lru_list_t::iterator >::iterator it);
+
+    std::mutex m_mtx;
+    lru_list_t m_lru;
+    std::map< cache_key_t, lru_list_t::iterator > m_map;
+    uint64_t m_size{0};
+};
+
+LogGroupReadCache& log_group_read_cache();
+
 class LogDev : public std::enable_shared_from_this< LogDev > {
     friend class HomeLogStore;
 
@@ -680,7 +744,8 @@ public:
      * @param record_header Pass the pointer to the header of the read record
      *
      * @return log_buffer : Opaque structure which contains the data blob and its size. It is safe buffer and hence it
-     * need not be freed and can be cheaply passed it around.
+     * need not be freed and can be cheaply passed it around. It is a view into the (cached) log group buffer, so
+     * holding it keeps the entire log group in memory.
      */
     log_buffer read(const logdev_key& key, serialized_log_record& record_header);
 
@@ -787,8 +852,7 @@ public:
     void on_io_completion(logstore_id_t id, logdev_key ld_key, logdev_key flush_idx, uint32_t nremaining_in_batch,
                           void* ctx);
     void on_log_store_found(logstore_id_t store_id, const logstore_superblk& sb);
-    void on_logfound(logstore_id_t id, logstore_seq_num_t seq_num, logdev_key ld_key, logdev_key flush_ld_key,
-                     log_buffer buf, uint32_t nremaining_in_batch);
+    void on_logs_found(logstore_id_t id, std::vector< log_found_record > const& recs, logdev_key flush_ld_key);
     void on_batch_completion(HomeLogStore* log_store, uint32_t nremaining_in_batch, logdev_key flush_ld_key);
 
     /**
@@ -830,19 +894,34 @@ private:
      */
     logdev_key do_device_truncate(bool dry_run = false);
 
+    // Log groups are used in a ring. Since completions are processed in log_idx order and there are never more than
+    // max_flush_pipeline_depth groups in-flight, the group picked here is always free. The ring advances only once the
+    // group is prepared for flush, so that a group which ended up empty is picked again by the next flush.
     LogGroup* make_log_group(uint32_t estimated_records) {
-        m_log_group_pool[m_log_group_idx].reset(estimated_records);
-        return &m_log_group_pool[m_log_group_idx];
+        auto* lg = &m_log_group_pool[m_log_group_idx];
+        lg->reset(estimated_records);
+        return lg;
     }
-
-    void free_log_group(LogGroup* lg) { m_log_group_idx = !m_log_group_idx; }
+    void advance_log_group() { m_log_group_idx = (m_log_group_idx + 1) % max_log_group; }
 
     LogGroup* prepare_flush(int32_t estimated_record);
 
+    /**
+     * @brief Get a slot to prepare and submit a new log group flush. Slot is given either when flush lock is free (in
+     * which case flush lock is taken) or when the flush lock is held only by in-flight flushes and the pipeline is not
+     * full yet.
+     *
+     * @return true if slot is acquired, caller should call release_flush_slot after submitting the flush
+     */
+    bool acquire_flush_slot();
+    void release_flush_slot(bool submitted);
+    static uint32_t flush_pipeline_depth();
+
     void do_flush(LogGroup* lg);
     void do_flush_write(LogGroup* lg);
     void flush_by_size(uint32_t min_threshold, uint32_t new_record_size = 0, logid_t new_idx = -1);
     void on_flush_completion(LogGroup* lg);
+    void process_flush_completion(LogGroup* lg);
     void do_load(off_t offset);
 
 #if 0
@@ -850,6 +929,14 @@ private:
     sisl::byte_array read_next_header(uint32_t max_buf_reads);
 #endif
 
+    /**
+     * @brief Get the buffer of the entire log group which contains the log id, either from read cache or from device.
+     * Log ids are never reused within a logdev session, so a cached group at the dev_offset which covers the log id
+     * is the right group even if the journal space has been reused.
+     */
+    sisl::byte_array read_log_group(const logdev_key& key);
+    void clear_read_cache();
+
     void _persist_info_block();
     void assert_next_pages(log_stream_reader& lstream);
     void set_flush_status(bool flush_status);
@@ -881,6 +968,8 @@ private:
     logid_t m_last_truncate_idx{-1};
 
     crc32_t m_last_crc{INVALID_CRC32_VALUE};
+    logid_t m_last_prepared_idx{-1};                  // Last log idx prepared for flush (could be in-flight)
+    crc32_t m_last_prepared_crc{INVALID_CRC32_VALUE}; // Crc of the last prepared log group, chained to next group
     log_append_comp_callback m_append_comp_cb{nullptr};
     log_found_callback m_logfound_cb{nullptr};
     store_found_callback m_store_found_cb{nullptr};
@@ -892,8 +981,14 @@ private:
     // Block flush Q request Q
     std::mutex m_block_flush_q_mutex;
     std::condition_variable m_block_flush_q_cv;
-    std::mutex m_comp_mutex;
+    mutable std::mutex m_comp_mutex;
     std::vector< flush_blocked_callback >* m_block_flush_q{nullptr};
+    uint32_t m_inflight_flushes{0}; // Log groups submitted but not completed yet (protected by block_flush_q_mutex)
+    bool m_preparing_flush{false};  // Is any flusher preparing a log group now (protected by block_flush_q_mutex)
+
+    // Log groups which are in-flight, in the order of log_idx (protected by comp_mutex)
+    std::deque< LogGroup* > m_flush_inflight_q;
+    bool m_flush_completion_in_progress{false}; // Is any thread delivering completions now (protected by comp_mutex)
 
     void* m_sb_cookie{nullptr};
     uint64_t m_flush_size_multiple{0};
@@ -53,6 +53,7 @@ void LogGroup::reset(const uint32_t max_records) {
     m_nrecords = 0;
     m_max_records = std::min(max_records, max_records_in_a_batch);
     m_actual_data_size = 0;
+    m_flush_done = false;
 
     m_iovecs.clear();
     m_iovecs.emplace_back(static_cast< void* >(m_cur_log_buf), m_inline_data_pos);
@@ -117,7 +118,7 @@ bool LogGroup::new_iovec_for_footer() const {
     return ((m_inline_data_pos + sizeof(log_group_footer)) >= m_cur_buf_len || m_oob_data_pos != 0);
 }
 
-const iovec_array& LogGroup::finish(logdev_id_t logdev_id, const crc32_t prev_crc) {
+const iovec_array& LogGroup::finish(logdev_id_t logdev_id, const crc32_t prev_crc, uint8_t n_inflight_prev) {
     // add footer
     auto footer = add_and_get_footer();
 
@@ -147,6 +148,7 @@ const iovec_array& LogGroup::finish(logdev_id_t logdev_id, const crc32_t prev_cr
 #endif
 
     footer->start_log_idx = hdr->start_log_idx;
+    footer->n_inflight_prev = n_inflight_prev;
     hdr->cur_grp_crc = compute_crc();
 
     return m_iovecs;
@@ -214,6 +214,29 @@ void HomeLogStore::on_log_found(logstore_seq_num_t seq_num, const logdev_key& ld
     if (m_found_cb != nullptr) m_found_cb(seq_num, buf, nullptr);
 }
 
+void HomeLogStore::on_logs_found(std::vector< log_found_record > const& recs) {
+    if (recs.empty()) { return; }
+
+    logstore_seq_num_t max_seq_num{std::numeric_limits< logstore_seq_num_t >::min()};
+    for (auto const& rec : recs) {
+        m_records.create_and_complete(rec.seq_num, rec.ld_key);
+        max_seq_num = std::max(max_seq_num, rec.seq_num);
+    }
+    atomic_update_max(m_seq_num, max_seq_num + 1, std::memory_order_acq_rel);
+    m_flush_batch_max_lsn = std::max(m_flush_batch_max_lsn, max_seq_num);
+    THIS_LOGSTORE_LOG(DEBUG, "Found {} logs upto lsn={} logdev_key={}", recs.size(), max_seq_num, recs.back().ld_key);
+
+    if (m_found_cb == nullptr) { return; }
+    auto const truncated_upto = m_safe_truncation_boundary.seq_num.load(std::memory_order_acquire);
+    for (auto const& rec : recs) {
+        if (rec.seq_num <= truncated_upto) {
+            THIS_LOGSTORE_LOG(TRACE, "Log lsn={} is already truncated on per device, ignoring", rec.seq_num);
+            continue;
+        }
+        m_found_cb(rec.seq_num, rec.buf, nullptr);
+    }
+}
+
 void HomeLogStore::on_batch_completion(const logdev_key& flush_batch_ld_key) {
     assert(m_flush_batch_max_lsn != std::numeric_limits< logstore_seq_num_t >::min());
 
@@ -13,8 +13,11 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <atomic>
 #include <iterator>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 #include <iomgr/iomgr.hpp>
@@ -64,7 +67,8 @@ void LogStoreService::on_meta_blk_found(const sisl::byte_view& buf, void* meta_c
     HS_REL_ASSERT_EQ(m_sb->version, logstore_service_sb_version, "Invalid version of log service metablk");
 }
 
-folly::Future< std::error_code > LogStoreService::create_vdev(uint64_t size, HSDevType devType, uint32_t chunk_size) {
+folly::Future< std::error_code > LogStoreService::create_vdev(uint64_t size, HSDevType devType, uint32_t chunk_size,
+                                                              bool enable_discard, bool mirrored) {
     const auto atomic_page_size = hs()->device_mgr()->atomic_page_size(devType);
 
     hs_vdev_context hs_ctx;
@@ -91,8 +95,11 @@ folly::Future< std::error_code > LogStoreService::create_vdev(uint64_t size, HSD
                                                         .dev_type = devType,
                                                         .alloc_type = blk_allocator_type_t::none,
                                                         .chunk_sel_type = chunk_selector_type_t::ROUND_ROBIN,
-                                                        .multi_pdev_opts = vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
-                                                        .context_data = hs_ctx.to_blob()});
+                                                        .multi_pdev_opts = mirrored
+                                                            ? vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED
+                                                            : vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
+                                                        .context_data = hs_ctx.to_blob(),
+                                                        .enable_discard = enable_discard});
 
     return vdev->async_format();
 }
@@ -114,9 +121,39 @@ void LogStoreService::start(bool format) {
     // Create an truncate thread loop which handles truncation which does sync IO
     start_threads();
 
+    auto const nthreads =
+        std::min< size_t >(std::max(HS_DYNAMIC_CONFIG(logstore.recovery_parallelism), 1u), m_id_logdev_map.size());
+    if (format || (nthreads <= 1)) {
+        for (auto& [logdev_id, logdev] : m_id_logdev_map) {
+            logdev->start(format);
+        }
+        return;
+    }
+
+    // Each logdev reads and replays its own journal, so recover them in parallel. Logdevs are picked up by the
+    // recovery threads one after the other, so that a big logdev doesn't hold up others queued behind it.
+    auto const start_time = Clock::now();
+    std::vector< std::shared_ptr< LogDev > > logdevs;
+    logdevs.reserve(m_id_logdev_map.size());
     for (auto& [logdev_id, logdev] : m_id_logdev_map) {
-        logdev->start(format);
+        logdevs.push_back(logdev);
+    }
+
+    std::atomic< size_t > next_logdev{0};
+    std::vector< std::thread > recovery_threads;
+    recovery_threads.reserve(nthreads);
+    for (size_t i{0}; i < nthreads; ++i) {
+        recovery_threads.emplace_back(sisl::named_thread("logdev_recovery" + std::to_string(i), [&]() {
+            for (auto n = next_logdev.fetch_add(1); n < logdevs.size(); n = next_logdev.fetch_add(1)) {
+                logdevs[n]->start(false /* format */);
+            }
+        }));
+    }
+    for (auto& t : recovery_threads) {
+        t.join();
     }
+    HS_LOG(INFO, logstore, "Recovered {} logdevs using {} threads in {} ms", logdevs.size(), nthreads,
+           get_elapsed_time_ms(start_time));
 }
 
 void LogStoreService::stop() {
@@ -387,6 +424,8 @@ LogStoreServiceMetrics::LogStoreServiceMetrics() : sisl::MetricsGroup("LogStores
                      {"op", "write"});
     REGISTER_COUNTER(logstore_read_count, "Total number of read requests to log stores", "logstore_op_count",
                      {"op", "read"});
+    REGISTER_COUNTER(logdev_read_cache_hit, "Total number of log reads served from logdev read cache");
+    REGISTER_COUNTER(logdev_read_cache_miss, "Total number of log reads which had to read the log group from device");
     REGISTER_HISTOGRAM(logstore_append_latency, "Logstore append latency", "logstore_op_latency", {"op", "write"});
     REGISTER_HISTOGRAM(logstore_read_latency, "Logstore read latency", "logstore_op_latency", {"op", "read"});
     REGISTER_HISTOGRAM(logdev_flush_size_distribution, "Distribution of flush data size",
@@ -13,6 +13,9 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <iomgr/iomgr.hpp>
+#include <homestore/logstore_service.hpp>
+
 #include "device/chunk.h"
 #include "common/homestore_assert.hpp"
 #include "common/homestore_config.hpp"
@@ -28,12 +31,21 @@ log_stream_reader::log_stream_reader(off_t device_cursor, JournalVirtualDev* vde
         m_vdev{vdev},
         m_vdev_jd{std::move(vdev_jd)},
         m_first_group_cursor{device_cursor},
-        m_read_size_multiple{read_size_multiple} {
+        m_read_size_multiple{read_size_multiple},
+        m_read_ahead_depth{HS_DYNAMIC_CONFIG(logstore.recovery_read_ahead_depth)} {
     // We set the journal descriptor seek_cursor here so that
     // sync_next_read reads from the seek_cursor.
     m_vdev_jd->lseek(m_first_group_cursor);
 }
 
+log_stream_reader::~log_stream_reader() { stop_read_ahead(); }
+
+void log_stream_reader::stop_read_ahead() {
+    std::unique_lock lg{m_read_ahead_mtx};
+    m_read_ahead_stop = true;
+    m_read_ahead_cv.wait(lg, [this] { return !m_read_ahead_inflight; });
+}
+
 sisl::byte_view log_stream_reader::next_group(off_t* out_dev_offset) {
     const uint64_t bulk_read_size =
         uint64_cast(sisl::round_up(HS_DYNAMIC_CONFIG(logstore.bulk_read_size), m_read_size_multiple));
@@ -128,7 +140,7 @@ read_again:
         return ret_buf;
     }
 
-    HS_DBG_ASSERT_EQ(footer->version, log_group_footer::footer_version, "Log footer version mismatch");
+    HS_DBG_ASSERT_LE(footer->version, log_group_footer::footer_version, "Log footer version mismatch");
 
     // verify crc with data
     const crc32_t cur_crc =
@@ -164,26 +176,103 @@ sisl::byte_view log_stream_reader::group_in_next_page() {
 }
 
 sisl::byte_view log_stream_reader::read_next_bytes(uint64_t nbytes, bool& end_of_stream) {
-    // TO DO: Might need to address alignment based on data or fast type
-    const auto prev_pos = m_vdev_jd->seeked_pos();
-    auto sz_to_read = m_vdev_jd->sync_next_read(nullptr, nbytes);
-    if (sz_to_read == -1) {
+    auto chunk = next_read_chunk(nbytes);
+    if (chunk.size == -1) {
         end_of_stream = true;
         return sisl::byte_view{m_cur_log_buf};
     }
 
-    if (sz_to_read == 0) { return sisl::byte_view{m_cur_log_buf}; }
+    if (chunk.size == 0) { return sisl::byte_view{m_cur_log_buf}; }
+
+    // Nothing left over from previous read, use the buffer as is
+    if (m_cur_log_buf.size() == 0) { return sisl::byte_view{chunk.buf, 0, uint32_cast(chunk.size)}; }
+
+    auto out_buf = hs_utils::make_byte_array(chunk.size + m_cur_log_buf.size(), true, sisl::buftag::logread,
+                                             m_vdev->align_size());
+    memcpy(out_buf->bytes(), m_cur_log_buf.bytes(), m_cur_log_buf.size());
+    memcpy(out_buf->bytes() + m_cur_log_buf.size(), chunk.buf->bytes(), chunk.size);
+    return sisl::byte_view{out_buf};
+}
+
+log_stream_reader::read_chunk log_stream_reader::next_read_chunk(uint64_t nbytes) {
+    if (m_read_ahead_depth == 0) { return sync_read_chunk(nbytes); }
+
+    const uint64_t bulk_read_size =
+        uint64_cast(sisl::round_up(HS_DYNAMIC_CONFIG(logstore.bulk_read_size), m_read_size_multiple));
+    bool issue{false};
+    {
+        std::unique_lock lg{m_read_ahead_mtx};
+        issue = claim_read_ahead();
+    }
+    if (issue) { issue_read_ahead(bulk_read_size); }
+
+    read_chunk chunk;
+    {
+        std::unique_lock lg{m_read_ahead_mtx};
+        m_read_ahead_cv.wait(lg, [this] {
+            return !m_read_ahead_chunks.empty() || m_read_ahead_done || m_read_ahead_stop;
+        });
+        if (m_read_ahead_chunks.empty()) {
+            if (m_read_ahead_done) {
+                chunk.size = -1; // Read ahead has reached the end of stream and it is consumed already
+                return chunk;
+            }
+            // Read ahead is stopped and whatever it has read is consumed, continue from where it left
+            lg.unlock();
+            return sync_read_chunk(nbytes);
+        }
+        chunk = std::move(m_read_ahead_chunks.front());
+        m_read_ahead_chunks.pop_front();
+        issue = claim_read_ahead();
+    }
+    if (issue) { issue_read_ahead(bulk_read_size); }
+    return chunk;
+}
 
-    auto out_buf =
-        hs_utils::make_byte_array(sz_to_read + m_cur_log_buf.size(), true, sisl::buftag::logread, m_vdev->align_size());
-    if (m_cur_log_buf.size()) { memcpy(out_buf->bytes(), m_cur_log_buf.bytes(), m_cur_log_buf.size()); }
+// Expected to be called with m_read_ahead_mtx held. Returns true if the caller has to issue the next read ahead.
+bool log_stream_reader::claim_read_ahead() {
+    if (m_read_ahead_inflight || m_read_ahead_stop || m_read_ahead_done ||
+        (m_read_ahead_chunks.size() >= m_read_ahead_depth)) {
+        return false;
+    }
+    m_read_ahead_inflight = true;
+    return true;
+}
 
-    auto sz_read = m_vdev_jd->sync_next_read(out_buf->bytes() + m_cur_log_buf.size(), sz_to_read);
-    assert(sz_read == sz_to_read);
+void log_stream_reader::issue_read_ahead(uint64_t bulk_read_size) {
+    // Journal is read synchronously, so it is done on the logstore's sync io capable fiber. Each read issues the next
+    // one if there is room for it, instead of waiting for the room on the fiber.
+    iomanager.run_on_forget(logstore_service().truncate_thread(), [this, bulk_read_size]() {
+        auto chunk = sync_read_chunk(bulk_read_size);
+        bool issue_next{false};
+        {
+            std::unique_lock lg{m_read_ahead_mtx};
+            m_read_ahead_done = (chunk.size == -1);
+            m_read_ahead_chunks.push_back(std::move(chunk));
+            m_read_ahead_inflight = false;
+            issue_next = claim_read_ahead();
+
+            // Notify under the lock, reader could be destroyed right after stop_read_ahead sees no read in flight
+            m_read_ahead_cv.notify_all();
+        }
+        if (issue_next) { issue_read_ahead(bulk_read_size); }
+    });
+}
+
+log_stream_reader::read_chunk log_stream_reader::sync_read_chunk(uint64_t nbytes) {
+    // TO DO: Might need to address alignment based on data or fast type
+    read_chunk chunk;
+    const auto prev_pos = m_vdev_jd->seeked_pos();
+    chunk.size = m_vdev_jd->sync_next_read(nullptr, nbytes);
+    if (chunk.size <= 0) { return chunk; }
+
+    chunk.buf = hs_utils::make_byte_array(chunk.size, true, sisl::buftag::logread, m_vdev->align_size());
+    auto sz_read = m_vdev_jd->sync_next_read(chunk.buf->bytes(), chunk.size);
+    assert(sz_read == chunk.size);
 
     LOGTRACEMOD(logstore,
                 "LogStream read {} bytes req bytes {} from vdev prev offset {} and vdev cur offset {} log_dev={}",
                 sz_read, nbytes, prev_pos, m_vdev_jd->seeked_pos(), m_vdev_jd->logdev_id());
-    return sisl::byte_view{out_buf};
+    return chunk;
 }
 } // namespace homestore
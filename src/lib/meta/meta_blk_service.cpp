@@ -13,6 +13,7 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
@@ -21,13 +22,18 @@
 #include <memory>
 #include <mutex>
 #include <system_error>
+#include <unordered_map>
+#include <vector>
+#include <sys/uio.h>
 
 #include <sisl/fds/compress.hpp>
 #include <sisl/fds/utils.hpp>
+#include <iomgr/iomgr.hpp>
 #include <iomgr/iomgr_flip.hpp>
 
 #include <homestore/meta_service.hpp>
 #include <homestore/homestore.hpp>
+#include <homestore/work_sharing.hpp>
 #include "device/chunk.h"
 #include <homestore/chunk_selector.h>
 #include "common/homestore_flip.hpp"
@@ -47,7 +53,7 @@ MetaBlkService& meta_service() { return hs()->meta_service(); }
 
 MetaBlkService::MetaBlkService(const char* name) : m_metrics{name} { m_last_mblk_id = std::make_unique< BlkId >(); }
 
-void MetaBlkService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks) {
+void MetaBlkService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_chunks, bool mirrored) {
     const auto phys_page_size = hs()->device_mgr()->optimal_page_size(devType);
 
     meta_vdev_context meta_ctx;
@@ -60,7 +66,9 @@ void MetaBlkService::create_vdev(uint64_t size, HSDevType devType, uint32_t num_
                                                     .dev_type = devType,
                                                     .alloc_type = blk_allocator_type_t::varsize,
                                                     .chunk_sel_type = chunk_selector_type_t::ROUND_ROBIN,
-                                                    .multi_pdev_opts = vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
+                                                    .multi_pdev_opts = mirrored
+                                                        ? vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED
+                                                        : vdev_multi_pdev_opts_t::ALL_PDEV_STRIPED,
                                                     .context_data = meta_ctx.to_blob()});
 }
 
@@ -105,8 +113,15 @@ void MetaBlkService::start(bool need_format) {
 }
 
 void MetaBlkService::stop() {
+    // Async updates queued ahead of this are written before the worker is stopped
+    stop_upd_writer();
     {
         std::lock_guard< decltype(m_shutdown_mtx) > lg_shutdown{m_shutdown_mtx};
+        if (m_inited && m_dir_dirty) {
+            // persist the directory, so that next startup could load the meta blks in a few large ios
+            std::lock_guard< decltype(m_meta_mtx) > lg{m_meta_mtx};
+            write_meta_blk_dir();
+        }
         cache_clear();
 
         {
@@ -131,6 +146,7 @@ void MetaBlkService::cache_clear() {
 
     m_meta_blks.clear();
     m_ovf_blk_hdrs.clear();
+    free_prefetched_ovf_data();
 }
 
 void MetaBlkService::read(const BlkId& bid, uint8_t* dest, size_t sz) const {
@@ -218,8 +234,198 @@ void MetaBlkService::write_ssb() {
 
 void MetaBlkService::scan_meta_blks() {
     cache_clear();
+    auto const start_time = Clock::now();
     const auto self_recover = scan_and_load_meta_blks(m_meta_blks, m_ovf_blk_hdrs, m_last_mblk_id.get(), m_sub_info);
+    HISTOGRAM_OBSERVE(m_metrics, scan_latency, get_elapsed_time_us(start_time));
+    HS_LOG(INFO, metablk, "Scanned {} meta blks and {} ovf blks in {} us, dir_dirty={}", m_meta_blks.size(),
+           m_ovf_blk_hdrs.size(), get_elapsed_time_us(start_time), m_dir_dirty);
     if (self_recover) { set_self_recover(); }
+
+    std::lock_guard< decltype(m_meta_mtx) > lg{m_meta_mtx};
+    if (m_dir_dirty) { write_meta_blk_dir(); }
+}
+
+void MetaBlkService::write_meta_blk_dir() {
+    HS_DBG_ASSERT(m_meta_mtx.try_lock() == false, "mutex should be already be locked");
+    if (!HS_DYNAMIC_CONFIG(metablk.meta_blk_dir_enabled)) { return; }
+
+    std::vector< BlkId > bids;
+    bids.reserve(m_meta_blks.size() + m_ovf_blk_hdrs.size());
+    for (auto const& [id, mblk] : m_meta_blks) {
+        bids.push_back(mblk->hdr.h.bid);
+    }
+    for (auto const& [id, ovf_hdr] : m_ovf_blk_hdrs) {
+        bids.push_back(ovf_hdr->h.bid);
+    }
+    auto const nhdr_entries = bids.size();
+    for (auto const& [id, ovf_hdr] : m_ovf_blk_hdrs) {
+        auto const* data_bid = ovf_hdr->get_data_bid();
+        bids.insert(bids.end(), data_bid, data_bid + ovf_hdr->h.nbids);
+    }
+
+    auto const entries_sz = bids.size() * sizeof(BlkId);
+    auto const dir_sz = sisl::round_up(sizeof(meta_blk_dir_hdr) + entries_sz, block_size());
+    auto const nblks = dir_sz / block_size();
+    if (nblks > max_blks_per_blkid()) {
+        HS_LOG(WARN, metablk, "meta blk directory of {} entries is too large, skip writing it", bids.size());
+        return;
+    }
+
+    BlkId dir_bid;
+    blk_alloc_hints hints;
+    hints.is_contiguous = true;
+    try {
+        if (m_sb_vdev->alloc_contiguous_blks(s_cast< blk_count_t >(nblks), hints, dir_bid) != BlkAllocStatus::SUCCESS) {
+            HS_LOG(WARN, metablk, "Unable to allocate {} contiguous blks for meta blk directory", nblks);
+            return;
+        }
+    } catch (const std::exception& e) {
+        HS_LOG(WARN, metablk, "Unable to allocate {} contiguous blks for meta blk directory: {}", nblks, e.what());
+        return;
+    }
+
+    auto* dir = r_cast< meta_blk_dir_hdr* >(hs_utils::iobuf_alloc(dir_sz, sisl::buftag::metablk, align_size()));
+    std::memset(voidptr_cast(dir), 0, dir_sz);
+    dir->magic = META_BLK_DIR_MAGIC;
+    dir->version = META_BLK_DIR_VERSION;
+    dir->nentries = uint32_cast(nhdr_entries);
+    dir->ndata_entries = uint32_cast(bids.size() - nhdr_entries);
+    dir->bid = dir_bid;
+    std::memcpy(voidptr_cast(dir->get_entries_mutable()), bids.data(), entries_sz);
+    dir->crc = crc32_ieee(init_crc32, r_cast< const uint8_t* >(dir->get_entries()), entries_sz);
+
+    auto error = m_sb_vdev->sync_write(r_cast< const char* >(dir), uint32_cast(dir_sz), dir_bid);
+    hs_utils::iobuf_free(uintptr_cast(dir), sisl::buftag::metablk);
+    if (error.value()) {
+        HS_LOG(WARN, metablk, "error {} while writing meta blk directory at {}", error.value(), dir_bid.to_string());
+        m_sb_vdev->free_blk(dir_bid);
+        return;
+    }
+
+    // point ssb to the new directory only after it is persisted, then release the old one
+    auto const old_dir_bid = m_ssb->dir_bid;
+    m_ssb->dir_bid = dir_bid;
+    write_ssb();
+    if (old_dir_bid.is_valid()) { m_sb_vdev->free_blk(old_dir_bid); }
+    m_dir_dirty = false;
+
+    HS_LOG(INFO, metablk, "Written meta blk directory at {} with {} entries", dir_bid.to_string(), bids.size());
+}
+
+std::unordered_map< uint64_t, uint8_t* >
+MetaBlkService::prefetch_meta_blk_dir(std::unordered_map< uint64_t, uint8_t* >& ovf_data) {
+    std::unordered_map< uint64_t, uint8_t* > blks;
+    auto const dir_bid = m_ssb->dir_bid;
+
+    // Unless the directory is loaded, its blks are not committed and could be reused, so it should never be freed
+    m_ssb->dir_bid.invalidate();
+    if (!dir_bid.is_valid() || !HS_DYNAMIC_CONFIG(metablk.meta_blk_dir_enabled)) { return blks; }
+
+    auto const dir_sz = uint64_cast(dir_bid.blk_count()) * block_size();
+    auto* dir = r_cast< meta_blk_dir_hdr* >(hs_utils::iobuf_alloc(dir_sz, sisl::buftag::metablk, align_size()));
+    read(dir_bid, uintptr_cast(dir), dir_sz);
+
+#ifdef _PRERELEASE
+    if (HomeStoreFlip::instance()->test_flip("meta_blk_dir_corrupt")) { dir->crc = ~dir->crc; }
+#endif
+
+    // version 0x1 directory has no ovf data entries and its ndata_entries is zeroed pad
+    auto const nentries = uint64_cast(dir->nentries) + dir->ndata_entries;
+    auto const entries_sz = nentries * sizeof(BlkId);
+    if ((dir->magic != META_BLK_DIR_MAGIC) || (dir->version > META_BLK_DIR_VERSION) ||
+        (dir->bid.to_integer() != dir_bid.to_integer()) || (sizeof(meta_blk_dir_hdr) + entries_sz > dir_sz) ||
+        (dir->crc != crc32_ieee(init_crc32, r_cast< const uint8_t* >(dir->get_entries()), entries_sz))) {
+        HS_LOG(WARN, metablk, "meta blk directory at {} is not valid, fall back to meta blk chain walk",
+               dir_bid.to_string());
+        hs_utils::iobuf_free(uintptr_cast(dir), sisl::buftag::metablk);
+        return blks;
+    }
+
+    // directory extent stays allocated until a newer directory replaces it
+    auto alloc_status = m_sb_vdev->commit_blk(dir_bid);
+    if (alloc_status != BlkAllocStatus::SUCCESS) HS_REL_ASSERT(0, "Failed to commit blk: {} ", dir_bid.to_string());
+    m_ssb->dir_bid = dir_bid;
+
+    std::vector< BlkId > bids;
+    bids.reserve(dir->nentries);
+    for (uint32_t i{0}; i < dir->nentries; ++i) {
+        if (dir->get_entries()[i].blk_count() == 1) { bids.push_back(dir->get_entries()[i]); }
+    }
+    std::vector< BlkId > data_bids(dir->get_entries() + dir->nentries, dir->get_entries() + nentries);
+    hs_utils::iobuf_free(uintptr_cast(dir), sisl::buftag::metablk);
+
+    auto const sort_unique = [](std::vector< BlkId >& v) {
+        std::sort(v.begin(), v.end(), [](BlkId const& a, BlkId const& b) {
+            return (a.chunk_num() != b.chunk_num()) ? (a.chunk_num() < b.chunk_num()) : (a.blk_num() < b.blk_num());
+        });
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    };
+    sort_unique(bids);
+    sort_unique(data_bids);
+
+    // Adjacent header blks are grouped, each group is read in one io into a buf per blk. Each ovf data blkid is read in
+    // one io into a single buf, as it is read back as a whole.
+    struct dir_read {
+        BlkId bid;
+        std::vector< uint8_t* > bufs;
+        bool is_data;
+        bool ok{false};
+    };
+    std::vector< dir_read > reads;
+    for (size_t i{0}; i < bids.size(); ++i) {
+        if (!reads.empty()) {
+            auto& r = reads.back();
+            if ((r.bid.chunk_num() == bids[i].chunk_num()) && (r.bid.blk_num() + r.bufs.size() == bids[i].blk_num()) &&
+                (r.bufs.size() < MAX_META_BLKS_PER_READ)) {
+                r.bufs.push_back(hs_utils::iobuf_alloc(block_size(), sisl::buftag::metablk, align_size()));
+                continue;
+            }
+        }
+        reads.push_back(dir_read{bids[i], {hs_utils::iobuf_alloc(block_size(), sisl::buftag::metablk, align_size())},
+                                 false /* is_data */});
+    }
+    auto const nhdr_reads = reads.size();
+    for (auto const& bid : data_bids) {
+        auto const sz = uint64_cast(bid.blk_count()) * block_size();
+        reads.push_back(dir_read{bid, {hs_utils::iobuf_alloc(sz, sisl::buftag::metablk, align_size())}, true});
+    }
+
+    // Caller itself reads along with the other fibers which could do sync io
+    run_shared_works(reads.size(), MAX_META_DIR_READ_FIBERS, iomanager.sync_io_capable_fibers(),
+                     [this, &reads](size_t i) {
+                         auto& r = reads[i];
+                         std::vector< iovec > iovs;
+                         if (r.is_data) {
+                             iovs.push_back(iovec{voidptr_cast(r.bufs[0]), r.bid.blk_count() * block_size()});
+                         } else {
+                             for (auto* buf : r.bufs) {
+                                 iovs.push_back(iovec{voidptr_cast(buf), block_size()});
+                             }
+                         }
+                         auto const bid = r.is_data ? r.bid
+                                                    : BlkId{r.bid.blk_num(), s_cast< blk_count_t >(r.bufs.size()),
+                                                            r.bid.chunk_num()};
+                         r.ok = !m_sb_vdev->sync_readv(iovs.data(), s_cast< int >(iovs.size()), bid);
+                     });
+
+    uint64_t ndata_blks{0};
+    for (auto& r : reads) {
+        for (size_t k{0}; k < r.bufs.size(); ++k) {
+            if (!r.ok) {
+                hs_utils::iobuf_free(r.bufs[k], sisl::buftag::metablk);
+            } else if (r.is_data) {
+                ovf_data[r.bid.to_integer()] = r.bufs[k];
+                ndata_blks += r.bid.blk_count();
+            } else {
+                blks[BlkId{s_cast< blk_num_t >(r.bid.blk_num() + k), 1, r.bid.chunk_num()}.to_integer()] = r.bufs[k];
+            }
+        }
+    }
+    HS_LOG(INFO, metablk, "Read {} hdr blks and {} ovf data blks listed in meta blk directory {} in {}+{} ios",
+           blks.size(), ndata_blks, dir_bid.to_string(), nhdr_reads, reads.size() - nhdr_reads);
+    COUNTER_INCREMENT(m_metrics, dir_prefetched_blks, blks.size() + ndata_blks);
+    m_last_scan_stats.dir_prefetched_blks = blks.size() + ndata_blks;
+    return blks;
 }
 
 bool MetaBlkService::scan_and_load_meta_blks(meta_blk_map_t& meta_blks, ovf_hdr_map_t& ovf_blk_hdrs,
@@ -230,13 +436,29 @@ bool MetaBlkService::scan_and_load_meta_blks(meta_blk_map_t& meta_blks, ovf_hdr_
     auto prev_meta_bid = m_ssb->bid;
     auto self_recover{false};
 
+    // Headers listed in the directory are read upfront in large ios, the chain walk below reads from disk only the blks
+    // directory doesn't have (e.g. added after the directory was written).
+    m_last_scan_stats = meta_scan_stats{};
+    std::unordered_map< uint64_t, uint8_t* > prefetched_data;
+    auto prefetched = prefetch_meta_blk_dir(prefetched_data);
+    auto const has_dir = !prefetched.empty();
+    uint64_t nmisses{0};
+    auto const load_blk = [this, &prefetched, &nmisses](BlkId const& b) -> uint8_t* {
+        if (auto it = prefetched.find(b.to_integer()); it != prefetched.end()) {
+            auto* buf = it->second;
+            prefetched.erase(it);
+            return buf;
+        }
+        ++nmisses;
+        auto* buf = hs_utils::iobuf_alloc(block_size(), sisl::buftag::metablk, align_size());
+        read(b, buf, block_size());
+        return buf;
+    };
+
     while (bid.is_valid()) {
         *last_mblk_id = bid;
 
-        // TODO: add a new API in blkstore read to by pass cache;
-        // e.g. take caller's read buf to avoid this extra memory copy;
-        auto* mblk = r_cast< meta_blk* >(hs_utils::iobuf_alloc(block_size(), sisl::buftag::metablk, align_size()));
-        read(bid, uintptr_cast(mblk), block_size());
+        auto* mblk = r_cast< meta_blk* >(load_blk(bid));
 
         // add meta blk to cache;
         meta_blks[bid.to_integer()] = mblk;
@@ -293,9 +515,7 @@ bool MetaBlkService::scan_and_load_meta_blks(meta_blk_map_t& meta_blks, ovf_hdr_
 
         while (obid.is_valid()) {
             // ovf blk header occupies whole blk;
-            auto* ovf_hdr =
-                r_cast< meta_blk_ovf_hdr* >(hs_utils::iobuf_alloc(block_size(), sisl::buftag::metablk, align_size()));
-            read(obid, uintptr_cast(ovf_hdr), block_size());
+            auto* ovf_hdr = r_cast< meta_blk_ovf_hdr* >(load_blk(obid));
 
             // verify self bid
             HS_REL_ASSERT_EQ(ovf_hdr->h.bid.to_integer(), obid.to_integer(), "Corrupted self-bid: {}/{}",
@@ -351,6 +571,37 @@ bool MetaBlkService::scan_and_load_meta_blks(meta_blk_map_t& meta_blks, ovf_hdr_
         bid = mblk->hdr.h.next_bid;
     }
 
+    // directory needs a rewrite if it missed any blk or had blks which are no longer in use
+    // Keep the ovf data of the loaded ovf blks for the recovery to read, the rest is of the blks no longer in use
+    uint64_t ndata_misses{0};
+    {
+        std::lock_guard< decltype(m_prefetched_data_mtx) > plg{m_prefetched_data_mtx};
+        for (auto const& [id, ovf_hdr] : ovf_blk_hdrs) {
+            auto const* data_bid = ovf_hdr->get_data_bid();
+            for (decltype(ovf_hdr->h.nbids) i{0}; i < ovf_hdr->h.nbids; ++i) {
+                auto const it = prefetched_data.find(data_bid[i].to_integer());
+                if (it == prefetched_data.end()) {
+                    ++ndata_misses;
+                    continue;
+                }
+                m_prefetched_ovf_data[it->first] = it->second;
+                prefetched_data.erase(it);
+            }
+        }
+    }
+
+    if (has_dir) {
+        COUNTER_INCREMENT(m_metrics, dir_prefetch_miss_cnt, nmisses + ndata_misses);
+        m_last_scan_stats.dir_misses = nmisses + ndata_misses;
+    }
+    m_dir_dirty = !has_dir || (nmisses != 0) || (ndata_misses != 0) || !prefetched.empty() || !prefetched_data.empty();
+    for (auto& [id, buf] : prefetched) {
+        hs_utils::iobuf_free(buf, sisl::buftag::metablk);
+    }
+    for (auto& [id, buf] : prefetched_data) {
+        hs_utils::iobuf_free(buf, sisl::buftag::metablk);
+    }
+
     return self_recover;
 }
 
@@ -482,6 +733,7 @@ void MetaBlkService::write_ovf_blk_to_disk(meta_blk_ovf_hdr* ovf_hdr, const uint
     // write data blk to disk;
     size_t size_written{0};
     auto* data_bid = ovf_hdr->get_data_bid();
+    drop_prefetched_ovf_data(data_bid, ovf_hdr->h.nbids);
     for (decltype(ovf_hdr->h.nbids) i{0}; i < ovf_hdr->h.nbids; ++i) {
         uint8_t* cur_ptr;
         uint32_t cur_size;
@@ -540,6 +792,45 @@ void MetaBlkService::write_meta_blk_to_disk(meta_blk* mblk) {
     }
 }
 
+void MetaBlkService::write_meta_blk_hdrs_to_disk(std::vector< meta_blk* >& mblks) {
+    std::sort(mblks.begin(), mblks.end(), [](meta_blk const* a, meta_blk const* b) {
+        auto const& ba = a->hdr.h.bid;
+        auto const& bb = b->hdr.h.bid;
+        return (ba.chunk_num() != bb.chunk_num()) ? (ba.chunk_num() < bb.chunk_num()) : (ba.blk_num() < bb.blk_num());
+    });
+
+    std::vector< iovec > iovs;
+    size_t i{0};
+    while (i < mblks.size()) {
+        auto const& first_bid = mblks[i]->hdr.h.bid;
+        iovs.clear();
+        for (auto j = i; (j < mblks.size()) && (iovs.size() < MAX_META_HDRS_PER_WRITE); ++j) {
+            auto const& bid = mblks[j]->hdr.h.bid;
+            if ((bid.chunk_num() != first_bid.chunk_num()) || (bid.blk_num() != first_bid.blk_num() + iovs.size())) {
+                break;
+            }
+            iovs.push_back(iovec{voidptr_cast(mblks[j]), block_size()});
+        }
+
+        if (iovs.size() == 1) {
+            write_meta_blk_to_disk(mblks[i]);
+        } else {
+            auto const bid = BlkId{first_bid.blk_num(), s_cast< blk_count_t >(iovs.size()), first_bid.chunk_num()};
+            auto error = m_sb_vdev->sync_writev(iovs.data(), s_cast< int >(iovs.size()), bid);
+            if (error.value()) {
+                // The combined io could fail where the single blk writes don't (e.g. device limits on io size), retry
+                // them one by one, which fail hard on error as any meta blk write does.
+                HS_LOG(ERROR, metablk, "error during write of {} meta blk hdrs at {}: {}, writing them one by one",
+                       iovs.size(), bid.to_string(), error.message());
+                for (size_t j{i}; j < i + iovs.size(); ++j) {
+                    write_meta_blk_to_disk(mblks[j]);
+                }
+            }
+        }
+        i += iovs.size();
+    }
+}
+
 //
 // write blks to disks in reverse order
 // 1. write meta blk chain to disk;
@@ -575,6 +866,7 @@ meta_blk* MetaBlkService::init_meta_blk(BlkId& bid, meta_sub_type type, const ui
 
     // this mblk is now the last;
     mblk->hdr.h.next_bid.invalidate();
+    m_dir_dirty = true;
 
     // write this meta blk to disk
     write_meta_blk_internal(mblk, context_data, sz);
@@ -610,6 +902,8 @@ void MetaBlkService::write_meta_blk_ovf(BlkId& out_obid, const uint8_t* context_
                                         const std::string& type) {
     HS_DBG_ASSERT(m_meta_mtx.try_lock() == false, "mutex should be already be locked");
 
+    m_dir_dirty = true;
+
     // allocate data blocks
     static thread_local std::vector< BlkId > context_data_blkids{};
     context_data_blkids.clear();
@@ -664,7 +958,8 @@ void MetaBlkService::write_meta_blk_ovf(BlkId& out_obid, const uint8_t* context_
     HS_REL_ASSERT_EQ(offset_in_ctx, sz);
 }
 
-void MetaBlkService::write_meta_blk_internal(meta_blk* mblk, const uint8_t* context_data, uint64_t sz) {
+void MetaBlkService::write_meta_blk_internal(meta_blk* mblk, const uint8_t* context_data, uint64_t sz,
+                                             bool write_hdr) {
     auto data_sz = sz;
     // start compression
     if (HS_DYNAMIC_CONFIG(metablk.compress_feature_on) && (sz >= min_compress_size())) {
@@ -750,6 +1045,7 @@ void MetaBlkService::write_meta_blk_internal(meta_blk* mblk, const uint8_t* cont
     }
 
     // write meta blk;
+    if (!write_hdr) { return; }
     write_meta_blk_to_disk(mblk);
 
 #ifdef _PRERELEASE
@@ -801,14 +1097,173 @@ void MetaBlkService::_cookie_sanity_check(const void* cookie) const {
 // 2. update the meta_blk
 // 3. free old ovf_bid if there is any
 //
+// The update goes through the group commit queue, so that it is ordered with any async update of the same sb. Caller
+// waits for it to be persisted, hence its buffer is not copied.
+//
 void MetaBlkService::update_sub_sb(const uint8_t* context_data, uint64_t sz, void* cookie) {
-    std::lock_guard< decltype(m_meta_mtx) > lg{m_meta_mtx};
+    // Wait in a fiber friendly way, as the updater writing this batch could be another fiber of the same reactor. The
+    // writer could also hand the writing of the pending updates, including this one, over to us.
+    auto promise = std::make_shared< iomgr::FiberManagerLib::Promise< bool > >();
+    auto taken_over = std::make_shared< bool >(false);
+    auto fut = promise->get_future();
+    queue_sub_sb_update(
+        context_data, sz, cookie, false /* copy_data */,
+        [promise, taken_over](bool success) {
+            if (!*taken_over) { promise->set_value(success); }
+        },
+        [promise, taken_over]() {
+            *taken_over = true;
+            promise->set_value(true);
+        });
+    fut.get();
+    if (*taken_over) { flush_pending_updates(); }
+}
+
+folly::Future< bool > MetaBlkService::async_update_sub_sb(const uint8_t* context_data, uint64_t sz, void* cookie) {
+    auto promise = std::make_shared< folly::Promise< bool > >();
+    auto fut = promise->getFuture();
+    queue_sub_sb_update(context_data, sz, cookie, true /* copy_data */,
+                        [promise](bool success) { promise->setValue(success); });
+    return fut;
+}
+
+void MetaBlkService::queue_sub_sb_update(const uint8_t* context_data, uint64_t sz, void* cookie, bool copy_data,
+                                         std::function< void(bool) > done_cb, std::function< void() > take_over_cb) {
     HS_REL_ASSERT_EQ(m_inited, true, "accessing metablk store before init is not allowed.");
+    {
+        std::lock_guard< decltype(m_pending_upd_mtx) > lg{m_pending_upd_mtx};
+        auto& req = m_pending_updates[s_cast< meta_blk* >(cookie)];
+        if (!req.done_cbs.empty()) { COUNTER_INCREMENT(m_metrics, update_coalesced_cnt, 1); }
+        if (copy_data) {
+            req.owned_data.assign(context_data, context_data + sz);
+            req.context_data = req.owned_data.data();
+        } else {
+            req.owned_data.clear();
+            req.context_data = context_data;
+        }
+        req.sz = sz;
+        req.done_cbs.push_back(std::move(done_cb));
+        if (take_over_cb) { req.take_over_cb = std::move(take_over_cb); }
+
+        // Someone is already writing the pending updates, it will pick this one up as well
+        if (m_upd_flush_in_progress) { return; }
+        m_upd_flush_in_progress = true;
+    }
+
+    if (take_over_cb) {
+        flush_pending_updates();
+    } else {
+        // Async updater mustn't block on meta lock and disk writes, let the worker write for it
+        iomanager.run_on_forget(upd_writer_fiber(), [this]() { flush_pending_updates(); });
+    }
+}
+
+iomgr::io_fiber_t MetaBlkService::upd_writer_fiber() {
+    std::lock_guard< decltype(m_upd_writer_mtx) > lg{m_upd_writer_mtx};
+    if (m_upd_writer_fiber == nullptr) {
+        folly::Promise< folly::Unit > p;
+        auto f = p.getFuture();
+        iomanager.create_reactor("meta_upd", iomgr::INTERRUPT_LOOP, 1u, [this, &p](bool is_started) mutable {
+            if (is_started) {
+                m_upd_writer_fiber = iomanager.iofiber_self();
+                p.setValue();
+            }
+        });
+        std::move(f).get();
+    }
+    return m_upd_writer_fiber;
+}
+
+void MetaBlkService::stop_upd_writer() {
+    std::lock_guard< decltype(m_upd_writer_mtx) > lg{m_upd_writer_mtx};
+    if (m_upd_writer_fiber == nullptr) { return; }
+
+    iomanager.run_on_wait(m_upd_writer_fiber, [] { iomanager.stop_io_loop(); });
+    m_upd_writer_fiber = nullptr;
+}
+
+void MetaBlkService::flush_pending_updates() {
+    while (true) {
+        std::unordered_map< meta_blk*, meta_update_req > reqs;
+        {
+            // Pick the pending updates with meta mutex held, so that a remove_sub_sb can't free a meta blk which is
+            // picked but not yet written.
+            std::lock_guard< decltype(m_meta_mtx) > lg{m_meta_mtx};
+            {
+                std::lock_guard< decltype(m_pending_upd_mtx) > plg{m_pending_upd_mtx};
+                if (m_pending_updates.empty()) {
+                    m_upd_flush_in_progress = false;
+                    break;
+                }
+                reqs.swap(m_pending_updates);
+            }
+
+            COUNTER_INCREMENT(m_metrics, update_batch_cnt, 1);
+            HISTOGRAM_OBSERVE(m_metrics, update_batch_size, reqs.size());
+
+            // Write all the overflow blks and then the headers of all meta blks in the batch. Each meta blk still
+            // follows the same order as a single update (new ovf blks, meta blk header, free old ovf blks), so a
+            // crash in the middle leaves every sb either in old or in new gen.
+            std::vector< meta_blk* > mblks;
+            std::vector< BlkId > ovf_bids_to_free;
+            mblks.reserve(reqs.size());
+            for (auto& [mblk, req] : reqs) {
+                ovf_bids_to_free.push_back(prepare_sub_sb_update(mblk, req.context_data, req.sz));
+                mblks.push_back(mblk);
+            }
+            write_meta_blk_hdrs_to_disk(mblks);
 
 #ifdef _PRERELEASE
-    _cookie_sanity_check(cookie);
+            if (hs()->crash_simulator().crash_if_flip_set("update_sb_abort")) { ovf_bids_to_free.clear(); }
+#endif
+
+            // free the overflow bid if it is there
+            for (auto const& obid : ovf_bids_to_free) {
+                free_ovf_blk_chain(obid);
+            }
+
+#ifdef _PRERELEASE
+            // validate since update will change content of cookie
+            for (auto const mblk : mblks) {
+                _cookie_sanity_check(mblk);
+            }
+#endif
+        }
+
+        for (auto& [mblk, req] : reqs) {
+            for (auto& cb : req.done_cbs) {
+                cb(true);
+            }
+        }
+
+        // Our own update is written in the first batch. Under sustained load there is always more pending, so hand the
+        // writing over to the next synchronous updater instead of writing for everyone else. Asynchronous updaters
+        // have no one waiting to take over, if only those are pending we continue to write them.
+        if (hand_over_pending_updates()) { break; }
+    }
+}
+
+bool MetaBlkService::hand_over_pending_updates() {
+    std::lock_guard< decltype(m_pending_upd_mtx) > plg{m_pending_upd_mtx};
+    for (auto& [mblk, req] : m_pending_updates) {
+        if (!req.take_over_cb) { continue; }
+
+        // Writer stays marked in progress, the new writer continues with the pending updates
+        auto take_over_cb = std::move(req.take_over_cb);
+        req.take_over_cb = nullptr;
+        COUNTER_INCREMENT(m_metrics, update_writer_handover_cnt, 1);
+        take_over_cb();
+        return true;
+    }
+    return false;
+}
+
+BlkId MetaBlkService::prepare_sub_sb_update(meta_blk* mblk, const uint8_t* context_data, uint64_t sz) {
+    HS_DBG_ASSERT(m_meta_mtx.try_lock() == false, "mutex should be already be locked");
+
+#ifdef _PRERELEASE
+    _cookie_sanity_check(mblk);
 #endif
-    meta_blk* mblk = s_cast< meta_blk* >(cookie);
 
     HS_LOG(DEBUG, metablk, "[type={}], update_sub_sb old sb: context_sz: {}, ovf_bid: {}, mstore used size: {}",
            mblk->hdr.h.type, (unsigned long)(mblk->hdr.h.context_sz), mblk->hdr.h.ovf_bid.to_string(),
@@ -838,15 +1293,8 @@ void MetaBlkService::update_sub_sb(const uint8_t* context_data, uint64_t sz, voi
     mblk->hdr.h.ovf_bid.invalidate();
     mblk->hdr.h.gen_cnt += 1;
 
-    // write this meta blk to disk
-    write_meta_blk_internal(mblk, context_data, sz);
-
-#ifdef _PRERELEASE
-    if (hs()->crash_simulator().crash_if_flip_set("update_sb_abort")) { return; }
-#endif
-
-    // free the overflow bid if it is there
-    free_ovf_blk_chain(ovf_bid_to_free);
+    // write the overflow blks of this meta blk to disk, header is written by the caller along with the batch
+    write_meta_blk_internal(mblk, context_data, sz, false /* write_hdr */);
 
     HS_LOG(DEBUG, metablk, "[type={}], update_sub_sb new sb: context_sz: {}, ovf_bid: {}, mstore used size: {}",
            mblk->hdr.h.type, uint64_cast(mblk->hdr.h.context_sz), mblk->hdr.h.ovf_bid.to_string(),
@@ -861,14 +1309,22 @@ void MetaBlkService::update_sub_sb(const uint8_t* context_data, uint64_t sz, voi
 #endif
 
     // no need to update cookie and in-memory meta blk map
-
-#ifdef _PRERELEASE
-    // validate since update will change content of cookie
-    _cookie_sanity_check(cookie);
-#endif
+    return ovf_bid_to_free;
 }
 
 std::error_condition MetaBlkService::remove_sub_sb(void* cookie) {
+    std::vector< std::function< void(bool) > > superseded_cbs;
+    auto const ret = remove_sub_sb_internal(cookie, superseded_cbs);
+
+    // Notify the waiters outside of meta lock, as they could issue meta ops right away
+    for (auto& cb : superseded_cbs) {
+        cb(true);
+    }
+    return ret;
+}
+
+std::error_condition
+MetaBlkService::remove_sub_sb_internal(void* cookie, std::vector< std::function< void(bool) > >& superseded_cbs) {
     std::lock_guard< decltype(m_meta_mtx) > lg{m_meta_mtx};
 #ifdef _PRERELEASE
     _cookie_sanity_check(cookie);
@@ -878,6 +1334,15 @@ std::error_condition MetaBlkService::remove_sub_sb(void* cookie) {
     const BlkId rm_bid = rm_blk->hdr.h.bid;
     const auto type = rm_blk->hdr.h.type;
 
+    // An update of this sb which is not yet written is superseded by the remove
+    {
+        std::lock_guard< decltype(m_pending_upd_mtx) > plg{m_pending_upd_mtx};
+        if (auto it = m_pending_updates.find(rm_blk); it != m_pending_updates.end()) {
+            superseded_cbs = std::move(it->second.done_cbs);
+            m_pending_updates.erase(it);
+        }
+    }
+
     // this record must exist in-memory copy
     HS_DBG_ASSERT(m_meta_blks.find(rm_bid.to_integer()) != m_meta_blks.end(), "{}, id: {} not found!", type,
                   rm_bid.to_string());
@@ -933,6 +1398,7 @@ std::error_condition MetaBlkService::remove_sub_sb(void* cookie) {
 
     // remove the in-memory handle from meta blk map;
     m_meta_blks.erase(rm_bid.to_integer());
+    m_dir_dirty = true;
 
     // clear in-memory cop of meta bids;
     m_sub_info[type].meta_bids.erase(rm_bid.to_integer());
@@ -1089,7 +1555,10 @@ sisl::byte_array MetaBlkService::read_sub_sb_internal(const meta_blk* mblk) cons
                 }
 
                 // TO DO: Might need to differentiate based on data or fast type
-                read(data_bid[i], buf->bytes() + read_offset, sisl::round_up(read_sz_per_db, align_size()));
+                auto const sz = sisl::round_up(read_sz_per_db, align_size());
+                if (!take_prefetched_ovf_data(data_bid[i], buf->bytes() + read_offset, sz)) {
+                    read(data_bid[i], buf->bytes() + read_offset, sz);
+                }
 
                 read_offset_in_this_ovf += read_sz_per_db;
                 read_offset += read_sz_per_db;
@@ -1135,6 +1604,39 @@ void MetaBlkService::recover(bool do_comp_cb) {
         auto& reg_info = x.second;
         if (!reg_info.has_deps) { recover_meta_sub_type(do_comp_cb, x.first); }
     }
+
+    // ovf data prefetched at scan is only for the recovery, later reads go to disk
+    free_prefetched_ovf_data();
+}
+
+bool MetaBlkService::take_prefetched_ovf_data(BlkId const& bid, uint8_t* dest, size_t sz) const {
+    std::lock_guard< decltype(m_prefetched_data_mtx) > lg{m_prefetched_data_mtx};
+    auto const it = m_prefetched_ovf_data.find(bid.to_integer());
+    if (it == m_prefetched_ovf_data.end()) { return false; }
+
+    HS_DBG_ASSERT_LE(sz, bid.blk_count() * block_size());
+    std::memcpy(dest, it->second, sz);
+    hs_utils::iobuf_free(it->second, sisl::buftag::metablk);
+    m_prefetched_ovf_data.erase(it);
+    return true;
+}
+
+void MetaBlkService::drop_prefetched_ovf_data(BlkId const* bids, uint32_t nbids) {
+    std::lock_guard< decltype(m_prefetched_data_mtx) > lg{m_prefetched_data_mtx};
+    for (uint32_t i{0}; i < nbids; ++i) {
+        if (auto const it = m_prefetched_ovf_data.find(bids[i].to_integer()); it != m_prefetched_ovf_data.end()) {
+            hs_utils::iobuf_free(it->second, sisl::buftag::metablk);
+            m_prefetched_ovf_data.erase(it);
+        }
+    }
+}
+
+void MetaBlkService::free_prefetched_ovf_data() {
+    std::lock_guard< decltype(m_prefetched_data_mtx) > lg{m_prefetched_data_mtx};
+    for (auto& [id, buf] : m_prefetched_ovf_data) {
+        hs_utils::iobuf_free(buf, sisl::buftag::metablk);
+    }
+    m_prefetched_ovf_data.clear();
 }
 
 void MetaBlkService::recover_meta_sub_type(bool do_comp_cb, const meta_sub_type& sub_type) {
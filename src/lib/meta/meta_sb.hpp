@@ -33,8 +33,13 @@ static constexpr uint32_t META_BLK_OVF_MAGIC{0xDEADBEEF};
 static constexpr uint32_t META_BLK_SB_MAGIC{0xABCDCEED};
 static constexpr uint32_t META_BLK_SB_VERSION{0x1};
 static constexpr uint32_t META_BLK_VERSION{0x1};
+static constexpr uint32_t META_BLK_DIR_MAGIC{0xDCEDBEED};
+static constexpr uint32_t META_BLK_DIR_VERSION{0x2};
 static constexpr uint32_t MAX_SUBSYS_TYPE_LEN{64};
 static constexpr uint32_t CONTEXT_DATA_OFFSET_ALIGNMENT{64};
+static constexpr uint32_t MAX_META_HDRS_PER_WRITE{64}; // max adjacent meta blk headers coalesced in one write
+static constexpr uint32_t MAX_META_BLKS_PER_READ{256};  // max adjacent blks read in one io while loading directory
+static constexpr uint32_t MAX_META_DIR_READ_FIBERS{8};  // max io fibers reading directory blks in parallel
 
 /**
  * Sub system types and their priorities
@@ -103,9 +108,35 @@ struct meta_blk_sb {
     BlkId bid;
     uint8_t migrated;
     uint8_t pad[7];
+    BlkId dir_bid; // meta blk directory, invalid if there isn't one
     std::string to_string() const {
-        return fmt::format("magic: {}, version: {}, next_bid: {}, self_bid: {}", magic, version, next_bid.to_string(),
-                           bid.to_string());
+        return fmt::format("magic: {}, version: {}, next_bid: {}, self_bid: {}, dir_bid: {}", magic, version,
+                           next_bid.to_string(), bid.to_string(), dir_bid.to_string());
+    }
+};
+#pragma pack()
+
+//
+// Meta blk directory: blkids of all the meta blks and ovf header blks, followed by the data blkids of the ovf blks
+// (from version 0x2), written as one contiguous extent. It lets the startup read all the headers and ovf data in a
+// few large parallel ios instead of walking the chain one blk at a time. It is only a hint, the meta blk chain is
+// still the source of truth, so a stale or missing directory just means more reads.
+//
+#pragma pack(1)
+struct meta_blk_dir_hdr {
+    uint32_t magic;
+    uint32_t version;
+    crc32_t crc;       // crc of the entries
+    uint32_t nentries;      // number of header blkids following this header
+    BlkId bid;              // self blkid covering the whole directory extent
+    uint32_t ndata_entries; // number of ovf data blkids following the header blkids, always 0 in version 0x1
+    uint8_t pad[4];
+
+    const BlkId* get_entries() const {
+        return reinterpret_cast< const BlkId* >(reinterpret_cast< const uint8_t* >(this) + sizeof(meta_blk_dir_hdr));
+    }
+    BlkId* get_entries_mutable() {
+        return reinterpret_cast< BlkId* >(reinterpret_cast< uint8_t* >(this) + sizeof(meta_blk_dir_hdr));
     }
 };
 #pragma pack()
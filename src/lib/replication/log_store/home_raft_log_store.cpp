@@ -40,6 +40,8 @@ static constexpr store_lsn_t to_store_lsn(uint64_t raft_lsn) { return s_cast< st
 static constexpr store_lsn_t to_store_lsn(repl_lsn_t repl_lsn) { return repl_lsn - 1; }
 static constexpr repl_lsn_t to_repl_lsn(store_lsn_t store_lsn) { return store_lsn + 1; }
 
+// NOTE: nuraft::buffer always owns its memory, so this is the only copy of the log record data on the read path.
+// The log_buffer itself is a view into the logdev read cache.
 static nuraft::ptr< nuraft::log_entry > to_nuraft_log_entry(sisl::blob const& log_blob) {
     uint8_t const* raw_ptr = log_blob.cbytes();
     uint64_t term = *r_cast< uint64_t const* >(raw_ptr);
@@ -87,6 +89,7 @@ void HomeRaftLogStore::truncate(uint32_t num_reserved_cnt, repl_lsn_t compact_ls
         REPL_STORE_LOG(INFO, "LogDev={}: Truncating log entries from {} to {}, compact_lsn={}, last_lsn={}",
                        m_logdev_id, start_lsn, truncate_lsn, compact_lsn, last_lsn);
         m_log_store->truncate(truncate_lsn);
+        trim_term_index(to_repl_lsn(s_cast< store_lsn_t >(truncate_lsn)) + 1);
     }
 }
 
@@ -111,7 +114,12 @@ HomeRaftLogStore::HomeRaftLogStore(logdev_id_t logdev_id, logstore_id_t logstore
                                      m_log_store = std::move(log_store);
                                      DEBUG_ASSERT_EQ(m_logstore_id, m_log_store->get_store_id(),
                                                      "Mismatch in passed and create logstore id");
-                                     m_log_store->register_log_found_cb(log_found_cb);
+                                     // Build the term index while the entries are replayed
+                                     m_log_store->register_log_found_cb(
+                                         [this, log_found_cb](store_lsn_t lsn, log_buffer buf, void* ctx) {
+                                             index_term(to_repl_lsn(lsn), extract_term(buf));
+                                             if (log_found_cb) { log_found_cb(lsn, buf, ctx); }
+                                         });
                                      m_log_store->register_log_replay_done_cb(log_replay_done_cb);
                                      REPL_STORE_LOG(DEBUG, "Home Log store created/opened successfully");
                                  });
@@ -163,6 +171,7 @@ ulong HomeRaftLogStore::append(nuraft::ptr< nuraft::log_entry >& entry) {
     auto const next_seq =
         m_log_store->append_async(sisl::io_blob{buf->data_begin(), uint32_cast(buf->size()), false /* is_aligned */},
                                   nullptr /* cookie */, [buf](int64_t, sisl::io_blob&, logdev_key, void*) {});
+    index_term(to_repl_lsn(next_seq), entry->get_term());
     return to_repl_lsn(next_seq);
 }
 
@@ -177,6 +186,7 @@ void HomeRaftLogStore::write_at(ulong index, nuraft::ptr< nuraft::log_entry >& e
 
     m_log_store->append_async(sisl::io_blob{buf->data_begin(), uint32_cast(buf->size()), false /* is_aligned */},
                               nullptr /* cookie */, [buf](int64_t, sisl::io_blob&, logdev_key, void*) {});
+    index_term(s_cast< repl_lsn_t >(index), entry->get_term());
 }
 
 void HomeRaftLogStore::end_of_append_batch(ulong start, ulong cnt) {
@@ -208,6 +218,8 @@ nuraft::ptr< nuraft::log_entry > HomeRaftLogStore::entry_at(ulong index) {
 }
 
 ulong HomeRaftLogStore::term_at(ulong index) {
+    if (auto const t = indexed_term(s_cast< repl_lsn_t >(index)); t.has_value()) { return *t; }
+
     ulong term;
     try {
         auto log_bytes = m_log_store->read_sync(to_store_lsn(index));
@@ -286,14 +298,18 @@ void HomeRaftLogStore::apply_pack(ulong index, nuraft::buffer& pack) {
 bool HomeRaftLogStore::compact(ulong compact_lsn) {
     auto cur_max_lsn = m_log_store->get_contiguous_issued_seq_num(m_last_durable_lsn);
     if (cur_max_lsn < to_store_lsn(compact_lsn)) {
-        // release this assert if for some use case, we should tolorant this case;
-        // for now, don't expect this case to happen.
-        RELEASE_ASSERT(false, "compact_lsn={} is beyond the current max_lsn={}", compact_lsn, cur_max_lsn);
-
-        // We need to fill the remaining entries with dummy data.
+        // This happens when a follower has installed a snapshot which is ahead of its log. Fill the gap with dummy
+        // entries, so that the log is contiguous and then truncate upto compact_lsn right away, so that start_index
+        // moves to compact_lsn + 1 and the log lines up with the snapshot.
+        REPL_STORE_LOG(INFO, "compact_lsn={} is beyond the current max_lsn={}, padding and truncating the log",
+                       compact_lsn, to_repl_lsn(cur_max_lsn));
         for (auto lsn{cur_max_lsn + 1}; lsn <= to_store_lsn(compact_lsn); ++lsn) {
             append(m_dummy_log_entry);
         }
+        m_log_store->flush_sync(to_store_lsn(compact_lsn));
+        m_log_store->truncate(to_store_lsn(compact_lsn));
+        trim_term_index(compact_lsn + 1);
+        return true;
     }
 
     m_log_store->flush_sync(to_store_lsn(compact_lsn));
@@ -318,4 +334,46 @@ ulong HomeRaftLogStore::last_durable_index() {
 
 void HomeRaftLogStore::wait_for_log_store_ready() { m_log_store_future.wait(); }
 
+void HomeRaftLogStore::index_term(repl_lsn_t lsn, uint64_t term) {
+    std::unique_lock lg{m_term_mtx};
+    if (lsn <= m_term_index_end) {
+        // Entries are being overwritten from this lsn, drop their terms
+        m_term_changes.erase(m_term_changes.lower_bound(lsn), m_term_changes.end());
+        m_term_index_end = lsn - 1;
+    }
+
+    if (m_term_changes.empty() || (lsn != m_term_index_end + 1) || (lsn < m_term_index_start)) {
+        // Either first entry or there is a gap in what is indexed, start indexing afresh from this lsn
+        m_term_changes.clear();
+        m_term_index_start = lsn;
+    }
+
+    if (m_term_changes.empty() || (m_term_changes.rbegin()->second != term)) { m_term_changes.emplace(lsn, term); }
+    m_term_index_end = lsn;
+}
+
+void HomeRaftLogStore::trim_term_index(repl_lsn_t start_lsn) {
+    std::unique_lock lg{m_term_mtx};
+    if (start_lsn <= m_term_index_start) { return; }
+    if (start_lsn > m_term_index_end) {
+        m_term_changes.clear();
+        m_term_index_start = start_lsn;
+        m_term_index_end = start_lsn - 1;
+        return;
+    }
+
+    // Retain the change point which covers the new start lsn
+    auto it = std::prev(m_term_changes.upper_bound(start_lsn));
+    auto const term = it->second;
+    m_term_changes.erase(m_term_changes.begin(), std::next(it));
+    m_term_changes.emplace(start_lsn, term);
+    m_term_index_start = start_lsn;
+}
+
+std::optional< uint64_t > HomeRaftLogStore::indexed_term(repl_lsn_t lsn) const {
+    std::unique_lock lg{m_term_mtx};
+    if (m_term_changes.empty() || (lsn < m_term_index_start) || (lsn > m_term_index_end)) { return std::nullopt; }
+    return std::prev(m_term_changes.upper_bound(lsn))->second;
+}
+
 } // namespace homestore
@@ -14,6 +14,10 @@
  *********************************************************************************/
 #pragma once
 
+#include <map>
+#include <mutex>
+#include <optional>
+
 #include <homestore/replication/repl_decls.h>
 #include <homestore/logstore_service.hpp>
 
@@ -192,6 +196,12 @@ public:
 
     void wait_for_log_store_ready();
 
+private:
+    // lsn -> term index maintenance
+    void index_term(repl_lsn_t lsn, uint64_t term);
+    void trim_term_index(repl_lsn_t start_lsn);
+    std::optional< uint64_t > indexed_term(repl_lsn_t lsn) const;
+
 private:
     logstore_id_t m_logstore_id;
     logdev_id_t m_logdev_id;
@@ -199,5 +209,12 @@ private:
     nuraft::ptr< nuraft::log_entry > m_dummy_log_entry;
     store_lsn_t m_last_durable_lsn{-1};
     folly::Future< folly::Unit > m_log_store_future;
+
+    // Compact in-memory lsn -> term index, which holds only the lsns where the term changes. All lsns in the range
+    // [m_term_index_start, m_term_index_end] are indexed and term_at() for them need not read the log entry.
+    mutable std::mutex m_term_mtx;
+    std::map< repl_lsn_t, uint64_t > m_term_changes;
+    repl_lsn_t m_term_index_start{1};
+    repl_lsn_t m_term_index_end{0};
 };
 } // namespace homestore
@@ -4,6 +4,7 @@
 #include <iomgr/iomgr_flip.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/nil_generator.hpp>
+#include <thread>
 
 #include <sisl/fds/buffer.hpp>
 #include <sisl/grpc/generic_service.hpp>
@@ -144,6 +145,346 @@ void RaftReplDev::on_create_snapshot(nuraft::snapshot& s, nuraft::async_result<
     if (when_done) { when_done(ret_val, null_except); }
 }
 
+int RaftReplDev::on_read_snapshot_obj(nuraft::snapshot& s, uint64_t obj_id, raft_buf_ptr_t& data_out,
+                                      bool& is_last_obj) {
+    auto const read_start_time = Clock::now();
+    repl_snapshot snapshot{.last_log_idx_ = s.get_last_log_idx(), .last_log_term_ = s.get_last_log_term()};
+    repl_snapshot_obj obj;
+    obj.cursor = obj_id;
+
+    // With the transfer throttled, obj is capped to what could be sent in a tenth of a second at the configured rate,
+    // so that the pause after it is short
+    uint64_t max_size = HS_DYNAMIC_CONFIG(consensus.snapshot_obj_max_size_kb) * 1024;
+    auto const max_mbps = HS_DYNAMIC_CONFIG(consensus.snapshot_transfer_max_mbps);
+    if (max_mbps != 0) { max_size = std::min(max_size, (uint64_cast(max_mbps) * 1024 * 1024) / 10); }
+
+    auto const err = m_listener->read_snapshot_obj(snapshot, obj, uint32_cast(max_size));
+    if (err != ReplServiceError::OK) {
+        RD_LOGW("Snapshot: Listener failed to read obj cursor={} of snapshot idx={}/term={}, err={}, will retry",
+                obj_id, snapshot.last_log_idx_, snapshot.last_log_term_, enum_name(err));
+        COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+        return -1;
+    }
+    RD_REL_ASSERT(obj.is_last || (obj.next_cursor > obj.cursor),
+                  "Snapshot obj next_cursor={} is expected to be greater than cursor={}", obj.next_cursor, obj.cursor);
+
+    // Read the data of all blks listed by the listener
+    auto const blk_size = get_blk_size();
+    std::vector< sisl::sg_list > sgs_vec;
+    std::vector< folly::Future< std::error_code > > futs;
+    sgs_vec.reserve(obj.blks.size());
+    futs.reserve(obj.blks.size());
+
+    uint64_t total_size = sizeof(snapshot_obj_header) + obj.state.size();
+    for (auto const& b : obj.blks) {
+        uint32_t const data_size = b.blkid.blk_count() * blk_size;
+        sisl::sg_list sgs;
+        sgs.size = data_size;
+        sgs.iovs.emplace_back(iovec{.iov_base = iomanager.iobuf_alloc(blk_size, data_size), .iov_len = data_size});
+        sgs_vec.push_back(sgs);
+        futs.emplace_back(async_read(b.blkid, sgs_vec.back(), data_size));
+        total_size += sizeof(snapshot_blk_header) + b.header.size() + b.blkid.serialized_size() + data_size;
+    }
+
+    auto const free_bufs = [&sgs_vec]() {
+        for (auto const& sgs : sgs_vec) {
+            for (auto const& iov : sgs.iovs) {
+                iomanager.iobuf_free(uintptr_cast(iov.iov_base));
+            }
+        }
+    };
+
+    bool read_failed{false};
+    for (auto const& res : folly::collectAllUnsafe(futs).get()) {
+        if (res.hasException() || res.value()) { read_failed = true; }
+    }
+    if (read_failed) {
+        RD_LOGE("Snapshot: Error in reading data blks of obj cursor={} of snapshot idx={}/term={}, will retry", obj_id,
+                snapshot.last_log_idx_, snapshot.last_log_term_);
+        COUNTER_INCREMENT(m_metrics, read_err_cnt, 1);
+        COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+        free_bufs();
+        return -1;
+    }
+
+    // Pack the header, state and all the blks (with their header, blkid and data) in the obj
+    data_out = nuraft::buffer::alloc(total_size);
+    uint8_t* raw_ptr = data_out->data_begin();
+
+    auto* hdr = new (raw_ptr) snapshot_obj_header();
+    hdr->snp_log_idx = snapshot.last_log_idx_;
+    hdr->snp_log_term = snapshot.last_log_term_;
+    hdr->cursor = obj.cursor;
+    hdr->next_cursor = obj.next_cursor;
+    hdr->is_last = obj.is_last ? 1 : 0;
+    hdr->state_size = obj.state.size();
+    hdr->num_blks = uint32_cast(obj.blks.size());
+    raw_ptr += sizeof(snapshot_obj_header);
+
+    if (obj.state.size()) {
+        std::memcpy(raw_ptr, obj.state.cbytes(), obj.state.size());
+        raw_ptr += obj.state.size();
+    }
+
+    for (size_t i{0}; i < obj.blks.size(); ++i) {
+        auto const& b = obj.blks[i];
+        auto const blkid_blob = b.blkid.serialize();
+        auto* bhdr = new (raw_ptr) snapshot_blk_header();
+        bhdr->user_header_size = b.header.size();
+        bhdr->blkid_size = blkid_blob.size();
+        bhdr->data_size = uint32_cast(sgs_vec[i].size);
+        raw_ptr += sizeof(snapshot_blk_header);
+
+        if (b.header.size()) {
+            std::memcpy(raw_ptr, b.header.cbytes(), b.header.size());
+            raw_ptr += b.header.size();
+        }
+        std::memcpy(raw_ptr, blkid_blob.cbytes(), blkid_blob.size());
+        raw_ptr += blkid_blob.size();
+        std::memcpy(raw_ptr, sgs_vec[i].iovs[0].iov_base, sgs_vec[i].size);
+        raw_ptr += sgs_vec[i].size;
+    }
+    free_bufs();
+    RD_DBG_ASSERT_EQ(uint64_cast(raw_ptr - data_out->data_begin()), total_size, "Snapshot obj size mismatch");
+
+    is_last_obj = obj.is_last;
+    HISTOGRAM_OBSERVE(m_metrics, snapshot_obj_read_latency_us, get_elapsed_time_us(read_start_time));
+    COUNTER_INCREMENT(m_metrics, snapshot_obj_sent_cnt, 1);
+    COUNTER_INCREMENT(m_metrics, snapshot_bytes_sent, total_size);
+    RD_LOGD("Snapshot: Read obj cursor={} next_cursor={} is_last={} state_size={} num_blks={} total_size={} of "
+            "snapshot idx={}/term={}",
+            obj.cursor, obj.next_cursor, obj.is_last, obj.state.size(), obj.blks.size(), total_size,
+            snapshot.last_log_idx_, snapshot.last_log_term_);
+
+    // Throttle by holding on to this obj till the time it would take to send it at the configured rate. Since nuraft
+    // sends one obj at a time per follower and waits for its response, this paces the entire transfer.
+    if (max_mbps != 0) {
+        auto const expected_us = (total_size * 1000000) / (uint64_cast(max_mbps) * 1024 * 1024);
+        auto const elapsed_us = get_elapsed_time_us(read_start_time);
+        if (expected_us > elapsed_us) {
+            COUNTER_INCREMENT(m_metrics, snapshot_throttle_cnt, 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(expected_us - elapsed_us));
+        }
+    }
+    return 0;
+}
+
+void RaftReplDev::on_save_snapshot_obj(nuraft::snapshot& s, uint64_t& obj_id, nuraft::buffer& data,
+                                       bool is_first_obj, bool) {
+    auto const save_start_time = Clock::now();
+    repl_snapshot snapshot{.last_log_idx_ = s.get_last_log_idx(), .last_log_term_ = s.get_last_log_term()};
+
+    uint8_t const* raw_ptr = data.data_begin();
+    size_t remaining = data.size();
+    auto const consume = [&raw_ptr, &remaining](size_t sz) {
+        raw_ptr += sz;
+        remaining -= sz;
+    };
+
+    // Obj is sent by the leader over the network, a malformed one is rejected instead of trusting its fields. obj_id is
+    // left as is, so that the leader resends it, and the snapshot is not applied till all its objs are saved.
+    auto const reject_obj = [this, &snapshot](std::string const& reason) {
+        RD_LOGE("Snapshot: Rejecting obj of snapshot idx={}/term={}, {}", snapshot.last_log_idx_,
+                snapshot.last_log_term_, reason);
+        COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+    };
+
+    // Header fields are copied out of the packed layout, which also takes care of the rpc buffer not being aligned
+    snapshot_obj_header hdr;
+    if (remaining < sizeof(snapshot_obj_header)) {
+        reject_obj(fmt::format("obj of size={} is smaller than its header", remaining));
+        return;
+    }
+    std::memcpy(&hdr, raw_ptr, sizeof(snapshot_obj_header));
+    consume(sizeof(snapshot_obj_header));
+
+    uint64_t const magic = hdr.magic;
+    uint32_t const version = hdr.version;
+    uint64_t const snp_log_idx = hdr.snp_log_idx;
+    uint64_t const snp_log_term = hdr.snp_log_term;
+    uint32_t const state_size = hdr.state_size;
+    uint32_t const num_blks = hdr.num_blks;
+    if ((magic != snapshot_obj_header::SNAPSHOT_OBJ_MAGIC) || (version != snapshot_obj_header::SNAPSHOT_OBJ_VERSION)) {
+        reject_obj(fmt::format("magic={:#x} version={} mismatch", magic, version));
+        return;
+    }
+    if ((snp_log_idx != snapshot.last_log_idx_) || (snp_log_term != snapshot.last_log_term_)) {
+        reject_obj(fmt::format("obj belongs to snapshot idx={}/term={}", snp_log_idx, snp_log_term));
+        return;
+    }
+
+    {
+        std::unique_lock lg{m_snp_rcv_mtx};
+        if ((m_snp_rcv_ctx.snp_log_idx != snapshot.last_log_idx_) ||
+            (m_snp_rcv_ctx.snp_log_term != snapshot.last_log_term_)) {
+            RD_LOGI("Snapshot: Start receiving snapshot idx={}/term={}", snapshot.last_log_idx_,
+                    snapshot.last_log_term_);
+            m_snp_rcv_ctx = snapshot_rcv_ctx{.snp_log_idx = snapshot.last_log_idx_,
+                                             .snp_log_term = snapshot.last_log_term_,
+                                             .next_cursor = 0,
+                                             .completed = false};
+        } else if (is_first_obj && (m_snp_rcv_ctx.next_cursor != 0)) {
+            // Leader restarted sending the same snapshot, ask it to resume from where we left off
+            RD_LOGI("Snapshot: Resume receiving snapshot idx={}/term={} from cursor={}", snapshot.last_log_idx_,
+                    snapshot.last_log_term_, m_snp_rcv_ctx.next_cursor);
+            obj_id = m_snp_rcv_ctx.next_cursor;
+            return;
+        }
+    }
+
+    repl_snapshot_obj obj;
+    obj.cursor = hdr.cursor;
+    obj.next_cursor = hdr.next_cursor;
+    obj.is_last = (hdr.is_last == 1);
+
+    if (state_size) {
+        if (remaining < state_size) {
+            reject_obj(fmt::format("state of size={} overflows the obj", state_size));
+            return;
+        }
+        obj.state = sisl::io_blob_safe{state_size};
+        std::memcpy(obj.state.bytes(), raw_ptr, state_size);
+        consume(state_size);
+    }
+
+    // Write the data of every blk to the locally allocated blks
+    std::vector< sisl::io_blob_safe > data_bufs;
+    std::vector< folly::Future< std::error_code > > futs;
+    obj.blks.reserve(num_blks);
+    data_bufs.reserve(num_blks);
+    futs.reserve(num_blks);
+
+    auto const free_local_blks = [&obj]() {
+        for (auto const& b : obj.blks) {
+            if (b.blkid.is_valid()) { data_service().async_free_blk(b.blkid); }
+        }
+    };
+
+    bool failed{false};
+    for (uint32_t i{0}; i < num_blks; ++i) {
+        snapshot_blk_header bhdr;
+        if (remaining < sizeof(snapshot_blk_header)) {
+            reject_obj(fmt::format("header of blk={} overflows the obj", i));
+            failed = true;
+            break;
+        }
+        std::memcpy(&bhdr, raw_ptr, sizeof(snapshot_blk_header));
+        consume(sizeof(snapshot_blk_header));
+
+        uint32_t const user_header_size = bhdr.user_header_size;
+        uint32_t const data_size = bhdr.data_size;
+        if (remaining < (uint64_cast(user_header_size) + bhdr.blkid_size + data_size)) {
+            reject_obj(fmt::format("blk={} of data_size={} overflows the obj", i, data_size));
+            failed = true;
+            break;
+        }
+
+        auto& entry = obj.blks.emplace_back();
+        if (user_header_size) {
+            entry.header = sisl::io_blob_safe{user_header_size};
+            std::memcpy(entry.header.bytes(), raw_ptr, user_header_size);
+            consume(user_header_size);
+        }
+        consume(bhdr.blkid_size); // Remote blkid is of no use here, other than being informational
+
+        auto hints = m_listener->get_blk_alloc_hints(entry.header, data_size);
+        if (hints.hasError() ||
+            (data_service().alloc_blks(data_size, hints.value(), entry.blkid) != BlkAllocStatus::SUCCESS)) {
+            RD_LOGE("Snapshot: Unable to allocate blks of size={} for obj cursor={}", data_size, obj.cursor);
+            failed = true;
+            break;
+        }
+
+        // Copy the data to an aligned buffer, since rpc buffer is not guaranteed to be aligned
+        auto& buf = data_bufs.emplace_back(data_size, data_service().get_align_size());
+        std::memcpy(buf.bytes(), raw_ptr, data_size);
+        consume(data_size);
+        futs.emplace_back(data_service().async_write(r_cast< const char* >(buf.cbytes()), buf.size(), entry.blkid));
+    }
+
+    for (auto const& res : folly::collectAllUnsafe(futs).get()) {
+        if (res.hasException() || res.value()) {
+            COUNTER_INCREMENT(m_metrics, write_err_cnt, 1);
+            failed = true;
+        }
+    }
+
+    if (!failed) {
+        for (auto const& b : obj.blks) {
+            if (data_service().commit_blk(b.blkid) != BlkAllocStatus::SUCCESS) { failed = true; }
+        }
+    }
+
+    if (!failed) {
+        auto const err = m_listener->write_snapshot_obj(snapshot, obj);
+        if (err != ReplServiceError::OK) {
+            RD_LOGE("Snapshot: Listener failed to write obj cursor={}, err={}", obj.cursor, enum_name(err));
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        // Leave the obj_id as is, so that the leader resends this obj again
+        COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+        free_local_blks();
+        return;
+    }
+
+    {
+        std::unique_lock lg{m_snp_rcv_mtx};
+        m_snp_rcv_ctx.next_cursor = obj.next_cursor;
+        m_snp_rcv_ctx.completed = obj.is_last;
+    }
+    obj_id = obj.next_cursor;
+
+    HISTOGRAM_OBSERVE(m_metrics, snapshot_obj_save_latency_us, get_elapsed_time_us(save_start_time));
+    COUNTER_INCREMENT(m_metrics, snapshot_obj_rcvd_cnt, 1);
+    COUNTER_INCREMENT(m_metrics, snapshot_bytes_rcvd, data.size());
+    RD_LOGD("Snapshot: Saved obj cursor={} next_cursor={} is_last={} state_size={} num_blks={} of snapshot "
+            "idx={}/term={}",
+            obj.cursor, obj.next_cursor, obj.is_last, obj.state.size(), obj.blks.size(), snapshot.last_log_idx_,
+            snapshot.last_log_term_);
+}
+
+bool RaftReplDev::on_apply_snapshot(nuraft::snapshot& s) {
+    repl_snapshot snapshot{.last_log_idx_ = s.get_last_log_idx(), .last_log_term_ = s.get_last_log_term()};
+    {
+        // nuraft calls apply after the last obj, even if saving that obj had failed. Fail the apply in that case, so
+        // that the leader restarts the transfer (which resumes from where we left off).
+        std::unique_lock lg{m_snp_rcv_mtx};
+        if ((m_snp_rcv_ctx.snp_log_idx != snapshot.last_log_idx_) ||
+            (m_snp_rcv_ctx.snp_log_term != snapshot.last_log_term_) || !m_snp_rcv_ctx.completed) {
+            RD_LOGW("Snapshot: Not all objs of snapshot idx={}/term={} are saved yet, failing the apply",
+                    snapshot.last_log_idx_, snapshot.last_log_term_);
+            COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+            return false;
+        }
+    }
+
+    auto const err = m_listener->apply_snapshot(snapshot);
+    if (err != ReplServiceError::OK) {
+        RD_LOGE("Snapshot: Listener failed to apply snapshot idx={}/term={}, err={}", snapshot.last_log_idx_,
+                snapshot.last_log_term_, enum_name(err));
+        COUNTER_INCREMENT(m_metrics, snapshot_err_cnt, 1);
+        return false;
+    }
+
+    {
+        std::unique_lock lg{m_snp_rcv_mtx};
+        m_snp_rcv_ctx = snapshot_rcv_ctx{};
+    }
+
+    m_last_snapshot = nuraft::cs_new< nuraft::snapshot >(s.get_last_log_idx(), s.get_last_log_term(),
+                                                         s.get_last_config(), s.size(), s.get_type());
+    m_commit_upto_lsn.store(s_cast< repl_lsn_t >(s.get_last_log_idx()));
+    flush_durable_commit_lsn();
+    COUNTER_INCREMENT(m_metrics, snapshot_apply_cnt, 1);
+
+    RD_LOGI("Snapshot: Applied snapshot idx={}/term={}, commit lsn moved to {}", snapshot.last_log_idx_,
+            snapshot.last_log_term_, m_commit_upto_lsn.load());
+    return true;
+}
+
 void RaftReplDev::async_alloc_write(sisl::blob const& header, sisl::blob const& key, sisl::sg_list const& data,
                                     repl_req_ptr_t rreq) {
     if (!rreq) { auto rreq = repl_req_ptr_t(new repl_req_ctx{}); }
@@ -1063,13 +1404,13 @@ void RaftReplDev::flush_durable_commit_lsn() {
 }
 
 ///////////////////////////////////  Private metohds ////////////////////////////////////
-void RaftReplDev::cp_flush(CP*) {
+folly::Future< bool > RaftReplDev::cp_flush(CP*) {
     auto const lsn = m_commit_upto_lsn.load();
     auto const clsn = m_compact_lsn.load();
 
     if (lsn == m_last_flushed_commit_lsn) {
         // Not dirtied since last flush ignore
-        return;
+        return folly::makeFuture< bool >(true);
     }
 
     std::unique_lock lg{m_sb_mtx};
@@ -1077,8 +1418,11 @@ void RaftReplDev::cp_flush(CP*) {
     m_rd_sb->durable_commit_lsn = lsn;
     m_rd_sb->checkpoint_lsn = lsn;
     m_rd_sb->last_applied_dsn = m_next_dsn.load();
-    m_rd_sb.write();
+    // sb is copied by the meta service, so it is group committed with the other repl devs' sbs without waiting here;
+    // cp completes only after it is persisted.
+    auto fut = m_rd_sb.async_write();
     m_last_flushed_commit_lsn = lsn;
+    return fut;
 }
 
 void RaftReplDev::cp_cleanup(CP*) {}
@@ -28,6 +28,29 @@ struct raft_repl_dev_superblk : public repl_dev_superblk {
 
     uint32_t get_raft_sb_version() const { return raft_sb_version; }
 };
+
+// Each snapshot obj sent from the leader to the follower is laid out as
+//   [snapshot_obj_header][listener state][snapshot_blk_header][user header][blkid][data] ... (num_blks times)
+struct snapshot_obj_header {
+    static constexpr uint64_t SNAPSHOT_OBJ_MAGIC = 0xAE5A9B0B13C7D001;
+    static constexpr uint32_t SNAPSHOT_OBJ_VERSION = 1;
+
+    uint64_t magic{SNAPSHOT_OBJ_MAGIC};
+    uint32_t version{SNAPSHOT_OBJ_VERSION};
+    uint64_t snp_log_idx{0};  // Last log idx of the snapshot this obj belongs to
+    uint64_t snp_log_term{0}; // Last log term of the snapshot this obj belongs to
+    uint64_t cursor{0};       // Listener cursor this obj starts from, same as the nuraft obj_id
+    uint64_t next_cursor{0};  // Listener cursor of the next obj
+    uint8_t is_last{0};       // Is this the last obj of the snapshot
+    uint32_t state_size{0};   // Size of the listener state following this header
+    uint32_t num_blks{0};     // Number of data blks following the listener state
+};
+
+struct snapshot_blk_header {
+    uint32_t user_header_size{0};
+    uint32_t blkid_size{0};
+    uint32_t data_size{0};
+};
 #pragma pack()
 
 using raft_buf_ptr_t = nuraft::ptr< nuraft::buffer >;
@@ -89,6 +112,21 @@ public:
         REGISTER_HISTOGRAM(data_channel_wait_latency_us, "Data channel wait latency in us",
                            "raft_logstore_append_latency", {"op", "wait_for_data"});
 
+        // Snapshot transfer metrics
+        REGISTER_COUNTER(snapshot_obj_sent_cnt, "total snapshot objs sent", "snapshot_obj_cnt", {"op", "send"});
+        REGISTER_COUNTER(snapshot_obj_rcvd_cnt, "total snapshot objs received", "snapshot_obj_cnt",
+                         {"op", "receive"});
+        REGISTER_COUNTER(snapshot_bytes_sent, "total snapshot bytes sent", "snapshot_bytes", {"op", "send"});
+        REGISTER_COUNTER(snapshot_bytes_rcvd, "total snapshot bytes received", "snapshot_bytes", {"op", "receive"});
+        REGISTER_COUNTER(snapshot_err_cnt, "total snapshot transfer error count", "snapshot_err_cnt");
+        REGISTER_COUNTER(snapshot_throttle_cnt, "total snapshot objs held back by the transfer throttle",
+                         "snapshot_throttle_cnt");
+        REGISTER_COUNTER(snapshot_apply_cnt, "total snapshots applied", "snapshot_apply_cnt");
+        REGISTER_HISTOGRAM(snapshot_obj_read_latency_us, "snapshot obj read latency in us",
+                           "snapshot_obj_latency", {"op", "read"});
+        REGISTER_HISTOGRAM(snapshot_obj_save_latency_us, "snapshot obj save latency in us",
+                           "snapshot_obj_latency", {"op", "save"});
+
         register_me_to_farm();
     }
 
@@ -142,6 +180,17 @@ private:
 
     nuraft::ptr< nuraft::snapshot > m_last_snapshot{nullptr};
 
+    // Snapshot which is being received from the leader, tracked to resume the transfer from where it left off in case
+    // the leader restarts sending it (say after a leader switch or a connection reset).
+    struct snapshot_rcv_ctx {
+        uint64_t snp_log_idx{0};
+        uint64_t snp_log_term{0};
+        uint64_t next_cursor{0};
+        bool completed{false}; // Has the last obj been saved
+    };
+    std::mutex m_snp_rcv_mtx;
+    snapshot_rcv_ctx m_snp_rcv_ctx;
+
     static std::atomic< uint64_t > s_next_group_ordinal;
     bool m_log_store_replay_done{false};
 
@@ -187,7 +236,7 @@ public:
                                       sisl::blob const& key, uint32_t data_size, bool is_data_channel);
     folly::Future< folly::Unit > notify_after_data_written(std::vector< repl_req_ptr_t >* rreqs);
     void check_and_fetch_remote_data(std::vector< repl_req_ptr_t > rreqs);
-    void cp_flush(CP* cp);
+    folly::Future< bool > cp_flush(CP* cp);
     void cp_cleanup(CP* cp);
     void become_ready();
 
@@ -208,6 +257,29 @@ public:
      */
     void on_create_snapshot(nuraft::snapshot& s, nuraft::async_result< bool >::handler_type& when_done);
 
+    /**
+     * \brief Reads the snapshot obj which starts at listener cursor obj_id, to be sent to a lagging follower.
+     *
+     * Listener provides the state and the list of data blks, whose data is read here and packed along with the state.
+     * The transfer is throttled to consensus.snapshot_transfer_max_mbps.
+     *
+     * \return 0 on success, -1 on any failure in which case nuraft retries the same obj later.
+     */
+    int on_read_snapshot_obj(nuraft::snapshot& s, uint64_t obj_id, raft_buf_ptr_t& data_out, bool& is_last_obj);
+
+    /**
+     * \brief Saves the snapshot obj received from the leader. Data blks are written to locally allocated blks before
+     * handing over the obj to the listener. obj_id is updated to the next obj to be requested from the leader, which is
+     * left as is on failure so that the leader resends the same obj.
+     */
+    void on_save_snapshot_obj(nuraft::snapshot& s, uint64_t& obj_id, nuraft::buffer& data, bool is_first_obj,
+                              bool is_last_obj);
+
+    /**
+     * \brief Applies the snapshot once all objs are received and moves the commit lsn to the snapshot log idx.
+     */
+    bool on_apply_snapshot(nuraft::snapshot& s);
+
     /**
      * Truncates the replication log by providing a specified number of reserved entries.
      *
@@ -243,4 +243,20 @@ void RaftStateMachine::create_snapshot(nuraft::snapshot& s, nuraft::async_result
 std::string RaftStateMachine::rdev_name() const { return m_rd.rdev_name(); }
 
 nuraft::ptr< nuraft::snapshot > RaftStateMachine::last_snapshot() { return m_rd.get_last_snapshot(); }
+
+int RaftStateMachine::read_logical_snp_obj(nuraft::snapshot& s, void*& user_snp_ctx, ulong obj_id,
+                                           raft_buf_ptr_t& data_out, bool& is_last_obj) {
+    // Listener cursor is carried as the obj_id itself, so there is no per transfer context to be kept on the leader.
+    user_snp_ctx = nullptr;
+    return m_rd.on_read_snapshot_obj(s, obj_id, data_out, is_last_obj);
+}
+
+void RaftStateMachine::save_logical_snp_obj(nuraft::snapshot& s, ulong& obj_id, nuraft::buffer& data,
+                                            bool is_first_obj, bool is_last_obj) {
+    uint64_t next_obj_id = obj_id;
+    m_rd.on_save_snapshot_obj(s, next_obj_id, data, is_first_obj, is_last_obj);
+    obj_id = next_obj_id;
+}
+
+bool RaftStateMachine::apply_snapshot(nuraft::snapshot& s) { return m_rd.on_apply_snapshot(s); }
 } // namespace homestore
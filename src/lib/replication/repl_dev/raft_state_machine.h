@@ -111,7 +111,11 @@ public:
     void rollback(uint64_t lsn, nuraft::buffer&) override { LOGCRITICAL("Unimplemented rollback on: [{}]", lsn); }
     void become_ready();
 
-    bool apply_snapshot(nuraft::snapshot&) override { return false; }
+    bool apply_snapshot(nuraft::snapshot& s) override;
+    int read_logical_snp_obj(nuraft::snapshot& s, void*& user_snp_ctx, ulong obj_id, raft_buf_ptr_t& data_out,
+                             bool& is_last_obj) override;
+    void save_logical_snp_obj(nuraft::snapshot& s, ulong& obj_id, nuraft::buffer& data, bool is_first_obj,
+                              bool is_last_obj) override;
 
     void create_snapshot(nuraft::snapshot& s, nuraft::async_result< bool >::handler_type& when_done) override;
     nuraft::ptr< nuraft::snapshot > last_snapshot() override;
@@ -106,11 +106,11 @@ void SoloReplDev::async_free_blks(int64_t, MultiBlkId const& bid) { data_service
 
 uint32_t SoloReplDev::get_blk_size() const { return data_service().get_blk_size(); }
 
-void SoloReplDev::cp_flush(CP*) {
+folly::Future< bool > SoloReplDev::cp_flush(CP*) {
     auto lsn = m_commit_upto.load();
     m_rd_sb->durable_commit_lsn = lsn;
     m_rd_sb->checkpoint_lsn = lsn;
-    m_rd_sb.write();
+    return m_rd_sb.async_write();
 }
 
 void SoloReplDev::cp_cleanup(CP*) { /* m_data_journal->truncate(m_rd_sb->checkpoint_lsn); */
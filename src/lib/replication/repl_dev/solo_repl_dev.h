@@ -58,7 +58,7 @@ public:
 
     uint32_t get_blk_size() const override;
 
-    void cp_flush(CP* cp);
+    folly::Future< bool > cp_flush(CP* cp);
     void cp_cleanup(CP* cp);
 
 private:
@@ -12,6 +12,7 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
 #include <sisl/logging/logging.h>
 #include <homestore/meta_service.hpp>
 #include <homestore/blkdata_service.hpp>
@@ -155,10 +156,13 @@ AsyncReplResult<> SoloReplService::replace_member(group_id_t group_id, replica_i
 std::unique_ptr< CPContext > SoloReplServiceCPHandler::on_switchover_cp(CP* cur_cp, CP* new_cp) { return nullptr; }
 
 folly::Future< bool > SoloReplServiceCPHandler::cp_flush(CP* cp) {
-    repl_service().iterate_repl_devs([cp](cshared< ReplDev >& repl_dev) {
-        if (repl_dev) { std::dynamic_pointer_cast< SoloReplDev >(repl_dev)->cp_flush(cp); }
+    std::vector< folly::Future< bool > > futs;
+    repl_service().iterate_repl_devs([cp, &futs](cshared< ReplDev >& repl_dev) {
+        if (repl_dev) { futs.emplace_back(std::dynamic_pointer_cast< SoloReplDev >(repl_dev)->cp_flush(cp)); }
+    });
+    return folly::collectAllUnsafe(futs).thenValue([](auto&& vf) {
+        return std::all_of(vf.begin(), vf.end(), [](auto const& t) { return t.hasValue() && t.value(); });
     });
-    return folly::makeFuture< bool >(true);
 }
 
 void SoloReplServiceCPHandler::cp_cleanup(CP* cp) {
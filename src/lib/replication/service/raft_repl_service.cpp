@@ -14,6 +14,7 @@
  *********************************************************************************/
 #include <sisl/logging/logging.h>
 #include <iomgr/io_environment.hpp>
+#include <algorithm>
 #include <chrono>
 
 #include <boost/uuid/string_generator.hpp>
@@ -431,9 +432,14 @@ void RaftReplService::flush_durable_commit_lsn() {
 std::unique_ptr< CPContext > RaftReplServiceCPHandler::on_switchover_cp(CP* cur_cp, CP* new_cp) { return nullptr; }
 
 folly::Future< bool > RaftReplServiceCPHandler::cp_flush(CP* cp) {
-    repl_service().iterate_repl_devs(
-        [cp](cshared< ReplDev >& repl_dev) { std::static_pointer_cast< RaftReplDev >(repl_dev)->cp_flush(cp); });
-    return folly::makeFuture< bool >(true);
+    // Each repl dev's sb write is only queued, so that they are all persisted in a few group committed meta writes
+    std::vector< folly::Future< bool > > futs;
+    repl_service().iterate_repl_devs([cp, &futs](cshared< ReplDev >& repl_dev) {
+        futs.emplace_back(std::static_pointer_cast< RaftReplDev >(repl_dev)->cp_flush(cp));
+    });
+    return folly::collectAllUnsafe(futs).thenValue([](auto&& vf) {
+        return std::all_of(vf.begin(), vf.end(), [](auto const& t) { return t.hasValue() && t.value(); });
+    });
 }
 
 void RaftReplServiceCPHandler::cp_cleanup(CP* cp) {
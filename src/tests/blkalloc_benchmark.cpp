@@ -0,0 +1,97 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <sisl/logging/logging.h>
+#include <sisl/options/options.h>
+
+#include "common/homestore_config.hpp"
+#include "blkalloc/varsize_blk_allocator.h"
+
+SISL_LOGGING_INIT(HOMESTORE_LOG_MODS)
+SISL_OPTIONS_ENABLE(logging, blkalloc_benchmark)
+SISL_OPTION_GROUP(blkalloc_benchmark,
+                  (num_blks, "", "num_blks", "number of blks in the allocator",
+                   ::cxxopts::value< uint32_t >()->default_value("1048576"), "number"),
+                  (outstanding, "", "outstanding", "number of blkids each thread holds before freeing them",
+                   ::cxxopts::value< uint32_t >()->default_value("64"), "number"));
+
+using namespace homestore;
+
+static std::unique_ptr< VarsizeBlkAllocator > s_allocator;
+
+static void set_magazine_size(uint32_t sz) {
+    HS_SETTINGS_FACTORY().modifiable_settings([sz](auto& s) { s.blkallocator.magazine_size = sz; });
+}
+
+/*
+ * Every thread allocates single piece blkids of upto 8 blks (the common slab sizes) and frees the oldest one once it
+ * holds outstanding number of them, so that allocs and frees keep hitting the allocator concurrently. Run with the
+ * per thread magazines disabled (arg 0) and enabled, for increasing number of threads.
+ */
+static void alloc_free_mt(benchmark::State& state) {
+    if (state.thread_index() == 0) { set_magazine_size(uint32_cast(state.range(0))); }
+
+    std::mt19937 re{static_cast< uint32_t >(state.thread_index())};
+    std::uniform_int_distribution< uint32_t > slab_gen{0, 3};
+    std::deque< BlkId > held;
+    auto const max_held = SISL_OPTIONS["outstanding"].as< uint32_t >();
+
+    blk_alloc_hints hints;
+    hints.is_contiguous = true;
+    uint64_t nfailed{0};
+    for (auto _ : state) {
+        BlkId bid;
+        if (s_allocator->alloc(blk_count_t{1} << slab_gen(re), hints, bid) == BlkAllocStatus::SUCCESS) {
+            held.push_back(bid);
+        } else {
+            ++nfailed;
+        }
+        if (held.size() > max_held) {
+            s_allocator->free(held.front());
+            held.pop_front();
+        }
+    }
+
+    for (auto const& bid : held) {
+        s_allocator->free(bid);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["alloc_failed"] = nfailed;
+}
+
+BENCHMARK(alloc_free_mt)->Arg(0)->Arg(32)->ThreadRange(1, 32)->UseRealTime();
+
+int main(int argc, char** argv) {
+    SISL_OPTIONS_LOAD(argc, argv, logging, blkalloc_benchmark)
+    sisl::logging::SetLogger("blkalloc_benchmark");
+    spdlog::set_pattern("[%D %T%z] [%^%l%$] [%t] %v");
+
+    HomeStoreDynamicConfig::init_settings_default();
+    auto const nblks = SISL_OPTIONS["num_blks"].as< uint32_t >();
+    VarsizeBlkAllocConfig cfg{4096, 4096, 4096u, uint64_t{nblks} * 4096, false, "blkalloc_bench", true /* use_slabs */};
+    s_allocator = std::make_unique< VarsizeBlkAllocator >(cfg, true, 0);
+
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    LOGINFO("Metrics: {}", s_allocator->get_metrics_in_json().dump(4));
+    s_allocator.reset();
+    return 0;
+}
@@ -56,4 +56,12 @@ struct PrefixIntervalBtree {
     using ValueType = TestIntervalValue;
     static constexpr btree_node_type leaf_node_type = btree_node_type::PREFIX;
     static constexpr btree_node_type interior_node_type = btree_node_type::FIXED;
-};
\ No newline at end of file
+};
+
+struct CompactLeafBtree {
+    using BtreeType = IndexTable< TestFixedKey, TestFixedValue >;
+    using KeyType = TestFixedKey;
+    using ValueType = TestFixedValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::COMPACT;
+    static constexpr btree_node_type interior_node_type = btree_node_type::FIXED;
+};
@@ -186,6 +186,43 @@ public:
         m_shadow_map.force_put(k, value);
     }
 
+    void bulk_load(std::vector< uint64_t > const& keys) {
+        std::vector< std::pair< K, V > > kvs;
+        kvs.reserve(keys.size());
+        for (auto const k : keys) {
+            kvs.emplace_back(K{k}, V::generate_rand());
+        }
+
+        auto const ret = m_bt->bulk_load(kvs.begin(), kvs.end());
+        ASSERT_EQ(ret, btree_status_t::success) << "Bulk load of " << keys.size() << " keys failed";
+        for (auto const& [k, v] : kvs) {
+            m_shadow_map.force_put(k, v);
+        }
+    }
+
+    void batch_put(std::vector< uint64_t > const& keys) {
+        std::vector< K > ks;
+        std::vector< V > vs;
+        ks.reserve(keys.size());
+        vs.reserve(keys.size());
+        std::vector< std::pair< const BtreeKey*, const BtreeValue* > > kvs;
+        for (auto const k : keys) {
+            ks.emplace_back(K{k});
+            vs.emplace_back(V::generate_rand());
+        }
+        for (size_t i{0}; i < keys.size(); ++i) {
+            kvs.emplace_back(&ks[i], &vs[i]);
+        }
+
+        auto preq = BtreeBatchPutRequest< K >{std::move(kvs), btree_put_type::UPSERT};
+        auto const ret = m_bt->put(preq);
+        ASSERT_EQ(ret, btree_status_t::success) << "Batch put of " << keys.size() << " keys failed";
+        ASSERT_EQ(preq.m_cursor, keys.size()) << "Batch put did not put all the keys";
+        for (size_t i{0}; i < keys.size(); ++i) {
+            m_shadow_map.force_put(ks[i], vs[i]);
+        }
+    }
+
     void range_put(uint32_t start_k, uint32_t end_k, V const& value, bool update) {
         K start_key = K{start_k};
         K end_key = K{end_k};
@@ -254,6 +291,20 @@ public:
         do_range_remove(start_k, end_k, false /* removing_all_existing */);
     }
 
+    void range_remove_drop_subtrees(uint32_t start_k, uint32_t end_k) {
+        K start_key = K{start_k};
+        K end_key = K{end_k};
+
+        auto rreq = BtreeRangeRemoveRequest< K >{BtreeKeyRange< K >{start_key, true, end_key, true}, nullptr,
+                                                 std::numeric_limits< uint32_t >::max(), nullptr,
+                                                 true /* drop_subtrees */};
+        auto const ret = m_bt->remove(rreq);
+        m_shadow_map.range_erase(start_key, end_key);
+        ASSERT_EQ(ret, btree_status_t::success) << "not a successful drop remove op for range " << start_k << "-"
+                                                << end_k;
+        LOGINFO("Range remove of [{}-{}] dropped {} subtrees", start_k, end_k, rreq.m_num_dropped_subtrees);
+    }
+
     ////////////////////// All query operation variants ///////////////////////////////
     void query_all() { do_query(0u, SISL_OPTIONS["num_entries"].as< uint32_t >() - 1, UINT32_MAX); }
 
@@ -261,6 +312,43 @@ public:
         do_query(0u, SISL_OPTIONS["num_entries"].as< uint32_t >() - 1, batch_size);
     }
 
+    void parallel_query(uint32_t start_k, uint32_t end_k, uint32_t parallelism, bool stream) {
+        std::vector< std::pair< K, V > > out_vector;
+        std::mutex stream_mtx;
+        std::map< uint32_t, std::vector< std::pair< K, V > > > streamed;
+
+        BtreeParallelQueryRequest< K > qreq{BtreeKeyRange< K >{K{start_k}, true, K{end_k}, true}, parallelism, 100};
+        if (stream) {
+            qreq.m_stream_cb = [&stream_mtx, &streamed](uint32_t partition, BtreeKey const& k, BtreeValue const& v) {
+                std::unique_lock lg{stream_mtx};
+                streamed[partition].emplace_back(s_cast< K const& >(k), s_cast< V const& >(v));
+            };
+        }
+        auto const ret = m_bt->parallel_query(qreq, out_vector);
+        ASSERT_EQ(ret, btree_status_t::success) << "Expected success on parallel query";
+        LOGINFO("Parallel query of [{}-{}] with parallelism={} split into {} partitions", start_k, end_k, parallelism,
+                qreq.m_num_partitions);
+
+        if (stream) {
+            // Each partition streams in key order and partitions are in key order, so concatenating them in partition
+            // order should give the sorted result
+            ASSERT_EQ(out_vector.size(), 0) << "Streamed parallel query should not return values";
+            for (auto& [partition, values] : streamed) {
+                out_vector.insert(out_vector.end(), values.begin(), values.end());
+            }
+        }
+
+        std::unique_lock lg{m_shadow_map.guard()};
+        ASSERT_EQ(out_vector.size(), m_shadow_map.num_elems_in_range(start_k, end_k))
+            << "Parallel query returned incorrect number of entries";
+        auto it = m_shadow_map.map_const().lower_bound(K{start_k});
+        for (size_t idx{0}; idx < out_vector.size(); ++idx, ++it) {
+            ASSERT_EQ(out_vector[idx].first.compare(it->first), 0)
+                << "Parallel query returned incorrect key at idx=" << idx;
+            ASSERT_EQ(out_vector[idx].second, it->second) << "Parallel query returned incorrect value at idx=" << idx;
+        }
+    }
+
     void do_query(uint32_t start_k, uint32_t end_k, uint32_t batch_size) {
         std::vector< std::pair< K, V > > out_vector;
         m_shadow_map.guard().lock();
@@ -327,6 +415,28 @@ public:
         });
     }
 
+    void batch_get(std::vector< uint64_t > const& keys) const {
+        std::vector< K > ks;
+        std::vector< V > vs(keys.size());
+        ks.reserve(keys.size());
+        std::vector< std::pair< const BtreeKey*, BtreeValue* > > kv_ptrs;
+        for (auto const k : keys) {
+            ks.emplace_back(K{k});
+        }
+        for (size_t i{0}; i < keys.size(); ++i) {
+            kv_ptrs.emplace_back(&ks[i], &vs[i]);
+        }
+
+        auto greq = BtreeBatchGetRequest< K >{std::move(kv_ptrs)};
+        auto const ret = m_bt->get(greq);
+        ASSERT_EQ(greq.is_done(), true) << "Batch get did not lookup all the keys";
+        for (size_t i{0}; i < keys.size(); ++i) {
+            ASSERT_EQ(greq.m_found[i], m_shadow_map.exists(ks[i])) << "Batch get mismatch for key " << keys[i];
+            if (greq.m_found[i]) { m_shadow_map.validate_data(ks[i], vs[i]); }
+        }
+        ASSERT_EQ((ret == btree_status_t::success), (greq.m_num_found == keys.size()));
+    }
+
     void get_specific(uint32_t k) const {
         auto pk = std::make_unique< K >(k);
         auto out_v = std::make_unique< V >();
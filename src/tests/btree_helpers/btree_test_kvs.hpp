@@ -68,6 +68,9 @@ private:
     uint64_t m_key{0};
 
 public:
+    // Key is serialized as native uint64_t and compared numerically, which enables integral key search in nodes
+    using integral_key_t = uint64_t;
+
     TestFixedKey() = default;
     TestFixedKey(uint64_t k) : m_key{k} {}
     TestFixedKey(const TestFixedKey& other) : TestFixedKey(other.serialize(), true) {}
@@ -0,0 +1,110 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#define StoreSpecificBtreeNode homestore::BtreeNode
+
+#include <sisl/logging/logging.h>
+#include <homestore/btree/detail/simple_node.hpp>
+#include "btree_helpers/btree_test_kvs.hpp"
+
+using namespace homestore;
+SISL_LOGGING_DEF(btree)
+SISL_LOGGING_INIT(HOMESTORE_LOG_MODS)
+
+/*
+ * Compares the key search within a SimpleNode of fixed size integral keys, using the generic binary search (which
+ * compares each key through virtual calls) against the integral key search.
+ */
+class SearchNode : public SimpleNode< TestFixedKey, TestFixedValue > {
+public:
+    using SimpleNode< TestFixedKey, TestFixedValue >::SimpleNode;
+
+    node_find_result_t generic_search(const BtreeKey& key) const { return BtreeNode::bsearch_node(key); }
+    node_find_result_t integral_search(const BtreeKey& key) const { return this->bsearch_node(key); }
+};
+
+struct SearchFixture {
+    explicit SearchFixture(uint32_t node_size) : m_cfg{node_size} {
+        m_buf = std::unique_ptr< uint8_t[] >(new uint8_t[node_size]);
+        m_node = std::make_unique< SearchNode >(m_buf.get(), 1ul, true, true, m_cfg);
+
+        // Fill the node with even keys, so that half of the searches below are misses
+        uint64_t k{0};
+        while (m_node->has_room_for_put(btree_put_type::INSERT, 0, 0)) {
+            m_node->insert(m_node->total_entries(), TestFixedKey{k}, TestFixedValue::generate_rand());
+            k += 2;
+        }
+
+        std::mt19937_64 re{0x5eed};
+        std::uniform_int_distribution< uint64_t > key_gen{0, k};
+        m_search_keys.reserve(num_search_keys);
+        for (uint32_t i{0}; i < num_search_keys; ++i) {
+            m_search_keys.emplace_back(key_gen(re));
+        }
+    }
+
+    static constexpr uint32_t num_search_keys{4096};
+    BtreeConfig m_cfg;
+    std::unique_ptr< uint8_t[] > m_buf;
+    std::unique_ptr< SearchNode > m_node;
+    std::vector< TestFixedKey > m_search_keys;
+};
+
+static void search_generic(benchmark::State& state) {
+    SearchFixture f{uint32_cast(state.range(0))};
+    uint32_t i{0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.m_node->generic_search(f.m_search_keys[i++ % SearchFixture::num_search_keys]));
+    }
+    state.counters["entries"] = f.m_node->total_entries();
+}
+
+static void search_integral(benchmark::State& state) {
+    SearchFixture f{uint32_cast(state.range(0))};
+    uint32_t i{0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.m_node->integral_search(f.m_search_keys[i++ % SearchFixture::num_search_keys]));
+    }
+    state.counters["entries"] = f.m_node->total_entries();
+}
+
+// Both the search paths must agree on every key, before we compare how fast they are
+static bool validate_search() {
+    SearchFixture f{4096};
+    for (uint64_t k{0}; k <= (2 * f.m_node->total_entries()) + 1; ++k) {
+        TestFixedKey key{k};
+        if (f.m_node->generic_search(key) != f.m_node->integral_search(key)) {
+            LOGERROR("Search result mismatch for key={}", k);
+            return false;
+        }
+    }
+    return true;
+}
+
+BENCHMARK(search_generic)->Arg(512)->Arg(4096)->Arg(16384);
+BENCHMARK(search_integral)->Arg(512)->Arg(4096)->Arg(16384);
+
+int main(int argc, char** argv) {
+    if (!validate_search()) { return 1; }
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -132,6 +132,7 @@ INDEX_BTREE_BENCHMARK(FixedLenBtree)
 INDEX_BTREE_BENCHMARK(VarKeySizeBtree)
 INDEX_BTREE_BENCHMARK(VarValueSizeBtree)
 INDEX_BTREE_BENCHMARK(VarObjSizeBtree)
+INDEX_BTREE_BENCHMARK(CompactLeafBtree)
 // INDEX_BTREE_BENCHMARK(PrefixIntervalBtree)
 
 int main(int argc, char** argv) {
@@ -13,130 +13,168 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
-#include <filesystem>
-#include <fstream>
-#include <iostream>
+#include <memory>
 #include <mutex>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <benchmark/benchmark.h>
+#include <iomgr/io_environment.hpp>
 #include <sisl/logging/logging.h>
 #include <sisl/options/options.h>
+#include <homestore/homestore.hpp>
+#include <homestore/logstore_service.hpp>
+#include "common/homestore_config.hpp"
+#include "test_common/homestore_test_common.hpp"
 
-#include "logstore/log_dev.hpp"
-
+using namespace homestore;
 SISL_LOGGING_INIT(HOMESTORE_LOG_MODS)
-RCU_REGISTER_INIT
 
-static constexpr size_t ITERATIONS{100000};
-static constexpr size_t THREADS{64};
+SISL_OPTIONS_ENABLE(logging, log_dev_benchmark, iomgr, test_common_setup)
+SISL_OPTION_GROUP(log_dev_benchmark,
+                  (num_entries, "", "num_entries", "number of log records per run",
+                   ::cxxopts::value< uint64_t >()->default_value("50000"), "number"),
+                  (qdepth, "", "qdepth", "number of outstanding appends",
+                   ::cxxopts::value< uint32_t >()->default_value("64"), "number"),
+                  (max_record_size, "", "max_record_size", "max record size",
+                   ::cxxopts::value< uint32_t >()->default_value("1024"), "number"));
+
+static test_common::HSTestHelper s_helper;
+
+/*
+ * Appends log records to a log store of a fresh logdev, keeping qdepth appends outstanding, until num_entries records
+ * are appended and completed. Used to measure the logdev flush throughput for different flush pipeline depths.
+ */
+class BenchLogDev {
+public:
+    BenchLogDev() {
+        m_logdev_id = logstore_service().create_new_logdev();
+        m_log_store = logstore_service().create_new_log_store(m_logdev_id, true /* append_mode */);
+        generate_rand_data();
+    }
 
-static std::vector< logdev_key > s_log_keys;
-static uint64_t first_offset{~static_cast< uint64_t >(0)};
+    BenchLogDev(const BenchLogDev&) = delete;
+    BenchLogDev& operator=(const BenchLogDev&) = delete;
+    BenchLogDev(BenchLogDev&&) noexcept = delete;
+    BenchLogDev& operator=(BenchLogDev&&) noexcept = delete;
 
-void test_append(benchmark::State& state) {
-    uint64_t counter{0};
-    for ([[maybe_unused]] auto current_state : state) { // Loops upto iteration count
-        my_request* req{nullptr};
-        benchmark::DoNotOptimize(req = new my_request());
-        LogDev::instance()->append();
+    ~BenchLogDev() {
+        logstore_service().remove_log_store(m_logdev_id, m_log_store->get_store_id());
+        m_log_store.reset();
+        logstore_service().destroy_log_dev(m_logdev_id);
     }
-    std::cout << "Counter = " << counter << "\n";
-}
 
-[[nodiscard]] static std::shared_ptr< iomgr::ioMgr > start_homestore(const uint32_t ndevices, const uint64_t dev_size,
-                                                                     const uint32_t nthreads) {
-    std::vector< dev_info > device_info;
-    // these should be static so that they stay in scope in the lambda in case function ends before lambda completes
-    static std::mutex start_mutex;
-    static std::condition_variable cv;
-    static bool inited;
-
-    inited = false;
-    LOGINFO("creating {} device files with each of size {} ", ndevices, dev_size);
-    for (uint32_t i{0}; i < ndevices; ++i) {
-        const std::filesystem::path fpath{"/tmp/" + std::to_string(i + 1)};
-        std::ofstream ofs{fpath.string(), std::ios::binary | std::ios::out};
-        std::filesystem::resize_file(fpath, dev_size);
-        device_info.emplace_back(std::filesystem::canonical(fpath).string(), HSDevType::Data);
+    void run() {
+        m_nth_entry.store(0);
+        m_completed.store(0);
+        m_done = false;
+        iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this]() {
+            for (uint32_t i{0}; i < m_q_depth; ++i) {
+                issue_append();
+            }
+        });
+
+        std::unique_lock< std::mutex > lk{m_pending_mtx};
+        m_pending_cv.wait(lk, [&] { return m_done; });
+    }
+
+    uint64_t num_entries() const { return m_nentries; }
+    uint64_t bytes_written() const { return m_total_bytes; }
+
+private:
+    void issue_append() {
+        auto const ind = m_nth_entry.fetch_add(1, std::memory_order_acq_rel);
+        if (ind >= m_nentries) { return; }
+
+        auto const& data = m_data[ind];
+        m_log_store->append_async(sisl::io_blob(uintptr_cast(const_cast< char* >(data.data())),
+                                                uint32_cast(data.size()), false /* is_aligned */),
+                                  nullptr /* cookie */, [this](logstore_seq_num_t, sisl::io_blob&, logdev_key, void*) {
+                                      on_append_completion();
+                                  });
     }
 
-    LOGINFO("Creating iomgr with {} threads", nthreads);
-    auto iomgr_obj{std::make_shared< iomgr::ioMgr >(2, nthreads)};
-
-    const uint64_t app_mem_size{((ndevices * dev_size) * 15) / 100};
-    LOGINFO("Initialize and start HomeBlks with app_mem_size = {}", app_mem_size);
-
-    boost::uuids::string_generator gen;
-    init_params params;
-    params.open_flags = homestore::io_flag::DIRECT_IO;
-    params.min_virtual_page_size = 4096;
-    params.app_mem_size = app_mem_size;
-    params.devices = device_info;
-    params.iomgr = iomgr_obj;
-    params.init_done_cb = [&iomgr_obj, &tl_start_mutex = start_mutex, &tl_cv = cv,
-                           &tl_inited = inited](std::error_condition err, const out_params& params) {
-        iomgr_obj->start();
-        LOGINFO("HomeBlks Init completed");
-        {
-            std::unique_lock< std::mutex > lk{tl_start_mutex};
-            tl_inited = true;
+    void on_append_completion() {
+        if (m_completed.fetch_add(1, std::memory_order_acq_rel) + 1 == m_nentries) {
+            {
+                std::unique_lock< std::mutex > lk{m_pending_mtx};
+                m_done = true;
+            }
+            m_pending_cv.notify_all();
+            return;
         }
-        tl_cv.notify_one();
-    };
-    params.vol_mounted_cb = [](const VolumePtr& vol_obj, vol_state state) {};
-    params.vol_state_change_cb = [](const VolumePtr& vol, vol_state old_state, vol_state new_state) {};
-    params.vol_found_cb = [](boost::uuids::uuid uuid) -> bool { return true; };
-    VolInterface::init(params);
-
-    {
-        std::unique_lock< std::mutex > lk{start_mutex};
-        cv.wait(lk, [] { return inited; });
+        issue_append();
     }
-    return iomgr_obj;
-}
 
-static void on_append_completion(const logdev_key lkey, void* const ctx) {
-    s_log_keys.push_back(lkey);
-    LOGINFO("Append completed with log_idx = {} offset = {}", lkey.idx, lkey.dev_offset);
-    if (first_offset == ~static_cast< uint64_t >(0)) { first_offset = lkey.dev_offset; }
+    void generate_rand_data() {
+        std::random_device rd{};
+        std::default_random_engine re{rd()};
+        std::uniform_int_distribution< uint32_t > data_size{1, m_max_data_size};
+
+        m_data.reserve(m_nentries);
+        for (uint64_t i{0}; i < m_nentries; ++i) {
+            auto const sz = data_size(re);
+            m_data.emplace_back(std::string(sz, static_cast< char >('a' + (i % 26))));
+            m_total_bytes += sz;
+        }
+    }
+
+private:
+    logdev_id_t m_logdev_id;
+    std::shared_ptr< HomeLogStore > m_log_store;
+    std::atomic< uint64_t > m_nth_entry{0};
+    std::atomic< uint64_t > m_completed{0};
+
+    const uint64_t m_nentries{SISL_OPTIONS["num_entries"].as< uint64_t >()};
+    const uint32_t m_q_depth{SISL_OPTIONS["qdepth"].as< uint32_t >()};
+    const uint32_t m_max_data_size{SISL_OPTIONS["max_record_size"].as< uint32_t >()};
+
+    std::mutex m_pending_mtx;
+    std::condition_variable m_pending_cv;
+    bool m_done{false};
+
+    std::vector< std::string > m_data;
+    uint64_t m_total_bytes{0};
+};
+
+static void set_flush_pipeline_depth(uint32_t depth) {
+    HS_SETTINGS_FACTORY().modifiable_settings([depth](auto& s) { s.logstore.flush_pipeline_depth = depth; });
+    HS_SETTINGS_FACTORY().save();
 }
 
-static void on_log_found(const logdev_key lkey, const log_buffer buf) {
-    s_log_keys.push_back(lkey);
-    LOGINFO("Found a log with log_idx = {} offset = {}", lkey.idx, lkey.dev_offset);
+// Sweeps the logdev flush pipeline depth (number of in-flight log groups), given as the benchmark argument
+static void test_append_pipeline(benchmark::State& state) {
+    set_flush_pipeline_depth(uint32_cast(state.range(0)));
+    auto bld = std::make_unique< BenchLogDev >();
+    for (auto _ : state) { // Loops upto iteration count
+        bld->run();
+    }
+    state.SetItemsProcessed(int64_cast(state.iterations() * bld->num_entries()));
+    state.SetBytesProcessed(int64_cast(state.iterations() * bld->bytes_written()));
+    state.counters["pipeline_depth"] = state.range(0);
 }
 
 static void setup() {
-    auto iomgr_obj = start_homestore(SISL_OPTIONS["num_devs"].as< uint32_t >(),
-                                     SISL_OPTIONS["dev_size_mb"].as< uint64_t >() * 1024 * 1024,
-                                     SISL_OPTIONS["num_threads"].as< uint32_t >());
-
-    LogDev::instance()->register_append_cb(on_append_completion);
-    LogDev::instance()->register_logfound_cb(on_log_found);
+    s_helper.start_homestore("test_log_dev_bench",
+                             {{HS_SERVICE::META, {.size_pct = 5.0}}, {HS_SERVICE::LOG, {.size_pct = 87.0}}});
 }
 
-SISL_OPTIONS_ENABLE(logging, log_dev_benchmark)
-SISL_OPTION_GROUP(log_dev_benchmark,
-                  (num_threads, "", "num_threads", "number of threads",
-                   ::cxxopts::value< uint32_t >()->default_value("2"), "number"),
-                  (num_devs, "", "num_devs", "number of devices to create",
-                   ::cxxopts::value< uint32_t >()->default_value("2"), "number"),
-                  (dev_size_mb, "", "dev_size_mb", "size of each device in MB",
-                   ::cxxopts::value< uint64_t >()->default_value("5120"), "number"));
+static void teardown() { s_helper.shutdown_homestore(); }
 
-BENCHMARK(test_append)->Iterations(ITERATIONS)->Threads(THREADS);
+BENCHMARK(test_append_pipeline)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Iterations(1)->UseRealTime();
 
-SISL_OPTIONS_ENABLE(logging)
 int main(int argc, char** argv) {
-    SISL_OPTIONS_LOAD(argc, argv, logging, log_dev_benchmark)
+    SISL_OPTIONS_LOAD(argc, argv, logging, log_dev_benchmark, iomgr, test_common_setup)
     sisl::logging::SetLogger("log_dev_benchmark");
     spdlog::set_pattern("[%D %T%z] [%^%l%$] [%n] [%t] %v");
 
     setup();
     ::benchmark::Initialize(&argc, argv);
     ::benchmark::RunSpecifiedBenchmarks();
+    LOGINFO("Metrics: {}", sisl::MetricsFarm::getInstance().get_result_in_json()["LogStores"].dump(4));
+    teardown();
 }
@@ -23,6 +23,7 @@
 #include <homestore/btree/detail/simple_node.hpp>
 #include <homestore/btree/detail/varlen_node.hpp>
 #include <homestore/btree/detail/prefix_node.hpp>
+#include <homestore/btree/detail/compact_node.hpp>
 #include "btree_helpers/btree_test_kvs.hpp"
 
 static constexpr uint32_t g_node_size{4096};
@@ -63,6 +64,18 @@ struct PrefixIntervalBtreeTest {
     using ValueType = TestIntervalValue;
 };
 
+struct CompactNodeTest {
+    using NodeType = CompactNode< TestFixedKey, TestFixedValue >;
+    using KeyType = TestFixedKey;
+    using ValueType = TestFixedValue;
+};
+
+struct CompactVarObjNodeTest {
+    using NodeType = CompactNode< TestVarLenKey, TestVarLenValue >;
+    using KeyType = TestVarLenKey;
+    using ValueType = TestVarLenValue;
+};
+
 template < typename TestType >
 struct NodeTest : public testing::Test {
     using T = TestType;
@@ -327,7 +340,7 @@ private:
 };
 
 using NodeTypes = testing::Types< FixedLenNodeTest, VarKeySizeNodeTest, VarValueSizeNodeTest, VarObjSizeNodeTest,
-                                  PrefixIntervalBtreeTest >;
+                                  PrefixIntervalBtreeTest, CompactNodeTest, CompactVarObjNodeTest >;
 TYPED_TEST_SUITE(NodeTest, NodeTypes);
 
 TYPED_TEST(NodeTest, SequentialInsert) {
@@ -19,6 +19,8 @@
 #include <random>
 #include <unordered_set>
 #include <farmhash.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 #include <iomgr/io_environment.hpp>
@@ -39,6 +41,7 @@
 #include "common/homestore_config.hpp"
 #include "common/homestore_assert.hpp"
 #include "blkalloc/blk_allocator.h"
+#include "blkalloc/bitmap_blk_allocator.h"
 #include "test_common/bits_generator.hpp"
 #include "test_common/homestore_test_common.hpp"
 
@@ -241,6 +244,53 @@ public:
             });
     }
 
+    // allocate and write a batch of ios of different sizes in one go, then read back and verify each of them;
+    void write_batch_verify(uint32_t num_ios) {
+        auto const blk_size = inst().get_blk_size();
+        auto sgs_list = std::make_shared< std::vector< sisl::sg_list > >(num_ios);
+        auto blkids = std::make_shared< std::vector< MultiBlkId > >();
+        for (uint32_t i{0}; i < num_ios; ++i) {
+            struct iovec iov;
+            iov.iov_len = ((i % 4) + 1) * blk_size; // Mix of 1 to 4 blks
+            iov.iov_base = iomanager.iobuf_alloc(512, iov.iov_len);
+            test_common::HSTestHelper::fill_data_buf(r_cast< uint8_t* >(iov.iov_base), iov.iov_len, i + 1);
+            (*sgs_list)[i].iovs.push_back(iov);
+            (*sgs_list)[i].size = iov.iov_len;
+        }
+
+        inst()
+            .async_alloc_write_batch(*sgs_list, blk_alloc_hints{}, *blkids)
+            .thenValue([this, sgs_list, blkids](auto&& err) {
+                RELEASE_ASSERT(!err, "Batch write error");
+                RELEASE_ASSERT_EQ(blkids->size(), sgs_list->size(), "Expected one blkid per write in the batch");
+
+                std::vector< folly::Future< std::error_code > > futs;
+                auto read_sgs_list = std::make_shared< std::vector< sisl::sg_list > >(blkids->size());
+                for (size_t i{0}; i < blkids->size(); ++i) {
+                    inst().commit_blk((*blkids)[i]);
+
+                    struct iovec iov;
+                    iov.iov_len = (*blkids)[i].blk_count() * inst().get_blk_size();
+                    iov.iov_base = iomanager.iobuf_alloc(512, iov.iov_len);
+                    (*read_sgs_list)[i].iovs.push_back(iov);
+                    (*read_sgs_list)[i].size = iov.iov_len;
+                    futs.emplace_back(inst().async_read((*blkids)[i], (*read_sgs_list)[i], iov.iov_len));
+                }
+
+                folly::collectAllUnsafe(futs).thenValue([this, sgs_list, read_sgs_list](auto&& vf) {
+                    for (size_t i{0}; i < vf.size(); ++i) {
+                        RELEASE_ASSERT(!vf[i].value(), "Read error");
+                        RELEASE_ASSERT(test_common::HSTestHelper::compare((*read_sgs_list)[i], (*sgs_list)[i]),
+                                       "Read after batch write data mismatch for io={}", i);
+                        free((*read_sgs_list)[i]);
+                        free((*sgs_list)[i]);
+                    }
+                    LOGINFO("Batch of {} writes are read and verified", vf.size());
+                    this->finish_and_notify();
+                });
+            });
+    }
+
     void write_and_restart_with_missing_data_drive(const uint64_t io_size) {
         vdev_info vinfo;
         auto data_vdev = inst().open_vdev(vinfo, true);
@@ -793,6 +843,41 @@ private:
         }
     }
 
+    ////////////////////////// Bitmap Flush APIS ////////////////////////////////
+    std::vector< BitmapBlkAllocator* > data_blk_allocators() {
+        vdev_info vinfo;
+        auto data_vdev = inst().open_vdev(vinfo, true);
+        std::vector< BitmapBlkAllocator* > allocators;
+        for (auto& [_, chunk] : data_vdev->get_chunks()) {
+            if (!chunk) continue;
+            allocators.push_back(r_cast< BitmapBlkAllocator* >(chunk->blk_allocator_mutable()));
+        }
+        return allocators;
+    }
+
+    // Total bytes of bitmap written by all data chunks on the last cp
+    uint64_t last_cp_bitmap_bytes() {
+        uint64_t total{0};
+        for (auto const ba : data_blk_allocators()) {
+            total += ba->last_cp_flush_bytes();
+        }
+        return total;
+    }
+
+    std::vector< MultiBlkId > alloc_commit_blks(uint32_t num_blks) {
+        std::vector< MultiBlkId > bids;
+        iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, num_blks, &bids]() {
+            for (uint32_t i{0}; i < num_blks; ++i) {
+                MultiBlkId bid;
+                auto const status = inst().alloc_blks(inst().get_blk_size(), blk_alloc_hints{}, bid);
+                RELEASE_ASSERT_EQ(status, BlkAllocStatus::SUCCESS, "Blk allocation failed");
+                RELEASE_ASSERT_EQ(inst().commit_blk(bid), BlkAllocStatus::SUCCESS, "Blk commit failed");
+                bids.push_back(bid);
+            }
+        });
+        return bids;
+    }
+
     void add_read_delay() {
 #ifdef _PRERELEASE
         flip::FlipClient* fc = iomgr_flip::client_instance();
@@ -881,6 +966,18 @@ TEST_F(BlkDataServiceTest, TestWriteThenReadVerify) {
     LOGINFO("Step 4: I/O completed, do shutdown.");
 }
 
+TEST_F(BlkDataServiceTest, TestAllocWriteBatchThenReadVerify) {
+    const uint32_t num_ios = 64;
+    LOGINFO("Step 1: run on worker thread to schedule a batch of {} writes.", num_ios);
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker,
+                            [this, num_ios]() { this->write_batch_verify(num_ios); });
+
+    LOGINFO("Step 2: Wait for I/O to complete.");
+    wait_for_all_io_complete();
+
+    LOGINFO("Step 3: I/O completed, do shutdown.");
+}
+
 // Free_blk test, no read involved;
 TEST_F(BlkDataServiceTest, TestWriteThenFreeBlk) {
     // start io in worker thread;
@@ -994,6 +1091,168 @@ TEST_F(BlkDataServiceTest, TestRestartWithMissingDrive) {
     LOGINFO("Step 11: I/O completed, do shutdown.");
 }
 
+/**
+ * @brief Measures the bitmap bytes written per cp. After first cp writes full bitmap, a cp which changes only few blks
+ * should persist only the modified bitmap portions and a cp without any change should not write any bitmap at all.
+ */
+TEST_F(BlkDataServiceTest, TestIncrementalBitmapFlush) {
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.blkallocator.max_incremental_bitmaps = 16;
+        s.blkallocator.incremental_bitmap_compact_pct = 100.0;
+    });
+    HS_SETTINGS_FACTORY().save();
+
+    uint64_t full_bitmap_bytes{0};
+    for (auto const ba : data_blk_allocators()) {
+        full_bitmap_bytes += (ba->get_total_blks() + 7) / 8;
+    }
+
+    LOGINFO("Step 1: Allocate blks and flush the cp, which persists the entire bitmap");
+    auto bids = alloc_commit_blks(4);
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    LOGINFO("Bitmap bytes written on first cp={}, full bitmap size={}", last_cp_bitmap_bytes(), full_bitmap_bytes);
+
+    LOGINFO("Step 2: Allocate few blks and flush the cp, which should persist only the modified portions");
+    for (uint32_t i{0}; i < 3; ++i) {
+        auto new_bids = alloc_commit_blks(4);
+        bids.insert(bids.end(), new_bids.begin(), new_bids.end());
+        test_common::HSTestHelper::trigger_cp(true /* wait */);
+
+        auto const cp_bytes = last_cp_bitmap_bytes();
+        LOGINFO("Bitmap bytes written on incremental cp={}, full bitmap size={}", cp_bytes, full_bitmap_bytes);
+        ASSERT_GT(cp_bytes, 0) << "Expected modified bitmap portions to be written";
+        ASSERT_LT(cp_bytes, full_bitmap_bytes) << "Expected only modified portions to be written";
+    }
+
+    LOGINFO("Step 3: Flush cp without any blk changes, which should not persist bitmap");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    ASSERT_EQ(last_cp_bitmap_bytes(), 0) << "Expected no bitmap write when no blk is modified";
+
+    LOGINFO("Step 4: Free few blks, which should be persisted incrementally as well");
+    std::vector< MultiBlkId > free_bids{bids.end() - 4, bids.end()};
+    bids.resize(bids.size() - 4);
+    iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, &free_bids]() {
+        for (auto const& bid : free_bids) {
+            inst().async_free_blk(bid).thenValue([](auto&& err) { RELEASE_ASSERT(!err, "Free error"); });
+        }
+    });
+    test_common::HSTestHelper::trigger_cp(true /* wait */); // Frees are applied to bitmap after this cp
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    ASSERT_GT(last_cp_bitmap_bytes(), 0) << "Expected freed bitmap portions to be written";
+
+    LOGINFO("Step 5: Restart homestore and validate full bitmap with incremental bitmaps applied are recovered, with "
+            "the committed blks allocated and the freed blks free");
+    m_helper.restart_homestore();
+    for (auto const& bid : bids) {
+        auto const b = bid.to_single_blkid();
+        auto const ba = homestore::hs()->device_mgr()->get_chunk(b.chunk_num())->blk_allocator();
+        ASSERT_TRUE(ba->is_blk_alloced_on_disk(b, true /* use_lock */))
+            << "Committed blk " << b.to_string() << " is not found on disk bitmap after restart";
+    }
+    for (auto const& bid : free_bids) {
+        auto const b = bid.to_single_blkid();
+        auto const ba = homestore::hs()->device_mgr()->get_chunk(b.chunk_num())->blk_allocator();
+        ASSERT_FALSE(ba->is_blk_alloced_on_disk(b, true /* use_lock */))
+            << "Freed blk " << b.to_string() << " is found allocated on disk bitmap after restart";
+    }
+}
+
+/**
+ * @brief Frees written blks with discard enabled on the data vdev and validates that, once the cp is committed, the
+ * freed ranges are punched out as holes in the file backed device, while the blks still in use keep their data.
+ */
+TEST_F(BlkDataServiceTest, TestDiscardFreedBlksAfterCp) {
+    if (SISL_OPTIONS.count("device_list") || SISL_OPTIONS["spdk"].as< bool >()) {
+        GTEST_SKIP() << "Discard test needs file backed devices to look for the punched holes";
+    }
+
+    vdev_info vinfo;
+    auto data_vdev = inst().open_vdev(vinfo, true);
+    data_vdev->enable_discard(true);
+
+    LOGINFO("Step 1: Write few extents and flush the cp");
+    uint32_t const num_extents{8};
+    std::vector< MultiBlkId > bids(num_extents);
+    std::vector< shared< sisl::sg_list > > sgs;
+    std::vector< folly::Future< std::error_code > > futs;
+    iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, &bids, &sgs, &futs]() {
+        for (auto& bid : bids) {
+            sgs.push_back(std::make_shared< sisl::sg_list >());
+            futs.push_back(write_sgs(1 * Mi, sgs.back(), 1 /* num_iovs */, bid));
+        }
+    });
+    for (auto& err : folly::collectAllUnsafe(futs).get()) {
+        ASSERT_FALSE(err.value()) << "Write failed";
+    }
+    for (auto& sg : sgs) {
+        free(*sg);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+
+    // Returns the number of bytes in the range of all pieces of bid, which are holes in the device file
+    auto const hole_bytes = [this](MultiBlkId const& bid) {
+        uint64_t holes{0};
+        auto it = bid.iterate();
+        while (auto const b = it.next()) {
+            auto const chunk = homestore::hs()->device_mgr()->get_chunk(b->chunk_num());
+            auto const fd = ::open(chunk->physical_dev()->get_devname().c_str(), O_RDONLY);
+            HS_REL_ASSERT_GE(fd, 0, "Unable to open device file");
+            auto const blk_size = uint64_cast(inst().get_blk_size());
+            auto const start = s_cast< off_t >(chunk->start_offset() + b->blk_num() * blk_size);
+            auto const end = start + s_cast< off_t >(b->blk_count() * blk_size);
+            for (auto off = start; off < end;) {
+                auto data_off = ::lseek(fd, off, SEEK_DATA);
+                if ((data_off < 0) || (data_off > end)) { data_off = end; }
+                holes += (data_off - off);
+                if (data_off == end) { break; }
+                auto const hole_off = ::lseek(fd, data_off, SEEK_HOLE);
+                off = ((hole_off < 0) || (hole_off > end)) ? end : hole_off;
+            }
+            ::close(fd);
+        }
+        return holes;
+    };
+    for (auto const& bid : bids) {
+        ASSERT_EQ(hole_bytes(bid), 0) << "Written blks " << bid.to_string() << " are not allocated in the file";
+    }
+
+    LOGINFO("Step 2: Free alternate extents and flush the cp, which should discard them after the cp is committed");
+    iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, &bids]() {
+        for (uint32_t i{0}; i < bids.size(); i += 2) {
+            inst().async_free_blk(bids[i]).thenValue([](auto&& err) { RELEASE_ASSERT(!err, "Free error"); });
+        }
+    });
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    homestore::hs()->device_mgr()->wait_for_discards();
+
+    for (uint32_t i{0}; i < bids.size(); ++i) {
+        auto const size = uint64_cast(bids[i].blk_count()) * inst().get_blk_size();
+        if (i % 2 == 0) {
+            ASSERT_EQ(hole_bytes(bids[i]), size) << "Freed blks " << bids[i].to_string() << " are not discarded";
+            auto it = bids[i].iterate();
+            while (auto const b = it.next()) {
+                ASSERT_FALSE(data_vdev->is_blk_alloced(*b))
+                    << "Freed blks " << b->to_string() << " are not released to allocator after discard";
+            }
+        } else {
+            ASSERT_EQ(hole_bytes(bids[i]), 0) << "Blks in use " << bids[i].to_string() << " are discarded";
+        }
+    }
+
+    LOGINFO("Step 3: Disable discard, free the rest and validate they are freed without discard");
+    data_vdev->enable_discard(false);
+    iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, &bids]() {
+        for (uint32_t i{1}; i < bids.size(); i += 2) {
+            inst().async_free_blk(bids[i]).thenValue([](auto&& err) { RELEASE_ASSERT(!err, "Free error"); });
+        }
+    });
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    homestore::hs()->device_mgr()->wait_for_discards();
+    for (uint32_t i{1}; i < bids.size(); i += 2) {
+        ASSERT_EQ(hole_bytes(bids[i]), 0) << "Blks " << bids[i].to_string() << " discarded with discard disabled";
+    }
+}
+
 // Stream related test
 
 SISL_OPTION_GROUP(test_data_service,
@@ -16,15 +16,18 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <random>
+#include <set>
 
 #include <gtest/gtest.h>
 #include <iomgr/io_environment.hpp>
+#include <iomgr/iomgr_flip.hpp>
 #include <sisl/logging/logging.h>
 #include <sisl/options/options.h>
 
@@ -255,6 +258,218 @@ TEST_F(DeviceMgrTest, CreateChunk) {
     vdev.reset();
 }
 
+TEST_F(DeviceMgrTest, MirroredVDevCreation) {
+    if (m_pdevs.size() < 2) { GTEST_SKIP() << "Mirrored vdev needs at least 2 pdevs"; }
+    static constexpr uint32_t io_size = 8192;
+    auto const num_pdevs = uint32_cast(m_pdevs.size());
+    auto const size = m_pdevs[0]->data_size() / 4;
+
+    LOGINFO("Step 1: Creating mirrored vdev of size={} on {} pdevs", in_bytes(size), num_pdevs);
+    auto vdev =
+        m_dmgr->create_vdev(homestore::vdev_parameters{.vdev_name = "test_mirrored_vdev",
+                                                       .vdev_size = size,
+                                                       .num_chunks = 2,
+                                                       .blk_size = 4096,
+                                                       .dev_type = HSDevType::Data,
+                                                       .alloc_type = blk_allocator_type_t::none,
+                                                       .chunk_sel_type = chunk_selector_type_t::NONE,
+                                                       .multi_pdev_opts = vdev_multi_pdev_opts_t::ALL_PDEV_MIRRORED,
+                                                       .context_data = sisl::blob{}});
+    ASSERT_EQ(vdev->num_mirrors(), num_pdevs - 1) << "Expected every pdev other than primary to hold a mirror";
+
+    auto const validate_mirrors = [](shared< VirtualDev > const& vd, uint32_t expected_mirrors) {
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            ASSERT_EQ(chunk->primary_chunk_id(), chunk_num) << "Chunk is not indexed by its primary chunk id";
+            ASSERT_EQ(chunk->mirror_chunks().size(), expected_mirrors) << "Unexpected number of mirrors";
+
+            std::set< const PhysicalDev* > replica_pdevs{chunk->physical_dev()};
+            for (auto const& mirror : chunk->mirror_chunks()) {
+                ASSERT_EQ(mirror->is_mirror(), true) << "Mirror chunk is not marked as mirror";
+                ASSERT_EQ(mirror->primary_chunk_id(), chunk_num) << "Mirror points to a different primary";
+                ASSERT_EQ(mirror->size(), chunk->size()) << "Mirror is not of same size as primary";
+                replica_pdevs.insert(mirror->physical_dev());
+            }
+            ASSERT_EQ(replica_pdevs.size(), expected_mirrors + 1) << "Replicas are expected on distinct pdevs";
+        }
+    };
+
+    uint32_t pattern{0};
+    auto const fill = [&pattern](uint8_t* buf, uint16_t chunk_num) {
+        for (uint32_t i{0}; i < io_size; ++i) {
+            buf[i] = uint8_t((pattern + chunk_num + i) & 0xff);
+        }
+    };
+
+    auto wbuf = iomanager.iobuf_alloc(512, io_size);
+    auto rbuf = iomanager.iobuf_alloc(512, io_size);
+    auto const validate_data = [&](shared< VirtualDev > const& vd) {
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            fill(wbuf, chunk_num);
+            for (uint32_t r{0}; r < 2 * (chunk->mirror_chunks().size() + 1); ++r) {
+                std::memset(rbuf, 0, io_size);
+                ASSERT_FALSE(vd->sync_read(r_cast< char* >(rbuf), io_size, chunk, io_size)) << "Read failed";
+                ASSERT_EQ(std::memcmp(wbuf, rbuf, io_size), 0) << "Read data mismatch for chunk " << chunk_num;
+            }
+        }
+    };
+
+    // Validate the data directly on each replica, bypassing the vdev. Replicas on the given pdev are expected to have
+    // missed the latest write.
+    auto const validate_replicas = [&](shared< VirtualDev > const& vd, std::string const& missed_dev = "") {
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            fill(wbuf, chunk_num);
+            std::vector< shared< Chunk > > replicas{chunk};
+            replicas.insert(replicas.end(), chunk->mirror_chunks().begin(), chunk->mirror_chunks().end());
+            for (auto const& replica : replicas) {
+                std::memset(rbuf, 0, io_size);
+                ASSERT_FALSE(replica->physical_dev_mutable()->sync_read(r_cast< char* >(rbuf), io_size,
+                                                                         replica->start_offset() + io_size));
+                auto const missed = (replica->physical_dev()->get_devname() == missed_dev);
+                ASSERT_EQ(std::memcmp(wbuf, rbuf, io_size) == 0, !missed)
+                    << "Replica chunk " << replica->chunk_id() << " missed=" << missed << " mismatch";
+                ASSERT_EQ(replica->is_stale(), missed) << "Replica chunk " << replica->chunk_id() << " stale mismatch";
+            }
+        }
+    };
+
+    auto const write_data = [&](shared< VirtualDev > const& vd) {
+        ++pattern;
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            fill(wbuf, chunk_num);
+            ASSERT_FALSE(vd->sync_write(r_cast< const char* >(wbuf), io_size, chunk, io_size)) << "Write failed";
+        }
+    };
+
+    LOGINFO("Step 2: Validate mirrors and write to each chunk, which should land on all of its mirrors");
+    validate_mirrors(vdev, num_pdevs - 1);
+    write_data(vdev);
+    validate_replicas(vdev);
+    validate_data(vdev);
+
+    LOGINFO("Step 3: Restarting homestore and validate if mirrors are loaded along with primaries");
+    std::string const primary_dev = vdev->get_chunks().begin()->second->physical_dev()->get_devname();
+    vdev.reset();
+    this->restart();
+    ASSERT_EQ(m_vdevs.size(), 1u) << "Expected mirrored vdev to be loaded";
+    validate_mirrors(m_vdevs[0], num_pdevs - 1);
+    validate_data(m_vdevs[0]);
+
+    LOGINFO("Step 4: Restarting without the pdev of primary chunks={}, mirrors should serve the data", primary_dev);
+    auto const all_dev_infos = m_dev_infos;
+    std::erase_if(m_dev_infos, [&primary_dev](auto const& d) { return d.dev_name == primary_dev; });
+    m_vdevs.clear();
+    this->restart();
+    ASSERT_EQ(m_vdevs.size(), 1u) << "Expected mirrored vdev to be loaded in degraded mode";
+    validate_mirrors(m_vdevs[0], num_pdevs - 2);
+    for (auto const& [_, chunk] : m_vdevs[0]->get_chunks()) {
+        ASSERT_EQ(chunk->is_mirror(), true) << "Expected a mirror to be promoted in place of missing primary";
+    }
+    validate_data(m_vdevs[0]);
+
+    LOGINFO("Step 5: Write while pdev={} is missing, restart with it back and it should be resynced", primary_dev);
+    write_data(m_vdevs[0]);
+    validate_data(m_vdevs[0]);
+    m_dev_infos = all_dev_infos;
+    m_vdevs.clear();
+    this->restart();
+    ASSERT_EQ(m_vdevs.size(), 1u) << "Expected mirrored vdev to be loaded";
+    validate_mirrors(m_vdevs[0], num_pdevs - 1);
+    validate_replicas(m_vdevs[0]);
+    validate_data(m_vdevs[0]);
+
+    LOGINFO("Step 6: Load the pdevs of one set of replicas, reads should be served by the less loaded replicas");
+    {
+        static constexpr int64_t load{1000};
+        auto const& vd = m_vdevs[0];
+        std::set< PhysicalDev* > primary_pdevs;
+        std::set< PhysicalDev* > mirror_pdevs;
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            primary_pdevs.insert(chunk->physical_dev_mutable());
+            for (auto const& mirror : chunk->mirror_chunks()) {
+                mirror_pdevs.insert(mirror->physical_dev_mutable());
+            }
+        }
+        for (auto* pdev : primary_pdevs) {
+            ASSERT_EQ(mirror_pdevs.count(pdev), 0u) << "Expected primaries and mirrors on different pdevs";
+        }
+        auto const set_load = [](std::set< PhysicalDev* > const& pdevs, bool loaded) {
+            for (auto* pdev : pdevs) {
+                for (int64_t i{0}; i < load; ++i) {
+                    loaded ? pdev->io_issued() : pdev->io_completed();
+                }
+            }
+        };
+
+        // Primaries get different data than their mirrors, so that the data read tells which replica served it
+        auto const mirror_pattern = pattern;
+        auto const primary_pattern = pattern + 1;
+        pattern = primary_pattern;
+        for (auto const& [chunk_num, chunk] : vd->get_chunks()) {
+            fill(wbuf, chunk_num);
+            ASSERT_FALSE(chunk->physical_dev_mutable()->sync_write(r_cast< const char* >(wbuf), io_size,
+                                                                    chunk->start_offset() + io_size));
+        }
+
+        set_load(primary_pdevs, true);
+        pattern = mirror_pattern;
+        validate_data(vd);
+        set_load(primary_pdevs, false);
+
+        set_load(mirror_pdevs, true);
+        pattern = primary_pattern;
+        validate_data(vd);
+        set_load(mirror_pdevs, false);
+
+        // Bring the replicas back in sync
+        write_data(vd);
+        validate_replicas(vd);
+    }
+
+#ifdef _PRERELEASE
+    flip::FlipClient* fc = iomgr_flip::client_instance();
+    flip::FlipFrequency freq;
+    freq.set_count(uint32_cast(m_vdevs[0]->get_chunks().size()));
+    freq.set_percent(100);
+
+    std::string const failed_dev = m_vdevs[0]->get_chunks().begin()->second->physical_dev()->get_devname();
+    LOGINFO("Step 7: Fail the writes on pdev={}, writes should succeed and its replicas should not be read from",
+            failed_dev);
+    fc->inject_noreturn_flip("simulate_mirror_io_error",
+                             {fc->create_condition("devname", flip::Operator::EQUAL, failed_dev),
+                              fc->create_condition("op_type", flip::Operator::EQUAL, std::string("WRITE"))},
+                             freq);
+    write_data(m_vdevs[0]);
+    validate_replicas(m_vdevs[0], failed_dev);
+    validate_data(m_vdevs[0]);
+
+    fc->remove_flip("simulate_mirror_io_error");
+
+    // Need a replica other than the stale one and the one failing the reads to serve them
+    if (num_pdevs > 2) {
+        auto const first_chunk = m_vdevs[0]->get_chunks().begin()->second;
+        std::string const read_failed_dev = first_chunk->mirror_chunks()[0]->physical_dev()->get_devname();
+        LOGINFO("Step 8: Fail the reads on pdev={}, reads should fail over to the other replicas", read_failed_dev);
+        freq.set_count(1000);
+        fc->inject_noreturn_flip("simulate_mirror_io_error",
+                                 {fc->create_condition("devname", flip::Operator::EQUAL, read_failed_dev),
+                                  fc->create_condition("op_type", flip::Operator::EQUAL, std::string("READ"))},
+                                 freq);
+        validate_data(m_vdevs[0]);
+        fc->remove_flip("simulate_mirror_io_error");
+    }
+
+    LOGINFO("Step 9: Restart and the replicas on pdev={} which missed the write should be resynced", failed_dev);
+    m_vdevs.clear();
+    this->restart();
+    ASSERT_EQ(m_vdevs.size(), 1u) << "Expected mirrored vdev to be loaded";
+    validate_replicas(m_vdevs[0]);
+    validate_data(m_vdevs[0]);
+#endif
+
+    iomanager.iobuf_free(wbuf);
+    iomanager.iobuf_free(rbuf);
+}
+
 int main(int argc, char* argv[]) {
     SISL_OPTIONS_LOAD(argc, argv, logging, test_device_manager, iomgr);
     ::testing::InitGoogleTest(&argc, argv);
@@ -122,7 +122,9 @@ public:
 
         // Do invidivual get validation
         for (uint64_t lsn = m_start_lsn; lsn < uint64_cast(m_next_lsn); ++lsn) {
-            validate_log(m_rls->entry_at(lsn), lsn);
+            auto const le = m_rls->entry_at(lsn);
+            validate_log(le, lsn);
+            ASSERT_EQ(m_rls->term_at(lsn), le->get_term()) << "term_at mismatch with entry at lsn=" << lsn;
         }
 
         // Do bulk get validation as well.
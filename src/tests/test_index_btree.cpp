@@ -72,6 +72,10 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
         std::shared_ptr< IndexTableBase > on_index_table_found(superblk< index_table_sb >&& sb) override {
             LOGINFO("Index table recovered");
             LOGINFO("Root bnode_id {} version {}", sb->root_node, sb->root_link_version);
+            if (sb->uuid == m_test->m_other_uuid) {
+                m_test->m_other_bt = std::make_shared< typename T::BtreeType >(std::move(sb), m_test->m_cfg);
+                return m_test->m_other_bt;
+            }
             m_test->m_bt = std::make_shared< typename T::BtreeType >(std::move(sb), m_test->m_cfg);
             return m_test->m_bt;
         }
@@ -112,6 +116,7 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
         BtreeTestHelper< TestType >::TearDown();
         m_helper.shutdown_homestore(false);
         this->m_bt.reset();
+        m_other_bt.reset();
         log_obj_life_counter();
     }
 
@@ -128,9 +133,41 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
         this->m_bt.reset();
     }
 
+    // Second index table, which is not tracked by the shadow map, to test the interaction between indexes
+    void create_other_btree() {
+        m_other_uuid = boost::uuids::random_generator()();
+        m_other_bt = std::make_shared< typename T::BtreeType >(m_other_uuid, boost::uuids::random_generator()(), 0,
+                                                                this->m_cfg);
+        hs()->index_service().add_index_table(m_other_bt);
+    }
+
+    void destroy_other_btree() {
+        auto cpg = hs()->cp_mgr().cp_guard();
+        auto op_context = (void*)cpg.context(cp_consumer_t::INDEX_SVC);
+        const auto [ret, free_node_cnt] = m_other_bt->destroy_btree(op_context);
+        ASSERT_EQ(ret, btree_status_t::success) << "btree destroy failed";
+        m_other_bt.reset();
+    }
+
+    std::vector< iomgr::io_fiber_t > sync_io_fibers() const {
+        std::vector< iomgr::io_fiber_t > fibers;
+        std::mutex mtx;
+        iomanager.run_on_wait(iomgr::reactor_regex::all_worker, [&fibers, &mtx]() {
+            auto fv = iomanager.sync_io_capable_fibers();
+            std::unique_lock lg(mtx);
+            fibers.insert(fibers.end(), fv.begin(), fv.end());
+        });
+        return fibers;
+    }
+
     test_common::HSTestHelper m_helper;
+    std::shared_ptr< typename T::BtreeType > m_other_bt;
+    boost::uuids::uuid m_other_uuid{};
 };
 
+// Nodes on the path of an operation, which are referenced by it and can't be evicted while it is in progress
+static constexpr uint32_t max_pinned_nodes{8};
+
 using BtreeTypes = testing::Types< FixedLenBtree, VarKeySizeBtree, VarValueSizeBtree, VarObjSizeBtree >;
 
 TYPED_TEST_SUITE(BtreeTest, BtreeTypes);
@@ -265,6 +302,369 @@ TYPED_TEST(BtreeTest, RangeUpdate) {
     LOGINFO("RangeUpdate test end");
 }
 
+TYPED_TEST(BtreeTest, BulkLoad) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    std::vector< uint64_t > keys;
+    for (uint64_t k{0}; k < num_entries; k += 2) {
+        keys.push_back(k);
+    }
+    LOGINFO("Step 1: Bulk load {} even keys", keys.size());
+    this->bulk_load(keys);
+
+    LOGINFO("Step 2: Query and get all entries and validate");
+    this->query_all_paginate(80);
+    this->get_all();
+
+    LOGINFO("Step 3: Flush the checkpoint of just the bulk loaded tree, restart and validate the recovered tree");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->get_all();
+
+    LOGINFO("Step 4: Insert the odd keys on top of bulk loaded tree and validate");
+    for (uint32_t k{1}; k < num_entries; k += 2) {
+        this->put(k, btree_put_type::INSERT);
+    }
+    this->query_all();
+
+    LOGINFO("Step 5: Flush the checkpoint, restart and validate the recovered tree");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->query_all();
+}
+
+TYPED_TEST(BtreeTest, BatchPutGet) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Batch put every third key in batches of 500, splitting the leaves mid-batch");
+    std::vector< uint64_t > keys;
+    for (uint64_t k{0}; k < num_entries; k += 3) {
+        keys.push_back(k);
+        if (keys.size() == 500) {
+            this->batch_put(keys);
+            keys.clear();
+        }
+    }
+    if (!keys.empty()) { this->batch_put(keys); }
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 2: Batch put all keys in a single batch, on top of existing keys");
+    keys.clear();
+    for (uint64_t k{0}; k < num_entries; ++k) {
+        keys.push_back(k);
+    }
+    this->batch_put(keys);
+    this->query_all();
+
+    LOGINFO("Step 3: Remove some keys and batch get all keys including missing ones");
+    for (uint32_t k{0}; k < num_entries; k += 7) {
+        this->remove_one(k);
+    }
+    keys.push_back(num_entries + 10);
+    this->batch_get(keys);
+}
+
+TYPED_TEST(BtreeTest, RangeRemoveDropSubtrees) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Drop the middle 80% of the keys and validate");
+    this->range_remove_drop_subtrees(num_entries / 10, (num_entries * 9) / 10);
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 3: Insert the dropped keys again and validate");
+    for (uint32_t i{num_entries / 10}; i <= (num_entries * 9) / 10; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    this->query_all();
+
+    LOGINFO("Step 4: Drop the first half of the keys and validate");
+    this->range_remove_drop_subtrees(0, num_entries / 2);
+    this->query_all();
+
+    LOGINFO("Step 5: Free the dropped nodes, flush the checkpoint, restart and validate the recovered tree");
+    this->m_bt->free_dropped_nodes();
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->query_all();
+
+    LOGINFO("Step 6: Drop more keys and restart, dropped nodes not yet freed should be freed after the restart");
+    this->range_remove_drop_subtrees(num_entries / 2 + 1, (num_entries * 3) / 4);
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->m_bt->free_dropped_nodes();
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    ASSERT_EQ(this->m_bt->num_dropped_nodes(), 0u) << "Dropped nodes are not freed after restart";
+    this->query_all();
+}
+
+TYPED_TEST(BtreeTest, ParallelQuery) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries and remove every 5th entry", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    for (uint32_t i{0}; i < num_entries; i += 5) {
+        this->remove_one(i);
+    }
+
+    LOGINFO("Step 2: Query all entries in parallel with varying parallelism and validate the ordered results");
+    for (uint32_t parallelism : {1u, 2u, 4u, 16u}) {
+        this->parallel_query(0, num_entries - 1, parallelism, false /* stream */);
+    }
+
+    LOGINFO("Step 3: Query all entries in parallel as per partition streams and validate");
+    this->parallel_query(0, num_entries - 1, 4, true /* stream */);
+
+    LOGINFO("Step 4: Query a sub range in parallel and validate");
+    this->parallel_query(num_entries / 3, (num_entries * 2) / 3, 4, false /* stream */);
+}
+
+TYPED_TEST(BtreeTest, ColdSweepQuery) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Flush the checkpoint and restart, so that the leaves are read from device with read-ahead");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+
+    LOGINFO("Step 3: Query all entries with pagination and validate");
+    this->query_all_paginate(150);
+
+    LOGINFO("Step 4: Query a sub range in one batch and validate");
+    this->do_query(num_entries / 4, (num_entries * 3) / 4, UINT32_MAX);
+}
+
+TYPED_TEST(BtreeTest, PrefetchSweepQuery) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries and flush them", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+
+    auto const cold_query_misses = [this, num_entries](uint32_t max_readahead_nodes) {
+        this->m_cfg.m_max_readahead_nodes = max_readahead_nodes;
+        this->restart_homestore();
+        std::this_thread::sleep_for(std::chrono::seconds{1});
+        iomanager.run_on_wait(this->sync_io_fibers()[0], [this, num_entries]() {
+            this->do_query(num_entries / 4, (num_entries * 3) / 4, UINT32_MAX);
+        });
+        auto const misses = this->m_bt->cache_stats().misses;
+        this->destroy_btree();
+        return misses;
+    };
+
+    LOGINFO("Step 2: Restart and sweep a range in one batch from an io fiber without read ahead");
+    auto const misses_wo_readahead = cold_query_misses(0);
+
+    LOGINFO("Step 3: Restart and sweep the same range with read ahead");
+    auto const misses_w_readahead = cold_query_misses(32);
+    LOGINFO("Misses without read ahead={} with read ahead={}", misses_wo_readahead, misses_w_readahead);
+    ASSERT_EQ(misses_w_readahead, misses_wo_readahead)
+        << "Prefetched leaves should be within the range and not read again by the sweep";
+}
+
+TYPED_TEST(BtreeTest, CacheQuota) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries and flush them", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+
+    LOGINFO("Step 2: Restart with empty cache and limit the cache of the index to few nodes");
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    auto const node_size = hs()->index_service().node_size();
+    auto const quota = 16 * node_size;
+    this->m_bt->set_cache_quota(quota, 0 /* reservation */);
+
+    LOGINFO("Step 3: Read all the entries and validate the index stays within its quota");
+    this->get_all();
+    this->query_all_paginate(80);
+    auto const stats = this->m_bt->cache_stats();
+    LOGINFO("Cache stats hits={} misses={} evictions={} cached_size={}", stats.hits, stats.misses, stats.evictions,
+            stats.cached_size);
+    ASSERT_GT(stats.misses * node_size, quota) << "Expected the index to read more nodes than its quota";
+    ASSERT_GT(stats.evictions, 0u) << "Expected evictions once the index exceeded its quota";
+    ASSERT_LE(stats.cached_size, quota + max_pinned_nodes * node_size) << "Index cache size exceeded its quota";
+}
+
+TYPED_TEST(BtreeTest, CacheScanResistance) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries, flush them and restart with empty cache", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    auto const node_size = hs()->index_service().node_size();
+    auto const quota = 16 * node_size;
+    this->m_bt->set_cache_quota(quota, 0 /* reservation */);
+
+    LOGINFO("Step 2: Read few keys twice, so that their leaves are promoted to protected segment");
+    std::vector< uint32_t > const hot_keys{0, num_entries / 2, num_entries - 1};
+    for (uint32_t round{0}; round < 2; ++round) {
+        for (auto const k : hot_keys) {
+            this->get_specific(k);
+        }
+    }
+
+    LOGINFO("Step 3: Scan all the entries once, which reads every leaf more than the quota could hold");
+    this->do_query(0, num_entries - 1, UINT32_MAX);
+    auto const scan_stats = this->m_bt->cache_stats();
+    LOGINFO("Cache stats after scan hits={} misses={} evictions={} cached_size={}", scan_stats.hits, scan_stats.misses,
+            scan_stats.evictions, scan_stats.cached_size);
+    ASSERT_GT(scan_stats.misses * node_size, quota) << "Expected the scan to read more nodes than the quota";
+    ASSERT_GT(scan_stats.evictions, 0u) << "Expected the scan to evict the nodes";
+
+    LOGINFO("Step 4: Read the keys again, their nodes should have survived the scan");
+    for (auto const k : hot_keys) {
+        this->get_specific(k);
+    }
+    ASSERT_EQ(this->m_bt->cache_stats().misses, scan_stats.misses) << "Scan evicted the frequently used nodes";
+}
+
+TYPED_TEST(BtreeTest, CacheIsolation) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries to each of the two indexes, flush them and restart with empty cache",
+            num_entries);
+    this->create_other_btree();
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+
+        typename TestFixture::K const key{i};
+        auto const value = TestFixture::V::generate_rand();
+        auto req = BtreeSinglePutRequest{&key, &value, btree_put_type::INSERT};
+        ASSERT_EQ(this->m_other_bt->put(req), btree_status_t::success) << "Put to other index failed for key=" << i;
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->destroy_other_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    ASSERT_NE(this->m_other_bt, nullptr) << "Other index is not recovered";
+
+    auto const node_size = hs()->index_service().node_size();
+    auto const quota = 8 * node_size;
+    this->m_other_bt->set_cache_quota(quota, 0 /* reservation */);
+
+    LOGINFO("Step 2: Read all the entries of the index without quota, so that all its nodes are cached");
+    this->get_all();
+    auto const before = this->m_bt->cache_stats();
+    ASSERT_GT(before.misses, 0u) << "Expected the nodes to be read from device after restart";
+
+    LOGINFO("Step 3: Read all the entries of the index with quota, which should evict only its own nodes");
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        typename TestFixture::K const key{i};
+        typename TestFixture::V value;
+        auto req = BtreeSingleGetRequest{&key, &value};
+        ASSERT_EQ(this->m_other_bt->get(req), btree_status_t::success) << "Get from other index failed for key=" << i;
+    }
+    auto const other = this->m_other_bt->cache_stats();
+    LOGINFO("Other index cache stats hits={} misses={} evictions={} cached_size={}", other.hits, other.misses,
+            other.evictions, other.cached_size);
+    ASSERT_GT(other.misses * node_size, quota) << "Expected the other index to read more nodes than its quota";
+    ASSERT_GT(other.evictions, 0u) << "Expected the other index to evict its nodes";
+    ASSERT_LE(other.cached_size, quota + max_pinned_nodes * node_size) << "Other index exceeded its quota";
+
+    LOGINFO("Step 4: Read all the entries of the index without quota again, all of them should be served from cache");
+    this->get_all();
+    auto const after = this->m_bt->cache_stats();
+    ASSERT_EQ(after.evictions, 0u) << "Index without quota lost its nodes to the other index";
+    ASSERT_EQ(after.misses, before.misses) << "Index without quota had to read its nodes again";
+}
+
+TYPED_TEST(BtreeTest, ConcurrentColdRead) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries, flush them and restart with empty cache", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+
+    LOGINFO("Step 2: Read the first key from the test thread, which can't wait on a fiber and reads synchronously");
+    this->get_specific(0);
+    auto const path_misses = this->m_bt->cache_stats().misses;
+    ASSERT_GT(path_misses, 0u) << "Expected the nodes to be read from device after restart";
+
+    LOGINFO("Step 3: Read the last key from all io fibers at once, they should share the reads of the same nodes");
+    auto const fibers = this->sync_io_fibers();
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t pending{fibers.size()};
+    for (auto const& fiber : fibers) {
+        iomanager.run_on_forget(fiber, [this, &mtx, &cv, &pending, num_entries]() {
+            this->get_specific(num_entries - 1);
+            std::unique_lock lg(mtx);
+            if (--pending == 0) { cv.notify_one(); }
+        });
+    }
+    {
+        std::unique_lock lg(mtx);
+        cv.wait(lg, [&pending] { return (pending == 0); });
+    }
+    auto const concurrent_misses = this->m_bt->cache_stats().misses - path_misses;
+    LOGINFO("Path misses={} misses by {} concurrent readers={}", path_misses, fibers.size(), concurrent_misses);
+    ASSERT_LE(concurrent_misses, path_misses) << "Concurrent readers of a node should join the in-flight read";
+
+    LOGINFO("Step 4: Validate all entries");
+    this->get_all();
+}
+
+TYPED_TEST(BtreeTest, CoalescedCpFlush) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries sequentially, so that the new nodes are on adjacent blks", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Flush the new nodes with coalesced writes, restart and validate");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->get_all();
+    this->do_query(0, num_entries - 1, 1000);
+
+    LOGINFO("Step 3: Update all the entries, so that every node is rewritten in place with coalesced writes");
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::UPDATE);
+    }
+
+    LOGINFO("Step 4: Flush the updated nodes, restart and validate");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->get_all();
+    this->do_query(0, num_entries - 1, 1000);
+}
+
 TYPED_TEST(BtreeTest, CpFlush) {
     LOGINFO("CpFlush test start");
 
@@ -507,6 +907,8 @@ struct BtreeConcurrentTest : public BtreeTestHelper< TestType >, public ::testin
 private:
     const std::string m_shadow_filename = "/tmp/shadow_map.txt";
     test_common::HSTestHelper m_helper;
+    std::shared_ptr< typename T::BtreeType > m_other_bt;
+    boost::uuids::uuid m_other_uuid{};
 };
 
 TYPED_TEST_SUITE(BtreeConcurrentTest, BtreeTypes);
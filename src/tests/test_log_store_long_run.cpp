@@ -302,10 +302,12 @@ public:
                 lsc->flush();
             }
             m_helper.change_start_cb([this, n_log_stores]() {
-                HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+                HS_SETTINGS_FACTORY().modifiable_settings([this](auto& s) {
                     // Disable flush and resource mgr timer in UT.
                     s.logstore.flush_timer_frequency_us = 0;
                     s.resource_limits.resource_audit_timer_ms = 0;
+                    s.logstore.recovery_parallelism = m_recovery_parallelism;
+                    s.logstore.recovery_read_ahead_depth = m_recovery_read_ahead_depth;
                 });
                 HS_SETTINGS_FACTORY().save();
                 for (uint32_t i{0}; i < n_log_stores; ++i) {
@@ -494,6 +496,13 @@ public:
         }
     }
 
+    void set_recovery_config(uint32_t parallelism, uint32_t read_ahead_depth) {
+        m_recovery_parallelism = parallelism;
+        m_recovery_read_ahead_depth = read_ahead_depth;
+    }
+
+    size_t num_log_stores() const { return m_log_store_clients.size(); }
+
     void delete_create_logstore() {
         // Delete a random logstore.
         std::uniform_int_distribution< uint64_t > gen{0, m_log_store_clients.size() - 1};
@@ -557,6 +566,8 @@ private:
     std::map< logdev_id_t, std::atomic< logid_t > > m_truncate_log_idx;
     uint32_t m_q_depth{64};
     uint32_t m_batch_size{1};
+    uint32_t m_recovery_parallelism{8};
+    uint32_t m_recovery_read_ahead_depth{2};
     std::random_device rd{};
     std::default_random_engine re{rd()};
     test_common::HSTestHelper m_helper;
@@ -617,6 +628,31 @@ TEST_F(LogStoreLongRun, LongRunning) {
     }
 }
 
+TEST_F(LogStoreLongRun, RecoveryTime) {
+    auto const nrecords = SISL_OPTIONS["num_recovery_records"].as< uint32_t >();
+    init();
+
+    // Fill up all the logstores and then recover the same journal, first serially without any read ahead and then
+    // with read ahead and logdevs recovered in parallel, measuring how long each restart takes.
+    kickstart_inserts(nrecords, 10 /* batch */, 5000 /* q_depth */);
+    wait_for_inserts();
+
+    for (auto const& [parallelism, read_ahead_depth] :
+         std::initializer_list< std::pair< uint32_t, uint32_t > >{{1, 0}, {1, 2}, {8, 0}, {8, 2}}) {
+        set_recovery_config(parallelism, read_ahead_depth);
+
+        auto const start_time = Clock::now();
+        start_homestore(true /* restart */);
+        auto const elapsed_ms = get_elapsed_time_ms(start_time);
+        LOGINFO("Restart with recovery_parallelism={} recovery_read_ahead_depth={} of {} logstores with {} records "
+                "each took {} ms",
+                parallelism, read_ahead_depth, num_log_stores(), nrecords, elapsed_ms);
+
+        recovery_validate();
+        init();
+    }
+}
+
 SISL_OPTIONS_ENABLE(logging, test_log_store_long_run, iomgr, test_common_setup)
 SISL_OPTION_GROUP(test_log_store_long_run,
                   (num_logstores, "", "num_logstores", "number of log stores",
@@ -626,7 +662,10 @@ SISL_OPTION_GROUP(test_log_store_long_run,
                   (num_iterations, "", "num_iterations", "Iterations",
                    ::cxxopts::value< uint32_t >()->default_value("1"), "the number of iterations to run each test"),
                   (run_time, "", "run_time", "running time in seconds",
-                   ::cxxopts::value< uint64_t >()->default_value("600"), "number"));
+                   ::cxxopts::value< uint64_t >()->default_value("600"), "number"),
+                  (num_recovery_records, "", "num_recovery_records",
+                   "number of records per logstore written before measuring recovery time",
+                   ::cxxopts::value< uint32_t >()->default_value("1000"), "number"));
 
 int main(int argc, char* argv[]) {
     int parsed_argc = argc;
@@ -92,6 +92,22 @@ struct PrefixIntervalBtreeTest {
     static constexpr btree_node_type interior_node_type = btree_node_type::FIXED;
 };
 
+struct CompactLeafBtreeTest {
+    using BtreeType = MemBtree< TestFixedKey, TestFixedValue >;
+    using KeyType = TestFixedKey;
+    using ValueType = TestFixedValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::COMPACT;
+    static constexpr btree_node_type interior_node_type = btree_node_type::FIXED;
+};
+
+struct CompactVarObjLeafBtreeTest {
+    using BtreeType = MemBtree< TestVarLenKey, TestVarLenValue >;
+    using KeyType = TestVarLenKey;
+    using ValueType = TestVarLenValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::COMPACT;
+    static constexpr btree_node_type interior_node_type = btree_node_type::VAR_OBJECT;
+};
+
 template < typename TestType >
 struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
     using T = TestType;
@@ -108,7 +124,8 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
 
 // TODO Enable PrefixIntervalBtreeTest later
 using BtreeTypes = testing::Types< /* PrefixIntervalBtreeTest, */ FixedLenBtreeTest, VarKeySizeBtreeTest,
-                                   VarValueSizeBtreeTest, VarObjSizeBtreeTest >;
+                                   VarValueSizeBtreeTest, VarObjSizeBtreeTest, CompactLeafBtreeTest,
+                                   CompactVarObjLeafBtreeTest >;
 TYPED_TEST_SUITE(BtreeTest, BtreeTypes);
 
 TYPED_TEST(BtreeTest, SequentialInsert) {
@@ -178,6 +195,129 @@ TYPED_TEST(BtreeTest, SequentialRemove) {
     this->get_specific(0);
 }
 
+TYPED_TEST(BtreeTest, BulkLoad) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    std::vector< uint64_t > keys;
+    for (uint64_t k{0}; k < num_entries; k += 2) {
+        keys.push_back(k);
+    }
+    LOGINFO("Step 1: Bulk load {} even keys", keys.size());
+    this->bulk_load(keys);
+
+    LOGINFO("Step 2: Query and get all entries and validate");
+    this->query_all_paginate(80);
+    this->get_all();
+
+    LOGINFO("Step 3: Insert the odd keys on top of bulk loaded tree and validate");
+    for (uint32_t k{1}; k < num_entries; k += 2) {
+        this->put(k, btree_put_type::INSERT);
+    }
+    this->query_all();
+}
+
+TYPED_TEST(BtreeTest, BatchPutGet) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Batch put every third key in batches of 500, splitting the leaves mid-batch");
+    std::vector< uint64_t > keys;
+    for (uint64_t k{0}; k < num_entries; k += 3) {
+        keys.push_back(k);
+        if (keys.size() == 500) {
+            this->batch_put(keys);
+            keys.clear();
+        }
+    }
+    if (!keys.empty()) { this->batch_put(keys); }
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 2: Batch put all keys in a single batch, on top of existing keys");
+    keys.clear();
+    for (uint64_t k{0}; k < num_entries; ++k) {
+        keys.push_back(k);
+    }
+    this->batch_put(keys);
+    this->query_all();
+
+    LOGINFO("Step 3: Remove some keys and batch get all keys including missing ones");
+    for (uint32_t k{0}; k < num_entries; k += 7) {
+        this->remove_one(k);
+    }
+    keys.push_back(num_entries + 10);
+    this->batch_get(keys);
+}
+
+TYPED_TEST(BtreeTest, RangeRemoveDropSubtrees) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Drop the middle 80% of the keys and validate");
+    this->range_remove_drop_subtrees(num_entries / 10, (num_entries * 9) / 10);
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 3: Insert the dropped keys again and validate");
+    for (uint32_t i{num_entries / 10}; i <= (num_entries * 9) / 10; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    this->query_all();
+
+    LOGINFO("Step 4: Drop all keys and validate");
+    this->range_remove_drop_subtrees(0, num_entries - 1);
+    this->query_all();
+}
+
+TYPED_TEST(BtreeTest, ParallelQuery) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries and remove every 5th entry", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    for (uint32_t i{0}; i < num_entries; i += 5) {
+        this->remove_one(i);
+    }
+
+    LOGINFO("Step 2: Query all entries in parallel with varying parallelism and validate the ordered results");
+    for (uint32_t parallelism : {1u, 2u, 4u, 16u}) {
+        this->parallel_query(0, num_entries - 1, parallelism, false /* stream */);
+    }
+
+    LOGINFO("Step 3: Query all entries in parallel as per partition streams and validate");
+    this->parallel_query(0, num_entries - 1, 4, true /* stream */);
+
+    LOGINFO("Step 4: Query a sub range in parallel and validate");
+    this->parallel_query(num_entries / 3, (num_entries * 2) / 3, 4, false /* stream */);
+}
+
+TYPED_TEST(BtreeTest, NodeMemoryReuse) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    uint64_t peak_size{0};
+    for (uint32_t round{0}; round < 3; ++round) {
+        LOGINFO("Round {}: Insert {} entries and remove all of them", round, num_entries);
+        for (uint32_t i{0}; i < num_entries; ++i) {
+            this->put(i, btree_put_type::INSERT);
+        }
+        auto const filled_size = this->m_bt->node_memory_size();
+        for (uint32_t i{0}; i < num_entries; ++i) {
+            this->remove_one(i);
+        }
+        auto const emptied_size = this->m_bt->node_memory_size();
+        LOGINFO("Node memory size after insert={} after remove={}", filled_size, emptied_size);
+        ASSERT_LE(emptied_size, filled_size) << "Node memory has grown after removing all entries";
+
+        // Freed node buffers are expected to be reused, so repeated churn should not grow the memory
+        if (round == 0) {
+            peak_size = filled_size;
+        } else {
+            ASSERT_LE(filled_size, peak_size + MemBtreeNodePool::default_slab_size)
+                << "Node memory has grown across rounds of insert and remove";
+        }
+    }
+    this->get_any(0, num_entries);
+}
+
 TYPED_TEST(BtreeTest, RandomInsert) {
     // Forward sequential insert
     const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
@@ -322,6 +462,21 @@ TYPED_TEST(BtreeConcurrentTest, ConcurrentAllOps) {
     this->multi_op_execute(ops);
 }
 
+TYPED_TEST(BtreeConcurrentTest, ConcurrentOptimisticReads) {
+    this->m_cfg.m_optimistic_read_turned_on = true;
+    this->m_bt = std::make_shared< typename TestFixture::T::BtreeType >(this->m_cfg);
+
+    std::vector< std::string > input_ops = {"put:30", "remove:20", "query:50"};
+    if (SISL_OPTIONS.count("operation_list")) {
+        input_ops = SISL_OPTIONS["operation_list"].as< std::vector< std::string > >();
+    }
+    auto ops = this->build_op_list(input_ops);
+
+    this->multi_op_execute(ops);
+    this->get_all();
+    this->query_all_paginate(80);
+}
+
 int main(int argc, char* argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     SISL_OPTIONS_LOAD(argc, argv, logging, test_mem_btree)
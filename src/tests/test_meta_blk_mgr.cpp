@@ -26,6 +26,7 @@
 #include <mutex>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 #include <iomgr/io_environment.hpp>
 #include <sisl/logging/logging.h>
@@ -938,6 +939,181 @@ TEST_F(VMetaBlkMgrTest, CompressionBackoff) {
     this->shutdown();
 }
 
+// Async updates of sbs issued concurrently from multiple threads, with each sb updated several times without waiting.
+// The updates are group committed and the latest update of every sb is the one expected after recovery.
+TEST_F(VMetaBlkMgrTest, AsyncUpdateGroupCommit) {
+    mtype = "Test_Async_Update";
+    reset_counters();
+    m_start_time = Clock::now();
+    this->register_client();
+
+    static constexpr uint32_t num_sbs{64};
+    static constexpr uint32_t num_threads{4};
+    static constexpr uint32_t updates_per_sb{8};
+    for (uint32_t i{0}; i < num_sbs; ++i) {
+        EXPECT_GT(this->do_sb_write(false), uint64_cast(0));
+    }
+
+    std::vector< std::pair< uint64_t, void* > > sbs;
+    for (auto const& [bid, info] : m_write_sbs) {
+        sbs.emplace_back(bid, info.cookie);
+    }
+
+    std::vector< std::thread > threads;
+    for (uint32_t t{0}; t < num_threads; ++t) {
+        threads.emplace_back([this, t, &sbs]() {
+            // Each thread updates its own set of sbs, so the last update issued for a sb is the expected one
+            std::vector< folly::Future< bool > > futs;
+            for (uint32_t u{0}; u < updates_per_sb; ++u) {
+                for (auto i = t; i < sbs.size(); i += num_threads) {
+                    auto const sz = rand_size(false /* overflow */);
+                    std::vector< uint8_t > buf(sz);
+                    gen_rand_buf(buf.data(), sz);
+                    futs.push_back(m_mbm->async_update_sub_sb(buf.data(), sz, sbs[i].second));
+
+                    std::unique_lock< std::mutex > lg{m_mtx};
+                    m_write_sbs[sbs[i].first].str = md5_sum(r_cast< const char* >(buf.data()), sz);
+                }
+            }
+            for (auto& f : futs) {
+                EXPECT_TRUE(std::move(f).get());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    this->recover_with_on_complete();
+
+    this->validate();
+
+    this->shutdown();
+}
+
+// Startup loads the meta blk headers and ovf data through the meta blk directory when it is up to date, and falls back
+// to the chain walk for the blks a stale directory doesn't list or when the directory is corrupt.
+TEST_F(VMetaBlkMgrTest, DirectoryPrefetch) {
+    mtype = "Test_Dir_Prefetch";
+    reset_counters();
+    m_start_time = Clock::now();
+    this->register_client();
+
+    auto const set_dir_enabled = [](bool enabled) {
+        HS_SETTINGS_FACTORY().modifiable_settings([enabled](auto& s) {
+            s.metablk.meta_blk_dir_enabled = enabled;
+            HS_SETTINGS_FACTORY().save();
+        });
+    };
+    set_dir_enabled(true);
+
+    static constexpr uint32_t num_sbs{32};
+    for (uint32_t i{0}; i < num_sbs; ++i) {
+        EXPECT_GT(this->do_sb_write((i % 4) == 0 /* overflow */), uint64_cast(0));
+    }
+
+    LOGINFO("Step 1: Restart, the directory written on shutdown lists all the blks");
+    this->recover_with_on_complete();
+    this->validate();
+    auto stats = m_mbm->last_scan_stats();
+    LOGINFO("Prefetched blks={} misses={}", stats.dir_prefetched_blks, stats.dir_misses);
+    ASSERT_GT(stats.dir_prefetched_blks, 0u) << "Expected the blks to be read through the directory";
+    ASSERT_EQ(stats.dir_misses, 0u) << "Expected the directory to list all the blks";
+
+    LOGINFO("Step 2: Add more sbs and restart without writing the directory on shutdown, so that it is stale");
+    for (uint32_t i{0}; i < num_sbs / 4; ++i) {
+        EXPECT_GT(this->do_sb_write(true /* overflow */), uint64_cast(0));
+    }
+    set_dir_enabled(false);
+    m_helper.change_start_cb([this, &set_dir_enabled]() {
+        set_dir_enabled(true);
+        register_client();
+    });
+    m_cb_blks.clear();
+    m_helper.restart_homestore();
+    this->validate();
+    stats = m_mbm->last_scan_stats();
+    LOGINFO("Prefetched blks={} misses={}", stats.dir_prefetched_blks, stats.dir_misses);
+    ASSERT_GT(stats.dir_prefetched_blks, 0u) << "Expected the blks listed in stale directory to be read through it";
+    ASSERT_GT(stats.dir_misses, 0u) << "Expected the blks added after the directory to be read by chain walk";
+
+#ifdef _PRERELEASE
+    LOGINFO("Step 3: Restart with a corrupt directory, all the blks are read by chain walk");
+    set_flip_point("meta_blk_dir_corrupt");
+    this->recover_with_on_complete();
+    this->validate();
+    ASSERT_EQ(m_mbm->last_scan_stats().dir_prefetched_blks, 0u) << "Expected the corrupt directory to be ignored";
+#endif
+
+    this->shutdown();
+}
+
+// Startup benchmark with a large number of subtypes (one sb each, some with overflow blks): time taken by services
+// start on restart when meta blks are loaded by walking the chain vs through the meta blk directory. It is not part of
+// the default test run, run it with --gtest_filter=VMetaBlkMgrTest.StartupWithManySubtypes
+TEST_F(VMetaBlkMgrTest, StartupWithManySubtypes) {
+    mtype = "Test_Startup";
+    reset_counters();
+    this->register_client();
+
+    auto const nsubtypes = SISL_OPTIONS["startup_subtypes"].as< uint32_t >();
+    auto const register_subtypes = [this, nsubtypes]() {
+        for (uint32_t i{0}; i < nsubtypes; ++i) {
+            auto const type = fmt::format("Test_Startup_{}", i);
+            m_mbm->deregister_handler(type);
+            m_mbm->register_handler(
+                type,
+                [this](meta_blk* mblk, sisl::byte_view buf, size_t size) {
+                    if (mblk) {
+                        std::unique_lock< std::mutex > lg{m_mtx};
+                        m_cb_blks[mblk->hdr.h.bid.to_integer()] =
+                            sb_info_t{mblk, md5_sum(r_cast< const char* >(buf.bytes()), size)};
+                    }
+                },
+                nullptr);
+        }
+    };
+    register_subtypes();
+
+    for (uint32_t i{0}; i < nsubtypes; ++i) {
+        auto const sz = rand_size((i % 16) == 0 /* overflow */);
+        uint8_t* buf = iomanager.iobuf_alloc(512, sz);
+        gen_rand_buf(buf, sz);
+        void* cookie{nullptr};
+        m_mbm->add_sub_sb(fmt::format("Test_Startup_{}", i), buf, sz, cookie);
+        m_write_sbs[s_cast< const meta_blk* >(cookie)->hdr.h.bid.to_integer()] =
+            sb_info_t{cookie, md5_sum(r_cast< const char* >(buf), sz)};
+        iomanager.iobuf_free(buf);
+    }
+
+    auto const timed_restart = [this, &register_subtypes](bool use_dir) {
+        HS_SETTINGS_FACTORY().modifiable_settings([use_dir](auto& s) {
+            s.metablk.meta_blk_dir_enabled = use_dir;
+            HS_SETTINGS_FACTORY().save();
+        });
+
+        Clock::time_point start_time;
+        m_cb_blks.clear();
+        m_helper.change_start_cb([this, &register_subtypes, &start_time]() {
+            register_client();
+            register_subtypes();
+            start_time = Clock::now();
+        });
+        m_helper.restart_homestore();
+        auto const elapsed_us = get_elapsed_time_us(start_time);
+        this->validate();
+        return elapsed_us;
+    };
+
+    auto const chain_us = timed_restart(false /* use_dir */);
+    timed_restart(true /* use_dir */); // directory is written on this shutdown
+    auto const dir_us = timed_restart(true /* use_dir */);
+    LOGINFO("Startup with {} subtypes: chain walk took {} us, meta blk directory took {} us", nsubtypes, chain_us,
+            dir_us);
+
+    this->shutdown();
+}
+
 SISL_OPTION_GROUP(
     test_meta_blk_mgr,
     (fixed_write_size_enabled, "", "fixed_write_size_enabled", "fixed write size enabled 0 or 1",
@@ -954,10 +1130,13 @@ SISL_OPTION_GROUP(
     (per_update, "", "per_update", "update percentage", ::cxxopts::value< uint32_t >()->default_value("20"), "number"),
     (per_write, "", "per_write", "write percentage", ::cxxopts::value< uint32_t >()->default_value("60"), "number"),
     (per_remove, "", "per_remove", "remove percentage", ::cxxopts::value< uint32_t >()->default_value("20"), "number"),
-    (bitmap, "", "bitmap", "bitmap test", ::cxxopts::value< bool >()->default_value("false"), "true or false"));
+    (bitmap, "", "bitmap", "bitmap test", ::cxxopts::value< bool >()->default_value("false"), "true or false"),
+    (startup_subtypes, "", "startup_subtypes", "number of subtypes in startup benchmark",
+     ::cxxopts::value< uint32_t >()->default_value("10000"), "number"));
 
 int main(int argc, char* argv[]) {
-    ::testing::GTEST_FLAG(filter) = "*random*:VMetaBlkMgrTest.recovery_test";
+    ::testing::GTEST_FLAG(filter) = "*random*:VMetaBlkMgrTest.recovery_test:VMetaBlkMgrTest.AsyncUpdateGroupCommit:"
+                                    "VMetaBlkMgrTest.DirectoryPrefetch";
     ::testing::InitGoogleTest(&argc, argv);
     SISL_OPTIONS_LOAD(argc, argv, logging, test_meta_blk_mgr, iomgr, test_common_setup);
     sisl::logging::SetLogger("test_meta_blk_mgr");
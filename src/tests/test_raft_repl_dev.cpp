@@ -58,6 +58,9 @@ SISL_OPTION_GROUP(test_raft_repl_dev,
                    ::cxxopts::value< uint32_t >()->default_value("0"), "number"),
                   (num_raft_logs_resv, "", "num_raft_logs_resv", "number of raft logs reserved",
                    ::cxxopts::value< uint32_t >()->default_value("0"), "number"),
+                  (num_reserved_log_items, "", "num_reserved_log_items",
+                   "number of raft logs retained by raft server on compaction",
+                   ::cxxopts::value< uint32_t >()->default_value("0"), "number"),
                   (res_mgr_audit_timer_ms, "", "res_mgr_audit_timer_ms", "resource manager audit timer",
                    ::cxxopts::value< uint32_t >()->default_value("0"), "number"));
 
@@ -156,6 +159,76 @@ public:
 
     AsyncReplResult<> create_snapshot(repl_snapshot& s) override { return make_async_success<>(); }
 
+    // Each key/value is carried in the snapshot state as below, followed by a blk entry if it has data
+    struct snapshot_kv {
+        uint64_t id;
+        int64_t lsn;
+        uint64_t data_size;
+        uint64_t data_pattern;
+    };
+
+    // Cursor 0 is the beginning of the db, otherwise it is the (key id + 1) to start from
+    ReplServiceError read_snapshot_obj(repl_snapshot const& s, repl_snapshot_obj& obj, uint32_t max_size) override {
+        std::vector< snapshot_kv > kvs;
+        uint64_t obj_size{0};
+        {
+            std::shared_lock lk(db_mtx_);
+            auto it = (obj.cursor == 0) ? inmem_db_.begin() : inmem_db_.lower_bound(Key{.id_ = obj.cursor - 1});
+            for (; it != inmem_db_.end(); ++it) {
+                auto const& [k, v] = *it;
+                // Keys committed after the snapshot are caught up by the raft logs following the snapshot
+                if (v.lsn_ > int64_cast(s.last_log_idx_)) { continue; }
+                if (!kvs.empty() && (obj_size + sizeof(snapshot_kv) + v.data_size_ > max_size)) { break; }
+
+                kvs.emplace_back(snapshot_kv{k.id_, v.lsn_, v.data_size_, v.data_pattern_});
+                obj_size += sizeof(snapshot_kv) + v.data_size_;
+                if (v.data_size_ != 0) {
+                    auto& b = obj.blks.emplace_back();
+                    b.header = sisl::io_blob_safe{sizeof(test_req::journal_header)};
+                    new (b.header.bytes()) test_req::journal_header{v.data_size_, v.data_pattern_};
+                    b.blkid = v.blkid_;
+                }
+            }
+            obj.is_last = (it == inmem_db_.end());
+            obj.next_cursor = obj.is_last ? obj.cursor + 1 : it->first.id_ + 1;
+        }
+
+        if (!kvs.empty()) {
+            obj.state = sisl::io_blob_safe{uint32_cast(kvs.size() * sizeof(snapshot_kv))};
+            std::memcpy(obj.state.bytes(), kvs.data(), obj.state.size());
+        }
+        return ReplServiceError::OK;
+    }
+
+    ReplServiceError write_snapshot_obj(repl_snapshot const& s, repl_snapshot_obj const& obj) override {
+        auto const* kvs = r_cast< snapshot_kv const* >(obj.state.cbytes());
+        auto const nkvs = obj.state.size() / sizeof(snapshot_kv);
+
+        std::unique_lock lk(db_mtx_);
+        size_t b{0};
+        for (size_t i{0}; i < nkvs; ++i) {
+            Value v{.lsn_ = kvs[i].lsn, .data_size_ = kvs[i].data_size, .data_pattern_ = kvs[i].data_pattern};
+            if (v.data_size_ != 0) {
+                RELEASE_ASSERT_LT(b, obj.blks.size(), "Snapshot obj has fewer blks than the keys with data");
+                v.blkid_ = obj.blks[b++].blkid;
+            }
+            snapshot_db_.insert_or_assign(Key{.id_ = kvs[i].id}, v);
+        }
+        return ReplServiceError::OK;
+    }
+
+    ReplServiceError apply_snapshot(repl_snapshot const& s) override {
+        std::unique_lock lk(db_mtx_);
+        LOGINFOMOD(replication, "[Replica={}] Applying snapshot idx={} term={} with {} keys", g_helper->replica_num(),
+                   s.last_log_idx_, s.last_log_term_, snapshot_db_.size());
+        for (auto const& [k, v] : snapshot_db_) {
+            if (inmem_db_.insert_or_assign(k, v).second) { ++commit_count_; }
+        }
+        snapshot_db_.clear();
+        ++snapshot_apply_count_;
+        return ReplServiceError::OK;
+    }
+
     ReplResult< blk_alloc_hints > get_blk_alloc_hints(sisl::blob const& header, uint32_t data_size) override {
         return blk_alloc_hints{};
     }
@@ -229,9 +302,16 @@ public:
         return inmem_db_.size();
     }
 
+    uint64_t snapshot_apply_count() const {
+        std::shared_lock lk(db_mtx_);
+        return snapshot_apply_count_;
+    }
+
 private:
     std::map< Key, Value > inmem_db_;
+    std::map< Key, Value > snapshot_db_; // Keys received as part of the snapshot, but yet to be applied
     uint64_t commit_count_{0};
+    uint64_t snapshot_apply_count_{0};
     std::shared_mutex db_mtx_;
 };
 
@@ -624,6 +704,64 @@ TEST_F(RaftReplDevTest, Snapshot_and_Compact) {
     g_helper->sync_for_cleanup_start();
 }
 
+//
+// This test needs the raft logs to be compacted while a follower is down, so that the follower has to be caught up by
+// installing the snapshot (data blks and the db state) streamed from the leader. The number of entries written while
+// the follower is down is derived from the raft snapshot/compaction settings, so the test always drives the follower
+// through the snapshot install. Smaller settings make it run faster, example:
+// ./bin/test_raft_repl_dev --gtest_filter=*Follower_Snapshot_Install* --num_io=500 --snapshot_distance=100
+// --num_reserved_log_items=50 --num_raft_logs_resv=50
+//
+TEST_F(RaftReplDevTest, Follower_Snapshot_Install) {
+    LOGINFO("Homestore replica={} setup completed", g_helper->replica_num());
+    g_helper->sync_for_test_start();
+
+    // Step 1: Fill up entries on all replicas
+    this->write_on_leader(20, true /* wait for commit on all */);
+
+    // Step 2: Make the snapshot objs fairly small to have the snapshot streamed in multiple objs
+    uint32_t prev_obj_size{4096};
+    HS_SETTINGS_FACTORY().modifiable_settings([&prev_obj_size](auto& s) {
+        prev_obj_size = s.consensus.snapshot_obj_max_size_kb;
+        s.consensus.snapshot_obj_max_size_kb = (SISL_OPTIONS["block_size"].as< uint32_t >() * 8) / 1024;
+    });
+    HS_SETTINGS_FACTORY().save();
+
+    // Step 3: Restart replica-2 (follower) with a long delay, while other replicas write and compact their logs
+    this->restart_replica(2, 30 /* shutdown_delay_sec */);
+    // Leader has to take at least one snapshot beyond the reserved log items and the log store reserve threshold, so
+    // that the entries the follower is missing are compacted and truncated away.
+    uint64_t const num_writes =
+        std::max(SISL_OPTIONS["num_io"].as< uint64_t >(),
+                 2ul * HS_DYNAMIC_CONFIG(consensus.snapshot_freq_distance) +
+                     HS_DYNAMIC_CONFIG(consensus.num_reserved_log_items) +
+                     HS_DYNAMIC_CONFIG(resource_limits.raft_logstore_reserve_threshold));
+    LOGINFO("After one follower is shutdown, insert {} more entries and truncate the raft logs", num_writes);
+    this->write_on_leader(num_writes, true /* wait for commit on all */);
+    if (g_helper->replica_num() != 2) {
+        for (auto const& db : dbs_) {
+            std::dynamic_pointer_cast< RaftReplDev >(db->repl_dev())
+                ->truncate(HS_DYNAMIC_CONFIG(resource_limits.raft_logstore_reserve_threshold));
+        }
+    }
+
+    // Step 4: Replica-2 is expected to have caught up by the snapshot followed by the logs after the snapshot
+    if (g_helper->replica_num() == 2) {
+        for (auto const& db : dbs_) {
+            ASSERT_GT(db->snapshot_apply_count(), 0u) << "Expected the follower to be caught up by the snapshot";
+        }
+    }
+
+    g_helper->sync_for_verify_start();
+    LOGINFO("Validate all data written so far by reading them");
+    this->validate_data();
+
+    HS_SETTINGS_FACTORY().modifiable_settings(
+        [prev_obj_size](auto& s) { s.consensus.snapshot_obj_max_size_kb = prev_obj_size; });
+    HS_SETTINGS_FACTORY().save();
+    g_helper->sync_for_cleanup_start();
+}
+
 TEST_F(RaftReplDevTest, RemoveReplDev) {
     LOGINFO("Homestore replica={} setup completed", g_helper->replica_num());
 
@@ -739,6 +877,9 @@ int main(int argc, char* argv[]) {
         if (SISL_OPTIONS.count("num_raft_logs_resv")) {
             s.resource_limits.raft_logstore_reserve_threshold = SISL_OPTIONS["num_raft_logs_resv"].as< uint32_t >();
         }
+        if (SISL_OPTIONS.count("num_reserved_log_items")) {
+            s.consensus.num_reserved_log_items = SISL_OPTIONS["num_reserved_log_items"].as< uint32_t >();
+        }
         if (SISL_OPTIONS.count("res_mgr_audit_timer_ms")) {
             s.resource_limits.resource_audit_timer_ms = SISL_OPTIONS["res_mgr_audit_timer_ms"].as< uint32_t >();
         }